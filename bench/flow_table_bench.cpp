@@ -0,0 +1,179 @@
+/**
+ * @brief Benchmark bảng luồng: FlowTable so với QHash (qHash SipHash hiện tại và hàm XOR cũ).
+ *
+ * Build: cmake -S . -B build -DBUILD_BENCHMARKS=ON -DCMAKE_BUILD_TYPE=Release
+ *        cmake --build build --target flow_table_bench
+ * Chạy:  ./build/bench/flow_table_bench [số luồng ...]   (mặc định: 1000000 2000000)
+ *
+ * Mỗi lần chạy: chèn N luồng IPv4 ngẫu nhiên (hạt giống cố định), rồi tra cứu LOOKUPS lần
+ * theo thứ tự xáo trộn, mỗi lần tăng packet_count của bản ghi (giống processPacket).
+ * Giá trị là FlowRecord: bản ghi cùng cỡ với StreamState (112 byte) nhưng không kéo theo
+ * ConversationManager (Q_OBJECT), để target chỉ cần FlowTable.hpp, StreamID.hpp và Qt6::Core.
+ * Cuối cùng là tập khóa "đối kháng" (cùng cặp cổng, ip1 ^ ip2 cố định) làm mọi khóa va chạm
+ * dưới hàm XOR cũ.
+ */
+#include <QHash>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "FlowTable.hpp"
+#include "StreamID.hpp"
+
+static const size_t LOOKUPS = 10000000;
+static const size_t ADVERSARIAL_FLOWS = 20000;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+// Bản ghi luồng thay cho StreamState: cùng kích thước, chỉ packet_count được dùng
+struct FlowRecord {
+    uint64_t packet_count = 0;
+    uint8_t payload[104] = {};
+};
+static_assert(sizeof(FlowRecord) == 112, "FlowRecord phải cùng cỡ với StreamState");
+
+// Khóa bọc lại để QHash dùng hàm băm XOR trước khi có FlowTable (để so sánh)
+struct LegacyKey {
+    StreamID id;
+    bool operator==(const LegacyKey& other) const { return id == other.id; }
+};
+
+inline size_t qHash(const LegacyKey& key, size_t seed = 0)
+{
+    uint32_t a[4], b[4];
+    memcpy(a, key.id.ip1.data(), 16);
+    memcpy(b, key.id.ip2.data(), 16);
+    return (seed ^ a[0] ^ a[1] ^ a[2] ^ a[3]) ^ (seed ^ b[0] ^ b[1] ^ b[2] ^ b[3]) ^
+           ::qHash(key.id.port1, seed) ^ ::qHash(key.id.port2, seed) ^ ::qHash(key.id.protocol, seed);
+}
+
+using Clock = std::chrono::steady_clock;
+
+double perSecond(size_t count, Clock::time_point start)
+{
+    const double sec = std::chrono::duration<double>(Clock::now() - start).count();
+    return sec > 0 ? static_cast<double>(count) / sec : 0.0;
+}
+
+StreamID makeKey(uint32_t ip1, uint32_t ip2, uint16_t port1, uint16_t port2)
+{
+    StreamID id;
+    memcpy(id.ip1.data(), &ip1, 4);
+    memcpy(id.ip2.data(), &ip2, 4);
+    id.port1 = port1;
+    id.port2 = port2;
+    id.protocol = 6;
+    return id;
+}
+
+std::vector<StreamID> randomKeys(size_t count, std::mt19937_64& rng)
+{
+    std::vector<StreamID> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t r = rng();
+        keys.push_back(makeKey(static_cast<uint32_t>(r), static_cast<uint32_t>(r >> 32),
+                               static_cast<uint16_t>(rng()), static_cast<uint16_t>(rng())));
+    }
+    return keys;
+}
+
+// Cùng cặp cổng và ip1 ^ ip2 = C: với hàm XOR cũ mọi khóa có cùng giá trị băm
+std::vector<StreamID> adversarialKeys(size_t count)
+{
+    std::vector<StreamID> keys;
+    keys.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t ip1 = 0x0A000000u + static_cast<uint32_t>(i);
+        keys.push_back(makeKey(ip1, ip1 ^ 0x5A5A5A5Au, 40000, 443));
+    }
+    return keys;
+}
+
+// Thứ tự tra cứu: LOOKUPS chỉ số ngẫu nhiên trong [0, n)
+std::vector<uint32_t> lookupOrder(size_t n, size_t lookups, std::mt19937_64& rng)
+{
+    std::vector<uint32_t> order(lookups);
+    for (uint32_t& i : order) i = static_cast<uint32_t>(rng() % n);
+    return order;
+}
+
+void report(size_t flows, const char* table, double insertRate, double lookupRate, uint64_t check)
+{
+    printf("%10zu  %-22s %8.2f M/s  %8.2f M/s   (check %llu)\n", flows, table, insertRate / 1e6,
+           lookupRate / 1e6, static_cast<unsigned long long>(check));
+    fflush(stdout);
+}
+
+void benchFlowTable(const std::vector<StreamID>& keys, const std::vector<uint32_t>& order)
+{
+    FlowTable<FlowRecord> table;
+    auto start = Clock::now();
+    for (const StreamID& key : keys) table.findOrInsert(key).packet_count = 1;
+    const double insertRate = perSecond(keys.size(), start);
+
+    start = Clock::now();
+    for (uint32_t i : order) table.find(keys[i])->packet_count++;
+    const double lookupRate = perSecond(order.size(), start);
+
+    uint64_t check = 0;
+    table.forEach([&](const StreamID&, const FlowRecord& s) { check += s.packet_count; });
+    report(keys.size(), "FlowTable (SipHash)", insertRate, lookupRate, check);
+}
+
+template <typename Key, typename Wrap>
+void benchQHash(const char* name, const std::vector<StreamID>& keys, const std::vector<uint32_t>& order,
+                Wrap wrap)
+{
+    QHash<Key, FlowRecord> table;
+    table.reserve(static_cast<qsizetype>(keys.size()));
+    auto start = Clock::now();
+    for (const StreamID& key : keys) table[wrap(key)].packet_count = 1;
+    const double insertRate = perSecond(keys.size(), start);
+
+    start = Clock::now();
+    for (uint32_t i : order) table.find(wrap(keys[i])).value().packet_count++;
+    const double lookupRate = perSecond(order.size(), start);
+
+    uint64_t check = 0;
+    for (auto it = table.cbegin(); it != table.cend(); ++it) check += it.value().packet_count;
+    report(keys.size(), name, insertRate, lookupRate, check);
+}
+
+void runAll(const std::vector<StreamID>& keys, size_t lookups, std::mt19937_64& rng)
+{
+    const std::vector<uint32_t> order = lookupOrder(keys.size(), lookups, rng);
+    benchFlowTable(keys, order);
+    benchQHash<StreamID>("QHash (SipHash qHash)", keys, order, [](const StreamID& k) { return k; });
+    benchQHash<LegacyKey>("QHash (old XOR hash)", keys, order, [](const StreamID& k) { return LegacyKey{k}; });
+}
+
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(static_cast<size_t>(strtoull(argv[i], nullptr, 10)));
+    if (sizes.empty()) sizes = { 1000000, 2000000 };
+
+    printf("sizeof(FlowRecord) = %zu, %zu lookups per run\n", sizeof(FlowRecord), LOOKUPS);
+    printf("%10s  %-22s %12s  %12s\n", "flows", "table", "insert", "lookup");
+
+    std::mt19937_64 rng(20240601);
+    for (size_t flows : sizes) {
+        if (flows == 0) continue;
+        runAll(randomKeys(flows, rng), LOOKUPS, rng);
+    }
+
+    // Hàm XOR cũ suy biến thành danh sách tuyến tính: ít khóa, ít lượt tra cứu
+    printf("adversarial keys (same ports, ip1^ip2 constant):\n");
+    runAll(adversarialKeys(ADVERSARIAL_FLOWS), ADVERSARIAL_FLOWS, rng);
+    return 0;
+}
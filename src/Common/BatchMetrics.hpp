@@ -0,0 +1,55 @@
+#ifndef BATCHMETRICS_HPP
+#define BATCHMETRICS_HPP
+
+#include <array>
+#include <cstdint>
+#include "LogHistogram.hpp"
+
+/**
+ * @brief Số liệu về cách luồng capture chia lô gửi lên tầng xử lý.
+ *
+ * Luồng capture ghi (qua AdaptiveBatcher) và đẩy lên GUI cùng snapshot thống kê (StatsShard).
+ * Bộ đếm và histogram gộp được bằng phép cộng; tốc độ đến / kích thước lô mục tiêu là giá trị
+ * tức thời của từng nguồn và được cộng lại khi gộp nhiều nguồn.
+ */
+struct BatchMetrics {
+    // Lý do gửi lô
+    enum FlushReason {
+        FLUSH_COUNT,    // Đủ số gói mục tiêu
+        FLUSH_BYTES,    // Đủ số byte tối đa
+        FLUSH_AGE,      // Gói cũ nhất trong lô chạm hạn độ trễ
+        FLUSH_END,      // Dừng / tạm dừng / hết file
+        FLUSH_REASON_COUNT
+    };
+
+    std::array<uint64_t, FLUSH_REASON_COUNT> flushes{};
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    LogHistogram batchPackets;   // Số gói mỗi lô
+    LogHistogram batchDelayNs;   // Tuổi gói cũ nhất lúc gửi lô (ns)
+    double arrivalRate = 0.0;    // Gói/s (trung bình trượt) tại lần gửi gần nhất
+    uint32_t targetPackets = 0;  // Kích thước lô mục tiêu hiện tại
+
+    uint64_t totalBatches() const {
+        uint64_t total = 0;
+        for (uint64_t count : flushes) total += count;
+        return total;
+    }
+
+    void merge(const BatchMetrics& other) {
+        for (int i = 0; i < FLUSH_REASON_COUNT; ++i) flushes[i] += other.flushes[i];
+        packets += other.packets;
+        bytes += other.bytes;
+        batchPackets.merge(other.batchPackets);
+        batchDelayNs.merge(other.batchDelayNs);
+        arrivalRate += other.arrivalRate;
+        targetPackets += other.targetPackets;
+    }
+
+    static const char* reasonName(int reason) {
+        static const char* NAMES[FLUSH_REASON_COUNT] = { "count", "bytes", "age", "end" };
+        return (reason >= 0 && reason < FLUSH_REASON_COUNT) ? NAMES[reason] : "";
+    }
+};
+
+#endif // BATCHMETRICS_HPP
@@ -0,0 +1,158 @@
+#include "BlockCodec.hpp"
+#include <cstring>
+#include <vector>
+
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5;   // 5 byte cuối luôn là literal (quy ước của LZ4)
+static const size_t MATCH_FIND_LIMIT = 12; // Không bắt đầu match trong 12 byte cuối
+static const size_t MAX_OFFSET = 65535;
+static const int HASH_LOG = 12;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash32(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Ghi phần dư của độ dài >= 15 (chuỗi 255 ... 255, r); false nếu hết chỗ
+inline bool writeLength(uint8_t*& op, const uint8_t* end, size_t length)
+{
+    while (length >= 255) {
+        if (op >= end) return false;
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= end) return false;
+    *op++ = static_cast<uint8_t>(length);
+    return true;
+}
+
+inline bool readLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+{
+    uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+// Một sequence: literal [anchor, anchor + literals) rồi (nếu matchLength > 0) match
+bool writeSequence(uint8_t*& op, const uint8_t* end, const uint8_t* anchor, size_t literals,
+                   size_t offset, size_t matchLength)
+{
+    if (op >= end) return false;
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((literals >= 15 ? 15 : literals) << 4);
+    if (literals >= 15 && !writeLength(op, end, literals - 15)) return false;
+    if (static_cast<size_t>(end - op) < literals) return false;
+    if (literals > 0) memcpy(op, anchor, literals);
+    op += literals;
+    if (matchLength == 0) return true; // Sequence cuối: chỉ literal
+
+    if (end - op < 2) return false;
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    const size_t code = matchLength - MIN_MATCH;
+    *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+    if (code >= 15 && !writeLength(op, end, code - 15)) return false;
+    return true;
+}
+
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+size_t BlockCodec::maxCompressedSize(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t BlockCodec::compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity)
+{
+    uint8_t* op = dst;
+    const uint8_t* const end = dst + capacity;
+    size_t anchor = 0;
+
+    if (size > MATCH_FIND_LIMIT) {
+        std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+        const size_t matchFindEnd = size - MATCH_FIND_LIMIT;
+        const size_t matchEnd = size - LAST_LITERALS;
+        size_t ip = 0;
+
+        while (ip <= matchFindEnd) {
+            const uint32_t sequence = read32(src + ip);
+            const uint32_t h = hash32(sequence);
+            size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+            if (candidate >= ip || ip - candidate > MAX_OFFSET || read32(src + candidate) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            // Nới match về phía trước (vào vùng literal) rồi về phía sau
+            while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+                --ip;
+                --candidate;
+            }
+            size_t length = MIN_MATCH;
+            while (ip + length < matchEnd && src[candidate + length] == src[ip + length]) ++length;
+
+            if (!writeSequence(op, end, src + anchor, ip - anchor, ip - candidate, length)) return 0;
+            ip += length;
+            anchor = ip;
+            if (ip - 2 <= matchFindEnd) table[hash32(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    if (!writeSequence(op, end, src + anchor, size - anchor, 0, 0)) return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+bool BlockCodec::decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* const ipEnd = src + size;
+    size_t op = 0;
+
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(ip, ipEnd, literals)) return false;
+        if (static_cast<size_t>(ipEnd - ip) < literals || rawSize - op < literals) return false;
+        if (literals > 0) memcpy(dst + op, ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == ipEnd) break; // Sequence cuối không có match
+
+        if (ipEnd - ip < 2) return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return false;
+        size_t length = token & 0x0F;
+        if (length == 15 && !readLength(ip, ipEnd, length)) return false;
+        length += MIN_MATCH;
+        if (rawSize - op < length) return false;
+
+        uint8_t* out = dst + op;
+        const uint8_t* match = out - offset;
+        if (offset >= length) {
+            memcpy(out, match, length);
+        } else {
+            for (size_t i = 0; i < length; ++i) out[i] = match[i]; // Chồng lấn: lặp lại mẫu ngắn
+        }
+        op += length;
+    }
+    return op == rawSize;
+}
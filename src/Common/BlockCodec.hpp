@@ -0,0 +1,28 @@
+#ifndef BLOCKCODEC_HPP
+#define BLOCKCODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Nén / giải nén một khối byte theo định dạng khối LZ4 (token + literal + offset 16 bit).
+ *
+ * Bản cài đặt gọn trong cây nguồn (không phụ thuộc liblz4): nén tham lam với bảng băm 4096 ô,
+ * đủ nhanh để nén từng khối ~64 KB ngay trên luồng xử lý. Giải nén kiểm tra mọi độ dài / offset,
+ * nên dữ liệu hỏng chỉ làm hàm trả false chứ không đọc / ghi ra ngoài bộ đệm.
+ * Khối do hàm này tạo ra đọc được bằng LZ4_decompress_safe và ngược lại.
+ */
+class BlockCodec
+{
+public:
+    // Kích thước đầu ra tối đa cho 'size' byte đầu vào (trường hợp không nén được)
+    static size_t maxCompressedSize(size_t size);
+
+    // Nén src vào dst; trả số byte đã ghi, 0 nếu dst không đủ chỗ
+    static size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+    // Giải nén đúng rawSize byte vào dst; false nếu khối hỏng hoặc độ dài không khớp
+    static bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize);
+};
+
+#endif // BLOCKCODEC_HPP
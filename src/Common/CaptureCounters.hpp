@@ -0,0 +1,44 @@
+#ifndef CAPTURECOUNTERS_HPP
+#define CAPTURECOUNTERS_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Bộ đếm của luồng capture về những gói KHÔNG đi qua đường hiển thị bình thường.
+ *
+ * Trong lúc tạm dừng, luồng capture vẫn đọc socket (để bộ đệm kernel không tràn) và xử lý
+ * gói theo chế độ tạm dừng: bỏ, chỉ đếm thống kê, hoặc ghi ra file tạm để phát lại khi tiếp tục.
+ * Số gói kernel / driver làm rơi lấy từ pcap_stats (tính từ lúc bắt đầu phiên, cộng mọi interface).
+ * Được đẩy lên GUI cùng StatsShard; gộp nhiều nguồn bằng phép cộng.
+ */
+struct CaptureCounters {
+    uint64_t pausedSkippedPackets = 0;   // Bỏ khi tạm dừng theo chế độ Discard
+    uint64_t pausedSkippedBytes = 0;
+    uint64_t pausedCountedPackets = 0;   // Chỉ đếm thống kê, không hiển thị (chế độ Count only)
+    uint64_t spooledPackets = 0;         // Ghi ra file tạm (chế độ Spool)
+    uint64_t spooledBytes = 0;
+    uint64_t spoolOverflowPackets = 0;   // Chế độ Spool nhưng file tạm đã đầy (giới hạn) hoặc lỗi ghi: bị mất
+    uint64_t spoolOverflowBytes = 0;
+    uint64_t replayedPackets = 0;        // Đã phát lại từ file tạm khi tiếp tục
+    uint64_t kernelDrops = 0;            // pcap_stats: ps_drop (bộ đệm kernel đầy)
+    uint64_t interfaceDrops = 0;         // pcap_stats: ps_ifdrop
+    uint64_t queueDrops = 0;             // Hàng đợi của reader đầy (luồng gộp không theo kịp)
+    uint64_t backlogDrops = 0;           // Tầng xử lý không theo kịp: lô đang giữ đã đầy (chỉ bắt trực tiếp)
+
+    void merge(const CaptureCounters& other) {
+        pausedSkippedPackets += other.pausedSkippedPackets;
+        pausedSkippedBytes += other.pausedSkippedBytes;
+        pausedCountedPackets += other.pausedCountedPackets;
+        spooledPackets += other.spooledPackets;
+        spooledBytes += other.spooledBytes;
+        spoolOverflowPackets += other.spoolOverflowPackets;
+        spoolOverflowBytes += other.spoolOverflowBytes;
+        replayedPackets += other.replayedPackets;
+        kernelDrops += other.kernelDrops;
+        interfaceDrops += other.interfaceDrops;
+        queueDrops += other.queueDrops;
+        backlogDrops += other.backlogDrops;
+    }
+};
+
+#endif // CAPTURECOUNTERS_HPP
@@ -0,0 +1,374 @@
+#include "HeavyHitterSketch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Bộ trộn 64-bit (fmix64 của MurmurHash3)
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline size_t roundUpPow2(size_t n)
+{
+    size_t v = 1;
+    while (v < n) v <<= 1;
+    return v;
+}
+
+// Seed ngẫu nhiên, chọn một lần cho cả tiến trình: các sketch của từng luồng
+// phải băm giống nhau thì mới gộp được
+static uint64_t processSeed()
+{
+    static const uint64_t seed = [] {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }();
+    return seed;
+}
+
+// --- SpaceSaving ---
+
+SpaceSaving::SpaceSaving(size_t capacity)
+    : m_capacity(std::max<size_t>(capacity, 1))
+{
+    m_counters.resize(m_capacity);
+    m_hashes.resize(m_capacity);
+    m_heap.reserve(m_capacity);
+    m_heapPos.resize(m_capacity);
+    m_slots.assign(roundUpPow2(m_capacity * 2), EMPTY);  // Tải <= 1/2
+    m_slotMask = m_slots.size() - 1;
+}
+
+void SpaceSaving::clear()
+{
+    m_size = 0;
+    m_heap.clear();
+    std::fill(m_slots.begin(), m_slots.end(), EMPTY);
+}
+
+size_t SpaceSaving::locate(const AddressKey& key, uint64_t hash) const
+{
+    size_t i = hash & m_slotMask;
+    while (m_slots[i] != EMPTY) {
+        const uint32_t c = m_slots[i];
+        if (m_hashes[c] == hash && m_counters[c].key == key) return i;
+        i = (i + 1) & m_slotMask;
+    }
+    return i;
+}
+
+void SpaceSaving::eraseSlot(size_t slot)
+{
+    // Backward-shift (giống FlowTable): không dùng tombstone
+    size_t hole = slot;
+    size_t k = (slot + 1) & m_slotMask;
+    while (m_slots[k] != EMPTY) {
+        const size_t home = m_hashes[m_slots[k]] & m_slotMask;
+        if (((k - home) & m_slotMask) >= ((k - hole) & m_slotMask)) {
+            m_slots[hole] = m_slots[k];
+            hole = k;
+        }
+        k = (k + 1) & m_slotMask;
+    }
+    m_slots[hole] = EMPTY;
+}
+
+void SpaceSaving::swapHeap(size_t a, size_t b)
+{
+    std::swap(m_heap[a], m_heap[b]);
+    m_heapPos[m_heap[a]] = static_cast<uint32_t>(a);
+    m_heapPos[m_heap[b]] = static_cast<uint32_t>(b);
+}
+
+void SpaceSaving::siftDown(size_t pos)
+{
+    const size_t n = m_heap.size();
+    while (true) {
+        size_t smallest = pos;
+        const size_t l = 2 * pos + 1;
+        const size_t r = l + 1;
+        if (l < n && m_counters[m_heap[l]].count < m_counters[m_heap[smallest]].count) smallest = l;
+        if (r < n && m_counters[m_heap[r]].count < m_counters[m_heap[smallest]].count) smallest = r;
+        if (smallest == pos) return;
+        swapHeap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void SpaceSaving::siftUp(size_t pos)
+{
+    while (pos > 0) {
+        const size_t parent = (pos - 1) / 2;
+        if (m_counters[m_heap[parent]].count <= m_counters[m_heap[pos]].count) return;
+        swapHeap(pos, parent);
+        pos = parent;
+    }
+}
+
+void SpaceSaving::insertCounter(const Counter& counter, uint64_t hash)
+{
+    const uint32_t c = static_cast<uint32_t>(m_size++);
+    m_counters[c] = counter;
+    m_hashes[c] = hash;
+    m_slots[locate(counter.key, hash)] = c;
+    m_heap.push_back(c);
+    m_heapPos[c] = static_cast<uint32_t>(m_heap.size() - 1);
+    siftUp(m_heap.size() - 1);
+}
+
+void SpaceSaving::add(const AddressKey& key, uint64_t hash, uint64_t weight)
+{
+    size_t slot = locate(key, hash);
+
+    // 1. Đã được theo dõi: tăng bộ đếm (chỉ có thể đi xuống trong min-heap)
+    if (m_slots[slot] != EMPTY) {
+        const uint32_t c = m_slots[slot];
+        m_counters[c].count += weight;
+        siftDown(m_heapPos[c]);
+        return;
+    }
+
+    // 2. Còn bộ đếm trống
+    if (m_size < m_capacity) {
+        insertCounter(Counter{ key, weight, 0 }, hash);
+        return;
+    }
+
+    // 3. Đầy: thay bộ đếm nhỏ nhất, giá trị cũ trở thành sai số
+    const uint32_t c = m_heap[0];
+    eraseSlot(locate(m_counters[c].key, m_hashes[c]));
+    const uint64_t minCount = m_counters[c].count;
+    m_counters[c] = Counter{ key, minCount + weight, minCount };
+    m_hashes[c] = hash;
+    m_slots[locate(key, hash)] = c;  // Vị trí có thể đổi sau backward-shift
+    siftDown(0);
+}
+
+void SpaceSaving::merge(const SpaceSaving& other)
+{
+    if (other.m_size == 0) return;
+
+    // Mergeable summaries (Agarwal et al.): count / error cộng dồn; khóa chỉ có ở một bên
+    // được cộng minCount() của bên kia (cận trên của mọi khóa không được theo dõi)
+    const uint64_t minThis = minCount();
+    const uint64_t minOther = other.minCount();
+    std::vector<std::pair<Counter, uint64_t>> merged;
+    merged.reserve(m_size + other.m_size);
+    for (size_t i = 0; i < m_size; ++i) {
+        Counter c = m_counters[i];
+        if (const Counter* o = other.find(c.key, m_hashes[i])) {
+            c.count += o->count;
+            c.error += o->error;
+        } else {
+            c.count += minOther;
+            c.error += minOther;
+        }
+        merged.emplace_back(c, m_hashes[i]);
+    }
+    for (size_t i = 0; i < other.m_size; ++i) {
+        if (find(other.m_counters[i].key, other.m_hashes[i])) continue;
+        Counter c = other.m_counters[i];
+        c.count += minThis;
+        c.error += minThis;
+        merged.emplace_back(c, other.m_hashes[i]);
+    }
+
+    // Giữ 'capacity' bộ đếm lớn nhất: khóa bị loại có count <= minCount() mới
+    const size_t keep = std::min(merged.size(), m_capacity);
+    std::partial_sort(merged.begin(), merged.begin() + keep, merged.end(),
+                      [](const auto& a, const auto& b) { return a.first.count > b.first.count; });
+    clear();
+    for (size_t i = 0; i < keep; ++i) insertCounter(merged[i].first, merged[i].second);
+}
+
+const SpaceSaving::Counter* SpaceSaving::find(const AddressKey& key, uint64_t hash) const
+{
+    const size_t slot = locate(key, hash);
+    return m_slots[slot] == EMPTY ? nullptr : &m_counters[m_slots[slot]];
+}
+
+std::vector<SpaceSaving::Counter> SpaceSaving::top(size_t k) const
+{
+    std::vector<Counter> result(m_counters.begin(), m_counters.begin() + m_size);
+    k = std::min(k, result.size());
+    std::partial_sort(result.begin(), result.begin() + k, result.end(),
+                      [](const Counter& a, const Counter& b) { return a.count > b.count; });
+    result.resize(k);
+    return result;
+}
+
+// --- CountMinSketch ---
+
+size_t CountMinSketch::column(uint64_t hash, int row)
+{
+    // Kirsch-Mitzenmacher: h_i = h1 + i * h2 (h2 lẻ)
+    const uint64_t h1 = hash & 0xFFFFFFFFULL;
+    const uint64_t h2 = (hash >> 32) | 1;
+    return static_cast<size_t>((h1 + row * h2) & (WIDTH - 1));
+}
+
+void CountMinSketch::add(uint64_t hash, uint64_t weight)
+{
+    for (int r = 0; r < DEPTH; ++r) m_rows[r][column(hash, r)] += weight;
+    m_total += weight;
+}
+
+uint64_t CountMinSketch::estimate(uint64_t hash) const
+{
+    uint64_t best = UINT64_MAX;
+    for (int r = 0; r < DEPTH; ++r) best = std::min(best, m_rows[r][column(hash, r)]);
+    return best;
+}
+
+uint64_t CountMinSketch::errorBound() const
+{
+    return static_cast<uint64_t>(std::ceil(2.718281828459045 * m_total / WIDTH));
+}
+
+void CountMinSketch::merge(const CountMinSketch& other)
+{
+    for (int r = 0; r < DEPTH; ++r) {
+        for (int c = 0; c < WIDTH; ++c) m_rows[r][c] += other.m_rows[r][c];
+    }
+    m_total += other.m_total;
+}
+
+void CountMinSketch::clear()
+{
+    for (auto& row : m_rows) row.fill(0);
+    m_total = 0;
+}
+
+// --- HyperLogLog ---
+
+void HyperLogLog::add(uint64_t hash)
+{
+    const size_t idx = hash >> (64 - PRECISION);
+    // Hạng = vị trí bit 1 đầu tiên trong các bit còn lại (bit canh để dừng vòng lặp)
+    uint64_t rest = (hash << PRECISION) | (1ULL << (PRECISION - 1));
+    uint8_t rank = 1;
+    while (!(rest & 0x8000000000000000ULL)) {
+        rest <<= 1;
+        rank++;
+    }
+    if (rank > m_registers[idx]) m_registers[idx] = rank;
+}
+
+double HyperLogLog::estimate() const
+{
+    const double m = REGISTERS;
+    double sum = 0.0;
+    int zeros = 0;
+    for (uint8_t r : m_registers) {
+        sum += std::ldexp(1.0, -r);
+        if (r == 0) zeros++;
+    }
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+    const double raw = alpha * m * m / sum;
+
+    // Vùng nhỏ: dùng linear counting (chính xác hơn khi còn nhiều thanh ghi 0)
+    if (raw <= 2.5 * m && zeros > 0) return m * std::log(m / zeros);
+    return raw;
+}
+
+void HyperLogLog::merge(const HyperLogLog& other)
+{
+    for (int i = 0; i < REGISTERS; ++i) m_registers[i] = std::max(m_registers[i], other.m_registers[i]);
+}
+
+// --- HeavyHitterSketch ---
+
+HeavyHitterSketch::HeavyHitterSketch(size_t capacity)
+    : m_byPackets(capacity),
+    m_byBytes(capacity)
+{
+    // Seed ngẫu nhiên: không thể dựng trước tập địa chỉ va chạm để làm lệch sketch
+    m_seed = processSeed();
+}
+
+uint64_t HeavyHitterSketch::hashKey(const AddressKey& key) const
+{
+    uint64_t lo, hi;
+    memcpy(&lo, key.addr.data(), 8);
+    memcpy(&hi, key.addr.data() + 8, 8);
+    uint64_t h = mix64(m_seed ^ lo);
+    h = mix64(h ^ hi ^ (key.is_ipv6 ? 0x9e3779b97f4a7c15ULL : 0));
+    return h;
+}
+
+void HeavyHitterSketch::add(const AddressKey& key, uint64_t bytes)
+{
+    const uint64_t hash = hashKey(key);
+    m_byPackets.add(key, hash, 1);
+    m_byBytes.add(key, hash, bytes);
+    m_cmsPackets.add(hash, 1);
+    m_cmsBytes.add(hash, bytes);
+    m_distinct.add(hash);
+    m_totalPackets++;
+    m_totalBytes += bytes;
+}
+
+void HeavyHitterSketch::merge(const HeavyHitterSketch& other)
+{
+    m_byPackets.merge(other.m_byPackets);
+    m_byBytes.merge(other.m_byBytes);
+    m_cmsPackets.merge(other.m_cmsPackets);
+    m_cmsBytes.merge(other.m_cmsBytes);
+    m_distinct.merge(other.m_distinct);
+    m_totalPackets += other.m_totalPackets;
+    m_totalBytes += other.m_totalBytes;
+}
+
+void HeavyHitterSketch::clear()
+{
+    m_byPackets.clear();
+    m_byBytes.clear();
+    m_cmsPackets.clear();
+    m_cmsBytes.clear();
+    m_distinct.clear();
+    m_totalPackets = m_totalBytes = 0;
+}
+
+void HeavyHitterSketch::fill(HeavyHitter& h, uint64_t hash, const SpaceSaving& summary,
+                             const CountMinSketch& cms, uint64_t& value, uint64_t& error) const
+{
+    const uint64_t cmsValue = cms.estimate(hash);
+    if (const SpaceSaving::Counter* c = summary.find(h.key, hash)) {
+        // Cả hai đều là cận trên: lấy giá trị nhỏ hơn; cận dưới chắc chắn = count - error
+        const uint64_t lower = c->count - c->error;
+        value = std::min(c->count, cmsValue);
+        error = value > lower ? value - lower : 0;
+    } else {
+        // Không nằm trong summary: chỉ có cận trên của Count-Min (sai số theo xác suất)
+        value = cmsValue;
+        error = std::min(cmsValue, cms.errorBound());
+    }
+}
+
+std::vector<HeavyHitter> HeavyHitterSketch::top(size_t k, bool byBytes) const
+{
+    const SpaceSaving& ranking = byBytes ? m_byBytes : m_byPackets;
+    std::vector<HeavyHitter> result;
+    for (const SpaceSaving::Counter& c : ranking.top(k)) {
+        HeavyHitter h;
+        h.key = c.key;
+        const uint64_t hash = hashKey(c.key);
+        fill(h, hash, m_byPackets, m_cmsPackets, h.packets, h.packets_error);
+        fill(h, hash, m_byBytes, m_cmsBytes, h.bytes, h.bytes_error);
+        result.push_back(h);
+    }
+    // Xếp lại theo giá trị đã siết bằng Count-Min
+    std::stable_sort(result.begin(), result.end(), [byBytes](const HeavyHitter& a, const HeavyHitter& b) {
+        return byBytes ? a.bytes > b.bytes : a.packets > b.packets;
+    });
+    return result;
+}
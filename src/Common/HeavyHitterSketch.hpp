@@ -0,0 +1,167 @@
+#ifndef HEAVYHITTERSKETCH_HPP
+#define HEAVYHITTERSKETCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Khóa địa chỉ nhị phân (IPv4 dùng 4 byte đầu, theo thứ tự chấm thập phân).
+ */
+struct AddressKey {
+    std::array<uint8_t, 16> addr{};
+    bool is_ipv6 = false;
+
+    static AddressKey fromIpv4(uint32_t ip) {
+        AddressKey k;
+        k.addr[0] = ip & 0xFF;
+        k.addr[1] = (ip >> 8) & 0xFF;
+        k.addr[2] = (ip >> 16) & 0xFF;
+        k.addr[3] = (ip >> 24) & 0xFF;
+        return k;
+    }
+    static AddressKey fromIpv6(const std::array<uint8_t, 16>& ip) {
+        AddressKey k;
+        k.addr = ip;
+        k.is_ipv6 = true;
+        return k;
+    }
+
+    bool operator==(const AddressKey& o) const { return is_ipv6 == o.is_ipv6 && addr == o.addr; }
+};
+
+/**
+ * @brief Một địa chỉ trong top-K. Giá trị thật nằm trong [value - error, value].
+ */
+struct HeavyHitter {
+    AddressKey key;
+    uint64_t packets = 0;
+    uint64_t packets_error = 0;
+    uint64_t bytes = 0;
+    uint64_t bytes_error = 0;
+};
+
+/**
+ * @brief Space-Saving (Metwally et al.) có trọng số: giữ đúng 'capacity' bộ đếm.
+ * Địa chỉ mới chiếm chỗ bộ đếm nhỏ nhất (min-heap) và thừa kế giá trị của nó làm sai số,
+ * nên mọi địa chỉ có tổng > N / capacity chắc chắn có mặt. O(log capacity) mỗi lần cập nhật.
+ */
+class SpaceSaving {
+public:
+    struct Counter {
+        AddressKey key;
+        uint64_t count = 0;   // Cận trên
+        uint64_t error = 0;   // count - error là cận dưới
+    };
+
+    explicit SpaceSaving(size_t capacity = 256);
+
+    void add(const AddressKey& key, uint64_t hash, uint64_t weight);
+    const Counter* find(const AddressKey& key, uint64_t hash) const;
+    std::vector<Counter> top(size_t k) const;   // Giảm dần theo count
+    uint64_t minCount() const { return m_size < m_capacity || m_size == 0 ? 0 : m_counters[m_heap[0]].count; }
+    // Gộp summary khác (cùng hàm hash): khóa vắng mặt ở một bên mang minCount() của bên đó
+    void merge(const SpaceSaving& other);
+    void clear();
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    size_t locate(const AddressKey& key, uint64_t hash) const;  // Slot chứa khóa hoặc slot trống
+    void eraseSlot(size_t slot);
+    void siftDown(size_t pos);
+    void siftUp(size_t pos);
+    void swapHeap(size_t a, size_t b);
+    void insertCounter(const Counter& counter, uint64_t hash);  // Yêu cầu m_size < m_capacity
+
+    size_t m_capacity;
+    size_t m_size = 0;
+    std::vector<Counter> m_counters;
+    std::vector<uint64_t> m_hashes;     // Hash của khóa trong mỗi bộ đếm (để xóa khỏi bảng chỉ số)
+    std::vector<uint32_t> m_heap;       // Min-heap các chỉ số bộ đếm theo count
+    std::vector<uint32_t> m_heapPos;    // Bộ đếm -> vị trí trong heap
+    std::vector<uint32_t> m_slots;      // Bảng chỉ số địa chỉ mở (dò tuyến tính): slot -> bộ đếm
+    size_t m_slotMask = 0;
+};
+
+/**
+ * @brief Count-Min sketch (d hàng x w cột). Ước lượng luôn >= giá trị thật,
+ * và vượt quá không quá (e / w) * N với xác suất >= 1 - e^-d.
+ */
+class CountMinSketch {
+public:
+    static constexpr int DEPTH = 4;
+    static constexpr int WIDTH = 2048;  // e / 2048 ~ 0.13% tổng
+
+    void add(uint64_t hash, uint64_t weight);
+    uint64_t estimate(uint64_t hash) const;
+    uint64_t errorBound() const;        // (e / w) * N
+    void merge(const CountMinSketch& other);
+    void clear();
+
+private:
+    static size_t column(uint64_t hash, int row);
+
+    std::array<std::array<uint64_t, WIDTH>, DEPTH> m_rows{};
+    uint64_t m_total = 0;
+};
+
+/**
+ * @brief HyperLogLog (p = 12, 4096 thanh ghi 1 byte): đếm số địa chỉ phân biệt,
+ * sai số chuẩn ~1.04 / sqrt(4096) = 1.6%.
+ */
+class HyperLogLog {
+public:
+    static constexpr int PRECISION = 12;
+    static constexpr int REGISTERS = 1 << PRECISION;
+
+    void add(uint64_t hash);
+    double estimate() const;
+    double relativeError() const { return 1.04 / 64.0; } // 1.04 / sqrt(REGISTERS)
+    void merge(const HyperLogLog& other);
+    void clear() { m_registers.fill(0); }
+
+private:
+    std::array<uint8_t, REGISTERS> m_registers{};
+};
+
+/**
+ * @brief Thống kê "heavy hitter" theo địa chỉ với bộ nhớ cố định (~140 KB) bất kể số địa chỉ:
+ * Space-Saving theo gói và theo byte, Count-Min cho giá trị còn lại, HyperLogLog cho số phân biệt.
+ */
+class HeavyHitterSketch {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit HeavyHitterSketch(size_t capacity = DEFAULT_CAPACITY);
+
+    void add(const AddressKey& key, uint64_t bytes);
+    // Gộp sketch của luồng khác (cùng seed: mọi sketch trong tiến trình dùng chung một seed)
+    void merge(const HeavyHitterSketch& other);
+    void clear();
+
+    // Top-K xếp theo gói (byBytes = false) hoặc theo byte; k <= capacity
+    std::vector<HeavyHitter> top(size_t k, bool byBytes) const;
+
+    double distinctEstimate() const { return m_distinct.estimate(); }
+    double distinctRelativeError() const { return m_distinct.relativeError(); }
+    uint64_t totalPackets() const { return m_totalPackets; }
+    uint64_t totalBytes() const { return m_totalBytes; }
+
+private:
+    uint64_t hashKey(const AddressKey& key) const;
+    void fill(HeavyHitter& h, uint64_t hash, const SpaceSaving& summary, const CountMinSketch& cms,
+              uint64_t& value, uint64_t& error) const;
+
+    uint64_t m_seed;
+    SpaceSaving m_byPackets;
+    SpaceSaving m_byBytes;
+    CountMinSketch m_cmsPackets;
+    CountMinSketch m_cmsBytes;
+    HyperLogLog m_distinct;
+    uint64_t m_totalPackets = 0;
+    uint64_t m_totalBytes = 0;
+};
+
+#endif // HEAVYHITTERSKETCH_HPP
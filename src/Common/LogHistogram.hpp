@@ -0,0 +1,104 @@
+#ifndef LOGHISTOGRAM_HPP
+#define LOGHISTOGRAM_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Histogram log-linear (kiểu HDR) cho giá trị nguyên không âm (byte, ns, bit/s...).
+ *
+ * Giá trị < 16 có bucket riêng; từ 16 trở lên mỗi lần nhân đôi chia thành 16 bucket đều nhau,
+ * nên sai số tương đối <= 1/16 (6.25%) trên toàn dải 0 .. 2^64. Bộ đếm 64-bit (không bão hòa),
+ * cộng một giá trị là O(1) không cấp phát; merge() là cộng mảng, nên mỗi luồng có thể giữ
+ * histogram riêng và gộp khi đọc. min / max / mean được lưu chính xác.
+ */
+class LogHistogram {
+public:
+    static constexpr int SUB_BITS    = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BITS;                 // 16
+    static constexpr int NUM_BUCKETS = SUB_BUCKETS + (64 - SUB_BITS) * SUB_BUCKETS;
+
+    void add(uint64_t value, uint64_t count = 1) {
+        if (count == 0) return;
+        m_buckets[bucketIndex(value)] += count;
+        if (m_count == 0 || value < m_min) m_min = value;
+        if (m_count == 0 || value > m_max) m_max = value;
+        m_sum += static_cast<double>(value) * count;
+        m_count += count;
+    }
+
+    void merge(const LogHistogram& other) {
+        if (other.m_count == 0) return;
+        for (int i = 0; i < NUM_BUCKETS; ++i) m_buckets[i] += other.m_buckets[i];
+        if (m_count == 0 || other.m_min < m_min) m_min = other.m_min;
+        if (m_count == 0 || other.m_max > m_max) m_max = other.m_max;
+        m_sum += other.m_sum;
+        m_count += other.m_count;
+    }
+
+    void clear() { *this = LogHistogram{}; }
+
+    /**
+     * @brief Giá trị xấp xỉ tại phân vị q (0..1): điểm giữa bucket chứa hạng ceil(q * N),
+     * kẹp trong [min, max]. Trả về 0 nếu rỗng.
+     */
+    uint64_t quantile(double q) const {
+        if (m_count == 0) return 0;
+        if (q <= 0.0) return m_min;
+        if (q >= 1.0) return m_max;
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(m_count)));
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            seen += m_buckets[i];
+            if (seen >= rank) {
+                const uint64_t lo = bucketLower(i), hi = bucketUpper(i);
+                const uint64_t mid = lo + (hi - lo) / 2;
+                return mid < m_min ? m_min : (mid > m_max ? m_max : mid);
+            }
+        }
+        return m_max;
+    }
+
+    uint64_t count() const { return m_count; }
+    uint64_t min() const { return m_min; }
+    uint64_t max() const { return m_max; }
+    double   mean() const { return m_count ? m_sum / static_cast<double>(m_count) : 0.0; }
+
+    // Duyệt các bucket khác 0 theo thứ tự tăng dần: f(lower, upper, count), upper là cận trên (bao gồm)
+    template <typename F>
+    void forEachBucket(F&& f) const {
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            if (m_buckets[i]) f(bucketLower(i), bucketUpper(i), m_buckets[i]);
+        }
+    }
+
+    static int bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<int>(value);
+        const int exp = 63 - __builtin_clzll(value);                 // >= SUB_BITS
+        const int sub = static_cast<int>((value >> (exp - SUB_BITS)) & (SUB_BUCKETS - 1));
+        return SUB_BUCKETS + (exp - SUB_BITS) * SUB_BUCKETS + sub;
+    }
+    static uint64_t bucketLower(int idx) {
+        if (idx < SUB_BUCKETS) return static_cast<uint64_t>(idx);
+        const int exp = SUB_BITS + (idx - SUB_BUCKETS) / SUB_BUCKETS;
+        const uint64_t sub = static_cast<uint64_t>((idx - SUB_BUCKETS) % SUB_BUCKETS);
+        return (1ULL << exp) + (sub << (exp - SUB_BITS));
+    }
+    static uint64_t bucketUpper(int idx) {
+        if (idx < SUB_BUCKETS) return static_cast<uint64_t>(idx);
+        const int exp = SUB_BITS + (idx - SUB_BUCKETS) / SUB_BUCKETS;
+        return bucketLower(idx) + ((1ULL << (exp - SUB_BITS)) - 1);
+    }
+
+private:
+    std::array<uint64_t, NUM_BUCKETS> m_buckets{};
+    uint64_t m_count = 0;
+    uint64_t m_min = 0;
+    uint64_t m_max = 0;
+    double   m_sum = 0.0;
+};
+
+#endif // LOGHISTOGRAM_HPP
@@ -1,6 +1,7 @@
 #ifndef PACKETDATA_HPP
 #define PACKETDATA_HPP
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <string>
@@ -8,6 +9,7 @@
 #include <ctime>
 #include <net/ethernet.h>
 #include <iostream>
+#include "ProtocolHierarchy.hpp"
 
 // ==================== LAYER 2: ETHERNET ====================
 struct EthernetHeader {
@@ -48,6 +50,12 @@ struct IPv6Header {
     uint8_t  hop_limit = 0;
     std::array<uint8_t, 16> src_ip{};
     std::array<uint8_t, 16> dest_ip{};
+
+    // Fragment extension header (44)
+    bool     has_fragment = false;
+    uint32_t frag_id = 0;
+    uint16_t frag_offset = 0;   // Đơn vị 8 byte (giống IPv4)
+    bool     frag_more = false; // Cờ M (More Fragments)
 };
 
 // ==================== LAYER 3: ARP ====================
@@ -84,6 +92,8 @@ struct TCPHeader {
     uint32_t ts_ecr = 0;
     // ------------------------------------
 
+    int8_t   window_scale = -1; // Option Window Scale (kind 3); -1 = không có
+
     enum Flags : uint8_t {
         FIN = 0x01,
         SYN = 0x02,
@@ -96,6 +106,39 @@ struct TCPHeader {
     };
 };
 
+// ==================== TCP ANALYSIS ====================
+// Kết quả phân tích SEQ/ACK (do ConversationManager điền)
+struct TCPAnalysis {
+    enum Flags : uint16_t {
+        RETRANSMISSION      = 0x0001,
+        FAST_RETRANSMISSION = 0x0002,
+        OUT_OF_ORDER        = 0x0004,
+        LOST_SEGMENT        = 0x0008, // Segment trước đó chưa được thấy
+        DUPLICATE_ACK       = 0x0010,
+        ZERO_WINDOW         = 0x0020,
+        WINDOW_FULL         = 0x0040,
+        WINDOW_UPDATE       = 0x0080,
+        KEEP_ALIVE          = 0x0100,
+        ACKED_UNSEEN        = 0x0200  // ACK cho segment chưa được thấy
+    };
+    // Các cờ báo lỗi (tô màu "Bad TCP")
+    static constexpr uint16_t PROBLEM_MASK = RETRANSMISSION | FAST_RETRANSMISSION | OUT_OF_ORDER |
+                                             LOST_SEGMENT | DUPLICATE_ACK | ZERO_WINDOW |
+                                             WINDOW_FULL | ACKED_UNSEEN;
+
+    uint16_t flags = 0;
+    uint32_t dup_ack_num = 0;    // Thứ tự của Duplicate ACK (1, 2, 3...)
+    uint32_t dup_ack_frame = 0;  // packet_id của ACK gốc bị lặp
+
+    // Đo RTT (ns; -1 = không có)
+    int64_t  ack_rtt_ns = -1;     // Từ segment dữ liệu tới ACK này
+    uint32_t ack_rtt_frame = 0;   // packet_id của segment được ACK này xác nhận
+    int64_t  ts_rtt_ns = -1;      // Từ TSval tới TSecr phản hồi (option Timestamps)
+    int64_t  initial_rtt_ns = -1; // iRTT của luồng: SYN -> ACK cuối của bắt tay
+
+    bool has(uint16_t f) const { return (flags & f) != 0; }
+};
+
 // ==================== LAYER 4: UDP ====================
 struct UDPHeader {
     uint16_t src_port = 0;
@@ -144,9 +187,20 @@ struct ApplicationLayer {
     uint16_t dns_class = 0;
 
     // TLS
-    uint8_t tls_version_major = 0;
+    uint8_t tls_version_major = 0;      // Phiên bản ở record layer
     uint8_t tls_version_minor = 0;
     std::string tls_sni;
+    uint8_t  tls_content_type = 0;      // 20: CCS, 21: Alert, 22: Handshake, 23: App Data
+    uint8_t  tls_handshake_type = 0;    // 1: ClientHello, 2: ServerHello, ...
+    uint16_t tls_hello_version = 0;     // legacy_version trong Hello
+    uint16_t tls_selected_version = 0;  // Phiên bản thực (supported_versions của ServerHello)
+    uint16_t tls_selected_cipher = 0;   // Cipher suite server chọn
+    std::string tls_alpn;               // "h2,http/1.1"
+    std::vector<uint16_t> tls_supported_versions;
+    std::vector<uint16_t> tls_cipher_suites;
+    std::string tls_ja3;                // Chuỗi JA3 đầy đủ
+    std::string tls_ja3_hash;           // MD5 của chuỗi JA3
+    std::string tls_ja4;
 };
 
 // ==================== CẤU TRÚC CHÍNH: PacketData ====================
@@ -156,10 +210,21 @@ struct PacketData {
     timespec timestamp{};
     uint32_t cap_length = 0;
     uint32_t wire_length = 0;
+    uint32_t interface_id = 0;  // Thứ tự interface khi bắt nhiều interface (= IDB trong pcapng); đọc file: 0
     int64_t stream_index = -1;
+    // Vị trí payload Tầng 7 trong raw_packet (sau header TCP/UDP, đã bỏ padding Ethernet)
+    uint32_t payload_offset = 0;
+    uint32_t payload_length = 0;       // Số byte payload đã bắt được (bị cắt bởi snaplen)
+    uint32_t tcp_segment_length = 0;   // (TCP) Độ dài dữ liệu thật của segment, theo header IP
     // Raw Data
     std::vector<uint8_t> raw_packet;
 
+    // IP Fragment
+    bool is_ip_fragment = false;         // Gói là một mảnh (fragment) của datagram IP
+    uint32_t reassembled_in = 0;         // packet_id của gói hoàn tất datagram (0 = chưa biết)
+    std::vector<uint32_t> fragment_ids;  // (Gói hoàn tất) packet_id của tất cả các mảnh
+    std::vector<uint8_t> reassembled;    // Payload IP đã ghép (Tầng 4 trở lên); rỗng nếu không phân mảnh
+
     // Layer 2
     EthernetHeader eth{};
     VLANHeader vlan{};
@@ -175,6 +240,7 @@ struct PacketData {
 
     // Layer 4
     TCPHeader tcp{};
+    TCPAnalysis tcp_analysis{};
     UDPHeader udp{};
     ICMPHeader icmp{};
     bool is_tcp = false;
@@ -187,12 +253,15 @@ struct PacketData {
     // Tree view (Wireshark style)
     std::string tree_view;
     int tree_depth = 0;
+    // Đường đi trong cây Protocol Hierarchy (Parser ghi khi đi xuống từng tầng)
+    ProtocolPath proto_path;
 
     // Expert info
     std::string expert_info;
     bool is_malformed = false;
     bool is_retransmitted = false;
     bool is_duplicate = false;
+    bool is_reassembled_pdu = false; // Gói này hoàn tất một PDU ghép từ nhiều TCP segment
 
     // ======= Methods =======
 
@@ -202,12 +271,21 @@ struct PacketData {
         tree_view.clear();
         expert_info.clear();
         tree_depth = 0;
+        proto_path.clear();
 
         has_vlan = is_ipv4 = is_ipv6 = is_arp = false;
         is_tcp = is_udp = is_icmp = false;
         is_malformed = is_retransmitted = is_duplicate = false;
+        is_reassembled_pdu = false;
 
         stream_index = -1;
+        payload_offset = payload_length = 0;
+        tcp_segment_length = 0;
+
+        is_ip_fragment = false;
+        reassembled_in = 0;
+        fragment_ids.clear();
+        reassembled.clear();
 
         eth = EthernetHeader{};
         vlan = VLANHeader{};
@@ -215,11 +293,24 @@ struct PacketData {
         ipv6 = IPv6Header{};
         arp = ARPHeader{};
         tcp = TCPHeader{};
+        tcp_analysis = TCPAnalysis{};
         udp = UDPHeader{};
         icmp = ICMPHeader{};
         app = ApplicationLayer{};
     }
 
+    // Con trỏ tới payload Tầng 7 (trong 'reassembled' nếu datagram được ghép từ nhiều mảnh)
+    const uint8_t* payloadData() const {
+        const std::vector<uint8_t>& buf = reassembled.empty() ? raw_packet : reassembled;
+        return buf.data() + payload_offset;
+    }
+    // Số byte payload thực sự có trong bộ đệm (có thể < tcp_segment_length nếu bị cắt bởi snaplen)
+    size_t payloadAvailable() const {
+        const std::vector<uint8_t>& buf = reassembled.empty() ? raw_packet : reassembled;
+        if (payload_offset >= buf.size()) return 0;
+        return std::min<size_t>(payload_length, buf.size() - payload_offset);
+    }
+
     std::string toJson() const;
     void printTree() const{
         std::cout << tree_view;
@@ -0,0 +1,90 @@
+#include "ProtocolHierarchy.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static const char* PROTOCOL_NAMES[PROTO_COUNT] = {
+    "Frame", "Ethernet", "802.1Q VLAN", "IPv4", "IPv6", "ARP", "TCP", "UDP",
+    "ICMP", "ICMPv6", "TLS", "HTTP", "DNS", "MDNS", "SSDP", "QUIC", "Data"
+};
+
+// --- Triển khai (Implementation) ---
+
+const char* protocolIdName(ProtocolId id)
+{
+    return id < PROTO_COUNT ? PROTOCOL_NAMES[id] : "Unknown";
+}
+
+ProtocolId protocolIdFromName(const std::string& name)
+{
+    if (name == "TLS")  return PROTO_TLS;
+    if (name == "HTTP") return PROTO_HTTP;
+    if (name == "DNS")  return PROTO_DNS;
+    if (name == "MDNS") return PROTO_MDNS;
+    if (name == "SSDP") return PROTO_SSDP;
+    return PROTO_DATA;
+}
+
+ProtocolHierarchy::ProtocolHierarchy()
+{
+    clear();
+}
+
+void ProtocolHierarchy::clear()
+{
+    m_nodes.clear();
+    Node root;
+    root.children.fill(-1);
+    m_nodes.push_back(root);
+    m_revision++;
+}
+
+int32_t ProtocolHierarchy::child(int32_t node, ProtocolId id)
+{
+    int32_t c = m_nodes[node].children[id];
+    if (c >= 0) return c;
+
+    // Nút mới (hiếm: chỉ khi gặp tổ hợp giao thức lần đầu)
+    Node n;
+    n.id = id;
+    n.parent = node;
+    n.children.fill(-1);
+    c = static_cast<int32_t>(m_nodes.size());
+    m_nodes.push_back(n);
+    m_nodes[node].children[id] = c;
+    return c;
+}
+
+void ProtocolHierarchy::add(const ProtocolPath& path, uint32_t bytes)
+{
+    int32_t node = 0;
+    m_nodes[0].packets++;
+    m_nodes[0].bytes += bytes;
+    for (int i = 0; i < path.depth; ++i) {
+        if (path.ids[i] >= PROTO_COUNT) break;
+        node = child(node, static_cast<ProtocolId>(path.ids[i]));
+        m_nodes[node].packets++;
+        m_nodes[node].bytes += bytes;
+    }
+    m_revision++;
+}
+
+void ProtocolHierarchy::merge(const ProtocolHierarchy& other)
+{
+    // Nút chỉ được nối thêm nên cha luôn có chỉ số nhỏ hơn con: duyệt theo thứ tự là đủ
+    std::vector<int32_t> mapped(other.m_nodes.size(), 0);
+    for (size_t i = 1; i < other.m_nodes.size(); ++i) {
+        const Node& src = other.m_nodes[i];
+        mapped[i] = child(mapped[src.parent], src.id);
+    }
+    for (size_t i = 0; i < other.m_nodes.size(); ++i) {
+        m_nodes[mapped[i]].packets += other.m_nodes[i].packets;
+        m_nodes[mapped[i]].bytes += other.m_nodes[i].bytes;
+    }
+    m_revision++;
+}
+
+void ProtocolHierarchy::resetCounts()
+{
+    for (Node& n : m_nodes) n.packets = n.bytes = 0;
+    m_revision++;
+}
@@ -0,0 +1,90 @@
+#ifndef PROTOCOLHIERARCHY_HPP
+#define PROTOCOLHIERARCHY_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Id cố định của các giao thức trong cây Protocol Hierarchy (không dùng khóa chuỗi).
+ */
+enum ProtocolId : uint8_t {
+    PROTO_FRAME,        // Gốc của cây
+    PROTO_ETHERNET,
+    PROTO_VLAN,
+    PROTO_IPV4,
+    PROTO_IPV6,
+    PROTO_ARP,
+    PROTO_TCP,
+    PROTO_UDP,
+    PROTO_ICMP,
+    PROTO_ICMPV6,
+    PROTO_TLS,
+    PROTO_HTTP,
+    PROTO_DNS,
+    PROTO_MDNS,
+    PROTO_SSDP,
+    PROTO_QUIC,
+    PROTO_DATA,         // Payload Tầng 4 không nhận diện được
+    PROTO_COUNT
+};
+
+const char* protocolIdName(ProtocolId id);
+// Tên giao thức Tầng 7 (ApplicationLayer::protocol) -> id; PROTO_DATA nếu không biết
+ProtocolId protocolIdFromName(const std::string& name);
+
+/**
+ * @brief Đường đi của một gói trong cây (eth -> vlan -> ipv4 -> tcp -> tls ...),
+ * do Parser ghi lại khi đi xuống từng tầng.
+ */
+struct ProtocolPath {
+    static constexpr int MAX_DEPTH = 8;
+
+    std::array<uint8_t, MAX_DEPTH> ids{};
+    uint8_t depth = 0;
+
+    void push(ProtocolId id) {
+        if (depth < MAX_DEPTH) ids[depth++] = id;
+    }
+    void clear() { depth = 0; }
+};
+
+/**
+ * @brief Cây Protocol Hierarchy: số gói / byte ở mỗi nút (gói đi qua nút đó).
+ *
+ * Mỗi nút giữ bảng con đánh chỉ số theo ProtocolId, nên cộng một gói chỉ là
+ * depth lần tra mảng + tăng bộ đếm. Nút chỉ được thêm (không xóa) cho tới clear(),
+ * nên chỉ số nút ổn định (UI dùng để cập nhật tại chỗ).
+ */
+class ProtocolHierarchy {
+public:
+    struct Node {
+        ProtocolId id = PROTO_FRAME;
+        int32_t parent = -1;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        std::array<int32_t, PROTO_COUNT> children;
+    };
+
+    ProtocolHierarchy();
+
+    void add(const ProtocolPath& path, uint32_t bytes);
+    // Cộng cây của luồng khác vào (khớp nút theo đường đi id, thêm nút còn thiếu)
+    void merge(const ProtocolHierarchy& other);
+    // Đưa bộ đếm về 0 nhưng giữ các nút: chỉ số nút không đổi qua các lần gộp lại
+    void resetCounts();
+    void clear();
+
+    // Nút 0 là gốc (frame): packets / bytes của nó là tổng
+    const std::vector<Node>& nodes() const { return m_nodes; }
+    uint64_t revision() const { return m_revision; }
+
+private:
+    int32_t child(int32_t node, ProtocolId id);
+
+    std::vector<Node> m_nodes;
+    uint64_t m_revision = 0;
+};
+
+#endif // PROTOCOLHIERARCHY_HPP
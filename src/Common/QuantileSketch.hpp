@@ -0,0 +1,102 @@
+#ifndef QUANTILESKETCH_HPP
+#define QUANTILESKETCH_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Sketch phân vị (percentile) kích thước cố định cho các giá trị thời gian (ns).
+ *
+ * Histogram theo thang log: 8 bucket / lần nhân đôi (sai số tương đối ~4.4%),
+ * phủ từ 1 µs tới ~16.7 s (giá trị ngoài khoảng dồn vào bucket đầu / cuối).
+ * Bộ đếm 16-bit: khi một bucket bão hòa, mọi bucket được chia đôi để giữ tỉ lệ.
+ * min / max / mean được lưu chính xác.
+ */
+class QuantileSketch {
+public:
+    static constexpr int     BUCKETS_PER_OCTAVE = 8;
+    static constexpr int     NUM_BUCKETS        = 192;
+    static constexpr int64_t MIN_VALUE_NS       = 1000; // 1 µs
+
+    void add(int64_t ns) {
+        if (ns < 0) return;
+        int idx = bucketIndex(ns);
+        if (m_buckets[idx] == std::numeric_limits<uint16_t>::max()) {
+            for (auto& b : m_buckets) b = static_cast<uint16_t>((b + 1) / 2);
+        }
+        m_buckets[idx]++;
+
+        if (m_count == 0 || ns < m_min) m_min = ns;
+        if (m_count == 0 || ns > m_max) m_max = ns;
+        m_sum += static_cast<double>(ns);
+        m_count++;
+    }
+
+    void merge(const QuantileSketch& other) {
+        if (other.m_count == 0) return;
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            uint32_t sum = static_cast<uint32_t>(m_buckets[i]) + other.m_buckets[i];
+            m_buckets[i] = static_cast<uint16_t>(std::min<uint32_t>(sum, std::numeric_limits<uint16_t>::max()));
+        }
+        if (m_count == 0 || other.m_min < m_min) m_min = other.m_min;
+        if (m_count == 0 || other.m_max > m_max) m_max = other.m_max;
+        m_sum += other.m_sum;
+        m_count += other.m_count;
+    }
+
+    /**
+     * @brief Giá trị xấp xỉ tại phân vị q (0..1), kẹp trong [min, max].
+     * @return -1 nếu chưa có mẫu.
+     */
+    int64_t quantile(double q) const {
+        if (m_count == 0) return -1;
+        if (q <= 0.0) return m_min;
+        if (q >= 1.0) return m_max;
+
+        uint64_t total = 0;
+        for (uint16_t b : m_buckets) total += b;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+        if (rank == 0) rank = 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; ++i) {
+            seen += m_buckets[i];
+            if (seen >= rank) {
+                int64_t v = bucketValue(i);
+                return v < m_min ? m_min : (v > m_max ? m_max : v);
+            }
+        }
+        return m_max;
+    }
+
+    void clear() { *this = QuantileSketch{}; }
+
+    uint64_t count() const { return m_count; }
+    int64_t  min() const { return m_count ? m_min : -1; }
+    int64_t  max() const { return m_count ? m_max : -1; }
+    double   mean() const { return m_count ? m_sum / static_cast<double>(m_count) : -1.0; }
+
+private:
+    static int bucketIndex(int64_t ns) {
+        if (ns < MIN_VALUE_NS) return 0;
+        int idx = 1 + static_cast<int>(std::log2(static_cast<double>(ns) / MIN_VALUE_NS) * BUCKETS_PER_OCTAVE);
+        return idx >= NUM_BUCKETS ? NUM_BUCKETS - 1 : idx;
+    }
+    // Điểm giữa (trung bình nhân) của bucket
+    static int64_t bucketValue(int idx) {
+        if (idx == 0) return MIN_VALUE_NS / 2;
+        double exp = (static_cast<double>(idx - 1) + 0.5) / BUCKETS_PER_OCTAVE;
+        return static_cast<int64_t>(MIN_VALUE_NS * std::exp2(exp));
+    }
+
+    std::array<uint16_t, NUM_BUCKETS> m_buckets{};
+    uint64_t m_count = 0;
+    int64_t  m_min = 0;
+    int64_t  m_max = 0;
+    double   m_sum = 0.0;
+};
+
+#endif // QUANTILESKETCH_HPP
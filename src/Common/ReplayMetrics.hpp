@@ -0,0 +1,47 @@
+#ifndef REPLAYMETRICS_HPP
+#define REPLAYMETRICS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include "LogHistogram.hpp"
+
+/**
+ * @brief Số liệu phát lại file qua đường bắt trực tiếp: tốc độ đạt được so với tốc độ mục tiêu.
+ *
+ * scheduledNs là thời điểm theo lịch của gói gần nhất (khoảng cách timestamp gốc / speed),
+ * elapsedNs là thời gian thực từ gói đầu; tốc độ mục tiêu = packets / scheduledNs,
+ * tốc độ đạt = packets / elapsedNs. lateNs: gói được gửi trễ so với lịch bao lâu.
+ * Nguồn phát lại ghi, luồng gộp chép vào StatsShard khi đẩy snapshot.
+ */
+struct ReplayMetrics {
+    double speed = 0.0;             // Hệ số tốc độ; 0 = nhanh nhất có thể
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t injectedPackets = 0;   // Đã gửi ra interface bằng pcap_inject
+    uint64_t injectErrors = 0;
+    int64_t elapsedNs = 0;
+    int64_t scheduledNs = 0;
+    LogHistogram lateNs;
+
+    bool active() const { return packets > 0; }
+    double targetRate() const {
+        return scheduledNs > 0 ? packets * 1e9 / static_cast<double>(scheduledNs) : 0.0;
+    }
+    double achievedRate() const {
+        return elapsedNs > 0 ? packets * 1e9 / static_cast<double>(elapsedNs) : 0.0;
+    }
+
+    void merge(const ReplayMetrics& other) {
+        if (!other.active()) return;
+        speed = other.speed;
+        packets += other.packets;
+        bytes += other.bytes;
+        injectedPackets += other.injectedPackets;
+        injectErrors += other.injectErrors;
+        elapsedNs = std::max(elapsedNs, other.elapsedNs);
+        scheduledNs = std::max(scheduledNs, other.scheduledNs);
+        lateNs.merge(other.lateNs);
+    }
+};
+
+#endif // REPLAYMETRICS_HPP
@@ -0,0 +1,91 @@
+#include "StatsShard.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static const char* SLOT_NAMES[] = {
+    "TLS", "HTTP", "DNS", "MDNS", "SSDP", "QUIC", "TCP", "UDP", "ICMP", "ARP", "Unknown"
+};
+
+// --- Triển khai (Implementation) ---
+
+const char* StatsShard::slotName(int slot)
+{
+    return SLOT_NAMES[slot];
+}
+
+int StatsShard::slotFromName(const std::string& name)
+{
+    for (int i = 0; i < PROTO_SLOT_COUNT; ++i) {
+        if (name == SLOT_NAMES[i]) return i;
+    }
+    return -1;
+}
+
+void StatsShard::add(const PacketData& packet)
+{
+    // --- 1. ĐẾM TỔNG SỐ GÓI TIN ---
+    m_totalPackets++;
+
+    // --- 2. ĐẾM GIAO THỨC ---
+    // QUIC nhận theo header (ConversationManager trên luồng GUI mới xác nhận theo luồng)
+    if (!packet.app.protocol.empty()) {
+        const int slot = slotFromName(packet.app.protocol);
+        if (slot >= 0) m_protocolCounts[slot]++;
+        else m_otherProtocols[packet.app.protocol]++;
+    }
+    else if (packet.is_udp && packet.app.quic_type != ApplicationLayer::NOT_QUIC) { m_protocolCounts[SLOT_QUIC]++; }
+    else if (packet.is_tcp) { m_protocolCounts[SLOT_TCP]++; }
+    else if (packet.is_udp) { m_protocolCounts[SLOT_UDP]++; }
+    else if (packet.is_icmp) { m_protocolCounts[SLOT_ICMP]++; }
+    else if (packet.is_arp) { m_protocolCounts[SLOT_ARP]++; }
+    else { m_protocolCounts[SLOT_UNKNOWN]++; }
+
+    m_hierarchy.add(packet.proto_path, packet.wire_length);
+    m_frameLengths.add(packet.wire_length);
+
+    // --- 3. ĐẾM IP (khóa nhị phân, không tạo chuỗi cho mỗi gói) ---
+    if (packet.is_ipv4) {
+        m_sourceIps.add(AddressKey::fromIpv4(packet.ipv4.src_ip), packet.wire_length);
+        m_destIps.add(AddressKey::fromIpv4(packet.ipv4.dest_ip), packet.wire_length);
+    } else if (packet.is_ipv6) {
+        m_sourceIps.add(AddressKey::fromIpv6(packet.ipv6.src_ip), packet.wire_length);
+        m_destIps.add(AddressKey::fromIpv6(packet.ipv6.dest_ip), packet.wire_length);
+    } else if (packet.is_arp) {
+        m_sourceIps.add(AddressKey::fromIpv4(packet.arp.sender_ip), packet.wire_length);
+        m_destIps.add(AddressKey::fromIpv4(packet.arp.target_ip), packet.wire_length);
+    }
+}
+
+void StatsShard::merge(const StatsShard& other)
+{
+    m_totalPackets += other.m_totalPackets;
+    for (int i = 0; i < PROTO_SLOT_COUNT; ++i) m_protocolCounts[i] += other.m_protocolCounts[i];
+    for (const auto& [name, count] : other.m_otherProtocols) m_otherProtocols[name] += count;
+    m_sourceIps.merge(other.m_sourceIps);
+    m_destIps.merge(other.m_destIps);
+    m_hierarchy.merge(other.m_hierarchy);
+    m_frameLengths.merge(other.m_frameLengths);
+    m_batchMetrics.merge(other.m_batchMetrics);
+    m_captureCounters.merge(other.m_captureCounters);
+    m_replayMetrics.merge(other.m_replayMetrics);
+}
+
+void StatsShard::resetCounts()
+{
+    m_totalPackets = 0;
+    m_protocolCounts.fill(0);
+    m_otherProtocols.clear();
+    m_sourceIps.clear();
+    m_destIps.clear();
+    m_hierarchy.resetCounts();
+    m_frameLengths.clear();
+    m_batchMetrics = BatchMetrics{};
+    m_captureCounters = CaptureCounters{};
+    m_replayMetrics = ReplayMetrics{};
+}
+
+void StatsShard::clear()
+{
+    resetCounts();
+    m_hierarchy.clear();
+}
@@ -0,0 +1,80 @@
+#ifndef STATSSHARD_HPP
+#define STATSSHARD_HPP
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "PacketData.hpp"
+#include "HeavyHitterSketch.hpp"
+#include "ProtocolHierarchy.hpp"
+#include "LogHistogram.hpp"
+#include "BatchMetrics.hpp"
+#include "CaptureCounters.hpp"
+#include "ReplayMetrics.hpp"
+#include "TripleBuffer.hpp"
+
+/**
+ * @brief Thống kê của MỘT luồng bắt/đọc gói (không khóa, không chia sẻ).
+ *
+ * Luồng worker cộng từng gói ngay sau khi parse; giao thức phổ biến đếm trong mảng
+ * cố định, tên lạ rơi vào map nhỏ. Mọi thành phần đều gộp được (merge), nên UI
+ * nhận snapshot của từng shard qua StatsExchange và cộng lại khi đọc.
+ */
+class StatsShard {
+public:
+    void add(const PacketData& packet);
+    void merge(const StatsShard& other);
+    // Bộ đếm về 0, giữ cấu trúc cây Protocol Hierarchy (dùng khi gộp lại từ đầu)
+    void resetCounts();
+    void clear();
+
+    uint64_t totalPackets() const { return m_totalPackets; }
+    // f(tên giao thức, số gói) cho mọi giao thức có số gói > 0
+    template <typename F>
+    void forEachProtocol(F&& f) const {
+        for (int i = 0; i < PROTO_SLOT_COUNT; ++i) {
+            if (m_protocolCounts[i]) f(std::string(slotName(i)), m_protocolCounts[i]);
+        }
+        for (const auto& [name, count] : m_otherProtocols) f(name, count);
+    }
+
+    const HeavyHitterSketch& sources() const { return m_sourceIps; }
+    const HeavyHitterSketch& destinations() const { return m_destIps; }
+    const ProtocolHierarchy& hierarchy() const { return m_hierarchy; }
+    const LogHistogram& frameLengths() const { return m_frameLengths; }
+    // Số liệu chia lô của luồng capture (AdaptiveBatcher ghi trực tiếp)
+    const BatchMetrics& batchMetrics() const { return m_batchMetrics; }
+    BatchMetrics& batchMetrics() { return m_batchMetrics; }
+    // Gói bỏ / chỉ đếm / spool khi tạm dừng, số gói kernel làm rơi
+    const CaptureCounters& captureCounters() const { return m_captureCounters; }
+    CaptureCounters& captureCounters() { return m_captureCounters; }
+    // Tốc độ phát lại (chỉ khi nguồn là file phát lại)
+    const ReplayMetrics& replayMetrics() const { return m_replayMetrics; }
+    ReplayMetrics& replayMetrics() { return m_replayMetrics; }
+
+private:
+    enum ProtocolSlot {
+        SLOT_TLS, SLOT_HTTP, SLOT_DNS, SLOT_MDNS, SLOT_SSDP, SLOT_QUIC,
+        SLOT_TCP, SLOT_UDP, SLOT_ICMP, SLOT_ARP, SLOT_UNKNOWN,
+        PROTO_SLOT_COUNT
+    };
+    static const char* slotName(int slot);
+    static int slotFromName(const std::string& name);   // -1 nếu không có slot cố định
+
+    uint64_t m_totalPackets = 0;
+    std::array<uint64_t, PROTO_SLOT_COUNT> m_protocolCounts{};
+    std::map<std::string, uint64_t> m_otherProtocols;
+    HeavyHitterSketch m_sourceIps;
+    HeavyHitterSketch m_destIps;
+    ProtocolHierarchy m_hierarchy;
+    LogHistogram m_frameLengths;
+    BatchMetrics m_batchMetrics;
+    CaptureCounters m_captureCounters;
+    ReplayMetrics m_replayMetrics;
+};
+
+// Kênh trao đổi snapshot từ một worker sang luồng GUI
+using StatsExchange = TripleBuffer<StatsShard>;
+
+#endif // STATSSHARD_HPP
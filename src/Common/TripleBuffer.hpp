@@ -0,0 +1,54 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Trao đổi snapshot một-ghi / một-đọc không khóa (double buffer + 1 ô trung gian).
+ *
+ * Luồng ghi điền writeBuffer() rồi publish(): ô vừa ghi được đổi (atomic exchange) với ô
+ * trung gian. Luồng đọc gọi consume() để lấy ô trung gian nếu có bản mới, rồi đọc readBuffer().
+ * Không bên nào chờ bên kia; luồng đọc luôn thấy snapshot đầy đủ mới nhất đã publish.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // --- Phía ghi ---
+    T& writeBuffer() { return m_buffers[m_writeIndex]; }
+    void publish() {
+        const uint8_t prev = m_middle.exchange(static_cast<uint8_t>(m_writeIndex | FRESH),
+                                               std::memory_order_acq_rel);
+        m_writeIndex = prev & INDEX_MASK;
+    }
+
+    // --- Phía đọc ---
+    // true nếu đã lấy được snapshot mới (readBuffer() thay đổi)
+    bool consume() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t prev = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = prev & INDEX_MASK;
+        return true;
+    }
+    const T& readBuffer() const { return m_buffers[m_readIndex]; }
+
+    // Đưa cả 3 ô về mặc định. Chỉ gọi khi không có luồng ghi nào đang chạy.
+    void reset() {
+        for (T& buffer : m_buffers) buffer = T{};
+        m_writeIndex = 0;
+        m_middle.store(1, std::memory_order_release);
+        m_readIndex = 2;
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;   // Ô trung gian chứa bản chưa đọc
+
+    std::array<T, 3> m_buffers{};
+    uint8_t m_writeIndex = 0;               // Chỉ luồng ghi dùng
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_readIndex = 2;                // Chỉ luồng đọc dùng
+};
+
+#endif // TRIPLEBUFFER_HPP
@@ -1,50 +1,217 @@
 #include "AppController.hpp"
 #include "../Core/Capture/InterfaceManager.hpp"
 #include "../UI/Widgets/StatisticsDialog.hpp"
+#include "../UI/Widgets/FollowStreamDialog.hpp"
+#include "../Core/Capture/PcapngWriter.hpp"
+#include "../Core/Capture/CaptureFileIndex.hpp"
+#include "../UI/Widgets/FileSliceDialog.hpp"
+#include "../UI/Widgets/ReplayDialog.hpp"
+#include "../UI/Widgets/PacketFormatter.hpp"
+#include "../Core/Capture/Parser.hpp"
+#include "../Core/Capture/RawPacket.hpp"
 #include <QDebug>
 #include <QDateTime>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QInputDialog>
+#include <QApplication>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QCoreApplication>
+#include <QMutexLocker>
 #include <pcap.h>
-#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+const quint64 GO_TO_WINDOW_PACKETS = 1000;   // Số gói đọc quanh gói đích khi nó chưa được nạp
+const qsizetype SAVE_READ_CHUNK = 4096;      // Số gói đọc mỗi lần từ PacketStore khi lưu file
+const qsizetype SORT_READ_CHUNK = 4096;      // Số gói đọc mỗi lần khi sắp bảng theo cột chuỗi
+static const char* GO_TO_TIME_FORMAT = "yyyy-MM-dd hh:mm:ss.zzz";
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static int64_t timestampNs(const PacketData &packet)
+{
+    return static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+}
+
+// Sắp cặp (khóa, packet_id) và trả về packet_id theo thứ tự mới; cùng khóa thì giữ thứ tự bắt gói
+template <typename Key>
+static std::vector<quint32> sortByKey(std::vector<std::pair<Key, quint32>> &keys, bool ascending)
+{
+    std::sort(keys.begin(), keys.end(), [ascending](const auto &a, const auto &b) {
+        if (a.first != b.first) return ascending ? a.first < b.first : b.first < a.first;
+        return a.second < b.second;
+    });
+    std::vector<quint32> ids;
+    ids.reserve(keys.size());
+    for (const auto &key : keys) ids.push_back(key.second);
+    return ids;
+}
+
+// (Luồng nền) Sắp packet_id của bảng gói theo một cột. Time / Length / Protocol dùng khóa gọn của
+// PacketStore (không đọc đĩa); cột chuỗi còn lại định dạng lại từng gói, đọc tuần tự theo khối.
+// 'window': bản chụp cửa sổ Go to (gói không có trong store)
+static std::vector<quint32> sortPacketIds(const PacketStore &store, const QList<PacketData> &window,
+                                          const std::vector<quint32> &ids, int column, bool ascending)
+{
+    auto windowPacket = [&window](quint32 packetId) -> const PacketData* {
+        if (window.isEmpty()) return nullptr;
+        const qint64 index = static_cast<qint64>(packetId) - window.first().packet_id;
+        if (index < 0 || index >= window.size() || window[index].packet_id != packetId) return nullptr;
+        return &window[index];
+    };
+
+    if (column == PacketRow::COL_TIME || column == PacketRow::COL_LENGTH) {
+        std::vector<PacketStore::SortKey> storeKeys;
+        std::vector<QString> protocolNames;
+        store.sortKeys(ids, storeKeys, protocolNames);
+        std::vector<std::pair<int64_t, quint32>> keys;
+        keys.reserve(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            int64_t key = -1;
+            if (storeKeys[i].valid) {
+                key = column == PacketRow::COL_TIME ? storeKeys[i].timeNs : storeKeys[i].length;
+            } else if (const PacketData *packet = windowPacket(ids[i])) {
+                key = column == PacketRow::COL_TIME ? timestampNs(*packet) : packet->wire_length;
+            }
+            keys.emplace_back(key, ids[i]);
+        }
+        return sortByKey(keys, ascending);
+    }
+
+    if (column == PacketRow::COL_PROTOCOL) {
+        // So sánh theo tên: xếp hạng các tên một lần rồi sắp theo hạng
+        std::vector<PacketStore::SortKey> storeKeys;
+        std::vector<QString> names;
+        store.sortKeys(ids, storeKeys, names);
+        const size_t storeNames = names.size();
+        std::vector<QString> windowNames(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (storeKeys[i].valid) continue;
+            if (const PacketData *packet = windowPacket(ids[i])) {
+                windowNames[i] = PacketFormatter::getProtocolName(*packet);
+                names.push_back(windowNames[i]);
+            }
+        }
+        std::vector<QString> ranked = names;
+        std::sort(ranked.begin(), ranked.end());
+        ranked.erase(std::unique(ranked.begin(), ranked.end()), ranked.end());
+        auto rankOf = [&ranked](const QString &name) {
+            return static_cast<int>(std::lower_bound(ranked.begin(), ranked.end(), name) - ranked.begin());
+        };
+        std::vector<int> storeRank(storeNames);
+        for (size_t i = 0; i < storeNames; ++i) storeRank[i] = rankOf(names[i]);
+
+        std::vector<std::pair<int, quint32>> keys;
+        keys.reserve(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            int key = -1;
+            if (storeKeys[i].valid) {
+                if (storeKeys[i].protocol < storeNames) key = storeRank[storeKeys[i].protocol];
+            } else if (windowPacket(ids[i])) {
+                key = rankOf(windowNames[i]);
+            }
+            keys.emplace_back(key, ids[i]);
+        }
+        return sortByKey(keys, ascending);
+    }
+
+    // Cột chuỗi (Source, Destination, Flags, Info): đọc các gói theo packet_id tăng dần,
+    // mỗi lần một khối liền nhau (gói đã ra đĩa được đọc tuần tự, không giải nén byte thô)
+    std::vector<quint32> order = ids;
+    std::sort(order.begin(), order.end());
+    std::vector<std::pair<QString, quint32>> keys;
+    keys.reserve(order.size());
+    QList<PacketData> chunk;
+    size_t i = 0;
+    while (i < order.size()) {
+        const quint32 first = order[i];
+        const bool complete = store.mid(static_cast<qsizetype>(first) - 1, SORT_READ_CHUNK, chunk, false);
+        const quint64 end = static_cast<quint64>(first) + chunk.size();
+        for (; i < order.size() && order[i] < end; ++i) {
+            keys.emplace_back(PacketFormatter::makeRow(chunk[order[i] - first]).cells[column], order[i]);
+        }
+        // Gói không đọc được / không có trong store: thử cửa sổ Go to, không có thì khóa rỗng
+        if (i < order.size() && order[i] == end && (!complete || chunk.isEmpty())) {
+            const PacketData *packet = windowPacket(order[i]);
+            keys.emplace_back(packet ? PacketFormatter::makeRow(*packet).cells[column] : QString(), order[i]);
+            ++i;
+        }
+    }
+    return sortByKey(keys, ascending);
+}
 
 AppController::AppController(MainWindow *mainWindow, QObject *parent)
     : QObject(parent),
     m_mainWindow(mainWindow),
     m_captureEngine(nullptr),
-    m_filterEngine(nullptr),
     m_statsManager(nullptr),
     m_statisticsDialog(nullptr),
     m_convManager(nullptr),
-    m_ioGraphDialog(nullptr)
-
+    m_ioGraphManager(nullptr),
+    m_ioGraphDialog(nullptr),
+    m_conversationsDialog(nullptr),
+    m_hierarchyDialog(nullptr),
+    m_pipelineThread(nullptr),
+    m_pipeline(nullptr)
 {
     // --- Khởi tạo Core ---
     m_captureEngine = new CaptureEngine(this);
-m_filterEngine = new DisplayFilterEngine();
     m_statsManager = new StatisticsManager(this);
+    m_statsManager->addSource(m_captureEngine->statsExchange());
     m_convManager = new ConversationManager(this);
+    m_ioGraphManager = new IOGraphManager(&m_packetStore, this);
+
+    // --- Tầng xử lý trên luồng riêng (GUI chỉ còn vẽ dòng đã định dạng) ---
+    m_pipelineThread = new QThread(this);
+    m_pipeline = new PacketPipeline(&m_packetStore, m_convManager, m_ioGraphManager);
+    m_pipeline->moveToThread(m_pipelineThread);
+    connect(m_pipelineThread, &QThread::finished, m_pipeline, &QObject::deleteLater);
+    m_pipelineThread->start();
     loadInterfaces();
 
     // --- (Các connect từ UI) ---
-    connect(m_mainWindow, &MainWindow::interfaceSelected, this, &AppController::onInterfaceSelected);
+    connect(m_mainWindow, &MainWindow::interfacesSelected, this, &AppController::onInterfacesSelected);
     connect(m_mainWindow, &MainWindow::openFileRequested, this, &AppController::onOpenFileRequested);
+    connect(m_mainWindow, &MainWindow::openFolderRequested, this, &AppController::onOpenFolderRequested);
+    connect(m_mainWindow, &MainWindow::replayFileRequested, this, &AppController::onReplayFileRequested);
+    connect(m_mainWindow, &MainWindow::memoryBudgetRequested, this, &AppController::onMemoryBudgetRequested);
+    connect(m_mainWindow, &MainWindow::compressionToggled, this, &AppController::onCompressionToggled);
     connect(m_mainWindow, &MainWindow::saveFileRequested, this, &AppController::onSaveFileRequested);
     connect(m_mainWindow, &MainWindow::onRestartCaptureClicked, this, &AppController::onRestartCaptureClicked);
     connect(m_mainWindow, &MainWindow::onStopCaptureClicked, this, &AppController::onStopCaptureClicked);
     connect(m_mainWindow, &MainWindow::onPauseCaptureClicked, this, &AppController::onPauseCaptureClicked);
+    connect(m_mainWindow, &MainWindow::pauseModeChanged, this, &AppController::onPauseModeChanged);
     connect(m_mainWindow, &MainWindow::onApplyFilterClicked, this, &AppController::onApplyFilterClicked);
     connect(m_mainWindow, &MainWindow::analyzeStatisticsRequested,
             this, &AppController::onStatisticsMenuClicked);
     // --- THÊM DÒNG NÀY ---
     connect(m_mainWindow, &MainWindow::analyzeIOGraphRequested,
             this, &AppController::onIOGraphMenuClicked);
+    connect(m_mainWindow, &MainWindow::analyzeConversationsRequested,
+            this, &AppController::onConversationsMenuClicked);
+    connect(m_mainWindow, &MainWindow::analyzeEndpointsRequested,
+            this, &AppController::onEndpointsMenuClicked);
+    connect(m_mainWindow, &MainWindow::analyzeProtocolHierarchyRequested,
+            this, &AppController::onProtocolHierarchyMenuClicked);
+    connect(m_mainWindow, &MainWindow::followTcpStreamRequested,
+            this, &AppController::onFollowTcpStreamRequested);
+    connect(m_mainWindow, &MainWindow::goToPacketRequested, this, &AppController::onGoToPacketRequested);
+    connect(m_mainWindow, &MainWindow::goToTimeRequested, this, &AppController::onGoToTimeRequested);
 
     // --- Connect signal từ Core (LÔ) ---
+    // CaptureEngine phát từ luồng capture -> lô được xếp hàng thẳng vào luồng xử lý (không qua GUI)
     connect(m_captureEngine, &CaptureEngine::packetsCaptured, // <-- Tín hiệu LÔ
-            this, &AppController::onPacketsCaptured);        // <-- Slot LÔ
+            m_pipeline, &PacketPipeline::processBatch);       // <-- Slot LÔ
+    // Lô xử lý xong: trả chỗ cho luồng capture ngay trên luồng xử lý (giới hạn số lô đang chờ)
+    connect(m_pipeline, &PacketPipeline::batchProcessed, m_captureEngine, &CaptureEngine::batchProcessed,
+            Qt::DirectConnection);
+    connect(m_pipeline, &PacketPipeline::rowsReady, this, &AppController::onRowsReady);
+    connect(m_pipeline, &PacketPipeline::readFailed, this, &AppController::onPipelineReadFailed);
 
     // --- Connect TÍN HIỆU (Signal) của AppController VỚI (Slot) của MainWindow ---
     connect(this, &AppController::displayNewPackets,      // <-- Tín hiệu LÔ
@@ -52,85 +219,282 @@ m_filterEngine = new DisplayFilterEngine();
     connect(this, &AppController::clearPacketTable, m_mainWindow, &MainWindow::clearPacketTable);
     connect(this, &AppController::displayFilterError, m_mainWindow, &MainWindow::showFilterError);
 
-    // Connect tín hiệu khi lọc xong
-    connect(this, &AppController::onFilteringFinished,
-            m_mainWindow, &MainWindow::addPacketsToTable);
+    // Bảng gói chỉ giữ packet_id: chi tiết / hex dump đọc lại gói gốc khi chọn dòng
+    m_mainWindow->setPacketLookup([this](quint32 packetId, PacketData &out) {
+        // (Gói đã ra đĩa được đọc lại từ segment)
+        if (m_packetStore.at(static_cast<qsizetype>(packetId) - 1, out) && out.packet_id == packetId) {
+            return true;
+        }
+        // Gói của cửa sổ đọc từ file (Go to tới gói chưa nạp)
+        for (const PacketData &packet : m_windowPackets) {
+            if (packet.packet_id == packetId) {
+                out = packet;
+                return true;
+            }
+        }
+        return false;
+    });
+
+    // Sắp xếp theo cột: khóa tính trên luồng nền, bảng chỉ nhận lại mảng packet_id đã hoán vị
+    m_sortPool.setMaxThreadCount(1);
+    m_mainWindow->setPacketSorter([this](std::vector<quint32> packetIds, int column, Qt::SortOrder order,
+                                         PacketListModel::SortDone done) {
+        const PacketStore *store = &m_packetStore;
+        const QList<PacketData> window = m_windowPackets; // Bản chụp (chia sẻ ngầm) cho luồng nền
+        m_sortPool.start([store, window, packetIds = std::move(packetIds), column, order,
+                          done = std::move(done)]() {
+            done(sortPacketIds(*store, window, packetIds, column, order == Qt::AscendingOrder));
+        });
+    });
 }
 
-void AppController::onInterfaceSelected(const QString &interfaceName, const QString &filterText)
+AppController::~AppController()
 {
-    qDebug() << "Interface selected:" << interfaceName << "Filter:" << filterText;
+    // Dừng nguồn trước, rồi mới dừng luồng xử lý (các manager còn sống tới khi AppController bị hủy)
+    m_captureEngine->stopCapture();
+    m_pipelineThread->quit();
+    m_pipelineThread->wait();
+}
 
-    { // <-- Khóa (lock) m_allPackets
-        QMutexLocker locker(&m_allPacketsMutex);
-        m_allPackets.clear();
-    }
+void AppController::onInterfacesSelected(const QStringList &interfaceNames, const QString &filterText)
+{
+    qDebug() << "Interfaces selected:" << interfaceNames << "Filter:" << filterText;
 
-    m_statsManager->clear();
-    m_convManager->clear();
-    m_currentFilterText = "";
-    emit clearPacketTable();
+    startNewSession();
 
-    m_captureEngine->setInterface(interfaceName);
+    m_captureEngine->setInterfaces(interfaceNames);
     m_captureEngine->setCaptureFilter(filterText);
     m_captureEngine->startCapture();
 
     m_mainWindow->showCapturePage();
-    m_mainWindow->updateInterfaceLabel(interfaceName, filterText);
+    m_mainWindow->updateInterfaceLabel(interfaceNames.join(", "), filterText);
 }
 
 void AppController::onOpenFileRequested()
 {
     qDebug() << "Open file requested";
     m_captureEngine->stopCapture();
-    QString filePath = QFileDialog::getOpenFileName(m_mainWindow, tr("Open Pcap File"));
+    QStringList filePaths = QFileDialog::getOpenFileNames(m_mainWindow, tr("Open Pcap File"));
+    if (filePaths.isEmpty()) {
+        return;
+    }
+    if (filePaths.size() > 1) {
+        openCaptureFiles(filePaths);
+        return;
+    }
+
+    startNewSession();
+    m_captureEngine->startCaptureFromFile(filePaths.first());
+    m_sessionFile = filePaths.first();
+    m_mainWindow->showCapturePage();
+}
+
+void AppController::onOpenFolderRequested()
+{
+    qDebug() << "Open folder requested";
+    m_captureEngine->stopCapture();
+    QString directory = QFileDialog::getExistingDirectory(m_mainWindow, tr("Open Capture Folder"));
+    if (directory.isEmpty()) {
+        return;
+    }
+    QStringList filePaths = CaptureFileIndex::captureFilesInDirectory(directory);
+    if (filePaths.isEmpty()) {
+        QMessageBox::warning(m_mainWindow, "Open Error", "No pcap / pcapng files in " + directory);
+        return;
+    }
+    openCaptureFiles(filePaths);
+}
+
+void AppController::onReplayFileRequested()
+{
+    qDebug() << "Replay file requested";
+    QString filePath = QFileDialog::getOpenFileName(m_mainWindow, tr("Replay Pcap File"));
     if (filePath.isEmpty()) {
         return;
     }
+    ReplayDialog dialog(filePath, InterfaceManager::getDevices(), m_mainWindow);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    const ReplayOptions options = dialog.options();
+
+    startNewSession();
+    m_captureEngine->startReplay(filePath, options);
+    m_mainWindow->showCapturePage();
+    const QString speed = options.speed > 0 ? QString("%1x").arg(options.speed) : QString("top speed");
+    m_mainWindow->updateInterfaceLabel(QString("Replay: %1 (%2)").arg(QFileInfo(filePath).fileName(), speed), QString());
+}
 
-    { // <--Khóa (lock) m_allPackets
-        QMutexLocker locker(&m_allPacketsMutex);
-        m_allPackets.clear();
+void AppController::onMemoryBudgetRequested()
+{
+    // Ngân sách RAM cho danh sách gói; gói cũ hơn được đổ ra segment tạm trên đĩa
+    const PacketStore::Usage usage = m_packetStore.usage();
+    QString label = tr("Packet data kept in memory (MiB).\nOlder packets are moved to a temporary file on disk.\n\n"
+                       "Now: %1 packets, %2 MiB in memory, %3 on disk (%4 MiB)")
+                        .arg(usage.packets)
+                        .arg(usage.memoryBytes >> 20)
+                        .arg(usage.spilled)
+                        .arg(usage.diskBytes >> 20);
+    if (usage.blockStoredBytes > 0) {
+        // Tỉ lệ nén byte thô và tốc độ giải nén khi đọc lại (chọn gói, lưu, đổ ra đĩa)
+        label += "\n" + tr("Packet bytes compressed %1:1 (%2 MiB -> %3 MiB)")
+                            .arg(static_cast<double>(usage.blockInputBytes) / usage.blockStoredBytes, 0, 'f', 2)
+                            .arg(usage.blockInputBytes >> 20)
+                            .arg(usage.blockStoredBytes >> 20);
+        if (usage.decodeNs > 0) {
+            label += "\n" + tr("Decoded %1 MiB at %2 MiB/s")
+                                .arg(usage.decodedBytes >> 20)
+                                .arg(usage.decodedBytes * 1e9 / usage.decodeNs / (1 << 20), 0, 'f', 0);
+        }
     }
-    m_statsManager->clear();
-    m_convManager->clear();
-    m_currentFilterText = "";
-    emit clearPacketTable();
-    m_captureEngine->startCaptureFromFile(filePath);
+    const QString error = m_packetStore.errorString();
+    if (!error.isEmpty()) {
+        label += "\n" + tr("Spilling stopped: %1").arg(error);
+    }
+
+    bool ok = false;
+    const int megabytes = QInputDialog::getInt(m_mainWindow, tr("Memory Budget"), label,
+                                               static_cast<int>(m_packetStore.memoryBudget() >> 20),
+                                               static_cast<int>(PacketStore::MIN_MEMORY_BUDGET >> 20), INT_MAX, 64, &ok);
+    if (ok) {
+        m_packetStore.setMemoryBudget(static_cast<qint64>(megabytes) << 20);
+    }
+}
+
+void AppController::onCompressionToggled(bool enabled)
+{
+    m_packetStore.setCompression(enabled);
+}
+
+void AppController::openCaptureFiles(const QStringList &filePaths)
+{
+    // Scan header từng file (không parse gói): lấy khoảng thời gian để cắt và bỏ file ngoài khoảng
+    QList<CaptureFileInfo> files;
+    QStringList errors;
+    QProgressDialog progress(tr("Indexing capture files..."), tr("Cancel"), 0, filePaths.size(), m_mainWindow);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(300);
+    for (int i = 0; i < filePaths.size(); ++i) {
+        progress.setValue(i);
+        if (progress.wasCanceled()) {
+            return;
+        }
+        CaptureFileInfo info;
+        QString error;
+        if (CaptureFileIndex::scan(filePaths[i], info, error)) {
+            files.append(info);
+        } else {
+            errors.append(error);
+        }
+    }
+    progress.setValue(filePaths.size());
+
+    if (files.isEmpty()) {
+        QMessageBox::warning(m_mainWindow, "Open Error", errors.join("\n"));
+        return;
+    }
+    if (!errors.isEmpty()) {
+        QMessageBox::warning(m_mainWindow, "Open Warning", "Skipped:\n" + errors.join("\n"));
+    }
+
+    FileSliceDialog dialog(files, m_mainWindow);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    startNewSession();
+    m_captureEngine->startCaptureFromFiles(files, dialog.slice());
     m_mainWindow->showCapturePage();
+    m_mainWindow->updateInterfaceLabel(QString("%1 files").arg(files.size()), QString());
 }
 
 void AppController::onSaveFileRequested()
 {
     qDebug() << "Save file requested";
 
-    // Tạo một bản copy an toàn để lưu
-    QList<PacketData> packetsToSave;
-    {
-        QMutexLocker locker(&m_allPacketsMutex);
-        packetsToSave = m_allPackets; // (Copy)
-    }
-
-    if (packetsToSave.isEmpty()) {
+    // Lưu các gói đã có tới lúc này; đọc từng khối từ store (phần đã ra đĩa đọc qua mmap)
+    const qsizetype total = m_packetStore.size();
+    if (total == 0) {
         QMessageBox::warning(m_mainWindow, "Save Error", "There are no packets to save.");
         return;
     }
 
-    QString filePath = QFileDialog::getSaveFileName(m_mainWindow, tr("Save File As..."));
+    // Nhiều interface: mặc định pcapng (pcap cổ điển không giữ được interface của từng gói)
+    const QList<CaptureEngine::InterfaceInfo> interfaces = m_captureEngine->sessionInterfaces();
+    const QString pcapngFilter = tr("pcapng (*.pcapng)");
+    const QString pcapFilter = tr("pcap (*.pcap)");
+    QString selectedFilter = interfaces.size() > 1 ? pcapngFilter : pcapFilter;
+    QString filePath = QFileDialog::getSaveFileName(m_mainWindow, tr("Save File As..."), QString(),
+                                                    pcapngFilter + ";;" + pcapFilter, &selectedFilter);
     if (filePath.isEmpty()) {
         return;
     }
+    const bool asPcapng = filePath.endsWith(".pcapng", Qt::CaseInsensitive) ||
+                          (!filePath.endsWith(".pcap", Qt::CaseInsensitive) && selectedFilter == pcapngFilter);
+
+    if (asPcapng) {
+        PcapngWriter writer;
+        if (!writer.open(filePath)) {
+            QMessageBox::warning(m_mainWindow, "Save Error", writer.errorString());
+            return;
+        }
+        // Một IDB cho mỗi interface_id xuất hiện (gói không rõ interface: Ethernet, không tên)
+        const uint32_t interfaceCount = std::max(static_cast<uint32_t>(interfaces.size()), m_packetStore.maxInterfaceId() + 1);
+        for (uint32_t id = 0; id < interfaceCount; ++id) {
+            if (id < static_cast<uint32_t>(interfaces.size())) {
+                writer.addInterface(interfaces[id].linkType, interfaces[id].name);
+            } else {
+                writer.addInterface(DLT_EN10MB, QString());
+            }
+        }
+        QList<PacketData> chunk;
+        for (qsizetype pos = 0; pos < total; pos += SAVE_READ_CHUNK) {
+            const bool complete = m_packetStore.mid(pos, std::min(SAVE_READ_CHUNK, total - pos), chunk);
+            for (const PacketData &packet : chunk) {
+                if (!writer.writePacket(packet.interface_id, packet.timestamp, packet.raw_packet.data(),
+                                        packet.cap_length, packet.wire_length)) {
+                    QMessageBox::warning(m_mainWindow, "Save Error", writer.errorString());
+                    return;
+                }
+            }
+            if (!complete) {
+                writer.close();
+                abortSave(filePath, pos + chunk.size() + 1);
+                return;
+            }
+        }
+        writer.close();
+        QMessageBox::information(m_mainWindow, "Save Successful", "Save complete.");
+        return;
+    }
 
-    pcap_t *pcap_handle = pcap_open_dead(DLT_EN10MB, 65535);
+    // pcap cổ điển: một link-type cho cả file (của interface đầu tiên)
+    const int linkType = interfaces.isEmpty() ? DLT_EN10MB : interfaces.first().linkType;
+    pcap_t *pcap_handle = pcap_open_dead(linkType, 65535);
     pcap_dumper_t *dumper = pcap_dump_open(pcap_handle, filePath.toStdString().c_str());
+    if (!dumper) {
+        QMessageBox::warning(m_mainWindow, "Save Error", pcap_geterr(pcap_handle));
+        pcap_close(pcap_handle);
+        return;
+    }
 
-    for (const PacketData &packet : packetsToSave) {
-        pcap_pkthdr header;
-        header.ts.tv_sec = packet.timestamp.tv_sec;
-        header.ts.tv_usec = packet.timestamp.tv_nsec / 1000;
-        header.caplen = packet.cap_length;
-        header.len = packet.wire_length;
-        pcap_dump(reinterpret_cast<u_char*>(dumper), &header, packet.raw_packet.data());
+    QList<PacketData> chunk;
+    for (qsizetype pos = 0; pos < total; pos += SAVE_READ_CHUNK) {
+        const bool complete = m_packetStore.mid(pos, std::min(SAVE_READ_CHUNK, total - pos), chunk);
+        for (const PacketData &packet : chunk) {
+            pcap_pkthdr header;
+            header.ts.tv_sec = packet.timestamp.tv_sec;
+            header.ts.tv_usec = packet.timestamp.tv_nsec / 1000;
+            header.caplen = packet.cap_length;
+            header.len = packet.wire_length;
+            pcap_dump(reinterpret_cast<u_char*>(dumper), &header, packet.raw_packet.data());
+        }
+        if (!complete) {
+            pcap_dump_close(dumper);
+            pcap_close(pcap_handle);
+            abortSave(filePath, pos + chunk.size() + 1);
+            return;
+        }
     }
 
     pcap_dump_close(dumper);
@@ -138,21 +502,24 @@ void AppController::onSaveFileRequested()
     QMessageBox::information(m_mainWindow, "Save Successful", "Save complete.");
 }
 
+void AppController::abortSave(const QString &filePath, qsizetype packetNumber)
+{
+    // Không để lại file thiếu gói trông như đã lưu xong
+    QFile::remove(filePath);
+    QMessageBox::warning(m_mainWindow, "Save Error",
+                         tr("Cannot read packet %1 from the packet store (temporary segment file "
+                            "damaged or removed).\nThe file was not saved.").arg(packetNumber));
+}
 
 void AppController::onRestartCaptureClicked()
 {
     qDebug() << "Restart capture";
 
-    { // Khóa (lock) m_allPackets
-        QMutexLocker locker(&m_allPacketsMutex);
-        m_allPackets.clear();
+    startNewSession();
+    if (m_captureEngine->isReplaying()) {
+        m_captureEngine->startReplay(m_captureEngine->replayFile(), m_captureEngine->replayOptions());
+        return;
     }
-
-    m_statsManager->clear();
-    m_convManager->clear();
-    m_currentFilterText = "";
-    emit clearPacketTable();
-    m_captureEngine->stopCapture();
     m_captureEngine->startCapture();
 }
 
@@ -172,100 +539,80 @@ void AppController::onPauseCaptureClicked()
     }
 }
 
+void AppController::onPauseModeChanged(int mode)
+{
+    // Áp dụng từ lần tạm dừng tiếp theo
+    m_captureEngine->setPauseMode(static_cast<CaptureEngine::PauseMode>(mode));
+}
+
 void AppController::onApplyFilterClicked(const QString &filterText)
 {
     qDebug() << "Apply Display Filter:" << filterText;
 
+    // Kiểm tra cú pháp trước: bộ lọc lỗi được báo trên thanh lọc, bảng giữ nguyên bộ lọc cũ
+    DisplayFilterEngine probe;
+    QString error;
+    if (!probe.setFilter(filterText, &error)) {
+        emit displayFilterError(error);
+        return;
+    }
+
     m_currentFilterText = filterText;
 
     refreshFullDisplay();
 }
 
 
-void AppController::onPacketsCaptured(QList<PacketData>* packetBatch)
+void AppController::onRowsReady(quint64 session, QList<quint32>* packetIds)
 {
-    // (Hàm này giờ chạy trên LUỒNG CHÍNH,
-    // vì CaptureEngine đã dùng QueuedConnection)
-    // --- GỌI BỘ NÃO MỚI (TRƯỚC) ---
-    // Lặp qua lô (batch) và gọi bộ não "stateful"
-    for (PacketData &packet : *packetBatch) { // <-- Lặp bằng tham chiếu (reference)
-        m_convManager->processPacket(packet);
-    }
-
-    // 1. Khóa và thêm lô vào danh sách chính
-    {
-        QMutexLocker locker(&m_allPacketsMutex);
-        m_allPackets.append(*packetBatch);
+    // (Chạy trên luồng UI) Dòng của phiên cũ (trước khi xóa bảng / đổi bộ lọc) bị bỏ
+    if (session != m_displaySession) {
+        delete packetIds;
+        return;
     }
+    emit displayNewPackets(packetIds);
+}
 
-    // 2. Gửi lô cho bộ đếm (rất nhanh, chỉ lặp 50-100 gói)
-    m_statsManager->processPackets(*packetBatch);
-    if (m_ioGraphDialog) {
-        m_ioGraphDialog->appendPackets(*packetBatch);
-    }
+void AppController::onPipelineReadFailed(quint64 session, quint64 packetNumber)
+{
+    if (session != m_displaySession) return;
+    QMessageBox::warning(m_mainWindow, "Display Filter Error",
+                         tr("Cannot read packet %1 from the packet store (temporary segment file "
+                            "damaged or removed).\nThe packet list only shows matches before it.")
+                             .arg(packetNumber));
+}
 
-    // 3. Lọc lô này để hiển thị live
-    QList<PacketData>* filteredBatch = new QList<PacketData>();
-    for (const PacketData &packet : *packetBatch) {
-        if (m_filterEngine->match(packet, m_currentFilterText))
-        {
-            filteredBatch->append(packet);
-        }
-    }
+void AppController::startNewSession()
+{
+    // 1. Dừng (join) luồng capture: không còn lô nào của phiên cũ được phát thêm
+    m_captureEngine->stopCapture();
 
-    // 4. Xóa lô gốc (từ CaptureEngine)
-    delete packetBatch;
+    // 2. Luồng xử lý xóa dữ liệu sau khi xử lý xong các lô cũ còn trong hàng đợi
+    const quint64 session = ++m_displaySession;
+    QMetaObject::invokeMethod(m_pipeline, [pipeline = m_pipeline, session]() {
+        pipeline->reset(session);
+    }, Qt::QueuedConnection);
 
-    // 5. Gửi lô đã lọc (có thể rỗng) lên UI
-    if (!filteredBatch->isEmpty()) {
-        emit displayNewPackets(filteredBatch);
-    } else {
-        delete filteredBatch; // Xóa nếu rỗng
-    }
+    m_statsManager->clear();
+    m_currentFilterText = "";
+    m_sessionFile.clear();
+    m_packetIndex.clear();
+    m_windowPackets.clear();
+    emit clearPacketTable();
 }
 
-
 void AppController::refreshFullDisplay()
 {
     // 1. Yêu cầu UI xóa sạch (chạy trên luồng UI)
+    m_windowPackets.clear();
     emit clearPacketTable();
 
-    // 2. Chạy tác vụ lọc (nặng) trên một luồng khác
-    QtConcurrent::run([this]() {
-        qDebug() << "Filter thread started...";
-
-        QList<PacketData>* filteredList = new QList<PacketData>();
-
-        // 3. Khóa m_allPackets CHỈ trong lúc đọc
-        {
-            QMutexLocker locker(&m_allPacketsMutex);
-
-            // 4. Lặp qua danh sách chính (trên luồng nền)
-            for (const PacketData &packet : m_allPackets) {
-                if (m_filterEngine->match(packet, m_currentFilterText)) {
-                    filteredList->append(packet);
-                }
-            }
-        } // (Mutex được tự động mở khóa ở đây)
-
-        qDebug() << "Filter thread finished. Emitting" << filteredList->size() << "packets.";
-
-        // 5. Gửi con trỏ chứa kết quả về luồng UI
-        // (Chúng ta emit tín hiệu 'onFilteringFinished'
-        //  đã được connect với 'addPacketsToTable' trong constructor)
-        QMetaObject::invokeMethod(this, [this, filteredList](){
-            emit onFilteringFinished(filteredList);
-        }, Qt::QueuedConnection);
-    });
-}
-
-
-void AppController::onFilteringFinished(QList<PacketData>* filteredPackets)
-{
-    // (Hàm này chạy trên luồng UI)
-    // Nó chỉ phát tín hiệu đã được kết nối với PacketTable
-    // (Chúng ta làm vậy để giữ AppController sạch sẽ)
-    emit displayNewPackets(filteredPackets);
+    // 2. Luồng xử lý lọc lại toàn bộ và gửi dòng lên theo từng đợt
+    const quint64 session = ++m_displaySession;
+    const QString filterText = m_currentFilterText;
+    QMetaObject::invokeMethod(m_pipeline, [pipeline = m_pipeline, filterText, session]() {
+        pipeline->setDisplayFilter(filterText, session);
+    }, Qt::QueuedConnection);
 }
 
 
@@ -280,7 +627,7 @@ void AppController::onStatisticsMenuClicked()
     qDebug() << "Statistics requested";
     if (!m_statisticsDialog)
     {
-        m_statisticsDialog = new StatisticsDialog(m_statsManager, m_mainWindow);
+        m_statisticsDialog = new StatisticsDialog(m_statsManager, m_convManager, m_mainWindow);
         connect(m_statisticsDialog, &QObject::destroyed, this, [this](){
             m_statisticsDialog = nullptr;
         });
@@ -299,14 +646,8 @@ void AppController::onIOGraphMenuClicked()
         return;
     }
 
-    // Nếu chưa có thì mới tạo
-    QList<PacketData> packetsSnapshot;
-    {
-        QMutexLocker locker(&m_allPacketsMutex);
-        packetsSnapshot = m_allPackets;
-    }
-
-    m_ioGraphDialog = new IOGraphDialog(packetsSnapshot, m_statsManager, m_mainWindow);
+    // Nếu chưa có thì mới tạo (đồ thị đọc chuỗi thời gian của IOGraphManager, không copy gói)
+    m_ioGraphDialog = new IOGraphDialog(m_ioGraphManager, m_mainWindow);
 
     // Quan trọng: Khi đóng Dialog thì reset con trỏ về null
     connect(m_ioGraphDialog, &QDialog::finished, this, [this]() {
@@ -316,3 +657,231 @@ void AppController::onIOGraphMenuClicked()
 
     m_ioGraphDialog->show();
 }
+
+void AppController::onConversationsMenuClicked()
+{
+    showConversationsDialog(ConversationsDialog::TAB_CONVERSATIONS);
+}
+
+void AppController::onEndpointsMenuClicked()
+{
+    showConversationsDialog(ConversationsDialog::TAB_ENDPOINTS);
+}
+
+void AppController::onProtocolHierarchyMenuClicked()
+{
+    if (!m_hierarchyDialog)
+    {
+        m_hierarchyDialog = new ProtocolHierarchyDialog(m_statsManager, m_mainWindow);
+        connect(m_hierarchyDialog, &QObject::destroyed, this, [this](){
+            m_hierarchyDialog = nullptr;
+        });
+    }
+    m_hierarchyDialog->show();
+    m_hierarchyDialog->activateWindow();
+    m_hierarchyDialog->raise();
+}
+
+void AppController::showConversationsDialog(ConversationsDialog::Tab tab)
+{
+    if (!m_conversationsDialog)
+    {
+        m_conversationsDialog = new ConversationsDialog(m_convManager, m_mainWindow);
+        connect(m_conversationsDialog, &QObject::destroyed, this, [this](){
+            m_conversationsDialog = nullptr;
+        });
+        // Double-click / "Apply as Filter" -> lọc theo luồng hoặc địa chỉ
+        connect(m_conversationsDialog, &ConversationsDialog::filterRequested,
+                m_mainWindow, &MainWindow::applyStreamFilter);
+    }
+    m_conversationsDialog->showTab(tab);
+    m_conversationsDialog->show();
+    m_conversationsDialog->activateWindow();
+    m_conversationsDialog->raise();
+}
+
+void AppController::onFollowTcpStreamRequested(const PacketData &packet)
+{
+    FollowStreamData data;
+    bool found;
+    {
+        QMutexLocker locker(m_convManager->mutex());
+        found = m_convManager->followTcpStream(packet, data);
+    }
+    if (!found) {
+        QMessageBox::information(m_mainWindow, "Follow TCP Stream",
+                                 "No reassembled data for this stream "
+                                 "(no payload, or it was evicted by the memory limit).");
+        return;
+    }
+
+    QString title = QString("Follow TCP Stream (stream == %1)").arg(packet.stream_index);
+    FollowStreamDialog *dialog = new FollowStreamDialog(data, title, m_mainWindow);
+    dialog->show();
+}
+
+bool AppController::ensurePacketIndex()
+{
+    if (m_packetIndex.isValid()) return true;
+    if (m_sessionFile.isEmpty()) return false;
+
+    // Chỉ duyệt header bản ghi (không parse gói): nhanh cỡ tốc độ đọc đĩa, làm một lần mỗi phiên
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QString error;
+    const bool built = m_packetIndex.build(m_sessionFile, error);
+    QApplication::restoreOverrideCursor();
+    if (!built) {
+        QMessageBox::warning(m_mainWindow, "Go to", "Cannot index " + m_sessionFile + ": " + error);
+        m_sessionFile.clear(); // Không thử lại mỗi lần Go to
+    }
+    return built;
+}
+
+void AppController::onGoToPacketRequested()
+{
+    quint64 total = 0;
+    PacketData last;
+    if (m_packetStore.at(m_packetStore.size() - 1, last)) {
+        total = last.packet_id;
+    }
+    if (ensurePacketIndex()) {
+        total = std::max<quint64>(total, m_packetIndex.packetCount());
+    }
+    if (total == 0) {
+        QMessageBox::information(m_mainWindow, "Go to Packet", "There are no packets yet.");
+        return;
+    }
+
+    bool ok = false;
+    const int number = QInputDialog::getInt(m_mainWindow, tr("Go to Packet"),
+                                            tr("Packet number (1 - %1):").arg(total),
+                                            1, 1, static_cast<int>(std::min<quint64>(total, INT_MAX)), 1, &ok);
+    if (ok) {
+        goToPacket(static_cast<quint64>(number));
+    }
+}
+
+void AppController::onGoToTimeRequested()
+{
+    // Khoảng thời gian: từ chỉ mục (cả file) hoặc từ các gói đã nạp
+    int64_t firstNs = 0;
+    bool haveRange = false;
+    if (ensurePacketIndex() && m_packetIndex.packetCount() > 0) {
+        firstNs = m_packetIndex.info().firstNs;
+        haveRange = true;
+    } else {
+        PacketData first;
+        if (m_packetStore.at(0, first)) {
+            firstNs = timestampNs(first);
+            haveRange = true;
+        }
+    }
+    if (!haveRange) {
+        QMessageBox::information(m_mainWindow, "Go to Time", "There are no packets yet.");
+        return;
+    }
+
+    bool ok = false;
+    const QDateTime firstTime = QDateTime::fromMSecsSinceEpoch(firstNs / 1000000).toLocalTime();
+    const QString text = QInputDialog::getText(m_mainWindow, tr("Go to Time"),
+                                               tr("Time (%1) or seconds since the first packet:").arg(GO_TO_TIME_FORMAT),
+                                               QLineEdit::Normal, firstTime.toString(GO_TO_TIME_FORMAT), &ok).trimmed();
+    if (!ok || text.isEmpty()) {
+        return;
+    }
+
+    int64_t targetNs;
+    bool isSeconds = false;
+    const double seconds = text.toDouble(&isSeconds);
+    if (isSeconds) {
+        targetNs = firstNs + static_cast<int64_t>(std::llround(seconds * 1e9));
+    } else {
+        const QDateTime time = QDateTime::fromString(text, GO_TO_TIME_FORMAT);
+        if (!time.isValid()) {
+            QMessageBox::warning(m_mainWindow, "Go to Time", "Cannot read time: " + text);
+            return;
+        }
+        targetNs = time.toMSecsSinceEpoch() * 1000000LL;
+    }
+
+    // Gói đầu tiên có timestamp >= đích: tìm nhị phân trên chỉ mục file, hoặc trên danh sách đã nạp
+    quint64 number = 0;
+    if (m_packetIndex.isValid()) {
+        QString error;
+        number = m_packetIndex.findTime(targetNs, error);
+        if (!error.isEmpty()) {
+            QMessageBox::warning(m_mainWindow, "Go to Time", error);
+            return;
+        }
+    } else {
+        PacketData packet;
+        if (m_packetStore.at(m_packetStore.lowerBoundTime(targetNs), packet)) {
+            number = packet.packet_id;
+        }
+    }
+    if (number == 0) {
+        QMessageBox::information(m_mainWindow, "Go to Time", "No packet at or after " + text + ".");
+        return;
+    }
+    goToPacket(number);
+}
+
+void AppController::goToPacket(quint64 packetNumber)
+{
+    PacketData packet;
+    const bool loaded = m_packetStore.at(static_cast<qsizetype>(packetNumber) - 1, packet) &&
+                        packet.packet_id == packetNumber;
+    if (loaded) {
+        if (!m_windowPackets.isEmpty()) {
+            refreshFullDisplay(); // Rời cửa sổ: hiện lại danh sách chính (dòng đích được chọn khi tới)
+        }
+        m_mainWindow->selectPacket(static_cast<quint32>(packetNumber));
+        return;
+    }
+    if (m_packetIndex.isValid() && packetNumber <= m_packetIndex.packetCount()) {
+        showIndexedWindow(packetNumber);
+        return;
+    }
+    QMessageBox::information(m_mainWindow, "Go to Packet",
+                             QString("Packet %1 has not been captured yet.").arg(packetNumber));
+}
+
+void AppController::showIndexedWindow(quint64 packetNumber)
+{
+    // Chỉ đọc + parse cửa sổ quanh gói đích; bảng hiện riêng cửa sổ này cho tới khi
+    // áp bộ lọc hoặc Go to một gói đã nạp
+    const quint64 first = packetNumber > GO_TO_WINDOW_PACKETS / 2 ? packetNumber - GO_TO_WINDOW_PACKETS / 2 : 1;
+    std::vector<RawPacket> rawPackets;
+    QString error;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool read = m_packetIndex.readPackets(first, GO_TO_WINDOW_PACKETS, rawPackets, error);
+    QApplication::restoreOverrideCursor();
+    if (!read) {
+        QMessageBox::warning(m_mainWindow, "Go to Packet", error);
+        return;
+    }
+
+    Parser parser; // Riêng cho cửa sổ: ghép mảnh IP chỉ trong phạm vi cửa sổ
+    QList<PacketData> windowPackets;
+    QList<quint32>* rows = new QList<quint32>();
+    for (size_t i = 0; i < rawPackets.size(); ++i) {
+        const RawPacket &raw = rawPackets[i];
+        PacketData packet;
+        packet.packet_id = static_cast<quint32>(first + i);
+        // Như luồng capture: mọi frame đều có dòng (gói hỏng hiện là Malformed), nên số thứ tự
+        // trùng với packet_id của phiên bắt / đọc file
+        parser.parse(&packet, raw.data.data(), raw.header.caplen, &raw.header.ts);
+        packet.cap_length = raw.header.caplen;
+        packet.wire_length = raw.header.len;
+        packet.interface_id = raw.interfaceId;
+        rows->append(packet.packet_id);
+        windowPackets.append(std::move(packet));
+    }
+
+    // Dòng đang chảy về từ luồng xử lý thuộc phiên hiển thị cũ: bị bỏ
+    ++m_displaySession;
+    emit clearPacketTable();
+    m_windowPackets = std::move(windowPackets);
+    emit displayNewPackets(rows);
+    m_mainWindow->selectPacket(static_cast<quint32>(packetNumber));
+}
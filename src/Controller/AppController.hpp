@@ -2,14 +2,20 @@
 #define APPCONTROLLER_HPP
 
 #include <QObject>
-#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
 #include "../UI/MainWindow.hpp"
 #include "../Core/Capture/CaptureEngine.hpp"
-#include "ControllerLib/DisplayFilterEngine.hpp"
+#include "../Core/Capture/PacketIndex.hpp"
 #include "StatisticsManager.hpp"
+#include "IOGraphManager.hpp"
+#include "PacketPipeline.hpp"
+#include "PacketStore.hpp"
 #include "ControllerLib/ConversationManager.hpp"
 #include "../Widgets/StatisticsDialog.hpp"
 #include "../Widgets/IOGraphDialog.hpp"
+#include "../Widgets/ConversationsDialog.hpp"
+#include "../Widgets/ProtocolHierarchyDialog.hpp"
 
 
 class AppController : public QObject
@@ -17,48 +23,81 @@ class AppController : public QObject
     Q_OBJECT
 public:
     explicit AppController(MainWindow *mainWindow, QObject *parent = nullptr);
+    ~AppController() override;
 
 public slots:
     // UI Actions
-    void onInterfaceSelected(const QString &interfaceName, const QString &filterText);
+    void onInterfacesSelected(const QStringList &interfaceNames, const QString &filterText);
     void onOpenFileRequested();
+    void onOpenFolderRequested();
+    void onReplayFileRequested();
+    void onMemoryBudgetRequested();
+    void onCompressionToggled(bool enabled);
     void onSaveFileRequested();
     void onRestartCaptureClicked();
     void onStopCaptureClicked();
     void onPauseCaptureClicked();
+    void onPauseModeChanged(int mode);
 
     // (QUAN TRỌNG) Slot này nhận chuỗi lọc
     void onApplyFilterClicked(const QString &filterText);
     void onStatisticsMenuClicked();
     void onIOGraphMenuClicked(); // <-- THÊM SLOT MỚI
+    void onConversationsMenuClicked();
+    void onEndpointsMenuClicked();
+    void onProtocolHierarchyMenuClicked();
+    void onFollowTcpStreamRequested(const PacketData &packet);
+    void onGoToPacketRequested();
+    void onGoToTimeRequested();
 
-    // Core Signals
-    void onPacketsCaptured(QList<PacketData>* packetBatch);
-
-    // Helper slot
-    void onFilteringFinished(QList<PacketData>* filteredPackets);
+    // Dòng đã lọc + định dạng từ luồng xử lý
+    void onRowsReady(quint64 session, QList<quint32>* packetIds);
+    void onPipelineReadFailed(quint64 session, quint64 packetNumber);
 
 signals:
-    void displayNewPackets(QList<PacketData>* packets);
+    void displayNewPackets(QList<quint32>* packetIds);
     void clearPacketTable();
     void displayFilterError(const QString &error);
 
 private:
     void loadInterfaces();
     void refreshFullDisplay(); // Hàm chạy lọc lại toàn bộ
+    void startNewSession();    // Dừng bắt gói, xóa dữ liệu và bảng (trước khi bắt / mở file mới)
+    void openCaptureFiles(const QStringList &filePaths); // Scan, chọn khoảng cắt, rồi đọc gộp
+    void showConversationsDialog(ConversationsDialog::Tab tab);
+    // Go to: gói đã nạp thì chọn trong bảng; chưa nạp thì đọc cửa sổ quanh nó từ file qua chỉ mục
+    void goToPacket(quint64 packetNumber);
+    bool ensurePacketIndex();   // Dựng chỉ mục (lần đầu) nếu phiên là một file; false nếu không có
+    void showIndexedWindow(quint64 packetNumber);
+    void abortSave(const QString &filePath, qsizetype packetNumber); // Xóa file dở và báo lỗi đọc store
 
     MainWindow *m_mainWindow;
     CaptureEngine *m_captureEngine;
-    DisplayFilterEngine *m_filterEngine;
     StatisticsManager *m_statsManager;
     StatisticsDialog *m_statisticsDialog;
     ConversationManager *m_convManager;
+    IOGraphManager *m_ioGraphManager;
     IOGraphDialog *m_ioGraphDialog;
+    ConversationsDialog *m_conversationsDialog;
+    ProtocolHierarchyDialog *m_hierarchyDialog;
+
+    // Tầng xử lý (luồng riêng): theo dõi luồng, I/O Graph, lọc, định dạng dòng
+    QThread *m_pipelineThread;
+    PacketPipeline *m_pipeline;
+    // Tăng mỗi lần bảng bị xóa (phiên mới / đổi bộ lọc): dòng của phiên cũ bị bỏ
+    quint64 m_displaySession = 0;
+
+    // Dữ liệu: gói mới trong RAM, gói cũ đổ ra segment trên đĩa khi vượt ngân sách bộ nhớ
+    PacketStore m_packetStore;
 
+    // Go to Packet / Go to Time (chỉ luồng GUI)
+    QString m_sessionFile;               // File đang mở (rỗng nếu bắt trực tiếp / nhiều file)
+    PacketIndex m_packetIndex;           // Chỉ mục thưa của m_sessionFile, dựng khi cần
+    QList<PacketData> m_windowPackets;   // Cửa sổ đọc từ file đang hiển thị (rỗng = bảng hiện danh sách chính)
 
-    // Dữ liệu
-    QList<PacketData> m_allPackets;
-    QMutex m_allPacketsMutex;
+    // Sắp xếp bảng gói theo cột (một luồng; khai báo sau m_packetStore nên bị hủy trước nó:
+    // hàm hủy của pool chờ job đang đọc store)
+    QThreadPool m_sortPool;
 
     //Lưu trữ từ khóa lọc hiện tại (ví dụ: "http")
     QString m_currentFilterText;
@@ -9,7 +9,211 @@ ConversationManager::ConversationManager(QObject *parent) : QObject(parent)
 void ConversationManager::clear()
 {
     m_streams.clear();
+    m_reassembler.clear();
+    m_rtt.clear();
     m_global_stream_counter = 0;
+
+    m_wheel.clear();
+    m_wheelNowSec = -1;
+    m_evictedIdle = m_evictedCapacity = 0;
+
+    m_table.clear();
+    m_updateSeq = m_tableSyncedSeq = 0;
+    m_flowIat.clear();
+}
+
+LogHistogram ConversationManager::flowThroughput() const
+{
+    LogHistogram hist;
+    for (const ConversationRecord& r : m_table.conversations()) {
+        if (r.last_ns <= r.first_ns) continue;
+        const double bits = static_cast<double>(r.bytes_ab + r.bytes_ba) * 8.0;
+        hist.add(static_cast<uint64_t>(bits * 1e9 / static_cast<double>(r.last_ns - r.first_ns)));
+    }
+    return hist;
+}
+
+ConversationInfo ConversationManager::makeInfo(const StreamID& id, const StreamState& state) const
+{
+    ConversationInfo info;
+    info.id = id;
+    info.state = state;
+    if (id.protocol == 6) {
+        if (const TcpRttStats* rtt = m_rtt.stats(state.rtt_slot)) {
+            info.has_rtt = true;
+            info.rtt = *rtt;
+        }
+    }
+    return info;
+}
+
+// Micro giây cho ConversationRecord (-1 = chưa đo, bão hòa ở INT32_MAX ~ 35 phút)
+static int32_t toMicros(int64_t ns)
+{
+    if (ns < 0) return -1;
+    return static_cast<int32_t>(std::min<int64_t>(ns / 1000, INT32_MAX));
+}
+
+ConversationRecord ConversationManager::makeRecord(const StreamID& id, const StreamState& state) const
+{
+    // A = phía gửi gói đầu tiên
+    const int a = state.first_reversed ? 1 : 0;
+    ConversationRecord r;
+    r.stream_index = state.stream_index;
+    r.addr_a = a ? id.ip2 : id.ip1;
+    r.addr_b = a ? id.ip1 : id.ip2;
+    r.port_a = a ? id.port2 : id.port1;
+    r.port_b = a ? id.port1 : id.port2;
+    r.protocol = id.protocol;
+    r.is_ipv6 = id.is_ipv6;
+    r.tcp_state = state.tcp_state;
+    r.packets_ab = state.dir_packets[a];
+    r.packets_ba = state.dir_packets[1 - a];
+    r.bytes_ab = state.dir_bytes[a];
+    r.bytes_ba = state.dir_bytes[1 - a];
+    r.first_ns = state.first_ns;
+    r.last_ns = state.last_ns;
+
+    if (id.protocol == 6) {
+        if (const TcpRttStats* rtt = m_rtt.stats(state.rtt_slot)) {
+            r.rtt_samples = static_cast<quint32>(rtt->ack_rtt.count());
+            r.irtt_us = toMicros(rtt->initial_rtt_ns);
+            r.rtt_min_us = toMicros(rtt->ack_rtt.min());
+            r.rtt_p50_us = toMicros(rtt->ack_rtt.quantile(0.50));
+            r.rtt_p90_us = toMicros(rtt->ack_rtt.quantile(0.90));
+            r.rtt_p99_us = toMicros(rtt->ack_rtt.quantile(0.99));
+            r.rtt_max_us = toMicros(rtt->ack_rtt.max());
+            r.ts_p50_us = toMicros(rtt->ts_rtt.quantile(0.50));
+            r.ts_p99_us = toMicros(rtt->ts_rtt.quantile(0.99));
+        }
+    }
+    return r;
+}
+
+void ConversationManager::syncConversationTable()
+{
+    if (m_tableSyncedSeq == m_updateSeq) return;
+
+    // Danh sách LRU xếp theo lần chạm gần nhất: chỉ duyệt các luồng đổi từ lần đồng bộ trước
+    m_streams.forEachRecent([this](const StreamID& id, StreamState& state) {
+        if (state.update_seq <= m_tableSyncedSeq) return false;
+        m_table.update(state.table_row, makeRecord(id, state));
+        return true;
+    });
+    m_tableSyncedSeq = m_updateSeq;
+}
+
+QList<ConversationInfo> ConversationManager::conversations() const
+{
+    QList<ConversationInfo> result;
+    result.reserve(m_streams.size());
+    m_streams.forEach([&](const StreamID& id, const StreamState& state) {
+        result.append(makeInfo(id, state));
+    });
+    return result;
+}
+
+// --- Idle timeout & eviction ---
+
+int ConversationManager::timeoutFor(const StreamID& id, const StreamState& state) const
+{
+    if (id.protocol != 6) return m_timeouts.udp_sec;
+    switch (state.tcp_state) {
+    case StreamState::FIN_WAIT:
+    case StreamState::CLOSED:
+        return m_timeouts.tcp_closed_sec;
+    case StreamState::SYN_SENT:
+    case StreamState::SYN_RCVD:
+        return m_timeouts.tcp_handshake_sec;
+    default:
+        // ESTABLISHED, hoặc luồng bắt được giữa chừng (không thấy SYN)
+        return m_timeouts.tcp_established_sec;
+    }
+}
+
+void ConversationManager::schedule(const StreamID& id, StreamState& state)
+{
+    const int64_t timeoutNs = static_cast<int64_t>(timeoutFor(id, state)) * 1000000000LL;
+    int64_t slot = (state.last_ns + timeoutNs + 999999999LL) / 1000000000LL; // Làm tròn lên
+    // Timeout dài hơn một vòng wheel: đặt ở ô xa nhất, tới đó sẽ kiểm tra và xếp lại
+    slot = std::max(slot, m_wheelNowSec + 1);
+    slot = std::min(slot, m_wheelNowSec + WHEEL_SLOTS - 1);
+
+    // Đã có mục sớm hơn (hoặc bằng): mục đó sẽ tự xếp lại khi tới hạn
+    if (state.wheel_slot_sec >= 0 && state.wheel_slot_sec <= slot) return;
+
+    m_wheel[slot % WHEEL_SLOTS].push_back({id, state.stream_index, slot});
+    state.wheel_slot_sec = slot;
+}
+
+void ConversationManager::checkWheelEntry(const WheelEntry& entry, int64_t nowSec)
+{
+    StreamState* state = m_streams.find(entry.id);
+    if (!state || state->stream_index != entry.stream_index || state->wheel_slot_sec != entry.slot_sec) {
+        return; // Mục cũ: luồng đã bị loại hoặc đã được xếp lịch lại
+    }
+
+    const int64_t expiresNs = state->last_ns + static_cast<int64_t>(timeoutFor(entry.id, *state)) * 1000000000LL;
+    if (nowSec * 1000000000LL >= expiresNs) {
+        evictFlow(entry.id, EVICT_IDLE);
+    } else {
+        state->wheel_slot_sec = -1;
+        schedule(entry.id, *state);
+    }
+}
+
+void ConversationManager::advanceWheel(int64_t nowSec)
+{
+    if (m_wheel.empty()) m_wheel.resize(WHEEL_SLOTS);
+    if (m_wheelNowSec < 0) { m_wheelNowSec = nowSec; return; }
+    if (nowSec <= m_wheelNowSec) return; // Timestamp lùi / cùng giây: không làm gì
+
+    if (nowSec - m_wheelNowSec >= WHEEL_SLOTS) {
+        // Nhảy quá một vòng (khoảng trống dài trong file pcap): kiểm tra lại toàn bộ
+        std::vector<WheelEntry> all;
+        for (auto& slot : m_wheel) {
+            all.insert(all.end(), slot.begin(), slot.end());
+            slot.clear();
+        }
+        m_wheelNowSec = nowSec;
+        for (const WheelEntry& e : all) checkWheelEntry(e, nowSec);
+        return;
+    }
+
+    while (m_wheelNowSec < nowSec) {
+        m_wheelNowSec++;
+        std::vector<WheelEntry> due;
+        due.swap(m_wheel[m_wheelNowSec % WHEEL_SLOTS]);
+        for (const WheelEntry& e : due) checkWheelEntry(e, m_wheelNowSec);
+    }
+}
+
+void ConversationManager::evictFlow(const StreamID& id, EvictReason reason)
+{
+    StreamState* state = m_streams.find(id);
+    if (!state) return;
+
+    if (m_evictionCallback) m_evictionCallback(makeInfo(id, *state), reason);
+
+    // Giữ bản ghi cuối cùng của luồng trong bảng hội thoại
+    ConversationRecord record = makeRecord(id, *state);
+    record.active = false;
+    m_table.update(state->table_row, record);
+
+    m_reassembler.removeFlow(id);
+    m_rtt.release(state->rtt_slot);
+    m_streams.erase(id);
+
+    if (reason == EVICT_IDLE) m_evictedIdle++;
+    else m_evictedCapacity++;
+}
+
+bool ConversationManager::followTcpStream(const PacketData& packet, FollowStreamData& out)
+{
+    if (!packet.is_tcp) return false;
+    StreamID id = getStreamID(packet);
+    if (id.protocol == 0) return false;
+    return m_reassembler.getStream(id, out);
 }
 
 // Hàm phụ trợ: Chuyển IPv4 uint32 thành std::array
@@ -24,7 +228,7 @@ std::array<uint8_t, 16> ConversationManager::ipToBytes(uint32_t ipv4) {
     return arr;
 }
 
-StreamID ConversationManager::getStreamID(const PacketData& packet)
+StreamID ConversationManager::getStreamID(const PacketData& packet, bool* reversed)
 {
     StreamID id{};
 
@@ -57,40 +261,191 @@ StreamID ConversationManager::getStreamID(const PacketData& packet)
 
     // 3. CANONICALIZATION (Chuẩn hóa: IP nhỏ đứng trước)
     // std::array hỗ trợ so sánh từ điển (lexicographical compare)
-    if (id.ip1 > id.ip2 || (id.ip1 == id.ip2 && id.port1 > id.port2)) {
+    bool swapped = id.ip1 > id.ip2 || (id.ip1 == id.ip2 && id.port1 > id.port2);
+    if (swapped) {
         std::swap(id.ip1, id.ip2);
         std::swap(id.port1, id.port2);
     }
+    if (reversed) *reversed = swapped;
 
     return id;
 }
 
+// --- Phân tích TCP (SEQ/ACK analysis) ---
+
+// Ngưỡng out-of-order: segment "lùi" đến trong khoảng này sau segment trước được coi là
+// đảo thứ tự thay vì gửi lại (giống giá trị mặc định của Wireshark khi chưa biết RTT)
+static constexpr int64_t OUT_OF_ORDER_THRESHOLD_NS = 3000000; // 3 ms
+
+// So sánh số thứ tự có xét quay vòng (RFC 1982)
+static inline int32_t seqDiff(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b); }
+
+static inline uint64_t effectiveWindow(const TcpDirState& self, const TcpDirState& peer, uint16_t win, bool syn)
+{
+    // Window Scale chỉ có hiệu lực khi cả hai phía cùng khai báo, và không áp dụng cho SYN
+    if (syn || self.win_scale < 0 || peer.win_scale < 0) return win;
+    return static_cast<uint64_t>(win) << self.win_scale;
+}
+
+void ConversationManager::analyzeTcp(StreamState& state, bool reversed, PacketData& packet)
+{
+    TcpDirState& self = state.tcp_dir[reversed ? 1 : 0];
+    TcpDirState& peer = state.tcp_dir[reversed ? 0 : 1];
+    TCPAnalysis& a = packet.tcp_analysis;
+
+    const TCPHeader& tcp = packet.tcp;
+    const bool syn = tcp.flags & TCPHeader::SYN;
+    const bool fin = tcp.flags & TCPHeader::FIN;
+    const bool rst = tcp.flags & TCPHeader::RST;
+    const bool ack = tcp.flags & TCPHeader::ACK;
+    const uint32_t payload = packet.tcp_segment_length; // Không dùng payload_length: bị cắt bởi snaplen
+    const uint32_t seglen = payload + (syn ? 1 : 0) + (fin ? 1 : 0);
+    const int64_t nowNs = static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+
+    if (syn) self.win_scale = tcp.window_scale;
+
+    // --- Phân tích SEQ ---
+    if (!self.seen || syn) {
+        // Segment đầu tiên của chiều này: chỉ khởi tạo
+        self.seen = true;
+        self.next_seq = tcp.seq_num + seglen;
+    } else if (!rst) {
+        const int32_t delta = seqDiff(tcp.seq_num, self.next_seq);
+
+        if (tcp.window == 0 && !fin) a.flags |= TCPAnalysis::ZERO_WINDOW;
+
+        if (seglen <= 1 && !fin && delta == -1) {
+            a.flags |= TCPAnalysis::KEEP_ALIVE;
+        } else if (seglen > 0) {
+            if (delta > 0) {
+                a.flags |= TCPAnalysis::LOST_SEGMENT;
+            } else if (delta < 0) {
+                if (peer.dup_ack_count >= 2 && peer.last_ack == tcp.seq_num) {
+                    a.flags |= TCPAnalysis::FAST_RETRANSMISSION | TCPAnalysis::RETRANSMISSION;
+                } else if (nowNs - self.last_seg_ns < OUT_OF_ORDER_THRESHOLD_NS &&
+                           seqDiff(tcp.seq_num + seglen, self.next_seq) < 0) {
+                    a.flags |= TCPAnalysis::OUT_OF_ORDER;
+                } else {
+                    a.flags |= TCPAnalysis::RETRANSMISSION;
+                }
+            }
+
+            // Bên nhận đã hết window: segment này lấp đầy đúng tới mép phải
+            if (payload > 0 && peer.ack_seen &&
+                static_cast<int64_t>(seqDiff(tcp.seq_num + payload, peer.last_ack)) ==
+                    static_cast<int64_t>(effectiveWindow(peer, self, peer.last_win, false))) {
+                a.flags |= TCPAnalysis::WINDOW_FULL;
+            }
+
+            if (seqDiff(tcp.seq_num + seglen, self.next_seq) > 0) {
+                self.next_seq = tcp.seq_num + seglen;
+            }
+        }
+    }
+    if (payload > 0) self.last_seg_ns = nowNs;
+
+    // --- Phân tích ACK ---
+    if (ack && !rst) {
+        const bool pureAck = payload == 0 && !syn && !fin;
+        if (self.ack_seen && pureAck && tcp.ack_num == self.last_ack &&
+            !(a.flags & TCPAnalysis::KEEP_ALIVE)) {
+            if (tcp.window == self.last_win) {
+                a.flags |= TCPAnalysis::DUPLICATE_ACK;
+                a.dup_ack_num = ++self.dup_ack_count;
+                a.dup_ack_frame = self.last_ack_frame;
+            } else if (tcp.window != 0) {
+                a.flags |= TCPAnalysis::WINDOW_UPDATE;
+            }
+        } else if (!self.ack_seen || tcp.ack_num != self.last_ack) {
+            self.dup_ack_count = 0;
+            self.last_ack_frame = packet.packet_id;
+        }
+
+        if (peer.seen && seqDiff(tcp.ack_num, peer.next_seq) > 0) {
+            a.flags |= TCPAnalysis::ACKED_UNSEEN;
+        }
+
+        self.ack_seen = true;
+        self.last_ack = tcp.ack_num;
+        self.last_win = tcp.window;
+    }
+
+    if (a.flags == 0) return;
+
+    // --- Expert info ---
+    packet.is_retransmitted = a.has(TCPAnalysis::RETRANSMISSION);
+    packet.is_duplicate = a.has(TCPAnalysis::DUPLICATE_ACK);
+
+    static const struct { uint16_t flag; const char* text; } kMessages[] = {
+        { TCPAnalysis::FAST_RETRANSMISSION, "Fast retransmission (suspected)" },
+        { TCPAnalysis::RETRANSMISSION,      "Retransmission (suspected)" },
+        { TCPAnalysis::OUT_OF_ORDER,        "Out-of-order segment" },
+        { TCPAnalysis::LOST_SEGMENT,        "Previous segment not captured" },
+        { TCPAnalysis::ACKED_UNSEEN,        "ACKed segment that wasn't captured" },
+        { TCPAnalysis::DUPLICATE_ACK,       "Duplicate ACK" },
+        { TCPAnalysis::ZERO_WINDOW,         "Zero window" },
+        { TCPAnalysis::WINDOW_FULL,         "Window is full" },
+        { TCPAnalysis::WINDOW_UPDATE,       "Window update" },
+        { TCPAnalysis::KEEP_ALIVE,          "Keep-alive" },
+    };
+    for (const auto& m : kMessages) {
+        if (!(a.flags & m.flag)) continue;
+        // Fast retransmission đã bao hàm retransmission
+        if (m.flag == TCPAnalysis::RETRANSMISSION && a.has(TCPAnalysis::FAST_RETRANSMISSION)) continue;
+        if (!packet.expert_info.empty()) packet.expert_info += "; ";
+        packet.expert_info += m.text;
+        if (m.flag == TCPAnalysis::DUPLICATE_ACK) {
+            packet.expert_info += " #" + std::to_string(a.dup_ack_num) + " of frame " + std::to_string(a.dup_ack_frame);
+        }
+    }
+}
+
 void ConversationManager::processPackets(QList<PacketData>& packetBatch)
 {
     for (PacketData& packet : packetBatch) {
         processPacket(packet);
     }
+    syncConversationTable();
 }
 
 void ConversationManager::processPacket(PacketData& packet)
 {
-    StreamID id = getStreamID(packet);
+    bool reversed = false;
+    StreamID id = getStreamID(packet, &reversed);
     if (id.protocol == 0) return;
 
-    // Tạo trạng thái mới nếu chưa có
-    if (!m_streams.contains(id)) {
-        StreamState newState;
-        newState.stream_index = m_global_stream_counter++;
-        newState.start_time = QDateTime::currentDateTime();
-        newState.tcp_state = StreamState::NONE; // Init TCP state
-        m_streams.insert(id, newState);
+    const int64_t nowNs = static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+
+    // Loại các luồng hết hạn trước (luồng cùng 5-tuple sau đó sẽ nhận stream index mới)
+    advanceWheel(packet.timestamp.tv_sec);
+
+    // Bảng đầy: loại luồng ít được dùng nhất để có chỗ cho luồng mới
+    if (m_streams.size() >= m_maxFlows && !m_streams.find(id)) {
+        while (m_streams.size() >= m_maxFlows) {
+            StreamID victim = m_streams.oldest()->key;
+            evictFlow(victim, EVICT_CAPACITY);
+        }
     }
 
-    StreamState& state = m_streams[id];
+    // Tìm (một lần băm) hoặc tạo trạng thái mới
+    bool inserted = false;
+    StreamState& state = m_streams.findOrInsert(id, &inserted);
+    if (inserted) {
+        state.stream_index = m_global_stream_counter++;
+        state.first_ns = nowNs;
+        state.first_reversed = reversed;
+        state.tcp_state = StreamState::NONE; // Init TCP state
+    }
+    const StreamState::TcpState prevTcpState = state.tcp_state;
+    if (!inserted && nowNs >= state.last_ns) m_flowIat.add(static_cast<uint64_t>(nowNs - state.last_ns));
 
-    // Cập nhật thống kê
+    // Cập nhật thống kê (dùng timestamp của gói, không gọi đồng hồ hệ thống)
+    state.last_ns = nowNs;
+    state.byte_count += packet.wire_length;
     state.packet_count++;
-    state.last_activity = QDateTime::currentDateTime();
+    state.dir_packets[reversed ? 1 : 0]++;
+    state.dir_bytes[reversed ? 1 : 0] += packet.wire_length;
+    state.update_seq = ++m_updateSeq;
 
     // Gán Stream Index vào gói tin
     packet.stream_index = state.stream_index;
@@ -99,16 +454,6 @@ void ConversationManager::processPacket(PacketData& packet)
     // LOGIC TCP (Handshake Tracking)
     // ============================
     if (packet.is_tcp) {
-        // Cập nhật thông tin hiển thị (Info Column) dựa trên cờ
-        // (Phần này giúp UI hiển thị giống Wireshark: [SYN], [ACK]...)
-        QString flagsStr = "";
-        if (packet.tcp.flags & TCPHeader::SYN) flagsStr += "SYN, ";
-        if (packet.tcp.flags & TCPHeader::FIN) flagsStr += "FIN, ";
-        if (packet.tcp.flags & TCPHeader::RST) flagsStr += "RST, ";
-        if (packet.tcp.flags & TCPHeader::PSH) flagsStr += "PSH, ";
-        if (packet.tcp.flags & TCPHeader::ACK) flagsStr += "ACK, ";
-        if (!flagsStr.isEmpty()) flagsStr.chop(2); // Xóa dấu phẩy cuối
-
         // Logic trạng thái kết nối
         if (packet.tcp.flags & TCPHeader::SYN) {
             if (packet.tcp.flags & TCPHeader::ACK) {
@@ -123,24 +468,33 @@ void ConversationManager::processPacket(PacketData& packet)
                 state.tcp_state = StreamState::SYN_SENT;
             }
         }
-        else if ((packet.tcp.flags & TCPHeader::ACK) && !(packet.tcp.flags & TCPHeader::SYN)) {
+        // (RST / FIN kiểm tra trước ACK: gói FIN hầu như luôn kèm cờ ACK)
+        else if (packet.tcp.flags & TCPHeader::RST) {
+            state.tcp_state = StreamState::CLOSED;
+        }
+        else if (packet.tcp.flags & TCPHeader::FIN) {
+            if (state.tcp_state != StreamState::CLOSED) state.tcp_state = StreamState::FIN_WAIT;
+        }
+        else if (packet.tcp.flags & TCPHeader::ACK) {
             // ACK (Gói thứ 3 của handshake)
             if (state.saw_syn && state.saw_syn_ack && state.tcp_state == StreamState::SYN_RCVD) {
                 state.tcp_state = StreamState::ESTABLISHED;
             }
         }
-        else if (packet.tcp.flags & TCPHeader::FIN) {
-            state.tcp_state = StreamState::FIN_WAIT;
-        }
-        else if (packet.tcp.flags & TCPHeader::RST) {
-            state.tcp_state = StreamState::CLOSED;
-        }
 
         // Cập nhật Info nếu chưa có Application Info
         // (Ví dụ: thay vì hiện mỗi "TCP", hiện "60442 -> 443 [SYN] Seq=0...")
         /* Lưu ý: Logic tạo string info chi tiết đã có trong PacketTable::getInfo,
          nhưng ở đây bạn có thể bổ sung trạng thái luồng nếu muốn.
         */
+
+        // Phân tích SEQ/ACK (retransmission, dup ACK, zero window...)
+        analyzeTcp(state, reversed, packet);
+        // Đo RTT (bắt tay, dữ liệu/ACK, TSval/TSecr)
+        m_rtt.processSegment(state.rtt_slot, reversed, packet);
+
+        // Ghép luồng (reassembly): cập nhật lại Tầng 7 nếu gói hoàn tất một PDU
+        m_reassembler.processSegment(id, reversed, packet);
     }
 
     // ============================
@@ -161,4 +515,9 @@ void ConversationManager::processPacket(PacketData& packet)
             }
         }
     }
+
+    // Lên lịch idle timeout cho luồng mới, hoặc sớm hơn nếu luồng vừa đóng (FIN / RST)
+    if (inserted || state.tcp_state != prevTcpState) {
+        schedule(id, state);
+    }
 }
@@ -2,59 +2,61 @@
 #define CONVERSATIONMANAGER_HPP
 
 #include <QObject>
-#include <QHash>
-#include <QDateTime>
+#include <QList>
+#include <QRecursiveMutex>
 #include <array>
+#include <functional>
+#include <vector>
 #include "../../Common/PacketData.hpp"
+#include "../../Common/LogHistogram.hpp"
+#include "StreamID.hpp"
+#include "FlowTable.hpp"
+#include "TcpReassembler.hpp"
+#include "TcpRttTracker.hpp"
+#include "ConversationTable.hpp"
 
 /**
- * @brief Định danh luồng hỗ trợ cả IPv4 và IPv6
+ * @brief Trạng thái SEQ/ACK của một chiều TCP (kích thước cố định, O(1) mỗi gói).
  */
-struct StreamID {
-    // Dùng mảng 16 byte để chứa IP (IPv4 sẽ dùng 4 byte đầu hoặc map sang v6)
-    std::array<uint8_t, 16> ip1{};
-    std::array<uint8_t, 16> ip2{};
-    quint16 port1 = 0;
-    quint16 port2 = 0;
-    quint8 protocol = 0;
-    bool is_ipv6 = false; // Cờ đánh dấu
-
-    // Toán tử so sánh bằng (Bắt buộc cho QHash)
-    bool operator==(const StreamID& other) const {
-        return ip1 == other.ip1 && ip2 == other.ip2 &&
-               port1 == other.port1 && port2 == other.port2 &&
-               protocol == other.protocol && is_ipv6 == other.is_ipv6;
-    }
+struct TcpDirState {
+    bool     seen = false;           // Đã thấy segment từ chiều này
+    bool     ack_seen = false;       // Đã thấy ACK từ chiều này
+    uint32_t next_seq = 0;           // seq + len lớn nhất đã thấy
+    uint32_t last_ack = 0;
+    uint16_t last_win = 0;           // Window thô (chưa nhân scale)
+    int8_t   win_scale = -1;         // Window Scale khai báo trong SYN (-1 = không có)
+    uint32_t dup_ack_count = 0;
+    uint32_t last_ack_frame = 0;     // packet_id của ACK gốc (không phải dup)
+    int64_t  last_seg_ns = 0;        // Thời điểm segment có dữ liệu gần nhất
 };
 
-// Hàm băm (Hash function) cho mảng 16 byte
-inline size_t qHash(const std::array<uint8_t, 16>& key, size_t seed = 0) {
-    // Hash đơn giản bằng cách XOR các khối 4 byte
-    const uint32_t* p = reinterpret_cast<const uint32_t*>(key.data());
-    return seed ^ p[0] ^ p[1] ^ p[2] ^ p[3];
-}
-
-// Hàm băm chính cho StreamID
-inline size_t qHash(const StreamID& key, size_t seed = 0) {
-    return qHash(key.ip1, seed) ^ qHash(key.ip2, seed) ^
-           qHash(key.port1, seed) ^ qHash(key.port2, seed) ^
-           qHash(key.protocol, seed);
-}
-
 /**
  * @brief Trạng thái luồng (Thêm TCP)
+ * Kích thước cố định (không cấp phát động) để nằm gọn trong FlowTable.
  */
 struct StreamState {
     quint64 stream_index = 0;
     quint64 packet_count = 0;
-    QDateTime start_time;
-    QDateTime last_activity;
+    quint64 byte_count = 0;
+    int64_t first_ns = 0;      // Timestamp (ns) của gói đầu / cuối (theo thời gian bắt gói)
+    int64_t last_ns = 0;
+
+    // Thống kê theo chiều: [0] = (ip1, port1) -> (ip2, port2), [1] = chiều ngược lại
+    std::array<quint64, 2> dir_packets{};
+    std::array<quint64, 2> dir_bytes{};
+    bool first_reversed = false;   // Gói đầu tiên đi theo chiều [1] (A = phía mở luồng)
+
+    // Số thứ tự cập nhật (cho ConversationTable) và dòng tương ứng trong bảng
+    quint64 update_seq = 0;
+    uint32_t table_row = ConversationTable::NO_ROW;
+    // Slot trạng thái đo RTT (TcpRttTracker), chỉ cấp khi luồng TCP có gì để đo
+    uint32_t rtt_slot = TcpRttTracker::NO_SLOT;
 
     // --- QUIC State ---
     bool is_quic_confirmed = false;
 
     // --- TCP State ---
-    enum TcpState {
+    enum TcpState : uint8_t {
         NONE,
         SYN_SENT,
         SYN_RCVD,
@@ -65,26 +67,137 @@ struct StreamState {
     TcpState tcp_state = NONE;
     bool saw_syn = false;      // Đã thấy gói SYN?
     bool saw_syn_ack = false;  // Đã thấy gói SYN-ACK?
+
+    // Giây của ô timer wheel đang giữ luồng (-1 = chưa lên lịch)
+    int64_t wheel_slot_sec = -1;
+
+    // Phân tích SEQ/ACK theo chiều: [0] = (ip1, port1) -> (ip2, port2), [1] = chiều ngược lại
+    std::array<TcpDirState, 2> tcp_dir{};
+};
+
+/**
+ * @brief Ảnh chụp một hội thoại cho cửa sổ Conversations.
+ */
+struct ConversationInfo {
+    StreamID id;
+    StreamState state;
+    bool has_rtt = false;
+    TcpRttStats rtt;
+};
+
+/**
+ * @brief Thời gian chờ (giây) trước khi một luồng không hoạt động bị loại khỏi bộ nhớ.
+ */
+struct FlowIdleTimeouts {
+    int tcp_handshake_sec   = 60;    // Chưa hoàn tất bắt tay (vd: SYN scan)
+    int tcp_established_sec = 1800;  // Đang mở
+    int tcp_closed_sec      = 30;    // Đã thấy FIN / RST
+    int udp_sec             = 120;
 };
 
 class ConversationManager : public QObject
 {
     Q_OBJECT
 public:
+    static constexpr size_t DEFAULT_MAX_FLOWS = 1000000;
+
+    enum EvictReason {
+        EVICT_IDLE,      // Hết thời gian chờ
+        EVICT_CAPACITY   // Bảng đầy: loại luồng ít dùng nhất (LRU)
+    };
+    // Được gọi ngay trước khi luồng bị xóa (để tổng hợp / xuất ra ngoài)
+    using EvictionCallback = std::function<void(const ConversationInfo&, EvictReason)>;
+
     explicit ConversationManager(QObject *parent = nullptr);
 
+    void setIdleTimeouts(const FlowIdleTimeouts& timeouts) { m_timeouts = timeouts; }
+    void setMaxFlows(size_t maxFlows) { m_maxFlows = maxFlows > 0 ? maxFlows : 1; }
+    void setEvictionCallback(EvictionCallback callback) { m_evictionCallback = std::move(callback); }
+
+    size_t activeFlows() const { return m_streams.size(); }
+    quint64 evictedIdleFlows() const { return m_evictedIdle; }
+    quint64 evictedCapacityFlows() const { return m_evictedCapacity; }
+
     void processPackets(QList<PacketData>& packetBatch);
     void processPacket(PacketData& packet);
     void clear();
 
+    /**
+     * @brief Khóa trạng thái luồng / bảng hội thoại. Luồng xử lý giữ khóa trong lúc cộng một lô,
+     * luồng GUI giữ khóa khi đọc bảng, phân bố hoặc Follow TCP Stream.
+     * Đệ quy: model của bảng có thể được view hỏi lại dữ liệu ngay trong lúc đang giữ khóa.
+     */
+    QRecursiveMutex* mutex() const { return &m_mutex; }
+
+    /**
+     * @brief Lấy dữ liệu đã ghép của luồng TCP chứa gói tin (Follow TCP Stream).
+     * @return false nếu không phải TCP hoặc luồng không còn dữ liệu (đã bị evict).
+     */
+    bool followTcpStream(const PacketData& packet, FollowStreamData& out);
+
+    TcpReassembler& reassembler() { return m_reassembler; }
+
+    // Danh sách hội thoại hiện có (kèm thống kê RTT của luồng TCP)
+    QList<ConversationInfo> conversations() const;
+
+    /**
+     * @brief Bảng hội thoại / cặp IP / endpoint (gồm cả luồng đã bị loại).
+     * Được cập nhật cuối mỗi processPackets(); sau khi gọi processPacket() lẻ
+     * thì gọi syncConversationTable() để đẩy các thay đổi vào bảng.
+     */
+    const ConversationTable& conversationTable() const { return m_table; }
+    void syncConversationTable();
+
+    // Phân bố khoảng cách giữa hai gói liên tiếp trong cùng luồng (ns), cộng dồn theo từng gói
+    const LogHistogram& flowInterArrival() const { return m_flowIat; }
+    // Phân bố thông lượng trung bình của mỗi luồng (bit/s), tính khi đọc từ bảng hội thoại
+    // (luồng có ít nhất hai gói ở hai thời điểm khác nhau)
+    LogHistogram flowThroughput() const;
+
 private:
-    StreamID getStreamID(const PacketData& packet);
+    // 'reversed' (tùy chọn) = true nếu nguồn của gói là (ip2, port2) sau khi chuẩn hóa
+    StreamID getStreamID(const PacketData& packet, bool* reversed = nullptr);
+
+    // Phân tích SEQ/ACK: điền packet.tcp_analysis, is_retransmitted, is_duplicate, expert_info
+    void analyzeTcp(StreamState& state, bool reversed, PacketData& packet);
+
+    // --- Idle timeout (timer wheel, độ phân giải 1 giây) ---
+    struct WheelEntry {
+        StreamID id;
+        quint64 stream_index;  // Phân biệt luồng mới cùng 5-tuple sau khi luồng cũ bị loại
+        int64_t slot_sec;      // Khớp StreamState::wheel_slot_sec, nếu không thì là mục cũ (bỏ qua)
+    };
+    int timeoutFor(const StreamID& id, const StreamState& state) const;
+    void schedule(const StreamID& id, StreamState& state);
+    void advanceWheel(int64_t nowSec);
+    void checkWheelEntry(const WheelEntry& entry, int64_t nowSec);
+    void evictFlow(const StreamID& id, EvictReason reason);
+    ConversationInfo makeInfo(const StreamID& id, const StreamState& state) const;
+    ConversationRecord makeRecord(const StreamID& id, const StreamState& state) const;
 
     // Hàm phụ trợ để copy IPv4 vào mảng 16 byte
     std::array<uint8_t, 16> ipToBytes(uint32_t ipv4);
 
-    QHash<StreamID, StreamState> m_streams;
-    quint64 m_global_stream_counter = 0;
+    FlowTable<StreamState> m_streams;
+    TcpReassembler m_reassembler;
+    TcpRttTracker m_rtt;
+    quint64 m_global_stream_counter = 0; // Không reset khi evict -> stream index luôn duy nhất
+
+    static constexpr int WHEEL_SLOTS = 1024;
+    std::vector<std::vector<WheelEntry>> m_wheel;
+    int64_t m_wheelNowSec = -1;          // Giây đã xử lý tới (-1 = chưa bắt đầu)
+
+    FlowIdleTimeouts m_timeouts;
+    size_t m_maxFlows = DEFAULT_MAX_FLOWS;
+    EvictionCallback m_evictionCallback;
+    quint64 m_evictedIdle = 0;
+    quint64 m_evictedCapacity = 0;
+
+    mutable QRecursiveMutex m_mutex;
+    ConversationTable m_table;
+    LogHistogram m_flowIat;
+    quint64 m_updateSeq = 0;             // Tăng mỗi gói TCP/UDP
+    quint64 m_tableSyncedSeq = 0;        // m_updateSeq tại lần đồng bộ bảng gần nhất
 };
 
 #endif // CONVERSATIONMANAGER_HPP
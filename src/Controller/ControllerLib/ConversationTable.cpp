@@ -0,0 +1,130 @@
+#include "ConversationTable.hpp"
+#include <algorithm>
+
+// --- Triển khai (Implementation) ---
+
+void ConversationTable::clear()
+{
+    m_conversations.clear();
+    m_pairs.clear();
+    m_endpoints.clear();
+    m_conversationRevisions.clear();
+    m_pairRevisions.clear();
+    m_endpointRevisions.clear();
+    m_pairIndex.clear();
+    m_endpointIndex.clear();
+    m_startNs = -1;
+    m_revision++;
+    m_resetCount++;
+}
+
+void ConversationTable::touch(int64_t& first, int64_t& last, const ConversationRecord& record, bool isNew)
+{
+    if (isNew) {
+        first = record.first_ns;
+        last = record.last_ns;
+        return;
+    }
+    first = std::min(first, record.first_ns);
+    last = std::max(last, record.last_ns);
+}
+
+uint32_t ConversationTable::pairRow(const ConversationRecord& record, bool& swapped)
+{
+    swapped = record.addr_a > record.addr_b;
+    StreamID key{};
+    key.ip1 = swapped ? record.addr_b : record.addr_a;
+    key.ip2 = swapped ? record.addr_a : record.addr_b;
+    key.is_ipv6 = record.is_ipv6;
+
+    bool inserted = false;
+    uint32_t& row = m_pairIndex.findOrInsert(key, &inserted);
+    if (inserted) {
+        row = static_cast<uint32_t>(m_pairs.size());
+        AddressPairRecord pair;
+        pair.addr_a = key.ip1;
+        pair.addr_b = key.ip2;
+        pair.is_ipv6 = key.is_ipv6;
+        pair.first_ns = record.first_ns;
+        pair.last_ns = record.last_ns;
+        m_pairs.push_back(pair);
+        m_pairRevisions.push_back(0);
+    }
+    return row;
+}
+
+uint32_t ConversationTable::endpointRow(const std::array<uint8_t, 16>& addr, bool isIpv6)
+{
+    StreamID key{};
+    key.ip1 = addr;
+    key.is_ipv6 = isIpv6;
+
+    bool inserted = false;
+    uint32_t& row = m_endpointIndex.findOrInsert(key, &inserted);
+    if (inserted) {
+        row = static_cast<uint32_t>(m_endpoints.size());
+        EndpointRecord endpoint;
+        endpoint.addr = addr;
+        endpoint.is_ipv6 = isIpv6;
+        m_endpoints.push_back(endpoint);
+        m_endpointRevisions.push_back(0);
+    }
+    return row;
+}
+
+void ConversationTable::update(uint32_t& row, const ConversationRecord& record)
+{
+    const bool isNew = (row == NO_ROW);
+    if (isNew) {
+        row = static_cast<uint32_t>(m_conversations.size());
+        m_conversations.push_back(ConversationRecord{});
+        m_conversationRevisions.push_back(0);
+    }
+    ConversationRecord& conv = m_conversations[row];
+
+    // 1. Phần chênh lệch so với lần cập nhật trước (bộ đếm của luồng chỉ tăng)
+    const quint64 dPacketsAB = record.packets_ab - conv.packets_ab;
+    const quint64 dPacketsBA = record.packets_ba - conv.packets_ba;
+    const quint64 dBytesAB = record.bytes_ab - conv.bytes_ab;
+    const quint64 dBytesBA = record.bytes_ba - conv.bytes_ba;
+    conv = record;
+
+    if (m_startNs < 0 || record.first_ns < m_startNs) m_startNs = record.first_ns;
+
+    // 2. Cặp IP
+    bool swapped = false;
+    const uint32_t pairIndex = pairRow(record, swapped);
+    AddressPairRecord& pair = m_pairs[pairIndex];
+    if (isNew) pair.flows++;
+    touch(pair.first_ns, pair.last_ns, record, false);
+    pair.packets_ab += swapped ? dPacketsBA : dPacketsAB;
+    pair.packets_ba += swapped ? dPacketsAB : dPacketsBA;
+    pair.bytes_ab += swapped ? dBytesBA : dBytesAB;
+    pair.bytes_ba += swapped ? dBytesAB : dBytesBA;
+
+    // 3. Endpoint (tra cứu riêng từng phía: tham chiếu vào vector có thể mất hiệu lực khi thêm dòng)
+    const uint32_t rowA = endpointRow(record.addr_a, record.is_ipv6);
+    const uint32_t rowB = endpointRow(record.addr_b, record.is_ipv6);
+
+    EndpointRecord& a = m_endpoints[rowA];
+    touch(a.first_ns, a.last_ns, record, isNew && a.flows == 0);
+    if (isNew) a.flows++;
+    a.tx_packets += dPacketsAB;
+    a.tx_bytes += dBytesAB;
+    a.rx_packets += dPacketsBA;
+    a.rx_bytes += dBytesBA;
+
+    EndpointRecord& b = m_endpoints[rowB];
+    touch(b.first_ns, b.last_ns, record, isNew && b.flows == 0);
+    if (isNew && rowB != rowA) b.flows++;
+    b.tx_packets += dPacketsBA;
+    b.tx_bytes += dBytesBA;
+    b.rx_packets += dPacketsAB;
+    b.rx_bytes += dBytesAB;
+
+    m_revision++;
+    m_conversationRevisions[row] = m_revision;
+    m_pairRevisions[pairIndex] = m_revision;
+    m_endpointRevisions[rowA] = m_revision;
+    m_endpointRevisions[rowB] = m_revision;
+}
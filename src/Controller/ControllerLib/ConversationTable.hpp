@@ -0,0 +1,131 @@
+#ifndef CONVERSATIONTABLE_HPP
+#define CONVERSATIONTABLE_HPP
+
+#include <QtGlobal>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "StreamID.hpp"
+#include "FlowTable.hpp"
+
+/**
+ * @brief Bản ghi gọn (~130 byte) của một hội thoại TCP/UDP cho cửa sổ Conversations.
+ * A là phía gửi gói đầu tiên của luồng, B là phía còn lại.
+ */
+struct ConversationRecord {
+    quint64 stream_index = 0;
+    std::array<uint8_t, 16> addr_a{};
+    std::array<uint8_t, 16> addr_b{};
+    quint16 port_a = 0;
+    quint16 port_b = 0;
+    quint8 protocol = 0;        // 6 = TCP, 17 = UDP
+    bool is_ipv6 = false;
+    quint8 tcp_state = 0;       // StreamState::TcpState
+    bool active = true;         // false = luồng đã bị loại khỏi ConversationManager (hết hạn / LRU)
+
+    quint64 packets_ab = 0;     // A -> B
+    quint64 packets_ba = 0;     // B -> A
+    quint64 bytes_ab = 0;
+    quint64 bytes_ba = 0;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+
+    // Tóm tắt RTT của luồng TCP (micro giây, -1 = chưa đo được)
+    quint32 rtt_samples = 0;
+    int32_t irtt_us = -1;
+    int32_t rtt_min_us = -1;
+    int32_t rtt_p50_us = -1;
+    int32_t rtt_p90_us = -1;
+    int32_t rtt_p99_us = -1;
+    int32_t rtt_max_us = -1;
+    int32_t ts_p50_us = -1;
+    int32_t ts_p99_us = -1;
+};
+
+/**
+ * @brief Tổng hợp theo cặp địa chỉ IP (mọi luồng giữa A và B, A là địa chỉ nhỏ hơn).
+ */
+struct AddressPairRecord {
+    std::array<uint8_t, 16> addr_a{};
+    std::array<uint8_t, 16> addr_b{};
+    bool is_ipv6 = false;
+    quint32 flows = 0;
+    quint64 packets_ab = 0;
+    quint64 packets_ba = 0;
+    quint64 bytes_ab = 0;
+    quint64 bytes_ba = 0;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+};
+
+/**
+ * @brief Tổng hợp theo địa chỉ IP (Endpoints). Tx = gói do địa chỉ này gửi.
+ */
+struct EndpointRecord {
+    std::array<uint8_t, 16> addr{};
+    bool is_ipv6 = false;
+    quint32 flows = 0;
+    quint64 tx_packets = 0;
+    quint64 rx_packets = 0;
+    quint64 tx_bytes = 0;
+    quint64 rx_bytes = 0;
+    int64_t first_ns = 0;
+    int64_t last_ns = 0;
+};
+
+/**
+ * @brief Bảng hội thoại tích lũy cho cửa sổ Conversations / Endpoints.
+ *
+ * ConversationManager đẩy bản ghi mới nhất của mỗi luồng vừa thay đổi (một lần mỗi lô,
+ * và một lần cuối khi luồng bị loại). Bảng giữ lại cả luồng đã bị loại, và cộng phần
+ * chênh lệch so với lần trước vào bảng cặp IP / endpoint, nên chi phí tỉ lệ với số luồng
+ * thay đổi chứ không phải tổng số luồng. Các dòng chỉ được thêm, không bị xóa (trừ clear()),
+ * nên chỉ số dòng ổn định cho model của UI.
+ */
+class ConversationTable {
+public:
+    static constexpr uint32_t NO_ROW = 0xFFFFFFFFu;
+
+    /**
+     * @brief Cập nhật dòng của một luồng.
+     * @param row Chỉ số dòng của luồng; NO_ROW = luồng mới -> thêm dòng và ghi lại chỉ số.
+     */
+    void update(uint32_t& row, const ConversationRecord& record);
+    void clear();
+
+    const std::vector<ConversationRecord>& conversations() const { return m_conversations; }
+    const std::vector<AddressPairRecord>& addressPairs() const { return m_pairs; }
+    const std::vector<EndpointRecord>& endpoints() const { return m_endpoints; }
+
+    // revision() lúc dòng thay đổi lần cuối (song song với từng vector ở trên): model của UI
+    // chỉ chép lại các dòng có giá trị lớn hơn revision nó đã thấy
+    const std::vector<quint64>& conversationRevisions() const { return m_conversationRevisions; }
+    const std::vector<quint64>& addressPairRevisions() const { return m_pairRevisions; }
+    const std::vector<quint64>& endpointRevisions() const { return m_endpointRevisions; }
+
+    int64_t startNs() const { return m_startNs; }          // Gói đầu tiên (-1 = chưa có)
+    quint64 revision() const { return m_revision; }        // Tăng sau mỗi thay đổi
+    quint64 resetCount() const { return m_resetCount; }    // Tăng sau mỗi clear()
+
+private:
+    uint32_t pairRow(const ConversationRecord& record, bool& swapped);
+    uint32_t endpointRow(const std::array<uint8_t, 16>& addr, bool isIpv6);
+    static void touch(int64_t& first, int64_t& last, const ConversationRecord& record, bool isNew);
+
+    std::vector<ConversationRecord> m_conversations;
+    std::vector<AddressPairRecord> m_pairs;
+    std::vector<EndpointRecord> m_endpoints;
+    std::vector<quint64> m_conversationRevisions;
+    std::vector<quint64> m_pairRevisions;
+    std::vector<quint64> m_endpointRevisions;
+
+    // Khóa cặp IP: StreamID (ip1 < ip2, port/protocol = 0); khóa endpoint: ip1 = địa chỉ, ip2 = 0
+    FlowTable<uint32_t> m_pairIndex;
+    FlowTable<uint32_t> m_endpointIndex;
+
+    int64_t m_startNs = -1;
+    quint64 m_revision = 0;
+    quint64 m_resetCount = 0;
+};
+
+#endif // CONVERSATIONTABLE_HPP
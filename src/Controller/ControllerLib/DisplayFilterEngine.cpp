@@ -3,33 +3,97 @@
 #include "../../Common/PacketData.hpp" // Đảm bảo include PacketData
 #include <QStringList>
 #include <QRegularExpression>
+#include <arpa/inet.h> // inet_pton
+#include <cstring>
 
-DisplayFilterEngine::DisplayFilterEngine() {}
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+enum ValueType { VALUE_INT, VALUE_DOUBLE, VALUE_TEXT };
+
+bool isProtocolName(const QString& name)
+{
+    static const QStringList names = {"http", "dns", "mdns", "tls", "ssdp", "quic",
+                                      "tcp", "udp", "icmp", "arp"};
+    return names.contains(name);
+}
+
+// Trường cờ tcp.analysis.* (chỉ dùng không kèm toán tử)
+bool isTcpAnalysisFlag(const QString& key)
+{
+    static const QStringList flags = {
+        "tcp.analysis.flags", "tcp.analysis.retransmission", "tcp.analysis.fast_retransmission",
+        "tcp.analysis.out_of_order", "tcp.analysis.lost_segment", "tcp.analysis.ack_lost_segment",
+        "tcp.analysis.duplicate_ack", "tcp.analysis.zero_window", "tcp.analysis.window_full",
+        "tcp.analysis.window_update", "tcp.analysis.keep_alive"};
+    return flags.contains(key);
+}
+
+bool isTcpAnalysisRtt(const QString& key)
+{
+    return key == "tcp.analysis.ack_rtt" || key == "tcp.analysis.ts_rtt" || key == "tcp.analysis.initial_rtt";
+}
+
+bool isTlsTextField(const QString& key)
+{
+    static const QStringList fields = {
+        "tls.sni", "tls.handshake.extensions_server_name", "tls.alpn", "tls.handshake.extensions_alpn_str",
+        "tls.ja3", "tls.handshake.ja3_hash", "tls.ja4", "tls.handshake.ja4"};
+    return fields.contains(key);
+}
 
-// --- HÀM HELPER CHUYỂN ĐỔI IP ---
-QString DisplayFilterEngine::ipToString(uint32_t ip) {
-    return QString("%1.%2.%3.%4")
-    .arg((ip) & 0xFF)
-        .arg((ip >> 8) & 0xFF)
-        .arg((ip >> 16) & 0xFF)
-        .arg((ip >> 24) & 0xFF);
+bool isOrderingOp(const QString& op)
+{
+    return op == ">" || op == "<" || op == ">=" || op == "<=";
 }
 
-bool DisplayFilterEngine::match(const PacketData& packet, const QString& filterText) {
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+DisplayFilterEngine::DisplayFilterEngine() {}
+
+bool DisplayFilterEngine::setFilter(const QString& filterText, QString* error)
+{
+    m_orBlocks.clear();
+    m_valid = true;
+
     QString filter = filterText.trimmed().toLower();
     if (filter.isEmpty()) return true;
 
-    // 1. Xử lý OR (||)
-    QStringList orParts = filter.split("||");
+    // 1. Tách OR (||), rồi AND (&&); mỗi điều kiện đơn được dịch một lần ở đây
+    for (const QString& orPart : filter.split("||")) {
+        std::vector<Condition> andBlock;
+        for (const QString& subPart : orPart.split("&&")) {
+            const QString text = subPart.trimmed();
+            if (text.isEmpty()) continue;
+
+            Condition condition;
+            QString reason;
+            if (!parseCondition(text, condition, reason)) {
+                m_orBlocks.clear();
+                m_valid = false;
+                if (error) *error = reason;
+                return false;
+            }
+            andBlock.push_back(std::move(condition));
+        }
+        m_orBlocks.push_back(std::move(andBlock));
+    }
+    return true;
+}
 
-    for (const QString& orPart : orParts) {
-        // 2. Xử lý AND (&&)
-        QStringList andParts = orPart.split("&&");
+bool DisplayFilterEngine::match(const PacketData& packet) const {
+    if (!m_valid) return false;
+    if (m_orBlocks.empty()) return true;
+
+    for (const std::vector<Condition>& andBlock : m_orBlocks) {
         bool isAndBlockValid = true;
 
-        for (const QString& subPart : andParts) {
+        for (const Condition& condition : andBlock) {
             // Kiểm tra từng điều kiện đơn lẻ
-            if (!matchSingleCondition(packet, subPart.trimmed())) {
+            if (!matchSingleCondition(packet, condition)) {
                 isAndBlockValid = false;
                 break;
             }
@@ -43,66 +107,169 @@ bool DisplayFilterEngine::match(const PacketData& packet, const QString& filterT
     return false;
 }
 
-bool DisplayFilterEngine::matchSingleCondition(const PacketData& packet, const QString& condition) {
-    if (condition.isEmpty()) return true;
+bool DisplayFilterEngine::parseCondition(const QString& text, Condition& out, QString& error)
+{
+    // 0. Toán tử "contains" (vd: tls.sni contains google): trường được kiểm tra như mọi toán tử khác
+    QString key;
+    QString op;
+    QString valueStr;
+    const int containsIndex = text.indexOf(" contains ");
+    if (containsIndex != -1) {
+        key = text.left(containsIndex).trimmed();
+        op = "contains";
+        valueStr = text.mid(containsIndex + 10).trimmed();
+    } else if (!text.contains(QRegularExpression("[=!<>]=?"))) {
+        // 1. Không có toán tử: tên giao thức, hoặc kiểm tra sự tồn tại của trường tcp.analysis.*
+        out.key = text;
+        if (text.startsWith("tcp.analysis.")) {
+            if (!isTcpAnalysisFlag(text) && !isTcpAnalysisRtt(text)) {
+                error = QString("\"%1\" is not a valid field").arg(text);
+                return false;
+            }
+            out.kind = Condition::TCP_ANALYSIS;
+            return true;
+        }
+        if (!isProtocolName(text)) {
+            error = QString("\"%1\" is not a valid protocol or field").arg(text);
+            return false;
+        }
+        out.kind = Condition::PROTOCOL;
+        return true;
+    } else {
+        // 2. Xác định toán tử
+        int opIndex = -1;
+
+        QStringList twoCharOps = {"==", "!=", ">=", "<="};
+        for (const QString& o : twoCharOps) {
+            opIndex = text.indexOf(o);
+            if (opIndex != -1) {
+                op = o;
+                break;
+            }
+        }
+
+        if (op.isEmpty()) {
+            if (text.contains(">")) { op = ">"; opIndex = text.indexOf(">"); }
+            else if (text.contains("<")) { op = "<"; opIndex = text.indexOf("<"); }
+            else if (text.contains("=")) { op = "=="; opIndex = text.indexOf("="); }
+        }
 
-    // 1. Lọc Protocol (Không có toán tử)
-    if (!condition.contains(QRegularExpression("[=!<>]=?"))) {
-        return checkProtocol(packet, condition);
+        if (op.isEmpty() || opIndex == -1) {
+            error = QString("\"%1\" has no valid operator").arg(text);
+            return false;
+        }
+
+        // 3. Tách Key và Value
+        key = text.left(opIndex).trimmed();
+        valueStr = text.mid(opIndex + op.length()).trimmed();
     }
+    valueStr.remove('\"').remove('\'');
 
-    // 2. Xác định toán tử
-    QString op = "";
-    int opIndex = -1;
+    // 4. Trường -> loại điều kiện và kiểu giá trị mà trường nhận
+    ValueType type = VALUE_INT;
+    if (key == "stream") {
+        out.kind = Condition::STREAM;
+    } else if (key == "ip.addr" || key == "ip.src" || key == "ip.dst" ||
+               key == "ipv6.addr" || key == "ipv6.src" || key == "ipv6.dst") {
+        out.kind = Condition::IP;
+        type = VALUE_TEXT;
+    } else if (key == "tcp.port" || key == "udp.port" || key == "port") {
+        out.kind = Condition::PORT;
+    } else if (key == "frame.interface_id" || key == "interface") {
+        out.kind = Condition::INTERFACE;
+    } else if (key == "frame.len" || key == "length") {
+        out.kind = Condition::LENGTH;
+    } else if (key == "tls.handshake.type") {
+        out.kind = Condition::TLS;
+    } else if (isTlsTextField(key)) {
+        out.kind = Condition::TLS;
+        type = VALUE_TEXT;
+    } else if (key == "tcp.analysis.duplicate_ack_num" || key == "tcp.analysis.duplicate_ack_frame") {
+        out.kind = Condition::TCP_ANALYSIS;
+    } else if (isTcpAnalysisRtt(key)) {
+        out.kind = Condition::TCP_ANALYSIS;
+        type = VALUE_DOUBLE;
+    } else if (isTcpAnalysisFlag(key)) {
+        error = QString("\"%1\" is a flag and takes no operator").arg(key);
+        return false;
+    } else {
+        error = QString("\"%1\" is not a valid field").arg(key.isEmpty() ? text : key);
+        return false;
+    }
 
-    QStringList twoCharOps = {"==", "!=", ">=", "<="};
-    for (const QString& o : twoCharOps) {
-        opIndex = condition.indexOf(o);
-        if (opIndex != -1) {
-            op = o;
-            break;
-        }
+    // 5. Toán tử phải hợp với kiểu trường: "contains" chỉ cho chuỗi, so sánh lớn / nhỏ chỉ cho số
+    if (op == "contains" && (type != VALUE_TEXT || out.kind == Condition::IP)) {
+        error = QString("\"contains\" is not supported for field \"%1\"").arg(key);
+        return false;
+    }
+    if (isOrderingOp(op) && type == VALUE_TEXT) {
+        error = QString("\"%1\" is not supported for field \"%2\"").arg(op, key);
+        return false;
+    }
+    if (valueStr.isEmpty()) {
+        error = QString("\"%1\" has no value").arg(text);
+        return false;
+    }
+    bool ok = true;
+    if (type == VALUE_INT) valueStr.toInt(&ok);
+    if (type == VALUE_DOUBLE) valueStr.toDouble(&ok);
+    if (!ok) {
+        error = QString("\"%1\" is not a valid value for field \"%2\"").arg(valueStr, key);
+        return false;
     }
 
-    if (op.isEmpty()) {
-        if (condition.contains(">")) { op = ">"; opIndex = condition.indexOf(">"); }
-        else if (condition.contains("<")) { op = "<"; opIndex = condition.indexOf("<"); }
-        else if (condition.contains("=")) { op = "=="; opIndex = condition.indexOf("="); }
+    // Địa chỉ được parse ở đây, không phải mỗi gói: mọi cách viết của cùng một địa chỉ đều khớp
+    // ("fe80::1" như danh sách gói, hay đủ 8 nhóm như cửa sổ Conversations)
+    if (out.kind == Condition::IP) {
+        const bool ipv6 = key.startsWith("ipv6.");
+        if (inet_pton(ipv6 ? AF_INET6 : AF_INET, valueStr.toLatin1().constData(), out.address.data()) != 1) {
+            error = QString("\"%1\" is not a valid %2 address").arg(valueStr, ipv6 ? "IPv6" : "IPv4");
+            return false;
+        }
     }
 
-    if (op.isEmpty() || opIndex == -1) return false;
+    out.key = key;
+    out.op = op;
+    out.value = valueStr;
+    return true;
+}
 
-    // 3. Tách Key và Value
-    QString key = condition.left(opIndex).trimmed();
-    QString valueStr = condition.mid(opIndex + op.length()).trimmed();
-    valueStr.remove('\"').remove('\'');
+bool DisplayFilterEngine::matchSingleCondition(const PacketData& packet, const Condition& condition) const {
+    const QString& key = condition.key;
+    const QString& op = condition.op;
+    const QString& valueStr = condition.value;
 
-    // 4. Gọi hàm kiểm tra tương ứng
+    switch (condition.kind) {
+    case Condition::PROTOCOL:
+        return checkProtocol(packet, key);
 
     //  HỖ TRỢ LỌC STREAM ---
-    if (key == "stream") {
+    case Condition::STREAM:
         // Nếu gói tin không thuộc luồng nào (stream_index = -1) -> Không bao giờ khớp
         if (packet.stream_index < 0) return false;
 
         // So sánh (stream_index là số nguyên, dùng compareInt cho tiện)
         return compareInt((int)packet.stream_index, valueStr.toInt(), op);
-    }
-    // -------------------------------
 
-    if (key == "ip.addr" || key == "ip.src" || key == "ip.dst") {
-        return checkIp(packet, valueStr, key, op);
-    }
-    if (key == "tcp.port" || key == "udp.port" || key == "port") {
+    case Condition::IP:
+        return checkIp(packet, condition);
+    case Condition::PORT:
         return checkPort(packet, valueStr.toInt(), key, op);
-    }
-    if (key == "frame.len" || key == "length") {
+    case Condition::INTERFACE:
+        // Chỉ số interface khi bắt nhiều interface (đọc file: luôn 0)
+        return compareInt((int)packet.interface_id, valueStr.toInt(), op);
+    case Condition::LENGTH:
         return checkLength(packet, valueStr.toInt(), op);
+    case Condition::TLS:
+        return checkTls(packet, key, valueStr, op);
+    case Condition::TCP_ANALYSIS:
+        return checkTcpAnalysis(packet, key, valueStr, op);
     }
 
     return false;
 }
 
-bool DisplayFilterEngine::checkProtocol(const PacketData& packet, const QString& protocol) {
+bool DisplayFilterEngine::checkProtocol(const PacketData& packet, const QString& protocol) const {
     if (protocol == "http") return packet.app.protocol == "HTTP";
     if (protocol == "dns")  return packet.app.protocol == "DNS";
     if (protocol == "mdns") return packet.app.protocol == "MDNS";
@@ -118,7 +285,7 @@ bool DisplayFilterEngine::checkProtocol(const PacketData& packet, const QString&
     return false;
 }
 
-bool DisplayFilterEngine::compareInt(int val, int target, const QString& op) {
+bool DisplayFilterEngine::compareInt(int val, int target, const QString& op) const {
     if (op == "==") return val == target;
     if (op == "!=") return val != target;
     if (op == ">")  return val > target;
@@ -128,29 +295,57 @@ bool DisplayFilterEngine::compareInt(int val, int target, const QString& op) {
     return false;
 }
 
-bool DisplayFilterEngine::checkIp(const PacketData& packet, const QString& targetIp, const QString& type, const QString& op) {
-    if (!packet.is_ipv4) return false;
-    QString pktSrc = ipToString(packet.ipv4.src_ip);
-    QString pktDst = ipToString(packet.ipv4.dest_ip);
+bool DisplayFilterEngine::compareDouble(double val, double target, const QString& op) const {
+    if (op == "==") return val == target;
+    if (op == "!=") return val != target;
+    if (op == ">")  return val > target;
+    if (op == "<")  return val < target;
+    if (op == ">=") return val >= target;
+    if (op == "<=") return val <= target;
+    return false;
+}
 
-    bool matchSrc = (pktSrc == targetIp);
-    bool matchDst = (pktDst == targetIp);
+bool DisplayFilterEngine::checkIp(const PacketData& packet, const Condition& condition) const {
+    // So sánh 16 / 4 byte với địa chỉ đã parse khi dịch bộ lọc
+    const QString& type = condition.key;
+    const QString& op = condition.op;
+    const uint8_t* target = condition.address.data();
+    const bool ipv6 = type.startsWith("ipv6.");
+
+    const uint8_t* pktSrc;
+    const uint8_t* pktDst;
+    size_t len;
+    if (ipv6) {
+        if (!packet.is_ipv6) return false;
+        pktSrc = packet.ipv6.src_ip.data();
+        pktDst = packet.ipv6.dest_ip.data();
+        len = 16;
+    } else {
+        // src_ip / dest_ip giữ nguyên thứ tự byte mạng như inet_pton
+        if (!packet.is_ipv4) return false;
+        pktSrc = reinterpret_cast<const uint8_t*>(&packet.ipv4.src_ip);
+        pktDst = reinterpret_cast<const uint8_t*>(&packet.ipv4.dest_ip);
+        len = 4;
+    }
+
+    bool matchSrc = memcmp(pktSrc, target, len) == 0;
+    bool matchDst = memcmp(pktDst, target, len) == 0;
 
     if (op == "==") {
-        if (type == "ip.src") return matchSrc;
-        if (type == "ip.dst") return matchDst;
-        if (type == "ip.addr") return matchSrc || matchDst;
+        if (type.endsWith(".src")) return matchSrc;
+        if (type.endsWith(".dst")) return matchDst;
+        if (type.endsWith(".addr")) return matchSrc || matchDst;
     }
     else if (op == "!=") {
-        if (type == "ip.src") return !matchSrc;
-        if (type == "ip.dst") return !matchDst;
-        if (type == "ip.addr") return !matchSrc && !matchDst;
+        if (type.endsWith(".src")) return !matchSrc;
+        if (type.endsWith(".dst")) return !matchDst;
+        if (type.endsWith(".addr")) return !matchSrc && !matchDst;
     }
 
     return false;
 }
 
-bool DisplayFilterEngine::checkPort(const PacketData& packet, int targetPort, const QString& type, const QString& op) {
+bool DisplayFilterEngine::checkPort(const PacketData& packet, int targetPort, const QString& type, const QString& op) const {
     uint16_t src = 0, dst = 0;
     bool hasPort = false;
 
@@ -177,6 +372,80 @@ bool DisplayFilterEngine::checkPort(const PacketData& packet, int targetPort, co
     return srcMatch || dstMatch;
 }
 
-bool DisplayFilterEngine::checkLength(const PacketData& packet, int targetLen, const QString& op) {
+bool DisplayFilterEngine::checkLength(const PacketData& packet, int targetLen, const QString& op) const {
     return compareInt(packet.wire_length, targetLen, op);
 }
+
+bool DisplayFilterEngine::compareString(const QString& val, const QString& target, const QString& op) const {
+    if (op == "==") return val == target;
+    if (op == "!=") return val != target;
+    if (op == "contains") return val.contains(target);
+    return false;
+}
+
+bool DisplayFilterEngine::checkTcpAnalysis(const PacketData& packet, const QString& key, const QString& value, const QString& op) const {
+    if (!packet.is_tcp) return false;
+    const TCPAnalysis& a = packet.tcp_analysis;
+
+    // Trường số (có toán tử)
+    if (key == "tcp.analysis.duplicate_ack_num") {
+        if (!a.has(TCPAnalysis::DUPLICATE_ACK)) return false;
+        return compareInt(a.dup_ack_num, value.toInt(), op);
+    }
+    if (key == "tcp.analysis.duplicate_ack_frame") {
+        if (!a.has(TCPAnalysis::DUPLICATE_ACK)) return false;
+        return compareInt(a.dup_ack_frame, value.toInt(), op);
+    }
+
+    // Trường RTT (đơn vị giây, giống Wireshark): "tcp.analysis.ack_rtt > 0.2"
+    int64_t rttNs = -2;
+    if (key == "tcp.analysis.ack_rtt")     rttNs = a.ack_rtt_ns;
+    if (key == "tcp.analysis.ts_rtt")      rttNs = a.ts_rtt_ns;
+    if (key == "tcp.analysis.initial_rtt") rttNs = a.initial_rtt_ns;
+    if (rttNs != -2) {
+        if (rttNs < 0) return false;
+        if (op.isEmpty()) return true; // Chỉ kiểm tra sự tồn tại
+        return compareDouble(rttNs / 1e9, value.toDouble(), op);
+    }
+
+    if (!op.isEmpty()) return false;
+
+    // Trường cờ (không có toán tử): "tcp.analysis.retransmission"...
+    if (key == "tcp.analysis.flags")               return (a.flags & TCPAnalysis::PROBLEM_MASK) != 0;
+    if (key == "tcp.analysis.retransmission")      return a.has(TCPAnalysis::RETRANSMISSION);
+    if (key == "tcp.analysis.fast_retransmission") return a.has(TCPAnalysis::FAST_RETRANSMISSION);
+    if (key == "tcp.analysis.out_of_order")        return a.has(TCPAnalysis::OUT_OF_ORDER);
+    if (key == "tcp.analysis.lost_segment")        return a.has(TCPAnalysis::LOST_SEGMENT);
+    if (key == "tcp.analysis.ack_lost_segment")    return a.has(TCPAnalysis::ACKED_UNSEEN);
+    if (key == "tcp.analysis.duplicate_ack")       return a.has(TCPAnalysis::DUPLICATE_ACK);
+    if (key == "tcp.analysis.zero_window")         return a.has(TCPAnalysis::ZERO_WINDOW);
+    if (key == "tcp.analysis.window_full")         return a.has(TCPAnalysis::WINDOW_FULL);
+    if (key == "tcp.analysis.window_update")       return a.has(TCPAnalysis::WINDOW_UPDATE);
+    if (key == "tcp.analysis.keep_alive")          return a.has(TCPAnalysis::KEEP_ALIVE);
+    return false;
+}
+
+bool DisplayFilterEngine::checkTls(const PacketData& packet, const QString& key, const QString& value, const QString& op) const {
+    if (packet.app.protocol != "TLS") return false;
+
+    if (key == "tls.handshake.type") {
+        return compareInt(packet.app.tls_handshake_type, value.toInt(), op);
+    }
+
+    // (Filter đã được toLower() nên so sánh trên chuỗi chữ thường)
+    std::string field;
+    if (key == "tls.sni" || key == "tls.handshake.extensions_server_name") {
+        field = packet.app.tls_sni;
+    } else if (key == "tls.alpn" || key == "tls.handshake.extensions_alpn_str") {
+        field = packet.app.tls_alpn;
+    } else if (key == "tls.ja3" || key == "tls.handshake.ja3_hash") {
+        field = packet.app.tls_ja3_hash;
+    } else if (key == "tls.ja4" || key == "tls.handshake.ja4") {
+        field = packet.app.tls_ja4;
+    } else {
+        return false;
+    }
+
+    if (field.empty()) return false;
+    return compareString(QString::fromStdString(field).toLower(), value, op);
+}
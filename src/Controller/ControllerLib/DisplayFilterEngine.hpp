@@ -2,26 +2,57 @@
 #define DISPLAYFILTERENGINE_HPP
 
 #include <QString>
+#include <array>
+#include <vector>
 #include "../../Common/PacketData.hpp"
 
+/**
+ * @brief Display filter: dịch chuỗi lọc một lần khi đặt (setFilter), rồi so từng gói với dạng đã dịch.
+ *
+ * Cặp trường / toán tử không hỗ trợ (vd: "ip.addr contains 10", "tcp.port > abc") bị từ chối
+ * ngay khi đặt, kèm lý do để thanh lọc báo lỗi, thay vì âm thầm không khớp gói nào.
+ * match() không thay đổi trạng thái: nhiều luồng có thể dùng chung một bộ lọc đã dịch.
+ */
 class DisplayFilterEngine {
 public:
     DisplayFilterEngine();
 
-    // Hàm chính: Xử lý logic AND (&&) và OR (||)
-    bool match(const PacketData& packet, const QString& filterText);
+    // Dịch bộ lọc (chuỗi rỗng = mọi gói). Lỗi: trả về false, ghi lý do vào 'error'
+    // và bộ lọc không khớp gói nào cho tới lần đặt tiếp theo
+    bool setFilter(const QString& filterText, QString* error = nullptr);
+    bool isEmpty() const { return m_valid && m_orBlocks.empty(); }
+
+    // Hàm chính: Xử lý logic AND (&&) và OR (||) trên bộ lọc đã dịch
+    bool match(const PacketData& packet) const;
 
 private:
-    // Hàm kiểm tra điều kiện đơn (Code cũ của chúng ta chuyển vào đây)
-    // Ví dụ: check "tcp.port == 80" hoặc "http"
-    bool matchSingleCondition(const PacketData& packet, const QString& condition);
-
-    bool checkProtocol(const PacketData& packet, const QString& protocol);
-    bool checkIp(const PacketData& packet, const QString& targetIp, const QString& type, const QString& op);
-    bool checkPort(const PacketData& packet, int targetPort, const QString& type, const QString& op);
-    bool checkLength(const PacketData& packet, int targetLen, const QString& op);
-    bool compareInt(int val1, int val2, const QString& op);
-    QString ipToString(uint32_t ip);
+    // Một điều kiện đơn đã dịch, vd: "tcp.port == 80" hoặc "http"
+    struct Condition {
+        enum Kind : uint8_t { PROTOCOL, TCP_ANALYSIS, STREAM, IP, PORT, INTERFACE, LENGTH, TLS };
+        Kind kind = PROTOCOL;
+        QString key;       // Tên trường (hoặc tên giao thức với PROTOCOL)
+        QString op;        // "==", "!=", ">", "<", ">=", "<=", "contains"; rỗng = chỉ kiểm tra sự tồn tại
+        QString value;     // Giá trị đã bỏ dấu nháy
+        // IP: địa chỉ đã parse một lần khi dịch (thứ tự byte mạng; IPv4 dùng 4 byte đầu)
+        std::array<uint8_t, 16> address{};
+    };
+
+    static bool parseCondition(const QString& text, Condition& out, QString& error);
+    bool matchSingleCondition(const PacketData& packet, const Condition& condition) const;
+
+    bool checkProtocol(const PacketData& packet, const QString& protocol) const;
+    bool checkIp(const PacketData& packet, const Condition& condition) const;
+    bool checkPort(const PacketData& packet, int targetPort, const QString& type, const QString& op) const;
+    bool checkLength(const PacketData& packet, int targetLen, const QString& op) const;
+    bool checkTcpAnalysis(const PacketData& packet, const QString& key, const QString& value, const QString& op) const;
+    bool checkTls(const PacketData& packet, const QString& key, const QString& value, const QString& op) const;
+    bool compareInt(int val1, int val2, const QString& op) const;
+    bool compareDouble(double val, double target, const QString& op) const;
+    bool compareString(const QString& val, const QString& target, const QString& op) const;
+
+    // OR của các khối AND
+    std::vector<std::vector<Condition>> m_orBlocks;
+    bool m_valid = true;
 };
 
 #endif // DISPLAYFILTERENGINE_HPP
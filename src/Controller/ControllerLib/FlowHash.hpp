@@ -0,0 +1,79 @@
+#ifndef FLOWHASH_HPP
+#define FLOWHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+/**
+ * @brief SipHash-1-3 (khóa 128-bit) cho khóa luồng.
+ *
+ * Có khóa bí mật ngẫu nhiên nên kẻ tấn công không thể chọn trước các 5-tuple
+ * va chạm nhau (hash flooding); đồng thời (A,B) và (B,A) không còn triệt tiêu như khi XOR.
+ */
+class FlowHash {
+public:
+    FlowHash() : m_k0(randomSeed()), m_k1(randomSeed()) {}
+    FlowHash(uint64_t k0, uint64_t k1) : m_k0(k0), m_k1(k1) {}
+
+    uint64_t operator()(const void* data, size_t len) const { return sipHash13(m_k0, m_k1, data, len); }
+
+    static uint64_t sipHash13(uint64_t k0, uint64_t k1, const void* data, size_t len) {
+        const uint8_t* in = static_cast<const uint8_t*>(data);
+        uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+        uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+        uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+        uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+        const size_t blocks = len / 8;
+        for (size_t i = 0; i < blocks; ++i) {
+            uint64_t m;
+            memcpy(&m, in + i * 8, 8); // Little-endian (x86/ARM)
+            v3 ^= m;
+            sipRound(v0, v1, v2, v3);
+            v0 ^= m;
+        }
+
+        uint64_t b = static_cast<uint64_t>(len) << 56;
+        const uint8_t* tail = in + blocks * 8;
+        for (size_t i = 0; i < (len & 7); ++i) {
+            b |= static_cast<uint64_t>(tail[i]) << (8 * i);
+        }
+        v3 ^= b;
+        sipRound(v0, v1, v2, v3);
+        v0 ^= b;
+
+        v2 ^= 0xff;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+    // Khóa ngẫu nhiên dùng chung cho cả tiến trình (cho qHash)
+    static uint64_t processSeed() {
+        static const uint64_t seed = randomSeed();
+        return seed;
+    }
+
+private:
+    static inline uint64_t rotl(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+
+    static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    }
+
+    static uint64_t randomSeed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+
+    uint64_t m_k0;
+    uint64_t m_k1;
+};
+
+#endif // FLOWHASH_HPP
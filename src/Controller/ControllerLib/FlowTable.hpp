@@ -0,0 +1,215 @@
+#ifndef FLOWTABLE_HPP
+#define FLOWTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "FlowHash.hpp"
+#include "StreamID.hpp"
+
+/**
+ * @brief Bảng luồng địa chỉ mở (open addressing) cho StreamID.
+ *
+ * - Mảng bucket 8 byte (tag 31-bit của hash + chỉ số bản ghi), dò tuyến tính,
+ *   hệ số tải tối đa 3/4: một lần tra cứu thường chỉ chạm 1 cache line của bucket.
+ * - Bản ghi (khóa + giá trị) nằm liền nhau trong một vector dày đặc, duyệt nhanh
+ *   và không có lỗ; xóa bằng cách dời phần tử cuối vào chỗ trống.
+ * - Xóa bucket bằng backward-shift (không dùng tombstone).
+ * - Hash SipHash-1-3 với khóa ngẫu nhiên cho mỗi bảng (chống hash flooding).
+ * - Danh sách LRU nội tại (chỉ số prev/next trong bản ghi): findOrInsert() đưa bản ghi
+ *   lên đầu, oldest() trả về bản ghi lâu nhất không được dùng. Mọi thao tác O(1).
+ *
+ * Con trỏ trả về bởi find()/findOrInsert() mất hiệu lực sau lần chèn / xóa kế tiếp.
+ */
+template <typename V>
+class FlowTable {
+public:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Entry {
+        StreamID key;
+        V value;
+        uint32_t tag = 0;
+        uint32_t lru_prev = NIL;  // Mới hơn
+        uint32_t lru_next = NIL;  // Cũ hơn
+    };
+
+    explicit FlowTable(size_t initialCapacity = 1024) { rebuild(roundUp(initialCapacity)); }
+    FlowTable(size_t initialCapacity, uint64_t k0, uint64_t k1) : m_hasher(k0, k1) { rebuild(roundUp(initialCapacity)); }
+
+    V* find(const StreamID& key) {
+        size_t pos;
+        return locate(key, makeTag(key), pos) ? &m_entries[m_buckets[pos].index].value : nullptr;
+    }
+    const V* find(const StreamID& key) const {
+        size_t pos;
+        return locate(key, makeTag(key), pos) ? &m_entries[m_buckets[pos].index].value : nullptr;
+    }
+
+    /**
+     * @brief Tìm hoặc tạo mới (giá trị mặc định).
+     * @param inserted (tùy chọn) true nếu bản ghi vừa được tạo.
+     */
+    V& findOrInsert(const StreamID& key, bool* inserted = nullptr) {
+        const uint32_t tag = makeTag(key);
+        size_t pos;
+        if (locate(key, tag, pos)) {
+            if (inserted) *inserted = false;
+            const uint32_t idx = m_buckets[pos].index;
+            if (idx != m_lruHead) { unlink(idx); pushFront(idx); }
+            return m_entries[idx].value;
+        }
+        if ((m_entries.size() + 1) * 4 > m_buckets.size() * 3) {
+            rebuild(m_buckets.size() * 2);
+            locate(key, tag, pos); // Tìm lại bucket trống sau khi mở rộng
+        }
+        const uint32_t idx = static_cast<uint32_t>(m_entries.size());
+        m_buckets[pos] = { tag, idx };
+        m_entries.push_back(Entry{ key, V{}, tag, NIL, NIL });
+        pushFront(idx);
+        if (inserted) *inserted = true;
+        return m_entries.back().value;
+    }
+
+    bool erase(const StreamID& key) {
+        size_t pos;
+        if (!locate(key, makeTag(key), pos)) return false;
+        eraseBucket(pos);
+        return true;
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_lruHead = m_lruTail = NIL;
+        rebuild(MIN_CAPACITY);
+    }
+
+    void reserve(size_t flows) {
+        size_t needed = roundUp(flows * 4 / 3 + 1);
+        if (needed > m_buckets.size()) rebuild(needed);
+        m_entries.reserve(flows);
+    }
+
+    size_t size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.empty(); }
+    size_t capacity() const { return m_buckets.size(); }
+
+    // Bản ghi lâu nhất chưa được findOrInsert() chạm tới (nullptr nếu bảng rỗng)
+    const Entry* oldest() const { return m_lruTail == NIL ? nullptr : &m_entries[m_lruTail]; }
+
+    // Duyệt các bản ghi (thứ tự không xác định)
+    const Entry& entryAt(size_t i) const { return m_entries[i]; }
+    Entry& entryAt(size_t i) { return m_entries[i]; }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (const Entry& e : m_entries) f(e.key, e.value);
+    }
+
+    // Duyệt theo thứ tự LRU, từ bản ghi mới dùng nhất; dừng khi f(key, value) trả về false
+    template <typename F>
+    void forEachRecent(F&& f) {
+        for (uint32_t i = m_lruHead; i != NIL; i = m_entries[i].lru_next) {
+            if (!f(m_entries[i].key, m_entries[i].value)) break;
+        }
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr uint32_t EMPTY = 0;
+
+    struct Bucket {
+        uint32_t tag = EMPTY;   // Bit cao luôn bật với bucket đã dùng
+        uint32_t index = 0;     // Vị trí trong m_entries
+    };
+
+    static size_t roundUp(size_t n) {
+        size_t cap = MIN_CAPACITY;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    uint32_t makeTag(const StreamID& key) const {
+        return static_cast<uint32_t>(hashStreamID(key, m_hasher)) | 0x80000000u;
+    }
+
+    // true nếu tìm thấy (pos = bucket chứa khóa); false thì pos = bucket trống để chèn
+    bool locate(const StreamID& key, uint32_t tag, size_t& pos) const {
+        size_t i = tag & m_mask;
+        while (true) {
+            const Bucket& b = m_buckets[i];
+            if (b.tag == EMPTY) { pos = i; return false; }
+            if (b.tag == tag && m_entries[b.index].key == key) { pos = i; return true; }
+            i = (i + 1) & m_mask;
+        }
+    }
+
+    void eraseBucket(size_t pos) {
+        const uint32_t removed = m_buckets[pos].index;
+
+        // 1. Backward-shift: kéo các phần tử phía sau về lấp chỗ trống
+        size_t hole = pos;
+        size_t k = (pos + 1) & m_mask;
+        while (m_buckets[k].tag != EMPTY) {
+            size_t home = m_buckets[k].tag & m_mask;
+            if (((k - home) & m_mask) >= ((k - hole) & m_mask)) {
+                m_buckets[hole] = m_buckets[k];
+                hole = k;
+            }
+            k = (k + 1) & m_mask;
+        }
+        m_buckets[hole] = Bucket{};
+
+        // 2. Dời bản ghi cuối vào vị trí bị xóa để vector luôn liền mạch
+        unlink(removed);
+        const uint32_t last = static_cast<uint32_t>(m_entries.size() - 1);
+        if (removed != last) {
+            size_t i = m_entries[last].tag & m_mask;
+            while (m_buckets[i].index != last || m_buckets[i].tag == EMPTY) i = (i + 1) & m_mask;
+            m_buckets[i].index = removed;
+            m_entries[removed] = std::move(m_entries[last]);
+
+            // Sửa liên kết LRU trỏ tới vị trí cũ
+            Entry& moved = m_entries[removed];
+            if (moved.lru_prev != NIL) m_entries[moved.lru_prev].lru_next = removed; else m_lruHead = removed;
+            if (moved.lru_next != NIL) m_entries[moved.lru_next].lru_prev = removed; else m_lruTail = removed;
+        }
+        m_entries.pop_back();
+    }
+
+    void unlink(uint32_t idx) {
+        Entry& e = m_entries[idx];
+        if (e.lru_prev != NIL) m_entries[e.lru_prev].lru_next = e.lru_next; else m_lruHead = e.lru_next;
+        if (e.lru_next != NIL) m_entries[e.lru_next].lru_prev = e.lru_prev; else m_lruTail = e.lru_prev;
+        e.lru_prev = e.lru_next = NIL;
+    }
+
+    void pushFront(uint32_t idx) {
+        Entry& e = m_entries[idx];
+        e.lru_prev = NIL;
+        e.lru_next = m_lruHead;
+        if (m_lruHead != NIL) m_entries[m_lruHead].lru_prev = idx;
+        m_lruHead = idx;
+        if (m_lruTail == NIL) m_lruTail = idx;
+    }
+
+    void rebuild(size_t capacity) {
+        m_buckets.assign(capacity, Bucket{});
+        m_mask = capacity - 1;
+        for (size_t idx = 0; idx < m_entries.size(); ++idx) {
+            size_t i = m_entries[idx].tag & m_mask;
+            while (m_buckets[i].tag != EMPTY) i = (i + 1) & m_mask;
+            m_buckets[i] = { m_entries[idx].tag, static_cast<uint32_t>(idx) };
+        }
+    }
+
+    FlowHash m_hasher;
+    std::vector<Bucket> m_buckets;
+    std::vector<Entry> m_entries;
+    size_t m_mask = 0;
+    uint32_t m_lruHead = NIL;  // Mới dùng nhất
+    uint32_t m_lruTail = NIL;  // Lâu nhất
+};
+
+#endif // FLOWTABLE_HPP
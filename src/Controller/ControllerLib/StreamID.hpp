@@ -0,0 +1,73 @@
+#ifndef STREAMID_HPP
+#define STREAMID_HPP
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include "FlowHash.hpp"
+
+/**
+ * @brief Định danh luồng hỗ trợ cả IPv4 và IPv6
+ */
+struct StreamID {
+    // Dùng mảng 16 byte để chứa IP (IPv4 sẽ dùng 4 byte đầu hoặc map sang v6)
+    std::array<uint8_t, 16> ip1{};
+    std::array<uint8_t, 16> ip2{};
+    quint16 port1 = 0;
+    quint16 port2 = 0;
+    quint8 protocol = 0;
+    bool is_ipv6 = false; // Cờ đánh dấu
+
+    // Toán tử so sánh bằng (Bắt buộc cho QHash)
+    bool operator==(const StreamID& other) const {
+        return ip1 == other.ip1 && ip2 == other.ip2 &&
+               port1 == other.port1 && port2 == other.port2 &&
+               protocol == other.protocol && is_ipv6 == other.is_ipv6;
+    }
+};
+
+// Gói các trường của khóa vào bộ đệm liền mạch (không lẫn byte padding của struct).
+// IPv4 chỉ dùng 4 byte đầu của mỗi địa chỉ -> khóa 13 byte, băm nhanh hơn.
+inline size_t packStreamID(const StreamID& key, uint8_t out[38]) {
+    const size_t ipLen = key.is_ipv6 ? 16 : 4;
+    memcpy(out, key.ip1.data(), ipLen);
+    memcpy(out + ipLen, key.ip2.data(), ipLen);
+    uint8_t* p = out + 2 * ipLen;
+    memcpy(p, &key.port1, 2);
+    memcpy(p + 2, &key.port2, 2);
+    p[4] = key.protocol;
+    if (!key.is_ipv6) return 2 * ipLen + 5;
+    p[5] = 1;
+    return 2 * ipLen + 6;
+}
+
+// Hàm băm có khóa (SipHash) cho bảng luồng
+inline uint64_t hashStreamID(const StreamID& key, const FlowHash& hasher) {
+    uint8_t buf[38];
+    size_t len = packStreamID(key, buf);
+    return hasher(buf, len);
+}
+
+// Địa chỉ dạng chuỗi (IPv6 viết đủ 8 nhóm hex, không rút gọn "::") - dùng chung cho UI và bộ lọc
+inline QString streamAddressToString(const std::array<uint8_t, 16>& ip, bool isIpv6) {
+    if (!isIpv6) {
+        return QString("%1.%2.%3.%4").arg(ip[0]).arg(ip[1]).arg(ip[2]).arg(ip[3]);
+    }
+    QStringList groups;
+    for (int i = 0; i < 16; i += 2) {
+        groups << QString::number((ip[i] << 8) | ip[i + 1], 16);
+    }
+    return groups.join(":");
+}
+
+// Hàm băm chính cho StreamID (QHash)
+inline size_t qHash(const StreamID& key, size_t seed = 0) {
+    uint8_t buf[38];
+    size_t len = packStreamID(key, buf);
+    return static_cast<size_t>(FlowHash::sipHash13(FlowHash::processSeed(), seed, buf, len));
+}
+
+#endif // STREAMID_HPP
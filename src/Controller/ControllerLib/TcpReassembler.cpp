@@ -0,0 +1,463 @@
+#include "TcpReassembler.hpp"
+#include "../../Core/Protocols/ApplicationLayer/HTTPParser.hpp"
+#include "../../Core/Protocols/ApplicationLayer/TLSParser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string>
+
+// --- Các hằng số giới hạn ---
+static constexpr uint32_t MAX_SEQ_GAP          = 16 * 1024 * 1024; // Segment xa hơn mức này coi như rác
+static constexpr size_t   MAX_PENDING_BYTES    = 256 * 1024;       // Chờ lấp lỗ hổng tối đa / chiều
+static constexpr size_t   MAX_PENDING_SEGMENTS = 512;
+static constexpr size_t   MAX_HTTP_HEADER      = 64 * 1024;
+static constexpr size_t   MAX_CHUNK_LINE       = 1024;
+static constexpr size_t   MAX_TLS_RECORD       = 16384 + 2048;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static const size_t NPOS = static_cast<size_t>(-1);
+
+static size_t findBytes(const std::vector<uint8_t>& buf, size_t from, const char* pattern, size_t patLen) {
+    if (buf.size() < patLen) return NPOS;
+    for (size_t i = from; i + patLen <= buf.size(); ++i) {
+        if (memcmp(buf.data() + i, pattern, patLen) == 0) return i;
+    }
+    return NPOS;
+}
+
+// Dòng byte có bắt đầu bằng một HTTP request/response không (cần ít nhất 8 byte)
+static bool startsWithHttp(const uint8_t* p, size_t len) {
+    static const char* starts[] = {
+        "GET ", "POST ", "PUT ", "DELETE ", "HEAD ", "OPTIONS ", "PATCH ", "HTTP/1."
+    };
+    for (const char* s : starts) {
+        size_t n = strlen(s);
+        if (len >= n && memcmp(p, s, n) == 0) return true;
+    }
+    return false;
+}
+
+static bool looksLikeTlsRecord(const uint8_t* p) {
+    return p[0] >= 20 && p[0] <= 24 && p[1] == 3 && p[2] <= 4;
+}
+
+// Lấy giá trị của một header (không phân biệt hoa thường) trong khối header HTTP
+static bool findHeaderValue(const std::string& lowerHeaders, const std::string& name, std::string& value) {
+    size_t pos = lowerHeaders.find("\r\n" + name + ":");
+    if (pos == std::string::npos) return false;
+    pos += name.size() + 3;
+    size_t end = lowerHeaders.find("\r\n", pos);
+    if (end == std::string::npos) end = lowerHeaders.size();
+    value = lowerHeaders.substr(pos, end - pos);
+    value.erase(0, value.find_first_not_of(" \t"));
+    return true;
+}
+
+// --- Triển khai (Implementation) ---
+
+TcpReassembler::TcpReassembler()
+    : m_perFlowLimit(DEFAULT_PER_FLOW_LIMIT),
+    m_globalLimit(DEFAULT_GLOBAL_LIMIT)
+{
+}
+
+void TcpReassembler::setMemoryLimits(size_t perFlowBytes, size_t globalBytes)
+{
+    m_perFlowLimit = perFlowBytes;
+    m_globalLimit = std::max(globalBytes, perFlowBytes);
+    enforceGlobalLimit();
+}
+
+void TcpReassembler::clear()
+{
+    m_flows.clear();
+    m_lru.clear();
+    m_totalBytes = 0;
+    m_evictedFlows = 0;
+}
+
+void TcpReassembler::removeFlow(const StreamID& id)
+{
+    dropFlow(id);
+}
+
+void TcpReassembler::dropFlow(const StreamID& id)
+{
+    auto it = m_flows.find(id);
+    if (it == m_flows.end()) return;
+    m_totalBytes -= it.value().bytes;
+    m_lru.erase(it.value().lru_it);
+    m_flows.erase(it);
+}
+
+void TcpReassembler::enforceGlobalLimit()
+{
+    // Luồng vừa xử lý luôn ở cuối danh sách LRU nên không bị evict
+    while (m_totalBytes > m_globalLimit && m_lru.size() > 1) {
+        StreamID victim = m_lru.front();
+        dropFlow(victim);
+        m_evictedFlows++;
+    }
+}
+
+bool TcpReassembler::processSegment(const StreamID& id, bool reversed, PacketData& packet)
+{
+    if (!packet.is_tcp) return false;
+
+    const uint8_t flags = packet.tcp.flags;
+    const bool isSyn = flags & TCPHeader::SYN;
+    if (packet.tcp_segment_length == 0 && !isSyn) return false; // Không có dữ liệu, không cần tạo luồng
+
+    auto it = m_flows.find(id);
+    if (it == m_flows.end()) {
+        Flow newFlow;
+        newFlow.bytes = sizeof(Flow);
+        m_lru.push_back(id);
+        newFlow.lru_it = std::prev(m_lru.end());
+        m_totalBytes += newFlow.bytes;
+        it = m_flows.insert(id, newFlow);
+    }
+    Flow& flow = it.value();
+    m_lru.splice(m_lru.end(), m_lru, flow.lru_it);
+
+    const int d = reversed ? 1 : 0;
+    if (flow.client_dir < 0) {
+        // SYN-ACK đi từ Server; các trường hợp khác coi bên gửi gói đầu là Client
+        flow.client_dir = (isSyn && (flags & TCPHeader::ACK)) ? 1 - d : d;
+    }
+
+    Direction& dir = flow.dir[d];
+    uint32_t seq = packet.tcp.seq_num;
+    if (isSyn) {
+        if (!dir.seeded || dir.next_offset == 0) {
+            dir.seeded = true;
+            dir.next_seq = seq + 1;
+        }
+        seq += 1; // SYN chiếm 1 sequence number (dữ liệu TFO bắt đầu sau đó)
+    } else if (!dir.seeded) {
+        // Bắt giữa chừng: lấy segment đầu tiên làm mốc
+        dir.seeded = true;
+        dir.next_seq = seq;
+    }
+
+    // Gói bị cắt bởi snaplen: phần thiếu coi như bị mất
+    size_t n = packet.payloadAvailable();
+    size_t lost = packet.tcp_segment_length > n ? packet.tcp_segment_length - n : 0;
+    if (n + lost == 0) return false;
+
+    const uint8_t* p = packet.payloadData();
+    const size_t contribStart = dir.data.size();
+
+    int32_t delta = static_cast<int32_t>(seq - dir.next_seq);
+    if (delta < 0) {
+        // Truyền lại (toàn bộ hoặc một phần chồng lấn): bỏ phần đã có
+        size_t overlap = static_cast<size_t>(-static_cast<int64_t>(delta));
+        if (overlap >= n) return false;
+        p += overlap;
+        n -= overlap;
+        delta = 0;
+    }
+
+    if (delta > 0) {
+        // Đến sớm (out-of-order): giữ lại chờ lấp lỗ hổng
+        if (static_cast<uint32_t>(delta) > MAX_SEQ_GAP || lost > 0) return false;
+
+        uint64_t key = dir.next_offset + static_cast<uint32_t>(delta);
+        auto pit = dir.pending.find(key);
+        if (pit != dir.pending.end()) {
+            if (pit->second.size() >= n) return false; // Bản truyền lại của segment đang chờ
+            dir.pending_bytes -= pit->second.size();
+            flow.bytes -= pit->second.size();
+            m_totalBytes -= pit->second.size();
+        }
+        dir.pending[key].assign(p, p + n);
+        dir.pending_bytes += n;
+        flow.bytes += n;
+        m_totalBytes += n;
+
+        // Chờ quá lâu: coi như lỗ hổng bị mất hẳn (không bắt được gói)
+        if (dir.pending_bytes > MAX_PENDING_BYTES || dir.pending.size() > MAX_PENDING_SEGMENTS) {
+            skipGap(flow, d);
+        }
+    } else {
+        append(flow, d, p, n);
+        if (lost > 0) {
+            dir.next_offset += lost;
+            dir.next_seq += static_cast<uint32_t>(lost);
+            dir.missing += lost;
+            dir.mode = APP_NONE;
+        }
+        drainPending(flow, d);
+    }
+
+    bool completed = dissect(dir, contribStart, packet);
+    if (completed) {
+        packet.is_reassembled_pdu = true;
+    }
+
+    enforceGlobalLimit(); // (Không dùng 'flow' sau dòng này)
+    return completed;
+}
+
+void TcpReassembler::append(Flow& flow, int d, const uint8_t* p, size_t n)
+{
+    Direction& dir = flow.dir[d];
+    dir.next_offset += n;
+    dir.next_seq += static_cast<uint32_t>(n);
+
+    // Giới hạn bộ nhớ của luồng: vượt quá thì ngừng lưu (vẫn theo dõi sequence)
+    size_t room = (flow.truncated || flow.bytes >= m_perFlowLimit) ? 0 : m_perFlowLimit - flow.bytes;
+    size_t store = std::min(n, room);
+    if (store < n) {
+        flow.truncated = true;
+        dir.mode = APP_NONE;
+    }
+    if (store == 0) return;
+
+    uint64_t offset = dir.data.size();
+    dir.data.insert(dir.data.end(), p, p + store);
+    flow.bytes += store;
+    m_totalBytes += store;
+
+    if (!flow.chunks.empty() && dir.missing == 0) {
+        TcpStreamChunk& last = flow.chunks.back();
+        if (last.direction == d && last.offset + last.length == offset) {
+            last.length += static_cast<uint32_t>(store);
+            return;
+        }
+    }
+    TcpStreamChunk chunk;
+    chunk.direction = static_cast<uint8_t>(d);
+    chunk.offset = offset;
+    chunk.length = static_cast<uint32_t>(store);
+    chunk.missing_before = dir.missing;
+    dir.missing = 0;
+    flow.chunks.push_back(chunk);
+    flow.bytes += sizeof(TcpStreamChunk);
+    m_totalBytes += sizeof(TcpStreamChunk);
+}
+
+void TcpReassembler::drainPending(Flow& flow, int d)
+{
+    Direction& dir = flow.dir[d];
+    while (!dir.pending.empty()) {
+        auto it = dir.pending.begin();
+        if (it->first > dir.next_offset) break; // Vẫn còn lỗ hổng
+
+        uint64_t start = it->first;
+        std::vector<uint8_t> segment = std::move(it->second);
+        dir.pending.erase(it);
+        dir.pending_bytes -= segment.size();
+        flow.bytes -= segment.size();
+        m_totalBytes -= segment.size();
+
+        uint64_t end = start + segment.size();
+        if (end > dir.next_offset) {
+            size_t skip = static_cast<size_t>(dir.next_offset - start);
+            append(flow, d, segment.data() + skip, segment.size() - skip);
+        }
+    }
+}
+
+void TcpReassembler::skipGap(Flow& flow, int d)
+{
+    Direction& dir = flow.dir[d];
+    if (dir.pending.empty()) return;
+
+    uint64_t gap = dir.pending.begin()->first - dir.next_offset;
+    dir.next_offset += gap;
+    dir.next_seq += static_cast<uint32_t>(gap);
+    dir.missing += gap;
+    dir.mode = APP_NONE; // Mất dữ liệu: không thể cắt PDU chính xác nữa
+    drainPending(flow, d);
+}
+
+bool TcpReassembler::dissect(Direction& dir, size_t contribStart, PacketData& packet)
+{
+    if (dir.mode == APP_UNKNOWN) {
+        size_t avail = dir.data.size() - dir.pdu_start;
+        if (avail < 8) return false; // Chờ thêm dữ liệu để nhận dạng
+
+        const uint8_t* p = dir.data.data() + dir.pdu_start;
+        if (looksLikeTlsRecord(p)) {
+            dir.mode = APP_TLS;
+        } else if (startsWithHttp(p, avail)) {
+            dir.mode = APP_HTTP;
+        } else {
+            dir.mode = APP_NONE;
+        }
+    }
+
+    if (dir.mode == APP_HTTP) return dissectHttp(dir, contribStart, packet);
+    if (dir.mode == APP_TLS)  return dissectTls(dir, contribStart, packet);
+    return false;
+}
+
+bool TcpReassembler::dissectHttp(Direction& dir, size_t contribStart, PacketData& packet)
+{
+    bool completed = false;
+
+    while (dir.mode == APP_HTTP && dir.pdu_start < dir.data.size()) {
+        const size_t end = dir.data.size();
+
+        // 1. Bỏ qua body (Content-Length hoặc dữ liệu của một chunk)
+        if (dir.body_remaining > 0) {
+            size_t take = static_cast<size_t>(std::min<uint64_t>(dir.body_remaining, end - dir.pdu_start));
+            dir.pdu_start += take;
+            dir.body_remaining -= take;
+            dir.scan_pos = dir.pdu_start;
+            continue;
+        }
+
+        // 2. Body dạng chunked: đọc từng dòng kích thước
+        if (dir.chunked) {
+            size_t eol = findBytes(dir.data, dir.pdu_start, "\r\n", 2);
+            if (eol == NPOS) {
+                if (end - dir.pdu_start > MAX_CHUNK_LINE) dir.mode = APP_NONE;
+                break;
+            }
+            if (dir.chunk_trailer) {
+                bool emptyLine = (eol == dir.pdu_start);
+                dir.pdu_start = eol + 2;
+                if (emptyLine) {
+                    dir.chunked = false;
+                    dir.chunk_trailer = false;
+                }
+            } else {
+                uint64_t size = 0;
+                size_t digits = 0;
+                for (size_t i = dir.pdu_start; i < eol && isxdigit(dir.data[i]); ++i, ++digits) {
+                    size = size * 16 + static_cast<uint64_t>(isdigit(dir.data[i]) ? dir.data[i] - '0'
+                                                                                 : (tolower(dir.data[i]) - 'a' + 10));
+                }
+                if (digits == 0 || digits > 15) {
+                    dir.mode = APP_NONE;
+                    break;
+                }
+                dir.pdu_start = eol + 2;
+                if (size == 0) dir.chunk_trailer = true;
+                else dir.body_remaining = size + 2; // Dữ liệu + CRLF
+            }
+            dir.scan_pos = dir.pdu_start;
+            continue;
+        }
+
+        // 3. Header của message mới
+        if (end - dir.pdu_start < 8) break;
+        if (!startsWithHttp(dir.data.data() + dir.pdu_start, end - dir.pdu_start)) {
+            dir.mode = APP_NONE;
+            break;
+        }
+
+        size_t from = std::max(dir.pdu_start, dir.scan_pos >= 3 ? dir.scan_pos - 3 : 0);
+        size_t pos = findBytes(dir.data, from, "\r\n\r\n", 4);
+        if (pos == NPOS) {
+            dir.scan_pos = end;
+            if (end - dir.pdu_start > MAX_HTTP_HEADER) dir.mode = APP_NONE;
+            break;
+        }
+        size_t headerEnd = pos + 4;
+        const uint8_t* header = dir.data.data() + dir.pdu_start;
+        size_t headerLen = headerEnd - dir.pdu_start;
+
+        // Header trải trên nhiều segment: gói này là gói hoàn tất -> dissect lại
+        if (dir.pdu_start < contribStart) {
+            ApplicationLayer app;
+            if (HTTPParser::parse(app, header, headerLen)) {
+                packet.app = app;
+                completed = true;
+            }
+        }
+
+        // Xác định độ dài body
+        std::string lower(reinterpret_cast<const char*>(header), headerLen);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+        bool isResponse = lower.compare(0, 5, "http/") == 0;
+        int status = 0;
+        if (isResponse) {
+            size_t sp = lower.find(' ');
+            if (sp != std::string::npos) status = atoi(lower.c_str() + sp + 1);
+        }
+
+        dir.pdu_start = headerEnd;
+        dir.scan_pos = headerEnd;
+
+        std::string value;
+        if (isResponse && (status / 100 == 1 || status == 204 || status == 304)) {
+            // Không có body
+        } else if (findHeaderValue(lower, "transfer-encoding", value) &&
+                   value.find("chunked") != std::string::npos) {
+            dir.chunked = true;
+        } else if (findHeaderValue(lower, "content-length", value)) {
+            dir.body_remaining = strtoull(value.c_str(), nullptr, 10);
+        } else if (isResponse) {
+            // Body kéo dài đến khi đóng kết nối: không cắt tiếp được
+            dir.mode = APP_NONE;
+        }
+    }
+
+    return completed;
+}
+
+bool TcpReassembler::dissectTls(Direction& dir, size_t contribStart, PacketData& packet)
+{
+    bool completed = false;
+
+    while (dir.mode == APP_TLS) {
+        size_t avail = dir.data.size() - dir.pdu_start;
+        if (avail < 5) break;
+
+        const uint8_t* record = dir.data.data() + dir.pdu_start;
+        if (!looksLikeTlsRecord(record)) {
+            dir.mode = APP_NONE;
+            break;
+        }
+        size_t recordLen = (static_cast<size_t>(record[3]) << 8) | record[4];
+        if (recordLen > MAX_TLS_RECORD) {
+            dir.mode = APP_NONE;
+            break;
+        }
+        if (avail < 5 + recordLen) break; // Chờ record đầy đủ
+
+        // Handshake record trải trên nhiều segment (vd: ClientHello lớn có key share hậu lượng tử)
+        if (record[0] == 22 && dir.pdu_start < contribStart) {
+            ApplicationLayer app;
+            if (TLSParser::parse(app, record, 5 + recordLen)) {
+                packet.app = app;
+                completed = true;
+            }
+        }
+
+        dir.pdu_start += 5 + recordLen;
+
+        // Từ Application Data trở đi toàn bộ là dữ liệu mã hóa: ngừng cắt record
+        if (record[0] == 23) {
+            dir.mode = APP_NONE;
+        }
+    }
+
+    return completed;
+}
+
+bool TcpReassembler::getStream(const StreamID& id, FollowStreamData& out) const
+{
+    auto it = m_flows.constFind(id);
+    if (it == m_flows.constEnd()) return false;
+
+    const Flow& flow = it.value();
+    if (flow.chunks.empty()) return false;
+
+    // Chuẩn hóa: chiều 0 luôn là Client -> Server
+    const int c = flow.client_dir < 0 ? 0 : flow.client_dir;
+    out.data[0] = flow.dir[c].data;
+    out.data[1] = flow.dir[1 - c].data;
+    out.truncated = flow.truncated;
+    out.chunks = flow.chunks;
+    for (TcpStreamChunk& chunk : out.chunks) {
+        chunk.direction = (chunk.direction == c) ? 0 : 1;
+    }
+    return true;
+}
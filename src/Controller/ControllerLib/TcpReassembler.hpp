@@ -0,0 +1,124 @@
+#ifndef TCPREASSEMBLER_HPP
+#define TCPREASSEMBLER_HPP
+
+#include <QHash>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+#include "../../Common/PacketData.hpp"
+#include "StreamID.hpp"
+
+/**
+ * @brief Một đoạn dữ liệu liền mạch của một chiều trong luồng TCP
+ * (dùng để hiển thị xen kẽ Client/Server trong "Follow TCP Stream").
+ */
+struct TcpStreamChunk {
+    uint8_t  direction = 0;   // 0: Client -> Server, 1: Server -> Client
+    uint64_t offset = 0;      // Vị trí trong FollowStreamData::data[direction]
+    uint32_t length = 0;
+    uint64_t missing_before = 0; // Số byte bị mất (không bắt được) ngay trước đoạn này
+};
+
+/**
+ * @brief Dữ liệu của một luồng TCP đã ghép, trả về cho "Follow TCP Stream".
+ */
+struct FollowStreamData {
+    std::vector<uint8_t> data[2];        // data[0]: Client -> Server, data[1]: Server -> Client
+    std::vector<TcpStreamChunk> chunks;  // Thứ tự xuất hiện của các đoạn
+    bool truncated = false;              // Đã chạm giới hạn bộ nhớ của luồng
+};
+
+/**
+ * @brief Bộ ghép (reassembly) luồng TCP theo từng StreamID.
+ *
+ * - Xử lý segment đến sai thứ tự, chồng lấn (overlap) và truyền lại (retransmission).
+ * - Giới hạn bộ nhớ theo từng luồng và toàn cục; khi vượt giới hạn toàn cục
+ *   thì loại bỏ (evict) luồng ít được dùng nhất (LRU).
+ * - Khi một PDU (HTTP header, TLS record) trải trên nhiều segment được ghép xong,
+ *   gói hoàn tất PDU sẽ được điền lại phần Application Layer.
+ */
+class TcpReassembler {
+public:
+    static constexpr size_t DEFAULT_PER_FLOW_LIMIT = 1 * 1024 * 1024;  // 1 MB
+    static constexpr size_t DEFAULT_GLOBAL_LIMIT   = 64 * 1024 * 1024; // 64 MB
+
+    TcpReassembler();
+
+    void setMemoryLimits(size_t perFlowBytes, size_t globalBytes);
+
+    /**
+     * @brief Đưa một TCP segment vào bộ ghép.
+     * @param id StreamID (đã chuẩn hóa) của luồng.
+     * @param reversed true nếu nguồn của gói là (ip2, port2) của StreamID.
+     * @param packet Gói tin (sẽ được cập nhật app nếu hoàn tất một PDU).
+     * @return true nếu gói này hoàn tất một PDU ghép từ nhiều segment.
+     */
+    bool processSegment(const StreamID& id, bool reversed, PacketData& packet);
+
+    /**
+     * @brief Lấy dữ liệu đã ghép của một luồng (để hiển thị Follow TCP Stream).
+     * @return false nếu luồng không có dữ liệu hoặc đã bị evict.
+     */
+    bool getStream(const StreamID& id, FollowStreamData& out) const;
+
+    void removeFlow(const StreamID& id);
+    void clear();
+
+    size_t memoryUsage() const { return m_totalBytes; }
+    quint64 evictedFlows() const { return m_evictedFlows; }
+
+private:
+    // Cách cắt PDU cho dissector Tầng 7 trên dòng byte đã ghép
+    enum AppMode {
+        APP_UNKNOWN,
+        APP_HTTP,
+        APP_TLS,
+        APP_NONE   // Không theo dõi nữa (không nhận ra, bị mất dữ liệu, hết bộ nhớ...)
+    };
+
+    struct Direction {
+        bool     seeded = false;
+        uint32_t next_seq = 0;        // Sequence number tiếp theo mong đợi
+        uint64_t next_offset = 0;     // Số byte liền mạch đã nhận (vị trí logic trong luồng)
+        std::map<uint64_t, std::vector<uint8_t>> pending; // Segment đến sớm, key = vị trí logic
+        size_t   pending_bytes = 0;
+        uint64_t missing = 0;         // Byte bị bỏ qua chưa được ghi vào chunk
+        std::vector<uint8_t> data;    // Byte đã ghép và được lưu (tối đa giới hạn luồng)
+
+        // --- Cắt PDU ---
+        AppMode  mode = APP_UNKNOWN;
+        size_t   pdu_start = 0;       // Vị trí (trong data) của PDU chưa xử lý
+        size_t   scan_pos = 0;        // Đã tìm "\r\n\r\n" đến đâu (tránh quét lại)
+        uint64_t body_remaining = 0;  // HTTP: số byte body còn phải bỏ qua
+        bool     chunked = false;     // HTTP: body dạng chunked
+        bool     chunk_trailer = false;
+    };
+
+    struct Flow {
+        Direction dir[2];             // Theo chiều của StreamID (0: ip1 -> ip2)
+        int       client_dir = -1;    // Chiều của Client (bên gửi SYN / gói đầu tiên)
+        std::vector<TcpStreamChunk> chunks; // direction ở đây theo chiều StreamID
+        size_t    bytes = 0;          // Tổng bộ nhớ đang dùng (data + pending)
+        bool      truncated = false;
+        std::list<StreamID>::iterator lru_it;
+    };
+
+    void append(Flow& flow, int d, const uint8_t* p, size_t n);
+    void drainPending(Flow& flow, int d);
+    void skipGap(Flow& flow, int d);
+    bool dissect(Direction& dir, size_t contribStart, PacketData& packet);
+    bool dissectHttp(Direction& dir, size_t contribStart, PacketData& packet);
+    bool dissectTls(Direction& dir, size_t contribStart, PacketData& packet);
+    void enforceGlobalLimit();
+    void dropFlow(const StreamID& id);
+
+    QHash<StreamID, Flow> m_flows;
+    std::list<StreamID> m_lru;        // Đầu danh sách: luồng lâu không dùng nhất
+    size_t m_perFlowLimit;
+    size_t m_globalLimit;
+    size_t m_totalBytes = 0;
+    quint64 m_evictedFlows = 0;
+};
+
+#endif // TCPREASSEMBLER_HPP
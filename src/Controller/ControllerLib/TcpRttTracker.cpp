@@ -0,0 +1,138 @@
+#include "TcpRttTracker.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// So sánh số thứ tự có xét quay vòng (RFC 1982)
+static inline int32_t seqDiff(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b); }
+
+// --- Triển khai (Implementation) ---
+
+TcpRttStats& TcpRttTracker::statsOf(Flow& flow)
+{
+    if (!flow.stats) flow.stats = std::make_unique<TcpRttStats>();
+    return *flow.stats;
+}
+
+void TcpRttTracker::processSegment(uint32_t& slot, bool reversed, PacketData& packet)
+{
+    const TCPHeader& tcp = packet.tcp;
+    const bool syn = tcp.flags & TCPHeader::SYN;
+    const bool fin = tcp.flags & TCPHeader::FIN;
+    const bool rst = tcp.flags & TCPHeader::RST;
+    const bool ack = tcp.flags & TCPHeader::ACK;
+    // Độ dài thật của segment (payload_length bị cắt bởi snaplen, ACK sẽ không khớp)
+    const uint32_t seglen = packet.tcp_segment_length + (syn ? 1 : 0) + (fin ? 1 : 0);
+
+    if (slot == NO_SLOT) {
+        // Chưa có gì đang chờ đo: ACK thuần / RST không cần trạng thái
+        if (seglen == 0 || rst) return;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_flows.size());
+            m_flows.emplace_back();
+        }
+    }
+
+    Flow& flow = m_flows[slot];
+    const int d = reversed ? 1 : 0;
+    Direction& self = flow.dir[d];
+    Direction& peer = flow.dir[1 - d];
+    TCPAnalysis& a = packet.tcp_analysis;
+    const int64_t nowNs = static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+
+    // --- 1. Bắt tay (SYN / SYN-ACK / ACK) ---
+    if (syn && !ack) {
+        // SYN gửi lại: dùng lần gửi cuối để không cộng thời gian chờ timeout vào iRTT
+        flow.syn_dir = d;
+        flow.syn_ns = nowNs;
+    } else if (syn && ack) {
+        if (flow.syn_dir == 1 - d && flow.syn_ns >= 0) {
+            flow.synack_ns = nowNs;
+            flow.synack_seq = tcp.seq_num;
+            statsOf(flow).syn_synack_ns = nowNs - flow.syn_ns;
+        }
+    } else if (ack && !rst && flow.syn_dir == d && flow.synack_ns >= 0 && // (stats đã được cấp cùng synack_ns)
+               flow.stats->initial_rtt_ns < 0 && tcp.ack_num == flow.synack_seq + 1) {
+        flow.stats->synack_ack_ns = nowNs - flow.synack_ns;
+        flow.stats->initial_rtt_ns = nowNs - flow.syn_ns;
+    }
+
+    // --- 2. Dữ liệu / ACK ---
+    if (seglen > 0 && !rst) {
+        if (a.has(TCPAnalysis::RETRANSMISSION)) {
+            // Karn: không biết ACK sau này thuộc lần gửi nào -> bỏ các mẫu bị phủ
+            while (!self.probes.empty() && seqDiff(self.probes.back().end_seq, tcp.seq_num) > 0) {
+                self.probes.popBack();
+            }
+        } else if (!self.seen || seqDiff(tcp.seq_num + seglen, self.high_seq) > 0) {
+            self.probes.push({tcp.seq_num + seglen, packet.packet_id, nowNs});
+        }
+        if (!self.seen || seqDiff(tcp.seq_num + seglen, self.high_seq) > 0) {
+            self.high_seq = tcp.seq_num + seglen;
+        }
+        self.seen = true;
+    }
+
+    if (ack && !rst) {
+        // ACK tích lũy: segment mới nhất được xác nhận cho mẫu RTT
+        bool matched = false;
+        SeqProbe acked;
+        while (!peer.probes.empty() && seqDiff(tcp.ack_num, peer.probes.front().end_seq) >= 0) {
+            acked = peer.probes.front();
+            peer.probes.popFront();
+            matched = true;
+        }
+        if (matched) {
+            a.ack_rtt_ns = nowNs - acked.sent_ns;
+            a.ack_rtt_frame = acked.frame;
+            statsOf(flow).ack_rtt.add(a.ack_rtt_ns);
+        }
+    }
+
+    // --- 3. Timestamps (TSval / TSecr) ---
+    if (tcp.has_timestamp && !rst) {
+        // Chỉ lấy TSval của segment có dữ liệu: ACK thuần có thể được phản hồi rất lâu sau
+        if (seglen > 0 && (!self.ts_seen || seqDiff(tcp.ts_val, self.last_ts_val) > 0)) {
+            self.ts_probes.push({tcp.ts_val, nowNs});
+            self.last_ts_val = tcp.ts_val;
+            self.ts_seen = true;
+        }
+
+        if (ack && tcp.ts_ecr != 0) {
+            while (!peer.ts_probes.empty() && seqDiff(peer.ts_probes.front().ts_val, tcp.ts_ecr) < 0) {
+                peer.ts_probes.popFront(); // Cũ hơn giá trị được phản hồi: sẽ không bao giờ khớp
+            }
+            if (!peer.ts_probes.empty() && peer.ts_probes.front().ts_val == tcp.ts_ecr) {
+                a.ts_rtt_ns = nowNs - peer.ts_probes.front().sent_ns;
+                statsOf(flow).ts_rtt.add(a.ts_rtt_ns);
+                peer.ts_probes.popFront();
+            }
+        }
+    }
+
+    if (flow.stats) a.initial_rtt_ns = flow.stats->initial_rtt_ns;
+}
+
+const TcpRttStats* TcpRttTracker::stats(uint32_t slot) const
+{
+    if (slot >= m_flows.size()) return nullptr;
+    return m_flows[slot].stats.get();
+}
+
+void TcpRttTracker::release(uint32_t& slot)
+{
+    if (slot >= m_flows.size()) return;
+    m_flows[slot] = Flow{};
+    m_freeSlots.push_back(slot);
+    slot = NO_SLOT;
+}
+
+void TcpRttTracker::clear()
+{
+    m_flows.clear();
+    m_flows.shrink_to_fit();
+    m_freeSlots.clear();
+    m_freeSlots.shrink_to_fit();
+}
@@ -0,0 +1,109 @@
+#ifndef TCPRTTTRACKER_HPP
+#define TCPRTTTRACKER_HPP
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../../Common/PacketData.hpp"
+#include "../../Common/QuantileSketch.hpp"
+
+/**
+ * @brief Thống kê RTT của một luồng TCP (ns; -1 = chưa đo được).
+ */
+struct TcpRttStats {
+    int64_t initial_rtt_ns = -1;  // SYN -> ACK hoàn tất bắt tay (iRTT)
+    int64_t syn_synack_ns  = -1;  // Nửa phía server: SYN -> SYN-ACK
+    int64_t synack_ack_ns  = -1;  // Nửa phía client: SYN-ACK -> ACK
+    QuantileSketch ack_rtt;       // Mẫu từ ghép cặp dữ liệu / ACK
+    QuantileSketch ts_rtt;        // Mẫu từ TSval / TSecr
+};
+
+/**
+ * @brief Đo RTT cho từng luồng TCP.
+ *
+ * - Bắt tay: thời gian SYN / SYN-ACK / ACK.
+ * - Dữ liệu / ACK: mỗi chiều giữ tối đa PROBE_SLOTS segment đang chờ ACK;
+ *   segment bị truyền lại thì bỏ mẫu (thuật toán Karn).
+ * - Timestamps (RFC 7323): TSval của segment có dữ liệu, đo tới khi chiều kia phản hồi TSecr.
+ *
+ * Trạng thái nằm trong một mảng slot; chỉ số slot được giữ trong bản ghi của luồng
+ * (StreamState::rtt_slot), nên không cần tra cứu băm thứ hai mỗi gói. Slot chỉ được cấp
+ * khi luồng có gì để đo (SYN, segment có dữ liệu / TSval đang chờ), còn TcpRttStats
+ * (hai sketch) chỉ được cấp khi có mẫu đầu tiên: luồng chỉ có ACK thuần hoặc RST
+ * không tốn thêm bộ nhớ. Xử lý O(1) mỗi gói.
+ */
+class TcpRttTracker {
+public:
+    static constexpr int PROBE_SLOTS = 8;
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    /**
+     * @brief Xử lý một segment (gọi sau khi đã phân tích SEQ/ACK).
+     * Điền packet.tcp_analysis.ack_rtt_ns / ts_rtt_ns / initial_rtt_ns nếu đo được.
+     * @param slot Slot của luồng (NO_SLOT = chưa có); được cấp ở đây khi cần.
+     */
+    void processSegment(uint32_t& slot, bool reversed, PacketData& packet);
+
+    // Trả về nullptr nếu luồng chưa có mẫu nào
+    const TcpRttStats* stats(uint32_t slot) const;
+
+    // Trả slot về danh sách trống (slot = NO_SLOT sau khi gọi)
+    void release(uint32_t& slot);
+    void clear();
+
+private:
+    struct SeqProbe {
+        uint32_t end_seq = 0;    // seq + len của segment
+        uint32_t frame = 0;
+        int64_t  sent_ns = 0;
+    };
+    struct TsProbe {
+        uint32_t ts_val = 0;
+        int64_t  sent_ns = 0;
+    };
+
+    // Hàng đợi vòng kích thước cố định; đầy thì ghi đè phần tử cũ nhất
+    template <typename T>
+    struct Ring {
+        std::array<T, PROBE_SLOTS> items{};
+        uint8_t head = 0;
+        uint8_t size = 0;
+
+        void push(const T& v) {
+            if (size == PROBE_SLOTS) { head = (head + 1) % PROBE_SLOTS; size--; }
+            items[(head + size) % PROBE_SLOTS] = v;
+            size++;
+        }
+        T& front() { return items[head]; }
+        T& back() { return items[(head + size - 1) % PROBE_SLOTS]; }
+        void popFront() { head = (head + 1) % PROBE_SLOTS; size--; }
+        void popBack() { size--; }
+        bool empty() const { return size == 0; }
+    };
+
+    struct Direction {
+        bool     seen = false;
+        uint32_t high_seq = 0;      // seq + len lớn nhất đã gửi
+        Ring<SeqProbe> probes;
+        bool     ts_seen = false;
+        uint32_t last_ts_val = 0;
+        Ring<TsProbe> ts_probes;
+    };
+
+    struct Flow {
+        Direction dir[2];
+        int      syn_dir = -1;      // Chiều gửi SYN (client)
+        int64_t  syn_ns = -1;
+        int64_t  synack_ns = -1;
+        uint32_t synack_seq = 0;
+        std::unique_ptr<TcpRttStats> stats; // Cấp khi có mẫu đầu tiên
+    };
+
+    TcpRttStats& statsOf(Flow& flow);
+
+    std::vector<Flow> m_flows;
+    std::vector<uint32_t> m_freeSlots;
+};
+
+#endif // TCPRTTTRACKER_HPP
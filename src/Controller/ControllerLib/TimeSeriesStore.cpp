@@ -0,0 +1,135 @@
+#include "TimeSeriesStore.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static const int64_t RESOLUTION_NS[TimeSeriesStore::RES_COUNT] = {
+    1000000LL,        // 1 ms
+    100000000LL,      // 100 ms
+    1000000000LL,     // 1 s
+    10000000000LL,    // 10 s
+    60000000000LL     // 1 phút
+};
+
+// Giới hạn bộ nhớ cho độ phân giải mịn nhất: 256 khối x 4096 ô ~ 17.5 phút
+static const size_t MAX_CHUNKS_1MS = 256;
+
+// --- Triển khai (Implementation) ---
+
+TimeSeriesStore::TimeSeriesStore()
+{
+    for (int r = 0; r < RES_COUNT; ++r) {
+        m_levels[r].widthNs = RESOLUTION_NS[r];
+    }
+    m_levels[RES_1MS].maxChunks = MAX_CHUNKS_1MS;
+}
+
+int64_t TimeSeriesStore::resolutionNs(Resolution res)
+{
+    return RESOLUTION_NS[res];
+}
+
+void TimeSeriesStore::clear()
+{
+    for (Level& level : m_levels) {
+        level.chunks.clear();
+        level.liveChunks = 0;
+        level.firstRetained = 0;
+        level.lastIndex = -1;
+    }
+    m_originNs = -1;
+    m_lastNs = -1;
+    m_totalCount = 0;
+}
+
+void TimeSeriesStore::add(int64_t timestampNs, uint32_t value)
+{
+    if (m_originNs < 0) m_originNs = timestampNs;
+    if (timestampNs > m_lastNs) m_lastNs = timestampNs;
+    m_totalCount++;
+
+    // Gói có timestamp trước mốc 0 (lệch đồng hồ / gộp nhiều interface) dồn vào ô đầu
+    const int64_t offsetNs = timestampNs > m_originNs ? timestampNs - m_originNs : 0;
+    for (Level& level : m_levels) {
+        addToLevel(level, offsetNs, value);
+    }
+}
+
+void TimeSeriesStore::setOrigin(int64_t timestampNs)
+{
+    if (m_originNs < 0) m_originNs = timestampNs;
+}
+
+void TimeSeriesStore::merge(const TimeSeriesStore& other)
+{
+    if (other.m_totalCount == 0) return;
+    if (m_originNs < 0) m_originNs = other.m_originNs;
+    if (other.m_lastNs > m_lastNs) m_lastNs = other.m_lastNs;
+    m_totalCount += other.m_totalCount;
+
+    for (int r = 0; r < RES_COUNT; ++r) {
+        Level& level = m_levels[r];
+        const Level& src = other.m_levels[r];
+        for (int64_t c = src.firstRetained; c < static_cast<int64_t>(src.chunks.size()); ++c) {
+            if (!src.chunks[c]) continue;
+            Chunk* chunk = chunkFor(level, c);
+            if (!chunk) continue;
+            for (int64_t i = 0; i < CHUNK_SIZE; ++i) (*chunk)[i].merge((*src.chunks[c])[i]);
+        }
+        if (src.lastIndex > level.lastIndex) level.lastIndex = src.lastIndex;
+    }
+}
+
+TimeSeriesStore::Chunk* TimeSeriesStore::chunkFor(Level& level, int64_t chunkIndex)
+{
+    if (chunkIndex < level.firstRetained) return nullptr; // Vùng đã bị giải phóng
+
+    if (chunkIndex >= static_cast<int64_t>(level.chunks.size())) {
+        level.chunks.resize(chunkIndex + 1);
+    }
+    if (!level.chunks[chunkIndex]) {
+        level.chunks[chunkIndex].reset(new Chunk());
+        level.liveChunks++;
+
+        // Vượt giới hạn: giải phóng các khối cũ nhất (có thể chính là khối vừa cấp nếu nó cũ nhất)
+        while (level.maxChunks > 0 && level.liveChunks > level.maxChunks) {
+            if (level.chunks[level.firstRetained]) {
+                level.chunks[level.firstRetained].reset();
+                level.liveChunks--;
+            }
+            level.firstRetained++;
+        }
+    }
+    return level.chunks[chunkIndex].get();
+}
+
+void TimeSeriesStore::addToLevel(Level& level, int64_t offsetNs, uint32_t value)
+{
+    const int64_t index = offsetNs / level.widthNs;
+    Chunk* chunk = chunkFor(level, index / CHUNK_SIZE);
+    if (!chunk) return;
+
+    (*chunk)[index % CHUNK_SIZE].add(value);
+    if (index > level.lastIndex) level.lastIndex = index;
+}
+
+int64_t TimeSeriesStore::bucketCount(Resolution res) const
+{
+    return m_levels[res].lastIndex + 1;
+}
+
+const TimeBucket& TimeSeriesStore::bucket(Resolution res, int64_t index) const
+{
+    static const TimeBucket EMPTY_BUCKET;
+    const Level& level = m_levels[res];
+    if (index < 0) return EMPTY_BUCKET;
+    const int64_t chunkIndex = index / CHUNK_SIZE;
+    if (chunkIndex >= static_cast<int64_t>(level.chunks.size()) || !level.chunks[chunkIndex]) {
+        return EMPTY_BUCKET;
+    }
+    return (*level.chunks[chunkIndex])[index % CHUNK_SIZE];
+}
+
+int64_t TimeSeriesStore::firstAvailableIndex(Resolution res) const
+{
+    return m_levels[res].firstRetained * CHUNK_SIZE;
+}
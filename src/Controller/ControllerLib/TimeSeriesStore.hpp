@@ -0,0 +1,102 @@
+#ifndef TIMESERIESSTORE_HPP
+#define TIMESERIESSTORE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Một ô thời gian: số gói, tổng / min / max của giá trị gộp (vd: frame.len).
+ */
+struct TimeBucket {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint32_t min = std::numeric_limits<uint32_t>::max();
+    uint32_t max = 0;
+
+    void add(uint32_t value) {
+        count++;
+        sum += value;
+        if (value < min) min = value;
+        if (value > max) max = value;
+    }
+    void merge(const TimeBucket& other) {
+        if (other.count == 0) return;
+        count += other.count;
+        sum += other.sum;
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+    }
+};
+
+/**
+ * @brief Chuỗi thời gian nhiều độ phân giải (1 ms, 100 ms, 1 s, 10 s, 1 phút) cho I/O Graph.
+ *
+ * Mỗi gói được cộng vào một ô ở mỗi độ phân giải đúng một lần khi tới (O(1)), nên vẽ lại
+ * hoặc đổi interval chỉ đọc mảng ô có sẵn. Mốc 0 là gói đầu tiên sau clear().
+ * Mảng ô được cấp phát theo khối 4096 ô khi cần (khoảng lặng không tốn bộ nhớ).
+ * Độ phân giải 1 ms chỉ giữ ~1M ô gần nhất (~17 phút, 24 MB): khối cũ hơn bị giải phóng
+ * (firstAvailableIndex() tăng lên; UI dùng độ phân giải thô hơn cho vùng đó).
+ */
+class TimeSeriesStore {
+public:
+    enum Resolution {
+        RES_1MS,
+        RES_100MS,
+        RES_1S,
+        RES_10S,
+        RES_1MIN,
+        RES_COUNT
+    };
+
+    TimeSeriesStore();
+
+    static int64_t resolutionNs(Resolution res);
+
+    void add(int64_t timestampNs, uint32_t value);
+    void clear();
+
+    // Đặt mốc 0 (chỉ có tác dụng khi chưa có mốc); các chuỗi cùng mốc có thể merge() với nhau
+    void setOrigin(int64_t timestampNs);
+    // Cộng dồn từng ô của 'other' (phải cùng mốc 0) vào chuỗi này
+    void merge(const TimeSeriesStore& other);
+
+    bool isEmpty() const { return m_totalCount == 0; }
+    int64_t originNs() const { return m_originNs; }    // Timestamp gói đầu tiên (-1 = chưa có)
+    int64_t lastNs() const { return m_lastNs; }        // Timestamp lớn nhất đã thấy
+    uint64_t totalCount() const { return m_totalCount; }
+
+    // Số ô từ mốc 0 tới ô chứa gói mới nhất
+    int64_t bucketCount(Resolution res) const;
+    // Ô thứ i (ô rỗng nếu chưa có gói hoặc đã bị giải phóng)
+    const TimeBucket& bucket(Resolution res, int64_t index) const;
+    // Ô nhỏ nhất còn dữ liệu (các ô trước đó đã bị giải phóng do giới hạn bộ nhớ)
+    int64_t firstAvailableIndex(Resolution res) const;
+
+private:
+    static constexpr int64_t CHUNK_SIZE = 4096;
+    using Chunk = std::array<TimeBucket, CHUNK_SIZE>;
+
+    struct Level {
+        int64_t widthNs = 0;
+        size_t maxChunks = 0;          // 0 = không giới hạn
+        size_t liveChunks = 0;
+        int64_t firstRetained = 0;     // Khối nhỏ nhất còn giữ (khối trước đó đã bị giải phóng)
+        int64_t lastIndex = -1;        // Ô lớn nhất đã ghi
+        std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    // Khối chứa ô chunkIndex (cấp phát nếu cần); nullptr nếu vùng đó đã bị giải phóng
+    Chunk* chunkFor(Level& level, int64_t chunkIndex);
+    void addToLevel(Level& level, int64_t offsetNs, uint32_t value);
+
+    std::array<Level, RES_COUNT> m_levels;
+    int64_t m_originNs = -1;
+    int64_t m_lastNs = -1;
+    uint64_t m_totalCount = 0;
+};
+
+#endif // TIMESERIESSTORE_HPP
@@ -0,0 +1,371 @@
+#include "IOGraphManager.hpp"
+#include "PacketStore.hpp"
+#include <QDebug>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Số gói đọc mỗi lần từ PacketStore khi tính lại đường mới
+static const qsizetype BACKFILL_CHUNK = 4096;
+
+static inline int64_t packetTimeNs(const PacketData& packet)
+{
+    return static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+}
+
+// --- IOGraphSeries ---
+
+QString IOGraphSeries::fieldName(Field field)
+{
+    switch (field) {
+    case FIELD_FRAME_LEN:  return "frame.len";
+    case FIELD_TCP_LEN:    return "tcp.len";
+    case FIELD_TCP_WINDOW: return "tcp.window_size_value";
+    case FIELD_ACK_RTT:    return "tcp.analysis.ack_rtt (us)";
+    default:               return "";
+    }
+}
+
+QString IOGraphSeries::aggregateName(Aggregate aggregate)
+{
+    switch (aggregate) {
+    case AGG_PACKETS: return "COUNT";
+    case AGG_SUM:     return "SUM";
+    case AGG_MIN:     return "MIN";
+    case AGG_MAX:     return "MAX";
+    case AGG_AVG:     return "AVG";
+    default:          return "";
+    }
+}
+
+bool IOGraphSeries::fieldValue(const PacketData& packet, Field field, uint32_t& value)
+{
+    switch (field) {
+    case FIELD_FRAME_LEN:
+        value = packet.wire_length;
+        return true;
+    case FIELD_TCP_LEN:
+        if (!packet.is_tcp) return false;
+        value = packet.payload_length;
+        return true;
+    case FIELD_TCP_WINDOW:
+        if (!packet.is_tcp) return false;
+        value = packet.tcp.window;
+        return true;
+    case FIELD_ACK_RTT:
+        if (!packet.is_tcp || packet.tcp_analysis.ack_rtt_ns < 0) return false;
+        value = static_cast<uint32_t>(std::min<int64_t>(packet.tcp_analysis.ack_rtt_ns / 1000, UINT32_MAX));
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IOGraphSeries::bucketValue(const TimeBucket& bucket, Aggregate aggregate, double& value)
+{
+    switch (aggregate) {
+    case AGG_PACKETS:
+        value = static_cast<double>(bucket.count);
+        return true;
+    case AGG_SUM:
+        value = static_cast<double>(bucket.sum);
+        return true;
+    default:
+        break;
+    }
+
+    // MIN / MAX / AVG không xác định trên ô rỗng: để trống thay vì vẽ 0
+    if (bucket.count == 0) return false;
+    switch (aggregate) {
+    case AGG_MIN: value = bucket.min; return true;
+    case AGG_MAX: value = bucket.max; return true;
+    case AGG_AVG: value = static_cast<double>(bucket.sum) / bucket.count; return true;
+    default:      return false;
+    }
+}
+
+QVector<QPointF> IOGraphSeries::points(TimeSeriesStore::Resolution res, int64_t first, int64_t last, int columns) const
+{
+    QVector<QPointF> out;
+    const double widthSec = TimeSeriesStore::resolutionNs(res) / 1e9;
+    first = std::max(first, store.firstAvailableIndex(res));
+    last = std::min(last, store.bucketCount(res));
+    if (first >= last || columns <= 0) return out;
+
+    const int64_t n = last - first;
+    double value = 0;
+
+    // 1. Ít ô: vẽ nguyên
+    if (n <= 2 * static_cast<int64_t>(columns)) {
+        out.reserve(static_cast<int>(n));
+        for (int64_t i = first; i < last; ++i) {
+            if (bucketValue(store.bucket(res, i), aggregate, value)) out.append(QPointF(i * widthSec, value));
+        }
+        return out;
+    }
+
+    // 2. Min/max theo cột pixel: cột c gom các ô [first + n*c/columns, first + n*(c+1)/columns)
+    out.reserve(2 * columns);
+    for (int c = 0; c < columns; ++c) {
+        const int64_t begin = first + n * c / columns;
+        const int64_t end = first + n * (c + 1) / columns;
+        int64_t minIndex = -1, maxIndex = -1;
+        double minValue = 0, maxValue = 0;
+        for (int64_t i = begin; i < end; ++i) {
+            if (!bucketValue(store.bucket(res, i), aggregate, value)) continue;
+            if (minIndex < 0 || value < minValue) { minValue = value; minIndex = i; }
+            if (maxIndex < 0 || value > maxValue) { maxValue = value; maxIndex = i; }
+        }
+        if (minIndex < 0) continue;
+        if (minIndex == maxIndex) {
+            out.append(QPointF(minIndex * widthSec, minValue));
+        } else if (minIndex < maxIndex) {
+            out.append(QPointF(minIndex * widthSec, minValue));
+            out.append(QPointF(maxIndex * widthSec, maxValue));
+        } else {
+            out.append(QPointF(maxIndex * widthSec, maxValue));
+            out.append(QPointF(minIndex * widthSec, minValue));
+        }
+    }
+    return out;
+}
+
+// --- Triển khai (Implementation) ---
+
+IOGraphManager::IOGraphManager(const PacketStore* packets, QObject *parent)
+    : QObject(parent),
+    m_packets(packets)
+{
+    // Đường mặc định: mọi gói, Bytes/Tick (như I/O Graph cũ)
+    addSeries(QString(), IOGraphSeries::FIELD_FRAME_LEN, IOGraphSeries::AGG_SUM);
+}
+
+IOGraphManager::~IOGraphManager()
+{
+    // Các luồng nền giữ con trỏ tới danh sách gói và tới 'this': dừng và chờ chúng xong
+    cancelBackfills();
+    m_pool.waitForDone();
+}
+
+IOGraphSeries* IOGraphManager::seriesById(int id)
+{
+    for (const std::unique_ptr<IOGraphSeries>& s : m_series) {
+        if (s->id == id) return s.get();
+    }
+    return nullptr;
+}
+
+const IOGraphSeries* IOGraphManager::findSeries(int id) const
+{
+    for (const std::unique_ptr<IOGraphSeries>& s : m_series) {
+        if (s->id == id) return s.get();
+    }
+    return nullptr;
+}
+
+int IOGraphManager::addSeries(const QString& filter, IOGraphSeries::Field field, IOGraphSeries::Aggregate aggregate,
+                              QString* error)
+{
+    // Dịch bộ lọc ngoài khóa; bộ lọc lỗi không tạo đường (đường trống sẽ trông như "không có gói khớp")
+    DisplayFilterEngine filterEngine;
+    if (!filterEngine.setFilter(filter, error)) return -1;
+
+    int id = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+        std::unique_ptr<IOGraphSeries> series(new IOGraphSeries());
+        series->id = m_nextId++;
+        series->filter = filter.trimmed();
+        series->filterEngine = filterEngine;
+        series->name = series->filter.isEmpty() ? QString("All packets") : series->filter;
+        series->field = field;
+        series->aggregate = aggregate;
+        if (m_originNs >= 0) series->store.setOrigin(m_originNs);
+
+        IOGraphSeries& ref = *series;
+        m_series.push_back(std::move(series));
+        startBackfill(ref);
+        id = ref.id;
+        m_revision++;
+    }
+    emit seriesChanged();
+    return id;
+}
+
+void IOGraphManager::removeSeries(int id)
+{
+    if (id == 0) return; // Đường mặc định luôn tồn tại
+
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const std::shared_ptr<BackfillJob>& job : m_jobs) {
+            if (job->seriesId == id) job->cancelled = true;
+        }
+        m_series.erase(std::remove_if(m_series.begin(), m_series.end(),
+                                      [id](const std::unique_ptr<IOGraphSeries>& s) { return s->id == id; }),
+                       m_series.end());
+        m_revision++;
+    }
+    emit seriesChanged();
+}
+
+void IOGraphManager::setAggregate(int id, IOGraphSeries::Aggregate aggregate)
+{
+    QMutexLocker locker(&m_mutex);
+    if (IOGraphSeries* series = seriesById(id)) {
+        series->aggregate = aggregate;
+        m_revision++;
+    }
+}
+
+void IOGraphManager::setVisible(int id, bool visible)
+{
+    QMutexLocker locker(&m_mutex);
+    if (IOGraphSeries* series = seriesById(id)) {
+        series->visible = visible;
+        m_revision++;
+    }
+}
+
+void IOGraphManager::addToSeries(IOGraphSeries& series, const PacketData& packet)
+{
+    uint32_t value = 0;
+    if (!series.filterEngine.match(packet)) return;
+    if (!IOGraphSeries::fieldValue(packet, series.field, value)) return;
+    series.store.add(packetTimeNs(packet), value);
+}
+
+void IOGraphManager::processPackets(const QList<PacketData> &packetBatch)
+{
+    if (packetBatch.isEmpty()) return;
+    QMutexLocker locker(&m_mutex);
+
+    // Mốc 0 chung: mọi đường vẽ trên cùng trục thời gian
+    if (m_originNs < 0) {
+        m_originNs = packetTimeNs(packetBatch.first());
+        for (const std::unique_ptr<IOGraphSeries>& s : m_series) s->store.setOrigin(m_originNs);
+    }
+
+    // Mỗi đường nhận gói mới ngay cả khi đang tính lại phần cũ. Lô có thể đã vào PacketStore
+    // (và vào phần tính lại của đường vừa thêm) trước khi tới đây: bỏ các gói dưới ranh giới
+    for (const std::unique_ptr<IOGraphSeries>& s : m_series) {
+        for (const PacketData& packet : packetBatch) {
+            if (packet.packet_id < s->backfillBoundary) continue;
+            addToSeries(*s, packet);
+        }
+    }
+    m_revision++;
+}
+
+void IOGraphManager::clear()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        cancelBackfills();
+        for (const std::unique_ptr<IOGraphSeries>& s : m_series) {
+            s->store.clear();
+            s->computing = false;
+            s->backfillBoundary = 0;
+        }
+        m_originNs = -1;
+        m_revision++;
+    }
+    emit seriesChanged();
+}
+
+void IOGraphManager::cancelBackfills()
+{
+    for (const std::shared_ptr<BackfillJob>& job : m_jobs) job->cancelled = true;
+    m_jobs.clear();
+}
+
+void IOGraphManager::startBackfill(IOGraphSeries& series)
+{
+    // Ranh giới: gói [0, total) đã có lúc thêm đường (packet_id 1..total) được tính ở luồng nền,
+    // các gói sau đó đi qua processPackets() như mọi đường khác
+    const qsizetype total = m_packets->size();
+    if (total == 0) return;
+    series.backfillBoundary = static_cast<uint32_t>(total) + 1;
+
+    const int slices = static_cast<int>(std::max<qsizetype>(1, std::min<qsizetype>(
+        QThread::idealThreadCount(), (total + BACKFILL_CHUNK - 1) / BACKFILL_CHUNK)));
+
+    std::shared_ptr<BackfillJob> job = std::make_shared<BackfillJob>();
+    job->seriesId = series.id;
+    job->filterEngine = series.filterEngine;
+    job->field = series.field;
+    job->remaining = slices;
+    job->partials.resize(slices);
+    for (TimeSeriesStore& partial : job->partials) partial.setOrigin(m_originNs);
+    m_jobs.push_back(job);
+    series.computing = true;
+
+    const qsizetype perSlice = (total + slices - 1) / slices;
+    for (int i = 0; i < slices; ++i) {
+        const qsizetype begin = i * perSlice;
+        const qsizetype end = std::min(total, begin + perSlice);
+        m_pool.start([this, job, i, begin, end]() {
+            runBackfillSlice(job, i, begin, end);
+        });
+    }
+}
+
+void IOGraphManager::runBackfillSlice(const std::shared_ptr<BackfillJob>& job, int slice,
+                                      qsizetype begin, qsizetype end)
+{
+    // (Chạy trên luồng nền) Các luồng dùng chung bộ lọc đã dịch của job (chỉ đọc)
+    const DisplayFilterEngine& filterEngine = job->filterEngine;
+    TimeSeriesStore& out = job->partials[slice];
+
+    for (qsizetype pos = begin; pos < end && !job->cancelled; pos += BACKFILL_CHUNK) {
+        // 1. Store chỉ giữ khóa trong lúc copy (hoặc đọc từ segment) một khối gói;
+        // các trường của đồ thị đều đã giải mã nên không cần giải nén byte thô
+        QList<PacketData> chunk;
+        const bool complete = m_packets->mid(pos, std::min(BACKFILL_CHUNK, end - pos), chunk, false);
+        if (chunk.isEmpty() && complete) break; // Danh sách đã bị xóa (job sẽ bị hủy)
+
+        // 2. Lọc + gộp ngoài khóa
+        for (const PacketData& packet : chunk) {
+            uint32_t value = 0;
+            if (!filterEngine.match(packet)) continue;
+            if (!IOGraphSeries::fieldValue(packet, job->field, value)) continue;
+            out.add(packetTimeNs(packet), value);
+        }
+        if (!complete) {
+            // Segment hỏng: đường chỉ tính tới gói đọc được cuối cùng
+            qWarning() << "IOGraphManager: cannot read packet" << pos + chunk.size() + 1;
+            break;
+        }
+    }
+
+    // 3. Luồng xong cuối cùng gộp các chuỗi riêng (vẫn ngoài luồng chính) rồi trả kết quả về
+    if (job->remaining.fetch_sub(1) != 1) return;
+    for (size_t i = 1; i < job->partials.size() && !job->cancelled; ++i) {
+        job->partials[0].merge(job->partials[i]);
+    }
+    QMetaObject::invokeMethod(this, [this, job]() {
+        finishBackfill(job);
+    }, Qt::QueuedConnection);
+}
+
+void IOGraphManager::finishBackfill(const std::shared_ptr<BackfillJob>& job)
+{
+    // (Luồng của manager) Job đã bị hủy (xóa đường / phiên bắt mới) thì bỏ kết quả
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+        if (it == m_jobs.end()) return;
+        m_jobs.erase(it);
+        if (job->cancelled) return;
+
+        IOGraphSeries* series = seriesById(job->seriesId);
+        if (!series) return;
+        series->store.merge(job->partials[0]);
+        series->computing = false;
+        m_revision++;
+    }
+    emit seriesChanged();
+}
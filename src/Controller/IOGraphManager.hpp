@@ -0,0 +1,136 @@
+#ifndef IOGRAPHMANAGER_HPP
+#define IOGRAPHMANAGER_HPP
+
+#include <QObject>
+#include <QMutex>
+#include <QList>
+#include <QString>
+#include <QThreadPool>
+#include <QPointF>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../../Common/PacketData.hpp"
+#include "ControllerLib/DisplayFilterEngine.hpp"
+#include "ControllerLib/TimeSeriesStore.hpp"
+
+class PacketStore;
+
+/**
+ * @brief Một đường trên I/O Graph: bộ lọc hiển thị + trường được gộp + chuỗi thời gian riêng.
+ *
+ * Mỗi ô giữ count / sum / min / max của trường, nên đổi phép gộp (COUNT, SUM, MIN, MAX, AVG)
+ * chỉ là đọc lại ô, không phải tính lại từ gói tin.
+ */
+struct IOGraphSeries {
+    enum Field {
+        FIELD_FRAME_LEN,     // frame.len (byte trên dây)
+        FIELD_TCP_LEN,       // tcp.len (byte payload TCP)
+        FIELD_TCP_WINDOW,    // tcp.window_size_value (chưa nhân window scale)
+        FIELD_ACK_RTT,       // tcp.analysis.ack_rtt (µs)
+        FIELD_COUNT
+    };
+    enum Aggregate {
+        AGG_PACKETS,         // COUNT: số gói khớp bộ lọc (và có trường)
+        AGG_SUM,
+        AGG_MIN,
+        AGG_MAX,
+        AGG_AVG,
+        AGG_COUNT
+    };
+
+    int id = 0;
+    QString name;
+    QString filter;          // Rỗng = mọi gói
+    DisplayFilterEngine filterEngine;   // 'filter' đã dịch
+    Field field = FIELD_FRAME_LEN;
+    Aggregate aggregate = AGG_SUM;
+    bool visible = true;
+    bool computing = false;  // Đang tính lại trên các gói đã có (luồng nền)
+    // Gói có packet_id nhỏ hơn giá trị này thuộc phần tính lại ở luồng nền:
+    // processPackets() bỏ qua chúng để không cộng hai lần
+    uint32_t backfillBoundary = 0;
+    TimeSeriesStore store;
+
+    static QString fieldName(Field field);
+    static QString aggregateName(Aggregate aggregate);
+    // Giá trị của trường trong gói (false nếu gói không có trường này)
+    static bool fieldValue(const PacketData& packet, Field field, uint32_t& value);
+    // Giá trị vẽ của một ô (false = không có điểm, vd: MIN của ô rỗng)
+    static bool bucketValue(const TimeBucket& bucket, Aggregate aggregate, double& value);
+
+    // Điểm vẽ (X = giây từ mốc 0) cho các ô [first, last) ở độ phân giải res.
+    // Nhiều ô hơn 2 * columns: mỗi cột pixel chỉ giữ ô min và ô max (theo thứ tự thời gian),
+    // nên số điểm <= 2 * columns mà vẫn giữ nguyên các đỉnh / đáy.
+    QVector<QPointF> points(TimeSeriesStore::Resolution res, int64_t first, int64_t last, int columns) const;
+};
+
+/**
+ * @brief Quản lý các đường của I/O Graph (đường 0 = mọi gói, không xóa được).
+ *
+ * Gói mới được cộng vào mọi đường theo từng lô (trên luồng xử lý). Khi thêm đường mới, các gói
+ * đã bắt được chia thành nhiều đoạn và tính song song trên QThreadPool riêng: mỗi luồng đọc từng khối
+ * gói từ PacketStore (trong RAM hoặc đã ra đĩa), lọc + gộp ngoài khóa vào chuỗi riêng, rồi các
+ * chuỗi được merge() và trả về luồng của manager. Dialog không bị chặn trong lúc tính.
+ * Danh sách đường và chuỗi thời gian được bảo vệ bởi mutex(): dialog giữ khóa khi đọc.
+ */
+class IOGraphManager : public QObject
+{
+    Q_OBJECT
+public:
+    // packets: danh sách gói chính của AppController (đọc khi tính lại đường mới)
+    explicit IOGraphManager(const PacketStore* packets, QObject *parent = nullptr);
+    ~IOGraphManager() override;
+
+    // Trả về id của đường mới, hoặc -1 (kèm lý do trong 'error') nếu bộ lọc không hợp lệ
+    int addSeries(const QString& filter, IOGraphSeries::Field field, IOGraphSeries::Aggregate aggregate,
+                  QString* error = nullptr);
+    void removeSeries(int id);
+    void setAggregate(int id, IOGraphSeries::Aggregate aggregate);
+    void setVisible(int id, bool visible);
+
+    // Đọc series() / findSeries() khi đang giữ mutex() (không gọi các hàm thay đổi trong lúc giữ)
+    QMutex* mutex() const { return &m_mutex; }
+    const std::vector<std::unique_ptr<IOGraphSeries>>& series() const { return m_series; }
+    const IOGraphSeries* findSeries(int id) const;
+    // Tăng mỗi khi dữ liệu hoặc danh sách đường thay đổi (dialog bỏ qua lần vẽ nếu không đổi)
+    quint64 revision() const { return m_revision.load(std::memory_order_relaxed); }
+
+public slots:
+    void processPackets(const QList<PacketData> &packetBatch);
+    // Xóa dữ liệu (bắt đầu phiên bắt mới); giữ nguyên danh sách đường
+    void clear();
+
+signals:
+    void seriesChanged();
+
+private:
+    struct BackfillJob {
+        int seriesId = 0;
+        DisplayFilterEngine filterEngine;   // Bản sao của bộ lọc đã dịch (match() không đổi trạng thái)
+        IOGraphSeries::Field field = IOGraphSeries::FIELD_FRAME_LEN;
+        std::atomic<bool> cancelled{false};
+        std::atomic<int> remaining{0};
+        std::vector<TimeSeriesStore> partials;   // Một chuỗi riêng cho mỗi luồng
+    };
+
+    IOGraphSeries* seriesById(int id);
+    void addToSeries(IOGraphSeries& series, const PacketData& packet);
+    void startBackfill(IOGraphSeries& series);
+    void runBackfillSlice(const std::shared_ptr<BackfillJob>& job, int slice, qsizetype begin, qsizetype end);
+    void finishBackfill(const std::shared_ptr<BackfillJob>& job);
+    void cancelBackfills();
+
+    const PacketStore* m_packets;
+    QThreadPool m_pool;          // Chỉ chạy các job tính lại (hủy manager chỉ chờ các job này)
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<IOGraphSeries>> m_series;
+    std::vector<std::shared_ptr<BackfillJob>> m_jobs;
+    int m_nextId = 0;
+    int64_t m_originNs = -1;     // Mốc 0 chung của mọi đường (gói đầu tiên)
+    std::atomic<quint64> m_revision{0};
+};
+
+#endif // IOGRAPHMANAGER_HPP
@@ -0,0 +1,127 @@
+#include "PacketPipeline.hpp"
+#include "IOGraphManager.hpp"
+#include "PacketStore.hpp"
+#include "ControllerLib/ConversationManager.hpp"
+#include <QMutexLocker>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Số dòng tối đa mỗi lần gửi lên UI khi lọc lại toàn bộ (bảng hiện dần, không chờ hết)
+static const qsizetype REFILTER_ROWS_PER_BATCH = 5000;
+// Số gói đọc mỗi lần từ PacketStore khi lọc lại (phần đã ra đĩa được đọc tuần tự theo khối)
+static const qsizetype REFILTER_READ_CHUNK = 4096;
+
+// --- Triển khai (Implementation) ---
+
+PacketPipeline::PacketPipeline(PacketStore* packets, ConversationManager* convManager,
+                               IOGraphManager* ioGraphManager)
+    : QObject(nullptr),
+    m_packets(packets),
+    m_convManager(convManager),
+    m_ioGraphManager(ioGraphManager)
+{
+}
+
+void PacketPipeline::processBatch(QList<PacketData>* packetBatch)
+{
+    // (Chạy trên luồng xử lý)
+    // 1. Theo dõi luồng: stream index, phân tích SEQ/ACK, ghép luồng
+    // (Cuối lô: các luồng vừa thay đổi được đẩy vào bảng Conversations / Endpoints)
+    {
+        QMutexLocker locker(m_convManager->mutex());
+        m_convManager->processPackets(*packetBatch);
+    }
+
+    // 2. Thêm lô vào danh sách chính (store tự khóa; vượt ngân sách RAM thì đổ gói cũ ra đĩa)
+    m_packets->append(*packetBatch);
+    markReassembledFragments(*packetBatch);
+
+    // 3. Cộng vào chuỗi thời gian của từng đường I/O Graph (manager tự khóa)
+    m_ioGraphManager->processPackets(*packetBatch);
+
+    // 4. Lọc: bảng chỉ nhận packet_id, dòng được định dạng khi hiện lên màn hình
+    QList<quint32>* rows = new QList<quint32>();
+    for (const PacketData &packet : *packetBatch) {
+        if (m_filterEngine.match(packet)) {
+            rows->append(packet.packet_id);
+        }
+    }
+    delete packetBatch;
+    emit batchProcessed();
+
+    publishRows(rows);
+}
+
+void PacketPipeline::setDisplayFilter(const QString& filterText, quint64 session)
+{
+    // (AppController đã kiểm tra cú pháp; bộ lọc lỗi không khớp gói nào)
+    m_filterEngine.setFilter(filterText);
+    m_session = session;
+
+    // Chỉ luồng này thêm gói: kích thước không đổi trong lúc lọc lại.
+    // Đọc theo khối như nhau dù gói còn trong RAM hay đã ra đĩa; bộ lọc chỉ dùng
+    // trường đã giải mã nên không cần giải nén byte thô
+    QList<quint32>* rows = new QList<quint32>();
+    QList<PacketData> chunk;
+    const qsizetype total = m_packets->size();
+    for (qsizetype pos = 0; pos < total; pos += REFILTER_READ_CHUNK) {
+        const bool complete = m_packets->mid(pos, REFILTER_READ_CHUNK, chunk, false);
+        for (const PacketData &packet : chunk) {
+            if (!m_filterEngine.match(packet)) continue;
+            rows->append(packet.packet_id);
+            if (rows->size() >= REFILTER_ROWS_PER_BATCH) {
+                publishRows(rows);
+                rows = new QList<quint32>();
+            }
+        }
+        if (!complete) {
+            // Phần còn lại không đọc được: báo lên thay vì để bảng thiếu dòng mà không ai biết
+            publishRows(rows);
+            emit readFailed(m_session, static_cast<quint64>(pos + chunk.size() + 1));
+            return;
+        }
+    }
+    publishRows(rows);
+}
+
+void PacketPipeline::reset(quint64 session)
+{
+    m_session = session;
+    m_filterEngine.setFilter(QString());
+
+    m_packets->clear();
+    {
+        QMutexLocker locker(m_convManager->mutex());
+        m_convManager->clear();
+    }
+    m_ioGraphManager->clear();
+}
+
+void PacketPipeline::publishRows(QList<quint32>* packetIds)
+{
+    if (packetIds->isEmpty()) {
+        delete packetIds;
+        return;
+    }
+    emit rowsReady(m_session, packetIds);
+}
+
+void PacketPipeline::markReassembledFragments(QList<PacketData>& packetBatch)
+{
+    // packet_id tăng liên tục từ 1 nên vị trí trong danh sách = packet_id - 1 (store tự kiểm)
+    const uint32_t batchFirstId = packetBatch.isEmpty() ? 0 : packetBatch.first().packet_id;
+
+    for (const PacketData &packet : packetBatch) {
+        if (packet.fragment_ids.empty()) continue;
+
+        for (uint32_t fragmentId : packet.fragment_ids) {
+            m_packets->setReassembledIn(fragmentId, packet.packet_id);
+            // Mảnh nằm trong cùng lô: cập nhật luôn bản sẽ được hiển thị
+            qsizetype batchIndex = static_cast<qsizetype>(fragmentId) - batchFirstId;
+            if (fragmentId >= batchFirstId && batchIndex < packetBatch.size() &&
+                packetBatch[batchIndex].packet_id == fragmentId) {
+                packetBatch[batchIndex].reassembled_in = packet.packet_id;
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef PACKETPIPELINE_HPP
+#define PACKETPIPELINE_HPP
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include "../../Common/PacketData.hpp"
+#include "ControllerLib/DisplayFilterEngine.hpp"
+
+class ConversationManager;
+class IOGraphManager;
+class PacketStore;
+
+/**
+ * @brief Tầng xử lý nằm giữa CaptureEngine và UI, chạy trên luồng riêng (moveToThread).
+ *
+ * Với mỗi lô: theo dõi luồng (ConversationManager), thêm vào danh sách gói chính,
+ * cộng vào I/O Graph và lọc theo display filter.
+ * Luồng GUI chỉ nhận packet_id của các gói khớp (rowsReady) kèm số phiên hiển thị,
+ * để bỏ các dòng thuộc phiên cũ (sau khi xóa / đổi bộ lọc); dòng được định dạng khi hiển thị.
+ * Thống kê gói được đếm ngay trên luồng capture (StatsShard), không đi qua tầng này.
+ */
+class PacketPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    // Các đối tượng dùng chung với luồng GUI; PacketPipeline là bên ghi duy nhất của packets
+    PacketPipeline(PacketStore* packets, ConversationManager* convManager, IOGraphManager* ioGraphManager);
+
+public slots:
+    void processBatch(QList<PacketData>* packetBatch);
+    // Bộ lọc mới: lọc lại toàn bộ gói đã có (phát dưới phiên 'session'), rồi áp dụng cho các lô sau
+    void setDisplayFilter(const QString& filterText, quint64 session);
+    // Phiên bắt mới: xóa danh sách gói và trạng thái phân tích
+    void reset(quint64 session);
+
+signals:
+    void rowsReady(quint64 session, QList<quint32>* packetIds);
+    // Đã xử lý xong một lô nhận từ processBatch (phát trên luồng xử lý)
+    void batchProcessed();
+    // Lọc lại dừng ở gói packetNumber: không đọc được từ store (segment hỏng)
+    void readFailed(quint64 session, quint64 packetNumber);
+
+private:
+    void markReassembledFragments(QList<PacketData>& packetBatch); // Ghi "Reassembled in" cho các mảnh IP
+    void publishRows(QList<quint32>* packetIds);
+
+    PacketStore* m_packets;
+    ConversationManager* m_convManager;
+    IOGraphManager* m_ioGraphManager;
+
+    // --- Trạng thái của luồng xử lý ---
+    DisplayFilterEngine m_filterEngine;   // Đã dịch từ chuỗi lọc hiện tại
+    quint64 m_session = 0;
+};
+
+#endif // PACKETPIPELINE_HPP
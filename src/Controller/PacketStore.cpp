@@ -0,0 +1,738 @@
+#include "PacketStore.hpp"
+#include "../../Common/BlockCodec.hpp"
+#include "../UI/Widgets/PacketFormatter.hpp"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Một segment mới khi segment đang ghi vượt cỡ này (bản ghi không bao giờ vắt qua hai segment)
+static const qint64 SEGMENT_BYTES = 64LL << 20;
+// Gom byte thô của các gói trong RAM thành khối cỡ này rồi nén
+static const qint64 BLOCK_BYTES = 64 * 1024;
+// Số segment giữ map cùng lúc (LRU)
+static const size_t HOT_SEGMENTS = 4;
+// Một mốc chỉ mục mỗi N gói trên đĩa: đọc gói bất kỳ = tới mốc + nhảy qua < N bản ghi
+static const qsizetype SPILL_INDEX_INTERVAL = 64;
+// Bản ghi: [u32 độ dài thân][thân]; thân bắt đầu bằng packet_id (u32) rồi timestamp (timespec)
+static const qint64 RECORD_HEADER_BYTES = 4;
+static const qint64 RECORD_TIMESTAMP_OFFSET = RECORD_HEADER_BYTES + 4;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+class RecordWriter {
+public:
+    explicit RecordWriter(QByteArray& out) : m_out(out) {}
+
+    template <typename T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable fields are written raw");
+        m_out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    void string(const std::string& value) {
+        pod(static_cast<uint32_t>(value.size()));
+        m_out.append(value.data(), static_cast<qsizetype>(value.size()));
+    }
+    template <typename T>
+    void vector(const std::vector<T>& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable elements are written raw");
+        pod(static_cast<uint32_t>(value.size()));
+        m_out.append(reinterpret_cast<const char*>(value.data()), static_cast<qsizetype>(value.size() * sizeof(T)));
+    }
+
+private:
+    QByteArray& m_out;
+};
+
+class RecordReader {
+public:
+    RecordReader(const uchar* data, qint64 length) : m_pos(data), m_end(data + length) {}
+
+    template <typename T>
+    void pod(T& value) {
+        if (!take(sizeof(T))) return;
+        memcpy(&value, m_pos - sizeof(T), sizeof(T));
+    }
+    void string(std::string& value) {
+        uint32_t size = 0;
+        pod(size);
+        if (!take(size)) return;
+        value.assign(reinterpret_cast<const char*>(m_pos - size), size);
+    }
+    template <typename T>
+    void vector(std::vector<T>& value) {
+        uint32_t count = 0;
+        pod(count);
+        const size_t bytes = static_cast<size_t>(count) * sizeof(T);
+        if (!take(bytes)) return;
+        value.resize(count);
+        if (bytes > 0) memcpy(value.data(), m_pos - bytes, bytes);
+    }
+    bool ok() const { return m_ok; }
+
+private:
+    bool take(size_t bytes) {
+        if (!m_ok || static_cast<size_t>(m_end - m_pos) < bytes) {
+            m_ok = false;
+            return false;
+        }
+        m_pos += bytes;
+        return true;
+    }
+
+    const uchar* m_pos;
+    const uchar* m_end;
+    bool m_ok = true;
+};
+
+// Danh sách trường của một bản ghi, dùng chung cho ghi (const PacketData) và đọc (PacketData):
+// thứ tự ghi và đọc không thể lệch nhau. packet_id + timestamp phải đứng đầu (RECORD_TIMESTAMP_OFFSET).
+template <typename Archive, typename Packet>
+void visitFields(Archive& ar, Packet& p)
+{
+    ar.pod(p.packet_id);
+    ar.pod(p.timestamp);
+    ar.pod(p.cap_length);
+    ar.pod(p.wire_length);
+    ar.pod(p.interface_id);
+    ar.pod(p.stream_index);
+    ar.pod(p.payload_offset);
+    ar.pod(p.payload_length);
+    ar.pod(p.tcp_segment_length);
+    ar.vector(p.raw_packet);
+
+    ar.pod(p.is_ip_fragment);
+    ar.pod(p.reassembled_in);
+    ar.vector(p.fragment_ids);
+    ar.vector(p.reassembled);
+
+    ar.pod(p.eth);
+    ar.pod(p.vlan);
+    ar.pod(p.has_vlan);
+    ar.pod(p.ipv4);
+    ar.pod(p.ipv6);
+    ar.pod(p.arp);
+    ar.pod(p.is_ipv4);
+    ar.pod(p.is_ipv6);
+    ar.pod(p.is_arp);
+    ar.pod(p.tcp);
+    ar.pod(p.tcp_analysis);
+    ar.pod(p.udp);
+    ar.pod(p.icmp);
+    ar.pod(p.is_tcp);
+    ar.pod(p.is_udp);
+    ar.pod(p.is_icmp);
+
+    auto& app = p.app;
+    ar.vector(app.data);
+    ar.string(app.protocol);
+    ar.string(app.info);
+    ar.pod(app.quic_type);
+    ar.string(app.http_method);
+    ar.string(app.http_host);
+    ar.string(app.http_path);
+    ar.string(app.http_version);
+    ar.pod(app.is_http_request);
+    ar.pod(app.is_http_response);
+    ar.pod(app.http_status_code);
+    ar.pod(app.dns_id);
+    ar.pod(app.is_dns_query);
+    ar.string(app.dns_name);
+    ar.pod(app.dns_type);
+    ar.pod(app.dns_class);
+    ar.pod(app.tls_version_major);
+    ar.pod(app.tls_version_minor);
+    ar.string(app.tls_sni);
+    ar.pod(app.tls_content_type);
+    ar.pod(app.tls_handshake_type);
+    ar.pod(app.tls_hello_version);
+    ar.pod(app.tls_selected_version);
+    ar.pod(app.tls_selected_cipher);
+    ar.string(app.tls_alpn);
+    ar.vector(app.tls_supported_versions);
+    ar.vector(app.tls_cipher_suites);
+    ar.string(app.tls_ja3);
+    ar.string(app.tls_ja3_hash);
+    ar.string(app.tls_ja4);
+
+    ar.string(p.tree_view);
+    ar.pod(p.tree_depth);
+    ar.pod(p.proto_path);
+    ar.string(p.expert_info);
+    ar.pod(p.is_malformed);
+    ar.pod(p.is_retransmitted);
+    ar.pod(p.is_duplicate);
+    ar.pod(p.is_reassembled_pdu);
+}
+
+void appendRecord(QByteArray& out, const PacketData& packet)
+{
+    const qsizetype start = out.size();
+    out.resize(start + RECORD_HEADER_BYTES);
+    RecordWriter writer(out);
+    visitFields(writer, packet);
+    const uint32_t length = static_cast<uint32_t>(out.size() - start - RECORD_HEADER_BYTES);
+    memcpy(out.data() + start, &length, sizeof(length));
+}
+
+uint32_t recordLength(const uchar* record)
+{
+    uint32_t length;
+    memcpy(&length, record, sizeof(length));
+    return length;
+}
+
+// Ước tính byte một gói chiếm trong RAM (struct + các bộ đệm lớn; đủ để so với ngân sách)
+qint64 footprint(const PacketData& packet)
+{
+    return static_cast<qint64>(sizeof(PacketData) +
+                               packet.raw_packet.capacity() +
+                               packet.reassembled.capacity() +
+                               packet.fragment_ids.capacity() * sizeof(uint32_t) +
+                               packet.app.data.capacity() +
+                               packet.app.info.capacity() +
+                               packet.app.tls_ja3.capacity() +
+                               packet.app.tls_cipher_suites.capacity() * sizeof(uint16_t) +
+                               packet.tree_view.capacity() +
+                               packet.expert_info.capacity());
+}
+
+int64_t timestampNs(const timespec& ts)
+{
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+PacketStore::PacketStore() = default;
+
+PacketStore::~PacketStore() = default;
+
+void PacketStore::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_memoryBudget = std::max(bytes, MIN_MEMORY_BUDGET);
+}
+
+qint64 PacketStore::memoryBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_memoryBudget;
+}
+
+PacketStore::Usage PacketStore::usage() const
+{
+    QMutexLocker locker(&m_mutex);
+    Usage result;
+    result.packets = m_spilled + static_cast<qsizetype>(m_recent.size());
+    result.spilled = m_spilled;
+    result.memoryBytes = m_memoryBytes;
+    for (qint64 size : m_segmentSizes) result.diskBytes += size;
+    result.segments = static_cast<int>(m_segmentPaths.size());
+    result.blockInputBytes = m_blockInputBytes;
+    result.blockStoredBytes = m_blockStoredBytes;
+    result.decodedBytes = m_decodedTotal;
+    result.decodeNs = m_decodeNs;
+    return result;
+}
+
+void PacketStore::setCompression(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_compression = enabled;
+}
+
+bool PacketStore::compression() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_compression;
+}
+
+QString PacketStore::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+void PacketStore::append(const QList<PacketData>& batch)
+{
+    // Tên giao thức như cột Protocol (định dạng ngoài khóa)
+    std::vector<QString> protocols;
+    protocols.reserve(batch.size());
+    for (const PacketData& packet : batch) protocols.push_back(PacketFormatter::getProtocolName(packet));
+
+    bool compression;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            const PacketData& packet = batch[i];
+            SortKey key;
+            key.timeNs = static_cast<int64_t>(packet.timestamp.tv_sec) * 1000000000LL + packet.timestamp.tv_nsec;
+            key.length = packet.wire_length;
+            // Bảng tên đầy (không xảy ra trong thực tế): UINT16_MAX = không rõ
+            key.protocol = UINT16_MAX;
+            auto it = m_protocolIds.constFind(protocols[i]);
+            if (it != m_protocolIds.constEnd()) {
+                key.protocol = it.value();
+            } else if (m_protocolNames.size() < UINT16_MAX) {
+                key.protocol = static_cast<uint16_t>(m_protocolNames.size());
+                m_protocolIds.insert(protocols[i], key.protocol);
+                m_protocolNames.push_back(protocols[i]);
+            }
+            key.valid = true;
+            m_sortKeys.push_back(key);
+
+            m_recent.push_back({ packet });
+            m_memoryBytes += footprint(m_recent.back().packet);
+            m_maxInterfaceId = std::max(m_maxInterfaceId, packet.interface_id);
+        }
+        compression = m_compression;
+    }
+    if (compression) {
+        packPendingBytes();
+    } else {
+        m_pendingIndex = m_spilled + static_cast<qsizetype>(m_recent.size());
+    }
+    spillIfNeeded();
+}
+
+void PacketStore::setReassembledIn(uint32_t packetId, uint32_t reassembledIn)
+{
+    const qsizetype index = static_cast<qsizetype>(packetId) - 1;
+    QMutexLocker locker(&m_mutex);
+    if (index < 0) return;
+    if (index < m_spilled) {
+        m_spilledReassembledIn.insert(packetId, reassembledIn);
+        return;
+    }
+    const size_t recentIndex = static_cast<size_t>(index - m_spilled);
+    if (recentIndex < m_recent.size() && m_recent[recentIndex].packet.packet_id == packetId) {
+        m_recent[recentIndex].packet.reassembled_in = reassembledIn;
+    }
+}
+
+void PacketStore::clear()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_recent.clear();
+        std::vector<SortKey>().swap(m_sortKeys);
+        m_protocolNames.clear();
+        m_protocolIds.clear();
+        m_memoryBytes = 0;
+        m_maxInterfaceId = 0;
+        m_spilled = 0;
+        m_segmentPaths.clear();
+        m_segmentSizes.clear();
+        m_index.clear();
+        m_spilledReassembledIn.clear();
+        m_error.clear();
+        m_mapped.clear(); // Đóng file = bỏ map
+        m_blocks.clear();
+        m_firstBlock = 1;
+        m_blockInputBytes = 0;
+        m_blockStoredBytes = 0;
+        m_decodedBlock = 0;
+        m_decodedTotal = 0;
+        m_decodeNs = 0;
+    }
+    m_writer.reset();
+    m_writerSize = 0;
+    m_spillDisabled = false;
+    m_pendingIndex = 0;
+    m_spillBlock = 0;
+    m_spillDir.reset(); // Xóa thư mục segment
+}
+
+qsizetype PacketStore::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_spilled + static_cast<qsizetype>(m_recent.size());
+}
+
+uint32_t PacketStore::maxInterfaceId() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxInterfaceId;
+}
+
+bool PacketStore::at(qsizetype index, PacketData& out) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (index < 0 || index >= m_spilled + static_cast<qsizetype>(m_recent.size())) return false;
+    if (index >= m_spilled) {
+        const StoredPacket& stored = m_recent[static_cast<size_t>(index - m_spilled)];
+        out = stored.packet;
+        return stored.block == 0 || restoreBytes(stored, out);
+    }
+    Location location;
+    const uchar* record = nullptr;
+    return locate(index, location, record) && readSpilled(record, out);
+}
+
+bool PacketStore::mid(qsizetype begin, qsizetype count, QList<PacketData>& out, bool withBytes) const
+{
+    out.clear();
+    QMutexLocker locker(&m_mutex);
+    const qsizetype total = m_spilled + static_cast<qsizetype>(m_recent.size());
+    begin = std::max<qsizetype>(begin, 0);
+    const qsizetype end = std::min(total, begin + std::max<qsizetype>(count, 0));
+    if (begin >= end) return true;
+    out.reserve(end - begin);
+
+    // 1. Phần trên đĩa: tới mốc chỉ mục một lần rồi đọc tuần tự
+    qsizetype pos = begin;
+    if (pos < m_spilled) {
+        Location location;
+        const uchar* record = nullptr;
+        if (!locate(pos, location, record)) return false;
+        while (pos < std::min(end, m_spilled)) {
+            PacketData packet;
+            if (!readSpilled(record, packet)) return false;
+            out.append(std::move(packet));
+            if (++pos < m_spilled && !nextRecord(location, record)) return false;
+        }
+    }
+
+    // 2. Phần trong RAM (gói liền nhau nằm cùng khối: mỗi khối giải nén một lần)
+    for (; pos < end; ++pos) {
+        const StoredPacket& stored = m_recent[static_cast<size_t>(pos - m_spilled)];
+        out.append(stored.packet);
+        if (withBytes && stored.block != 0 && !restoreBytes(stored, out.last())) {
+            out.removeLast();
+            return false;
+        }
+    }
+    return true;
+}
+
+void PacketStore::sortKeys(const std::vector<quint32>& packetIds, std::vector<SortKey>& keys,
+                           std::vector<QString>& protocolNames) const
+{
+    keys.assign(packetIds.size(), SortKey());
+    QMutexLocker locker(&m_mutex);
+    for (size_t i = 0; i < packetIds.size(); ++i) {
+        const size_t index = static_cast<size_t>(packetIds[i]) - 1;
+        if (packetIds[i] != 0 && index < m_sortKeys.size()) keys[i] = m_sortKeys[index];
+    }
+    protocolNames = m_protocolNames;
+}
+
+qsizetype PacketStore::lowerBoundTime(int64_t ns) const
+{
+    QMutexLocker locker(&m_mutex);
+    qsizetype low = 0;
+    qsizetype high = m_spilled + static_cast<qsizetype>(m_recent.size());
+    while (low < high) {
+        const qsizetype middle = low + (high - low) / 2;
+        if (timestampAt(middle) < ns) low = middle + 1;
+        else high = middle;
+    }
+    return low;
+}
+
+void PacketStore::packPendingBytes()
+{
+    // (Luồng ghi) Các gói chưa vào khối: đủ BLOCK_BYTES byte thô thì gom thành một khối
+    const qsizetype total = m_spilled + static_cast<qsizetype>(m_recent.size());
+    qsizetype first = std::max(m_pendingIndex, m_spilled);
+    qint64 bytes = 0;
+    for (qsizetype i = first; i < total; ++i) {
+        bytes += static_cast<qint64>(m_recent[static_cast<size_t>(i - m_spilled)].packet.raw_packet.size());
+        if (bytes < BLOCK_BYTES) continue;
+        packBlock(first, i + 1, bytes);
+        first = i + 1;
+        bytes = 0;
+    }
+    m_pendingIndex = first;
+}
+
+void PacketStore::packBlock(qsizetype begin, qsizetype end, qint64 rawBytes)
+{
+    // (Luồng ghi) Nén ngoài khóa; chỉ việc gắn khối vào gói và bỏ byte thô diễn ra trong khóa
+    std::vector<uint8_t> raw;
+    raw.reserve(static_cast<size_t>(rawBytes));
+    for (qsizetype i = begin; i < end; ++i) {
+        const std::vector<uint8_t>& bytes = m_recent[static_cast<size_t>(i - m_spilled)].packet.raw_packet;
+        raw.insert(raw.end(), bytes.begin(), bytes.end());
+    }
+
+    ByteBlock block;
+    block.rawSize = static_cast<uint32_t>(raw.size());
+    block.lastIndex = end - 1;
+    std::vector<uint8_t> packed(BlockCodec::maxCompressedSize(raw.size()));
+    const size_t packedSize = BlockCodec::compress(raw.data(), raw.size(), packed.data(), packed.size());
+    if (packedSize > 0 && packedSize < raw.size()) {
+        packed.resize(packedSize);
+        packed.shrink_to_fit();
+        block.data = std::move(packed);
+        block.compressed = true;
+    } else {
+        block.data = std::move(raw); // Không nén được (dữ liệu đã mã hóa / nén): vẫn gộp một bộ đệm
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const uint64_t id = m_firstBlock + m_blocks.size();
+    uint32_t offset = 0;
+    for (qsizetype i = begin; i < end; ++i) {
+        StoredPacket& stored = m_recent[static_cast<size_t>(i - m_spilled)];
+        const qint64 before = footprint(stored.packet);
+        stored.block = id;
+        stored.offset = offset;
+        stored.length = static_cast<uint32_t>(stored.packet.raw_packet.size());
+        offset += stored.length;
+        std::vector<uint8_t>().swap(stored.packet.raw_packet);
+        m_memoryBytes -= before - footprint(stored.packet);
+    }
+    m_memoryBytes += static_cast<qint64>(block.data.capacity());
+    m_blockInputBytes += block.rawSize;
+    m_blockStoredBytes += static_cast<qint64>(block.data.size());
+    m_blocks.push_back(std::move(block));
+}
+
+void PacketStore::spillIfNeeded()
+{
+    // (Luồng ghi) Chỉ luồng này thay đổi m_recent / segment, nên đọc chúng ngoài khóa là an toàn;
+    // mọi thay đổi người đọc nhìn thấy được công bố một lần trong khóa ở cuối
+    qint64 budget;
+    qint64 memory;
+    {
+        QMutexLocker locker(&m_mutex);
+        budget = m_memoryBudget;
+        memory = m_memoryBytes;
+    }
+    if (m_spillDisabled || memory <= budget) return;
+
+    // 1. Ghi các gói cũ nhất tới khi phần trong RAM còn 3/4 ngân sách (có khoảng trễ: không đổ mỗi lô)
+    const qint64 target = budget - budget / 4;
+    std::vector<std::pair<uint32_t, qint64>> sealed;   // Segment đã ghi xong trong lần này: kích thước cuối
+    std::vector<Location> newIndex;
+    QByteArray record;
+    QString error;
+    size_t count = 0;
+    qint64 freed = 0;
+
+    while (count < m_recent.size() && memory - freed > target) {
+        const StoredPacket& stored = m_recent[count];
+        record.clear();
+        if (stored.block == 0) {
+            appendRecord(record, stored.packet);
+        } else {
+            // Bản ghi trên đĩa luôn chứa byte thô: giải nén khối vào bộ đệm riêng của luồng ghi
+            PacketData packet = stored.packet;
+            if (!extractBytes(stored, m_spillBytes, m_spillBlock, packet)) {
+                error = "Cannot decode packet bytes";
+                break;
+            }
+            appendRecord(record, packet);
+        }
+
+        if (!m_writer || (m_writerSize > 0 && m_writerSize + record.size() > SEGMENT_BYTES)) {
+            if (m_writer) {
+                if (!m_writer->flush()) {
+                    error = m_writer->errorString();
+                    break;
+                }
+                sealed.push_back({ static_cast<uint32_t>(m_segmentPaths.size() - 1), m_writerSize });
+            }
+            if (!openWriterSegment(error)) break;
+        }
+        const uint32_t segment = static_cast<uint32_t>(m_segmentPaths.size() - 1);
+        if ((m_spilled + static_cast<qsizetype>(count)) % SPILL_INDEX_INTERVAL == 0) {
+            newIndex.push_back({ segment, m_writerSize });
+        }
+        if (m_writer->write(record) != record.size()) {
+            error = m_writer->errorString();
+            break;
+        }
+        m_writerSize += record.size();
+        freed += footprint(stored.packet);
+        if (stored.block != 0) {
+            // Gói cuối của khối ra đĩa: khối được bỏ khi công bố
+            const ByteBlock& block = m_blocks[static_cast<size_t>(stored.block - m_firstBlock)];
+            if (block.lastIndex == m_spilled + static_cast<qsizetype>(count)) {
+                freed += static_cast<qint64>(block.data.capacity());
+            }
+        }
+        ++count;
+    }
+    if (m_writer && !m_writer->flush() && error.isEmpty()) {
+        // Byte chưa chắc đã ra đĩa: không công bố gì ở lần này
+        error = m_writer->errorString();
+        count = 0;
+    }
+    if (!error.isEmpty()) {
+        // Không đổ được nữa: giữ các gói còn lại trong RAM (vượt ngân sách) thay vì mất dữ liệu
+        m_spillDisabled = true;
+        qWarning() << "PacketStore: spilling disabled:" << error;
+    }
+
+    // 2. Công bố: kích thước segment, mốc chỉ mục, rồi mới bỏ các gói khỏi RAM
+    QMutexLocker locker(&m_mutex);
+    if (!error.isEmpty()) m_error = error;
+    if (count == 0) return;
+    for (const auto& [segment, size] : sealed) m_segmentSizes[segment] = size;
+    m_segmentSizes.back() = m_writerSize;
+    const size_t published = (static_cast<size_t>(m_spilled) + count + SPILL_INDEX_INTERVAL - 1) / SPILL_INDEX_INTERVAL;
+    newIndex.resize(std::min(newIndex.size(), published - m_index.size()));
+    m_index.insert(m_index.end(), newIndex.begin(), newIndex.end());
+    m_recent.erase(m_recent.begin(), m_recent.begin() + static_cast<std::ptrdiff_t>(count));
+    m_spilled += static_cast<qsizetype>(count);
+    m_memoryBytes -= freed;
+    while (!m_blocks.empty() && m_blocks.front().lastIndex < m_spilled) {
+        m_blocks.pop_front();
+        ++m_firstBlock;
+    }
+}
+
+bool PacketStore::openWriterSegment(QString& error)
+{
+    // (Luồng ghi)
+    if (!m_spillDir) {
+        m_spillDir = std::make_unique<QTemporaryDir>(QDir::tempPath() + "/wiresharkmini-spill-XXXXXX");
+        if (!m_spillDir->isValid()) {
+            error = "Cannot create spill directory: " + m_spillDir->errorString();
+            m_spillDir.reset();
+            return false;
+        }
+    }
+    const QString path = m_spillDir->filePath(QString("segment-%1.bin").arg(m_segmentPaths.size(), 5, 10, QChar('0')));
+    std::unique_ptr<QFile> file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::WriteOnly)) {
+        error = "Cannot create " + path + ": " + file->errorString();
+        return false;
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_segmentPaths.push_back(path);
+        m_segmentSizes.push_back(0);
+    }
+    m_writer = std::move(file);
+    m_writerSize = 0;
+    return true;
+}
+
+bool PacketStore::locate(qsizetype index, Location& location, const uchar*& record) const
+{
+    const size_t entry = static_cast<size_t>(index / SPILL_INDEX_INTERVAL);
+    if (entry >= m_index.size()) return false;
+    location = m_index[entry];
+    const uchar* data = mappedSegment(location.segment, location.offset + RECORD_HEADER_BYTES);
+    if (!data) return false;
+    record = data + location.offset;
+    for (qsizetype skip = index % SPILL_INDEX_INTERVAL; skip > 0; --skip) {
+        if (!nextRecord(location, record)) return false;
+    }
+    return true;
+}
+
+bool PacketStore::nextRecord(Location& location, const uchar*& record) const
+{
+    location.offset += RECORD_HEADER_BYTES + recordLength(record);
+    if (location.offset >= m_segmentSizes[location.segment]) {
+        ++location.segment;
+        location.offset = 0;
+        if (location.segment >= m_segmentSizes.size()) return false;
+    }
+    const uchar* data = mappedSegment(location.segment, location.offset + RECORD_HEADER_BYTES);
+    if (!data) return false;
+    record = data + location.offset;
+    return true;
+}
+
+const uchar* PacketStore::mappedSegment(uint32_t segment, qint64 needed) const
+{
+    const qint64 published = m_segmentSizes[segment];
+    if (needed > published) return nullptr;
+
+    auto it = std::find_if(m_mapped.begin(), m_mapped.end(),
+                           [segment](const MappedSegment& mapped) { return mapped.segment == segment; });
+    if (it != m_mapped.end() && it->size >= needed) {
+        it->lastUse = ++m_useClock;
+        return it->data;
+    }
+    if (it != m_mapped.end()) {
+        // Segment đang ghi đã dài thêm từ lần map trước: map lại toàn bộ phần đã công bố
+        m_mapped.erase(it);
+    } else if (m_mapped.size() >= HOT_SEGMENTS) {
+        m_mapped.erase(std::min_element(m_mapped.begin(), m_mapped.end(),
+                                        [](const MappedSegment& a, const MappedSegment& b) { return a.lastUse < b.lastUse; }));
+    }
+
+    MappedSegment mapped;
+    mapped.segment = segment;
+    mapped.file = std::make_unique<QFile>(m_segmentPaths[segment]);
+    if (!mapped.file->open(QIODevice::ReadOnly)) return nullptr;
+    mapped.data = mapped.file->map(0, published);
+    if (!mapped.data) return nullptr;
+    mapped.size = published;
+    mapped.lastUse = ++m_useClock;
+    m_mapped.push_back(std::move(mapped));
+    return m_mapped.back().data;
+}
+
+bool PacketStore::readSpilled(const uchar* record, PacketData& out) const
+{
+    out = PacketData();
+    RecordReader reader(record + RECORD_HEADER_BYTES, recordLength(record));
+    visitFields(reader, out);
+    if (!reader.ok()) return false;
+    auto patched = m_spilledReassembledIn.constFind(out.packet_id);
+    if (patched != m_spilledReassembledIn.constEnd()) out.reassembled_in = patched.value();
+    return true;
+}
+
+bool PacketStore::restoreBytes(const StoredPacket& stored, PacketData& out) const
+{
+    // (Gọi khi đang giữ m_mutex) Chỉ đo khi thật sự giải nén một khối mới
+    const ByteBlock& block = m_blocks[static_cast<size_t>(stored.block - m_firstBlock)];
+    if (!block.compressed || m_decodedBlock == stored.block) {
+        return extractBytes(stored, m_decodedBytes, m_decodedBlock, out);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = extractBytes(stored, m_decodedBytes, m_decodedBlock, out);
+    m_decodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (ok) m_decodedTotal += block.rawSize;
+    return ok;
+}
+
+bool PacketStore::extractBytes(const StoredPacket& stored, std::vector<uint8_t>& cache, uint64_t& cachedBlock,
+                               PacketData& out) const
+{
+    const ByteBlock& block = m_blocks[static_cast<size_t>(stored.block - m_firstBlock)];
+    const uint8_t* bytes = block.data.data();
+    if (block.compressed) {
+        if (cachedBlock != stored.block) {
+            cachedBlock = 0;
+            cache.resize(block.rawSize);
+            if (!BlockCodec::decompress(block.data.data(), block.data.size(), cache.data(), cache.size())) return false;
+            cachedBlock = stored.block;
+        }
+        bytes = cache.data();
+    }
+    out.raw_packet.assign(bytes + stored.offset, bytes + stored.offset + stored.length);
+    return true;
+}
+
+int64_t PacketStore::timestampAt(qsizetype index) const
+{
+    if (index >= m_spilled) {
+        return timestampNs(m_recent[static_cast<size_t>(index - m_spilled)].packet.timestamp);
+    }
+    Location location;
+    const uchar* record = nullptr;
+    if (!locate(index, location, record)) return 0;
+    timespec ts;
+    memcpy(&ts, record + RECORD_TIMESTAMP_OFFSET, sizeof(ts));
+    return timestampNs(ts);
+}
@@ -0,0 +1,187 @@
+#ifndef PACKETSTORE_HPP
+#define PACKETSTORE_HPP
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "../../Common/PacketData.hpp"
+
+class QFile;
+class QTemporaryDir;
+
+/**
+ * @brief Danh sách gói chính của phiên, với RAM bị chặn trên.
+ *
+ * Gói mới nằm trong RAM (deque) cho tới khi tổng dung lượng ước tính vượt ngân sách bộ nhớ;
+ * khi đó các gói cũ nhất được ghi nối tiếp (append-only) vào các segment trong thư mục tạm
+ * và bỏ khỏi RAM, tới khi còn 3/4 ngân sách. Mỗi bản ghi chứa byte thô cùng toàn bộ kết quả
+ * giải mã (header, tầng ứng dụng, cây chi tiết, phân tích TCP), nên gói đọc lại giống hệt
+ * bản trong RAM mà không phải parse lại (việc ghép mảnh / ghép luồng phụ thuộc trạng thái).
+ *
+ * Khi bật nén, byte thô của các gói trong RAM được gom thành khối ~64 KB và nén (BlockCodec,
+ * định dạng khối LZ4); gói chỉ giữ vị trí của mình trong khối. Byte được giải nén khi cần
+ * (chọn gói, lưu file, đổ ra đĩa), với một khối vừa giải nén được giữ lại cho lần đọc kế tiếp.
+ *
+ * Vị trí = packet_id - 1. Gói đã đổ ra đĩa được đọc qua mmap (QFile::map), giữ một LRU
+ * nhỏ các segment đang map; một mốc chỉ mục thưa mỗi SPILL_INDEX_INTERVAL gói.
+ * Chỉ luồng xử lý (PacketPipeline) ghi; mọi luồng đọc được (khóa nội bộ). Byte được đổ ra
+ * đĩa ngoài khóa, nên luồng GUI không phải chờ I/O ghi.
+ */
+class PacketStore
+{
+public:
+    static constexpr qint64 DEFAULT_MEMORY_BUDGET = 512LL << 20;
+    static constexpr qint64 MIN_MEMORY_BUDGET = 16LL << 20;
+
+    struct Usage {
+        qsizetype packets = 0;
+        qsizetype spilled = 0;       // Số gói chỉ còn trên đĩa
+        qint64 memoryBytes = 0;      // Ước tính dung lượng các gói trong RAM
+        qint64 diskBytes = 0;
+        int segments = 0;
+        // Nén byte thô (cộng dồn trong phiên)
+        qint64 blockInputBytes = 0;  // Byte thô đã gom vào khối
+        qint64 blockStoredBytes = 0; // Byte của các khối sau nén
+        qint64 decodedBytes = 0;     // Byte đã giải nén khi đọc lại
+        qint64 decodeNs = 0;         // Thời gian giải nén
+    };
+
+    // Khóa sắp xếp gọn của một gói (giữ trong RAM cho mọi gói, kể cả gói đã ra đĩa)
+    struct SortKey {
+        int64_t timeNs = 0;
+        uint32_t length = 0;     // Độ dài trên dây (cột Length)
+        uint16_t protocol = 0;   // Chỉ số trong bảng tên giao thức (cột Protocol)
+        bool valid = false;      // (sortKeys) false: gói không có trong store
+    };
+
+    PacketStore();
+    ~PacketStore();
+
+    PacketStore(const PacketStore&) = delete;
+    PacketStore& operator=(const PacketStore&) = delete;
+
+    // Áp dụng từ lần thêm lô kế tiếp (việc đổ ra đĩa luôn chạy trên luồng xử lý)
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const;
+    // Nén byte thô của các gói mới (gói đã nằm trong khối vẫn đọc được khi tắt)
+    void setCompression(bool enabled);
+    bool compression() const;
+    Usage usage() const;
+    // Lỗi ghi segment gần nhất (khi đó các gói ở lại RAM); rỗng nếu không có
+    QString errorString() const;
+
+    // --- GHI (chỉ luồng xử lý) ---
+    void append(const QList<PacketData>& batch);
+    // "Reassembled in" của một mảnh IP (mảnh đã ra đĩa: ghi đè khi đọc lại)
+    void setReassembledIn(uint32_t packetId, uint32_t reassembledIn);
+    void clear();
+
+    // --- ĐỌC (mọi luồng) ---
+    qsizetype size() const;
+    bool isEmpty() const { return size() == 0; }
+    bool at(qsizetype index, PacketData& out) const;
+    // Tối đa 'count' gói từ 'begin' (ít hơn nếu hết danh sách).
+    // false: không đọc được gói begin + out.size() (segment hỏng, khối không giải nén được);
+    // out chỉ chứa các gói trước nó, mọi gói trong out đều đầy đủ.
+    // withBytes = false: bỏ qua giải nén, raw_packet có thể rỗng (lọc, I/O Graph chỉ cần trường đã giải mã)
+    bool mid(qsizetype begin, qsizetype count, QList<PacketData>& out, bool withBytes = true) const;
+    // Vị trí gói đầu tiên có timestamp >= ns (timestamp coi như không giảm); size() nếu không có
+    qsizetype lowerBoundTime(int64_t ns) const;
+    // Khóa sắp xếp của các gói theo packet_id (cùng thứ tự với packetIds) và bảng tên giao thức
+    // cho SortKey::protocol. Không đọc đĩa: sắp xếp bảng gói không phải đọc lại gói đã ra đĩa.
+    void sortKeys(const std::vector<quint32>& packetIds, std::vector<SortKey>& keys,
+                  std::vector<QString>& protocolNames) const;
+    uint32_t maxInterfaceId() const;
+
+private:
+    struct Location {
+        uint32_t segment = 0;
+        qint64 offset = 0;
+    };
+    struct StoredPacket {
+        PacketData packet;
+        uint64_t block = 0;      // Khối chứa byte thô; 0 = byte còn trong packet.raw_packet
+        uint32_t offset = 0;     // Vị trí / độ dài trong khối đã giải nén
+        uint32_t length = 0;
+    };
+    struct ByteBlock {
+        std::vector<uint8_t> data;
+        uint32_t rawSize = 0;
+        bool compressed = false; // false: không nén được, data là byte thô
+        qsizetype lastIndex = 0; // Vị trí gói cuối cùng trong khối
+    };
+    struct MappedSegment {
+        uint32_t segment = 0;
+        std::unique_ptr<QFile> file;
+        const uchar* data = nullptr;
+        qint64 size = 0;
+        quint64 lastUse = 0;
+    };
+
+    void packPendingBytes();
+    void packBlock(qsizetype begin, qsizetype end, qint64 rawBytes);
+    void spillIfNeeded();
+    bool openWriterSegment(QString& error);
+
+    // (Gọi khi đang giữ m_mutex)
+    bool locate(qsizetype index, Location& location, const uchar*& record) const;
+    const uchar* mappedSegment(uint32_t segment, qint64 needed) const;
+    bool readSpilled(const uchar* record, PacketData& out) const;
+    bool nextRecord(Location& location, const uchar*& record) const;
+    bool restoreBytes(const StoredPacket& stored, PacketData& out) const;
+    // Chép byte của gói từ khối (giải nén vào 'cache' nếu khối trong cache không phải khối đó)
+    bool extractBytes(const StoredPacket& stored, std::vector<uint8_t>& cache, uint64_t& cachedBlock,
+                      PacketData& out) const;
+    int64_t timestampAt(qsizetype index) const;
+
+    mutable QMutex m_mutex;
+    qint64 m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+    // --- Mọi gói (vị trí = packet_id - 1): khóa sắp xếp và bảng tên giao thức ---
+    std::vector<SortKey> m_sortKeys;
+    std::vector<QString> m_protocolNames;
+    QHash<QString, uint16_t> m_protocolIds;
+
+    // --- Phần trong RAM: gói [m_spilled, m_spilled + m_recent.size()) ---
+    std::deque<StoredPacket> m_recent;
+    qint64 m_memoryBytes = 0;                // Gói + khối byte
+    uint32_t m_maxInterfaceId = 0;
+    bool m_compression = true;
+    std::deque<ByteBlock> m_blocks;          // Khối của các gói còn trong RAM
+    uint64_t m_firstBlock = 1;               // Số hiệu của m_blocks.front()
+    qint64 m_blockInputBytes = 0;
+    qint64 m_blockStoredBytes = 0;
+
+    // Khối giải nén gần nhất (đọc trong khóa, nên mutable)
+    mutable uint64_t m_decodedBlock = 0;
+    mutable std::vector<uint8_t> m_decodedBytes;
+    mutable qint64 m_decodedTotal = 0;
+    mutable qint64 m_decodeNs = 0;
+
+    // --- Phần trên đĩa: gói [0, m_spilled) ---
+    qsizetype m_spilled = 0;
+    std::unique_ptr<QTemporaryDir> m_spillDir;
+    std::vector<QString> m_segmentPaths;
+    std::vector<qint64> m_segmentSizes;      // Số byte đã công bố (đã flush) của mỗi segment
+    std::vector<Location> m_index;           // Bản ghi của gói đầu mỗi nhóm SPILL_INDEX_INTERVAL gói
+    QHash<uint32_t, uint32_t> m_spilledReassembledIn;
+    QString m_error;
+
+    // LRU các segment đang map (đọc trong khóa, nên mutable)
+    mutable std::vector<MappedSegment> m_mapped;
+    mutable quint64 m_useClock = 0;
+
+    // --- Chỉ luồng ghi ---
+    std::unique_ptr<QFile> m_writer;         // Segment đang ghi nối tiếp
+    qint64 m_writerSize = 0;
+    bool m_spillDisabled = false;            // Đã lỗi ghi: không thử lại trong phiên này
+    qsizetype m_pendingIndex = 0;            // Gói đầu tiên chưa được gom vào khối
+    std::vector<uint8_t> m_spillBytes;       // Khối giải nén riêng của luồng ghi (khi đổ ra đĩa)
+    uint64_t m_spillBlock = 0;
+};
+
+#endif // PACKETSTORE_HPP
@@ -5,45 +5,64 @@
 #include <QMap>
 #include <QString>
 #include <QList>
+#include <QTimer>
 #include <QVector>
-#include <QPointF>
-#include "../../Common/PacketData.hpp"
+#include "../../Common/StatsShard.hpp"
 
+/**
+ * @brief Thống kê tổng hợp cho UI.
+ *
+ * Việc đếm diễn ra trên các luồng capture (mỗi luồng một StatsShard); lớp này chỉ
+ * lấy snapshot của từng nguồn theo chu kỳ cố định (không khóa) và gộp lại.
+ * Các getter đọc bản đã gộp, nên không bao giờ chặn luồng dữ liệu.
+ */
 class StatisticsManager : public QObject
 {
     Q_OBJECT
 public:
     explicit StatisticsManager(QObject *parent = nullptr);
 
+    // Đăng ký kênh snapshot của một worker (thuộc sở hữu của worker, phải sống lâu hơn manager)
+    void addSource(StatsExchange* source);
+
     // --- CÁC HÀM GETTER ---
     QMap<QString, qint64> getProtocolCounts() const;
-    QMap<QString, qint64> getSourceIpCounts() const;
-    QMap<QString, qint64> getDestIpCounts() const;
     qint64 getTotalPackets() const;
-    //  Hàm tính toán dữ liệu I/O Graph ---
-    // intervalMs: Khoảng thời gian (ví dụ 1000ms = 1 giây)
-    // modeBytes: true = Bytes/sec, false = Packets/sec
-    QVector<QPointF> calculateIOGraphData(const QList<PacketData>& packets, int intervalMs, bool modeBytes);
 
-public slots:
-    // (Hàm cũ xử lý 1 gói)
-    void processPacket(const PacketData &packet);
+    // Top-K địa chỉ nguồn / đích theo gói (byBytes = false) hoặc theo byte, kèm sai số
+    QList<HeavyHitter> getTopSources(int k, bool byBytes) const;
+    QList<HeavyHitter> getTopDestinations(int k, bool byBytes) const;
+    // Số địa chỉ phân biệt (ước lượng HyperLogLog, sai số tương đối distinctRelativeError())
+    double getDistinctSources() const;
+    double getDistinctDestinations() const;
+    double distinctRelativeError() const;
+
+    static QString addressToString(const AddressKey& key);
 
-    // Hàm xử lý 1 LÔ (batch) ---
-    void processPackets(const QList<PacketData> &packetBatch);
+    // Cây Protocol Hierarchy (gói / byte ở mỗi tầng), cộng dồn theo proto_path của Parser
+    const ProtocolHierarchy& protocolHierarchy() const { return m_merged.hierarchy(); }
+    // Phân bố độ dài frame (byte trên dây)
+    const LogHistogram& frameLengths() const { return m_merged.frameLengths(); }
+    // Số liệu chia lô của các luồng capture (kích thước lô, độ trễ, lý do gửi)
+    const BatchMetrics& batchMetrics() const { return m_merged.batchMetrics(); }
+    // Gói bỏ qua / chỉ đếm / spool khi tạm dừng và số gói kernel làm rơi
+    const CaptureCounters& captureCounters() const { return m_merged.captureCounters(); }
+    // Tốc độ phát lại đạt được so với mục tiêu (khi nguồn là file phát lại)
+    const ReplayMetrics& replayMetrics() const { return m_merged.replayMetrics(); }
 
+public slots:
     void clear();
 
+private slots:
+    // Lấy snapshot mới của các nguồn và gộp lại (chạy theo m_snapshotTimer)
+    void refreshSnapshot();
+
 private:
-    // --- 4 BỘ ĐẾM ---
-    qint64 m_totalPackets;
-    QMap<QString, qint64> m_protocolCounts;
-    QMap<QString, qint64> m_sourceIpCounts;
-    QMap<QString, qint64> m_destIpCounts;
-
-    // --- HÀM HỖ TRỢ ---
-    static QString ipToString(uint32_t ip_host_order);
-    static QString ipv6ToString(const std::array<uint8_t, 16>& ip);
+    QVector<StatsExchange*> m_sources;
+    QTimer m_snapshotTimer;
+
+    // --- BẢN GỘP (chỉ luồng GUI đọc / ghi) ---
+    StatsShard m_merged;
 };
 
 #endif // STATISTICSMANAGER_HPP
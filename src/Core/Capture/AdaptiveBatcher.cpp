@@ -0,0 +1,87 @@
+#include "AdaptiveBatcher.hpp"
+#include <algorithm>
+#include <cmath>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Trọng số của mẫu mới trong trung bình trượt tốc độ đến
+static const double RATE_EWMA_ALPHA = 0.25;
+
+// Lô mục tiêu = số gói đến trong một nửa ngân sách độ trễ: ở tốc độ ổn định lô được gửi
+// theo số gói trước khi chạm hạn, hạn độ trễ chỉ còn là chặn trên khi tốc độ giảm đột ngột
+static const double TARGET_FILL = 0.5;
+
+// Cửa sổ tối thiểu khi tính tốc độ (tránh chia cho khoảng thời gian ~0)
+static const int64_t MIN_RATE_WINDOW_NS = 1000;
+
+// --- Triển khai (Implementation) ---
+
+AdaptiveBatcher::AdaptiveBatcher(const Config& config)
+    : m_config(config),
+    m_maxDelayNs(static_cast<int64_t>(std::max(config.maxDelayMs, 1)) * 1000000),
+    m_targetPackets(config.minPackets)
+{
+    m_config.maxPackets = std::max(m_config.maxPackets, m_config.minPackets);
+}
+
+void AdaptiveBatcher::add(int64_t nowNs, uint32_t bytes)
+{
+    if (m_packets == 0) m_oldestNs = nowNs;
+    if (m_windowStartNs < 0) m_windowStartNs = nowNs;
+    ++m_packets;
+    m_bytes += bytes;
+}
+
+bool AdaptiveBatcher::shouldFlush(int64_t nowNs, BatchMetrics::FlushReason& reason) const
+{
+    if (m_packets == 0) return false;
+    if (m_packets >= m_targetPackets) {
+        reason = BatchMetrics::FLUSH_COUNT;
+        return true;
+    }
+    if (m_bytes >= m_config.maxBytes) {
+        reason = BatchMetrics::FLUSH_BYTES;
+        return true;
+    }
+    if (nowNs - m_oldestNs >= m_maxDelayNs) {
+        reason = BatchMetrics::FLUSH_AGE;
+        return true;
+    }
+    return false;
+}
+
+void AdaptiveBatcher::flushed(int64_t nowNs, BatchMetrics::FlushReason reason, BatchMetrics& metrics)
+{
+    if (m_packets == 0) return;
+
+    // 1. Số liệu của lô vừa gửi
+    metrics.flushes[reason]++;
+    metrics.packets += m_packets;
+    metrics.bytes += m_bytes;
+    metrics.batchPackets.add(m_packets);
+    metrics.batchDelayNs.add(static_cast<uint64_t>(std::max<int64_t>(nowNs - m_oldestNs, 0)));
+
+    // 2. Tốc độ đến trong cửa sổ từ lần gửi trước tới giờ
+    const int64_t window = std::max(nowNs - m_windowStartNs, MIN_RATE_WINDOW_NS);
+    const double sample = m_packets * 1e9 / static_cast<double>(window);
+    m_arrivalRate = (m_arrivalRate == 0.0) ? sample
+                                           : m_arrivalRate + RATE_EWMA_ALPHA * (sample - m_arrivalRate);
+    m_windowStartNs = nowNs;
+
+    // 3. Kích thước lô mục tiêu cho lần sau
+    const double target = std::round(m_arrivalRate * (m_maxDelayNs / 1e9) * TARGET_FILL);
+    m_targetPackets = static_cast<uint32_t>(std::clamp(target, static_cast<double>(m_config.minPackets),
+                                                       static_cast<double>(m_config.maxPackets)));
+
+    metrics.arrivalRate = m_arrivalRate;
+    metrics.targetPackets = m_targetPackets;
+
+    m_packets = 0;
+    m_bytes = 0;
+}
+
+int64_t AdaptiveBatcher::nsUntilDeadline(int64_t nowNs) const
+{
+    if (m_packets == 0) return -1;
+    return std::max<int64_t>(m_oldestNs + m_maxDelayNs - nowNs, 0);
+}
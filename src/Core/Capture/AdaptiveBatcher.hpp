@@ -0,0 +1,58 @@
+#ifndef ADAPTIVEBATCHER_HPP
+#define ADAPTIVEBATCHER_HPP
+
+#include <cstdint>
+#include "../../Common/BatchMetrics.hpp"
+
+/**
+ * @brief Quyết định khi nào luồng capture gửi lô gói lên tầng xử lý.
+ *
+ * Ba điều kiện gửi: đủ số gói mục tiêu, đủ số byte tối đa, hoặc gói cũ nhất trong lô
+ * đã chờ hết ngân sách độ trễ (maxDelayMs). Số gói mục tiêu tính từ tốc độ đến quan sát được
+ * (trung bình trượt theo từng lô): tốc độ thấp -> lô nhỏ, gửi theo hạn độ trễ;
+ * tốc độ cao -> lô lớn (tới maxPackets), ít lần gửi hơn.
+ * Thời gian truyền vào là ns của một đồng hồ đơn điệu (QElapsedTimer). Chỉ dùng trên một luồng.
+ */
+class AdaptiveBatcher {
+public:
+    struct Config {
+        int maxDelayMs = 50;                  // Ngân sách độ trễ của một gói trong lô
+        uint32_t minPackets = 16;
+        uint32_t maxPackets = 8192;
+        uint64_t maxBytes = 8ull << 20;       // 8 MiB
+    };
+
+    explicit AdaptiveBatcher(const Config& config);
+
+    // Gói mới vào lô (bytes: độ dài đã bắt)
+    void add(int64_t nowNs, uint32_t bytes);
+    // true nếu cần gửi lô ngay; reason: điều kiện đã chạm
+    bool shouldFlush(int64_t nowNs, BatchMetrics::FlushReason& reason) const;
+    // Lô vừa được gửi: ghi số liệu và cập nhật tốc độ / kích thước mục tiêu
+    void flushed(int64_t nowNs, BatchMetrics::FlushReason reason, BatchMetrics& metrics);
+
+    // Thời gian (ns) còn lại tới hạn độ trễ của lô hiện tại; -1 nếu lô rỗng
+    int64_t nsUntilDeadline(int64_t nowNs) const;
+
+    bool isEmpty() const { return m_packets == 0; }
+    // Lô đã tới số gói / byte tối đa (chỉ xảy ra khi lô đang bị giữ, chưa gửi được)
+    bool isFull() const { return m_packets >= m_config.maxPackets || m_bytes >= m_config.maxBytes; }
+    uint32_t targetPackets() const { return m_targetPackets; }
+    double arrivalRate() const { return m_arrivalRate; }
+
+private:
+    Config m_config;
+    int64_t m_maxDelayNs;
+
+    // --- Lô hiện tại ---
+    uint32_t m_packets = 0;
+    uint64_t m_bytes = 0;
+    int64_t m_oldestNs = 0;          // Thời điểm gói đầu tiên của lô vào
+
+    // --- Ước lượng tốc độ ---
+    int64_t m_windowStartNs = -1;    // Lần gửi trước (hoặc gói đầu tiên)
+    double m_arrivalRate = 0.0;      // Gói/s
+    uint32_t m_targetPackets;
+};
+
+#endif // ADAPTIVEBATCHER_HPP
@@ -1,241 +1,615 @@
 #include "CaptureEngine.hpp"
 #include "Parser.hpp"
+#include "PauseSpool.hpp"
+#include "InterfaceReader.hpp"
+#include "ReplayReader.hpp"
+#include "TimestampMerger.hpp"
+#include "CaptureFileMerger.hpp"
 #include <QThread>
 #include <QRandomGenerator>
 #include <QTime>
 #include <QString>
 #include <QMetaObject>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <initializer_list>
+
+const int DEFAULT_LATENCY_TARGET_MS = 50;   // Gói hiện lên trong ~50ms kể từ lúc đến
+const int STATS_PUBLISH_INTERVAL_MS = 250; // Chu kỳ đẩy snapshot thống kê
+const int IDLE_POLL_MS = STATS_PUBLISH_INTERVAL_MS; // Chờ tối đa khi không có gói (dừng / tạm dừng đánh thức ngay)
+const uint64_t PAUSE_SPOOL_MAX_BYTES = 1ull << 30; // Giới hạn file tạm khi tạm dừng (1 GiB)
+const int REPLAY_DRAIN_INTERVAL = 1024;     // Phát lại bao nhiêu gói thì nhận gói mới từ các reader một lần
+const int MAX_DRAIN_PACKETS = 65536;        // Số gói tối đa ghi nối vào spool mỗi lần trong lúc phát lại
+const int MAX_BATCHES_IN_FLIGHT = 8;        // Số lô tối đa đã gửi mà tầng xử lý chưa xong (giới hạn RAM hàng đợi)
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Chờ reader báo có gói hoặc tín hiệu dừng / tạm dừng, tối đa tới hạn gần nhất (-1: không có hạn)
+static void waitForWakeup(WakeupFd& wakeup, int64_t nsUntilBatchDeadline, int64_t nsUntilMergeRelease)
+{
+    int64_t timeoutMs = IDLE_POLL_MS;
+    for (int64_t ns : { nsUntilBatchDeadline, nsUntilMergeRelease }) {
+        if (ns >= 0) timeoutMs = std::min<int64_t>(timeoutMs, (ns + 999999) / 1000000);
+    }
+    if (timeoutMs <= 0) return; // Đã tới hạn: xử lý ngay
+
+    wakeup.wait(static_cast<int>(timeoutMs));
+    wakeup.drain(); // Hàng đợi và các cờ được kiểm tra lại ở đầu vòng lặp
+}
+
+// --- Triển khai (Implementation) ---
+
+struct CaptureEngine::LoopContext {
+    explicit LoopContext(const AdaptiveBatcher::Config& config)
+        : batcher(config),
+        packetBatch(new QList<PacketData>())
+    {
+        clock.start();
+        packetBatch->reserve(batcher.targetPackets());
+    }
+    ~LoopContext() { delete packetBatch; }
 
-const int LIVE_CAPTURE_TIMEOUT_MS = 100; // Gửi lô sau mỗi 100ms
-const int LIVE_BATCH_SIZE = 200;         // Hoặc khi đủ 200 gói
-const int FILE_READ_BATCH_SIZE = 1000;   // Gửi 1000 gói/lần khi đọc file
+    Parser parser;
+    StatsShard stats;
+    AdaptiveBatcher batcher;
+    QElapsedTimer clock;
+    int64_t lastStatsNs = 0;
+    QList<PacketData>* packetBatch;
+    bool waitForPipeline = false;   // true: nguồn là file, chờ tầng xử lý thay vì bỏ gói
+    bool held = false;              // Lô đã tới lúc gửi nhưng tầng xử lý còn đủ lô (bắt trực tiếp)
+};
 
 CaptureEngine::CaptureEngine(QObject *parent)
     : QObject(parent)
-    , m_isPaused(false)
-    , m_isRunning(false)
+    , m_latencyTargetMs(DEFAULT_LATENCY_TARGET_MS)
 {
 }
 
 CaptureEngine::~CaptureEngine() {
     stopCapture();
+    m_replayReader.reset();
+    closeReaders();
 }
 
 void CaptureEngine::setInterface(const QString &interfaceName) {
-    m_interface = interfaceName;
+    setInterfaces(QStringList{ interfaceName });
+}
+
+void CaptureEngine::setInterfaces(const QStringList &interfaceNames) {
+    m_interfaces = interfaceNames;
+}
+
+QList<CaptureEngine::InterfaceInfo> CaptureEngine::sessionInterfaces() const {
+    QList<InterfaceInfo> result;
+    if (m_readingFile) {
+        for (const CaptureFileInfo& file : m_files) {
+            result.append({ file.path, file.linkType });
+        }
+        return result;
+    }
+    if (m_replayReader) {
+        result.append({ m_replayReader->name(), m_replayReader->linkType() });
+        return result;
+    }
+    for (const auto& reader : m_readers) {
+        result.append({ reader->name(), reader->linkType() });
+    }
+    return result;
 }
 
 void CaptureEngine::setCaptureFilter(const QString &filter) {
     m_captureFilter = filter;
 }
 
+void CaptureEngine::setLatencyTarget(int ms) {
+    m_latencyTargetMs = std::max(ms, 2);
+}
+
+int CaptureEngine::kernelTimeoutMs() const {
+    // Kernel chỉ trả gói cho pcap khi đầy khối hoặc hết timeout: dành 1/4 ngân sách cho bước này
+    return std::max(m_latencyTargetMs / 4, 1);
+}
+
+int64_t CaptureEngine::mergeHoldNs() const {
+    // Một interface: gói luôn đúng thứ tự, không cần chờ. Nhiều interface: thêm 1/4 ngân sách
+    // để chờ interface im lặng trước khi coi gói sớm nhất đang có là đúng thứ tự
+    if (m_sources.size() <= 1) return 0;
+    return std::max(m_latencyTargetMs / 4, 1) * 1000000LL;
+}
+
+AdaptiveBatcher::Config CaptureEngine::batcherConfig(bool live) const {
+    AdaptiveBatcher::Config config;
+    // Bắt trực tiếp: phần còn lại sau timeout kernel và thời gian giữ của bộ gộp; đọc file: toàn bộ ngân sách
+    const int mergeHoldMs = static_cast<int>(mergeHoldNs() / 1000000LL);
+    config.maxDelayMs = live ? std::max(m_latencyTargetMs - kernelTimeoutMs() - mergeHoldMs, 1) : m_latencyTargetMs;
+    return config;
+}
+
 
 void CaptureEngine::startCapture() {
-    if (m_isRunning) stopCapture(); // Dừng luồng cũ nếu đang chạy
+    stopCapture(); // Dừng (join) luồng cũ nếu còn
+    m_readingFile = false;
+    m_replayReader.reset();
+    if (!openReaders()) {
+        return;
+    }
+    m_sources.clear();
+    for (auto& reader : m_readers) {
+        m_sources.push_back(reader.get());
+    }
 
-    m_isRunning = true;
-    m_isPaused = false;
+    m_isRunning.store(true, std::memory_order_release);
+    m_isPaused.store(false, std::memory_order_release);
+    m_wakeup.drain();
     m_packetCounter = 0;
+    m_statsExchange.reset(); // Luồng cũ đã dừng: không còn ai ghi
 
+    for (PacketSource* source : m_sources) {
+        source->start(&m_wakeup);
+    }
     m_captureThread = QThread::create([this]() {
         captureLoop(); // Hàm này sẽ chạy trên luồng mới
     });
-    connect(m_captureThread, &QThread::finished, m_captureThread, &QObject::deleteLater);
     m_captureThread->start();
 }
 
 
 void CaptureEngine::stopCapture() {
-    m_isRunning = false; // Báo cho các vòng lặp dừng lại
-
-    if (m_pcapHandle) {
-        // Ngắt (break) vòng lặp pcap_next_ex ngay lập tức
-        pcap_breakloop(m_pcapHandle);
+    m_isRunning.store(false, std::memory_order_release); // Báo cho các vòng lặp dừng lại
+    m_wakeup.notify(); // Đánh thức luồng đang chờ / đang tạm dừng
+
+    // Vòng lặp thoát ngay khi thức dậy: chờ hẳn để không còn lô nào được phát sau khi trả về
+    if (m_captureThread) {
+        m_captureThread->wait();
+        delete m_captureThread;
+        m_captureThread = nullptr;
     }
+    stopReaders();
+    m_sources.clear(); // Phiên sau tự chọn lại nguồn
+}
 
-    // Chờ cho luồng (thread) cũ kết thúc VÀ bị xóa
-    if (m_captureThread && m_captureThread->isRunning()) {
-        m_captureThread->quit(); // Yêu cầu thoát
-        m_captureThread->wait(1000); // Chờ (block) tối đa 1 giây
-    }
-    m_captureThread = nullptr; // Xóa con trỏ cũ
-    // -----------------------
+void CaptureEngine::setPauseMode(PauseMode mode) {
+    m_pauseMode.store(mode, std::memory_order_relaxed);
 }
 
 void CaptureEngine::pauseCapture() {
-    m_isPaused = true;
+    m_isPaused.store(true, std::memory_order_release);
+    m_wakeup.notify();
 }
 
 void CaptureEngine::resumeCapture() {
-    m_isPaused = false;
+    m_isPaused.store(false, std::memory_order_release);
+    m_wakeup.notify();
 }
 
-bool CaptureEngine::setupPcap() {
-    closePcap();
-    m_pcapHandle = pcap_open_live(m_interface.toUtf8().constData(), 65536, 1, LIVE_CAPTURE_TIMEOUT_MS, m_errbuf);
-    if (!m_pcapHandle) {
-        qDebug() << "pcap_open_live failed:" << m_errbuf;
+bool CaptureEngine::openReaders() {
+    // Danh sách interface đổi (kể cả thứ tự = interface_id): tạo lại toàn bộ reader
+    bool sameInterfaces = m_readers.size() == static_cast<size_t>(m_interfaces.size());
+    for (size_t i = 0; sameInterfaces && i < m_readers.size(); ++i) {
+        sameInterfaces = m_readers[i]->name() == m_interfaces[static_cast<int>(i)];
+    }
+    if (!sameInterfaces) {
+        closeReaders();
+        for (int i = 0; i < m_interfaces.size(); ++i) {
+            m_readers.push_back(std::make_unique<InterfaceReader>(static_cast<uint32_t>(i), m_interfaces[i]));
+        }
+    }
+    if (m_readers.empty()) {
+        emit errorOccurred("No interface selected");
         return false;
     }
-    pcap_setnonblock(m_pcapHandle, 1, m_errbuf);
+
+    // Reader nào còn handle cùng filter và timeout thì chỉ bỏ gói tồn từ lúc dừng
+    for (auto& reader : m_readers) {
+        if (!reader->open(m_captureFilter, kernelTimeoutMs())) {
+            emit errorOccurred(reader->openError());
+            return false;
+        }
+    }
     return true;
 }
 
-void CaptureEngine::closePcap() {
-    if (m_pcapHandle) {
-        pcap_close(m_pcapHandle);
-        m_pcapHandle = nullptr;
+void CaptureEngine::stopReaders() {
+    for (PacketSource* source : m_sources) {
+        source->stop();
     }
 }
 
-bool CaptureEngine::applyCaptureFilter() {
-    if (m_captureFilter.isEmpty() || !m_pcapHandle) return true;
-    struct bpf_program fp;
-    if (pcap_compile(m_pcapHandle, &fp, m_captureFilter.toUtf8().constData(), 0, PCAP_NETMASK_UNKNOWN) == -1) {
-        strncpy(m_errbuf, pcap_geterr(m_pcapHandle), PCAP_ERRBUF_SIZE);
-        return false;
+void CaptureEngine::closeReaders() {
+    m_readers.clear(); // Hủy reader = dừng luồng đọc + đóng handle
+}
+
+void CaptureEngine::waitWhilePaused() {
+    // Ngủ tới khi tiếp tục hoặc dừng (resumeCapture / stopCapture gọi notify)
+    while (m_isPaused.load(std::memory_order_acquire) && m_isRunning.load(std::memory_order_acquire)) {
+        m_wakeup.wait(-1);
+        m_wakeup.drain();
     }
-    if (pcap_setfilter(m_pcapHandle, &fp) == -1) {
-        pcap_freecode(&fp);
-        strncpy(m_errbuf, pcap_geterr(m_pcapHandle), PCAP_ERRBUF_SIZE);
-        return false;
+}
+
+void CaptureEngine::waitForPipeline() {
+    // Ngủ tới khi tầng xử lý trả một lô (batchProcessed gọi notify) hoặc dừng
+    while (m_batchesInFlight.load(std::memory_order_acquire) >= MAX_BATCHES_IN_FLIGHT &&
+           m_isRunning.load(std::memory_order_acquire)) {
+        m_wakeup.wait(IDLE_POLL_MS);
+        m_wakeup.drain();
     }
-    pcap_freecode(&fp);
-    return true;
 }
 
-void CaptureEngine::captureLoop() {
-    if (!setupPcap()) {
-        emit errorOccurred(QString("Failed to open interface: %1").arg(m_errbuf));
+void CaptureEngine::batchProcessed() {
+    m_batchesInFlight.fetch_sub(1, std::memory_order_acq_rel);
+    m_wakeup.notify();
+}
+
+void CaptureEngine::publishStats(const StatsShard& shard) {
+    // Chép vào ô ghi rồi đổi ô: luồng GUI không bao giờ thấy bản đang ghi dở
+    m_statsExchange.writeBuffer() = shard;
+    m_statsExchange.publish();
+}
+
+void CaptureEngine::processPacket(LoopContext& ctx, const struct pcap_pkthdr* header,
+                                  const u_char* data, uint32_t interfaceId, int64_t nowNs) {
+    // Lô đang giữ đã đầy: bỏ trước khi cấp số thứ tự để packet_id vẫn liên tục
+    if (ctx.held && ctx.batcher.isFull()) {
+        ctx.stats.captureCounters().backlogDrops++;
         return;
     }
-    if (!applyCaptureFilter()) {
-        emit errorOccurred(QString("Failed to set filter: %1").arg(m_errbuf));
-        closePcap();
+
+    // Mọi frame đọc được đều có số thứ tự và một dòng (gói không parse được hiện là Malformed),
+    // để packet_id luôn trùng vị trí bản ghi trong file (PacketIndex, Go to Packet / Time)
+    PacketData pkt;
+    pkt.packet_id = ++m_packetCounter; // Gán trước để bảng ghép mảnh IP ghi nhận
+    ctx.parser.parse(&pkt, data, header->caplen, &header->ts);
+    pkt.cap_length = header->caplen;
+    pkt.wire_length = header->len;
+    pkt.interface_id = interfaceId;
+    ctx.stats.add(pkt);
+    ctx.packetBatch->append(pkt);
+    ctx.batcher.add(nowNs, header->caplen);
+}
+
+void CaptureEngine::flushBatch(LoopContext& ctx, BatchMetrics::FlushReason reason, int64_t nowNs) {
+    if (ctx.packetBatch->isEmpty()) return;
+    if (reason != BatchMetrics::FLUSH_END) {
+        if (ctx.waitForPipeline) {
+            waitForPipeline();
+        } else {
+            // Không chặn luồng gộp (reader vẫn phải được nhận gói): giữ lô, gửi khi tầng xử lý trả chỗ
+            ctx.held = m_batchesInFlight.load(std::memory_order_acquire) >= MAX_BATCHES_IN_FLIGHT;
+            if (ctx.held) return;
+        }
+    }
+    ctx.held = false;
+    ctx.batcher.flushed(nowNs, reason, ctx.stats.batchMetrics());
+    m_batchesInFlight.fetch_add(1, std::memory_order_acq_rel);
+    emit packetsCaptured(ctx.packetBatch); // Gửi con trỏ (phát từ luồng capture, xếp hàng vào luồng xử lý)
+    ctx.packetBatch = new QList<PacketData>();
+    ctx.packetBatch->reserve(ctx.batcher.targetPackets());
+}
+
+void CaptureEngine::handlePausedPacket(LoopContext& ctx, PauseMode mode, PauseSpool& spool,
+                                       const RawPacket& packet) {
+    CaptureCounters& counters = ctx.stats.captureCounters();
+    switch (mode) {
+    case PAUSE_COUNT_ONLY: {
+        // Không hiển thị nên không cấp số thứ tự gói
+        PacketData pkt;
+        if (ctx.parser.parse(&pkt, packet.data.data(), packet.header.caplen, &packet.header.ts)) {
+            pkt.cap_length = packet.header.caplen;
+            pkt.wire_length = packet.header.len;
+            pkt.interface_id = packet.interfaceId;
+            ctx.stats.add(pkt);
+        }
+        counters.pausedCountedPackets++;
         return;
     }
+    case PAUSE_SPOOL:
+        if (spool.write(packet)) {
+            counters.spooledPackets++;
+            counters.spooledBytes += packet.header.len;
+        } else {
+            // Spool đầy (hoặc lỗi ghi): mất gói dù người dùng chọn giữ lại, đếm riêng với Discard
+            counters.spoolOverflowPackets++;
+            counters.spoolOverflowBytes += packet.header.len;
+        }
+        return;
+    case PAUSE_DISCARD:
+        break;
+    }
+    counters.pausedSkippedPackets++;
+    counters.pausedSkippedBytes += packet.header.len;
+}
 
-    Parser parser;
-    QList<PacketData>* packetBatch = new QList<PacketData>();
-    packetBatch->reserve(LIVE_BATCH_SIZE);
-    struct pcap_pkthdr* header;
-    const u_char* data;
-    int ret;
+bool CaptureEngine::collectFromReaders(TimestampMerger& merger, std::vector<RawPacket>& scratch) {
+    bool anyRunning = false;
+    for (size_t i = 0; i < m_sources.size(); ++i) {
+        if (merger.isSourceClosed(i)) continue;
+        PacketSource& source = *m_sources[i];
+        // Đọc cờ TRƯỚC khi lấy hàng đợi: nguồn đẩy gói cuối rồi mới đặt cờ, nên không sót gói
+        const bool failed = source.hasFailed();
+        const bool finished = source.isFinished();
+        source.takePackets(scratch);
+        for (RawPacket& packet : scratch) {
+            merger.push(i, std::move(packet));
+        }
+        scratch.clear();
+        if (failed || finished) {
+            // Các nguồn còn lại vẫn chạy tiếp; không chờ nguồn này trong bộ gộp nữa
+            merger.closeSource(i);
+            if (failed) emit errorOccurred(source.errorString());
+        } else {
+            anyRunning = true;
+        }
+    }
+    return anyRunning || !merger.isEmpty();
+}
 
-    while (m_isRunning)
-    {
-        if (m_isPaused) {
-            QThread::msleep(100);
+bool CaptureEngine::spoolArrivals(LoopContext& ctx, PauseSpool& spool, TimestampMerger& merger,
+                                  std::vector<RawPacket>& scratch) {
+    collectFromReaders(merger, scratch);
+    const int64_t holdNs = mergeHoldNs();
+    const int64_t nowMono = monotonicNs();
+    RawPacket packet;
+    int count = 0;
+    while (count < MAX_DRAIN_PACKETS && merger.pop(nowMono, holdNs, packet)) {
+        handlePausedPacket(ctx, PAUSE_SPOOL, spool, packet);
+        ++count;
+    }
+    return count > 0;
+}
+
+bool CaptureEngine::replaySpool(LoopContext& ctx, PauseSpool& spool, TimestampMerger& merger,
+                                std::vector<RawPacket>& scratch) {
+    // Gói đến trong lúc phát lại được ghi nối vào cuối spool (đúng thứ tự sau các gói đã spool).
+    // Phát lại nhanh hơn tốc độ đến nên phần đọc bắt kịp phần ghi; kết thúc khi không còn gói mới.
+    if (!spool.beginReplay()) {
+        emit errorOccurred("Cannot replay pause spool");
+        spool.close();
+        return true;
+    }
+    RawPacket packet;
+    BatchMetrics::FlushReason reason;
+    int sinceDrain = 0;
+    ctx.waitForPipeline = true; // Gói đã nằm trong spool: chờ tầng xử lý, không bỏ
+
+    bool interrupted = false;
+    while (m_isRunning.load(std::memory_order_relaxed)) {
+        // Tạm dừng lần nữa giữa lúc phát lại: dừng ngay thay vì phát hết spool
+        if (m_isPaused.load(std::memory_order_acquire)) {
+            interrupted = true;
+            break;
+        }
+        if (!spool.readNext(packet)) {
+            if (!spoolArrivals(ctx, spool, merger, scratch)) break;
             continue;
         }
+        const int64_t now = ctx.clock.nsecsElapsed();
+        processPacket(ctx, &packet.header, packet.data.data(), packet.interfaceId, now);
+        ctx.stats.captureCounters().replayedPackets++;
+        if (ctx.batcher.shouldFlush(now, reason)) {
+            flushBatch(ctx, reason, now);
+        }
+        if (++sinceDrain >= REPLAY_DRAIN_INTERVAL) {
+            spoolArrivals(ctx, spool, merger, scratch);
+            sinceDrain = 0;
+        }
+    }
+    ctx.waitForPipeline = false;
+    // Bị ngắt: spool giữ phần chưa phát (lần tiếp tục sau đọc tiếp từ chỗ dừng)
+    if (interrupted) return false;
+    spool.close();
+    return true;
+}
 
-        ret = pcap_next_ex(m_pcapHandle, &header, &data);
+void CaptureEngine::updateDropCounters(LoopContext& ctx) {
+    CaptureCounters& counters = ctx.stats.captureCounters();
+    counters.kernelDrops = 0;
+    counters.interfaceDrops = 0;
+    counters.queueDrops = 0;
+    ctx.stats.replayMetrics() = ReplayMetrics();
+    for (const PacketSource* source : m_sources) {
+        source->addCounters(ctx.stats);
+    }
+}
 
-        if (ret == 1) {
-            PacketData pkt;
-            if (parser.parse(&pkt, data, header->caplen)) {
-                pkt.cap_length = header->caplen;
-                pkt.wire_length = header->len;
-                pkt.packet_id = ++m_packetCounter;
-                packetBatch->append(pkt);
+void CaptureEngine::captureLoop() {
+    // Luồng gộp: nhận gói từ các reader, lấy ra theo thứ tự timestamp, parse và chia lô
+    LoopContext ctx(batcherConfig(true));
+    PauseSpool spool(PAUSE_SPOOL_MAX_BYTES);
+    TimestampMerger merger(m_sources.size());
+    std::vector<RawPacket> scratch;
+    RawPacket packet;
+    const int64_t holdNs = mergeHoldNs();
+    BatchMetrics::FlushReason reason;
+    bool paused = false;
+    PauseMode pauseMode = PAUSE_DISCARD;
+
+    while (m_isRunning.load(std::memory_order_acquire))
+    {
+        // --- Chuyển trạng thái tạm dừng / tiếp tục ---
+        const bool wantPaused = m_isPaused.load(std::memory_order_acquire);
+        if (wantPaused != paused) {
+            if (wantPaused) {
+                // Không giữ gói trong lô suốt thời gian tạm dừng
+                flushBatch(ctx, BatchMetrics::FLUSH_END, ctx.clock.nsecsElapsed());
+                pauseMode = static_cast<PauseMode>(m_pauseMode.load(std::memory_order_relaxed));
+                if (pauseMode == PAUSE_SPOOL && !spool.open()) {
+                    emit errorOccurred("Cannot create pause spool file: packets are discarded while paused");
+                    pauseMode = PAUSE_DISCARD;
+                }
+            } else if (spool.isOpen() && !replaySpool(ctx, spool, merger, scratch)) {
+                // Tạm dừng lại trong lúc phát lại: vẫn ở trạng thái tạm dừng (chế độ Spool), gói đến sau
+                // được ghi nối vào spool để không hiện trước phần chưa phát. Không giữ lô dở suốt lúc dừng
+                flushBatch(ctx, BatchMetrics::FLUSH_END, ctx.clock.nsecsElapsed());
+                publishStats(ctx.stats);
+                continue;
             }
+            paused = wantPaused;
+            publishStats(ctx.stats);
         }
-        else if (ret == 0) { // Timeout
-            // (Bỏ qua, vòng lặp sẽ kiểm tra logic gửi lô)
+
+        // Các reader luôn đọc socket, kể cả khi tạm dừng (bộ đệm kernel không tràn)
+        if (!collectFromReaders(merger, scratch)) {
+            break; // Mọi nguồn đều lỗi hoặc đã hết gói (phát lại xong)
         }
-        else if (ret == -1 || ret == -2) { // Lỗi hoặc break
-            qDebug() << "pcap_next_ex error or breakloop";
-            break;
+        const int64_t nowMono = monotonicNs();
+        int64_t now = ctx.clock.nsecsElapsed();
+        while (merger.pop(nowMono, holdNs, packet)) {
+            if (paused) {
+                handlePausedPacket(ctx, pauseMode, spool, packet);
+                continue;
+            }
+            now = ctx.clock.nsecsElapsed();
+            processPacket(ctx, &packet.header, packet.data.data(), packet.interfaceId, now);
+            if (ctx.batcher.shouldFlush(now, reason)) {
+                flushBatch(ctx, reason, now);
+            }
         }
 
-        if ( (packetBatch->size() >= LIVE_BATCH_SIZE) ||
-            (ret == 0 && !packetBatch->isEmpty()) )
-        {
-            QMetaObject::invokeMethod(this, [this, packetBatch]() {
-                emit packetsCaptured(packetBatch); // Gửi con trỏ
-            }, Qt::QueuedConnection);
-            packetBatch = new QList<PacketData>();
-            packetBatch->reserve(LIVE_BATCH_SIZE);
+        // Gửi lô khi gói cũ nhất chạm hạn độ trễ (đủ số gói / byte đã gửi ở trên)
+        now = ctx.clock.nsecsElapsed();
+        if (ctx.batcher.shouldFlush(now, reason)) {
+            flushBatch(ctx, reason, now);
         }
-    } // Kết thúc while(m_isRunning)
 
-    if (!packetBatch->isEmpty()) {
-        QMetaObject::invokeMethod(this, [this, packetBatch]() {
-            emit packetsCaptured(packetBatch);
-        }, Qt::QueuedConnection);
-    } else {
-        delete packetBatch;
-    }
+        if (now - ctx.lastStatsNs >= STATS_PUBLISH_INTERVAL_MS * 1000000LL) {
+            updateDropCounters(ctx);
+            publishStats(ctx.stats);
+            ctx.lastStatsNs = now;
+        }
 
-    closePcap();
+        // Chờ reader báo có gói, tới hạn độ trễ của lô hoặc hạn giữ của bộ gộp.
+        // Lô đang bị giữ thì không có hạn: batchProcessed đánh thức khi tầng xử lý trả chỗ
+        const int64_t batchDeadline = ctx.held ? -1 : ctx.batcher.nsUntilDeadline(now);
+        waitForWakeup(m_wakeup, batchDeadline, merger.nsUntilRelease(monotonicNs(), holdNs));
+    } // Kết thúc while(m_isRunning)
+
+    flushBatch(ctx, BatchMetrics::FLUSH_END, ctx.clock.nsecsElapsed());
+    updateDropCounters(ctx);
+    publishStats(ctx.stats);
     qDebug() << "Capture thread finished.";
 }
 
 
 void CaptureEngine::startCaptureFromFile(const QString &filePath)
 {
-    if (m_isRunning) stopCapture();
-    m_interface = filePath;
-    m_captureFilter = "";
-    m_isRunning = true;
-    m_isPaused = false;
+    // Một file: chỉ đọc header để biết link-type, không scan (đọc toàn bộ file)
+    CaptureFileInfo info;
+    QString error;
+    if (!CaptureFileIndex::probe(filePath, info, error)) {
+        info.path = filePath; // pcap_open_offline sẽ báo lỗi cụ thể
+    }
+    startCaptureFromFiles(QList<CaptureFileInfo>{ info }, FileSlice());
+}
+
+void CaptureEngine::startCaptureFromFiles(const QList<CaptureFileInfo> &files, const FileSlice &slice)
+{
+    stopCapture();
+    closeReaders(); // Handle trực tiếp giữ lại từ lần bắt trước (nếu có)
+    m_replayReader.reset();
+    m_readingFile = true;
+    m_files = files;
+    m_fileSlice = slice;
+    m_isRunning.store(true, std::memory_order_release);
+    m_isPaused.store(false, std::memory_order_release);
+    m_wakeup.drain();
     m_packetCounter = 0;
+    m_statsExchange.reset(); // Luồng cũ đã dừng: không còn ai ghi
 
     // Gán luồng mới vào biến thành viên
     m_captureThread = QThread::create([this]() { fileReadingLoop(); });
-    connect(m_captureThread, &QThread::finished, m_captureThread, &QObject::deleteLater);
+    m_captureThread->start();
+}
+
+void CaptureEngine::startReplay(const QString &filePath, const ReplayOptions &options)
+{
+    stopCapture();
+    m_readingFile = false;
+    m_replayReader.reset();
+    auto replay = std::make_unique<ReplayReader>(0, filePath, options);
+    QString error;
+    if (!replay->open(error)) {
+        emit errorOccurred(error);
+        return;
+    }
+    // Reader trực tiếp (nếu có) giữ handle để lần bắt sau dùng lại, nhưng không tham gia phiên này
+    m_replayReader = std::move(replay);
+    m_replayFile = filePath;
+    m_replayOptions = options;
+    m_sources.assign(1, m_replayReader.get());
+
+    m_isRunning.store(true, std::memory_order_release);
+    m_isPaused.store(false, std::memory_order_release);
+    m_wakeup.drain();
+    m_packetCounter = 0;
+    m_statsExchange.reset(); // Luồng cũ đã dừng: không còn ai ghi
+
+    m_replayReader->start(&m_wakeup);
+    m_captureThread = QThread::create([this]() { captureLoop(); });
     m_captureThread->start();
 }
 
 void CaptureEngine::fileReadingLoop()
 {
-    char errbuf[PCAP_ERRBUF_SIZE];
-    m_pcapHandle = pcap_open_offline(m_interface.toStdString().c_str(), errbuf);
-    if (!m_pcapHandle) {
-        emit errorOccurred(QString("pcap_open_offline error: %1").arg(errbuf));
+    CaptureFileMerger merger;
+    QStringList errors;
+    const bool opened = merger.open(m_files, m_fileSlice.startNs, m_fileSlice.endNs, errors);
+    for (const QString& error : errors) {
+        emit errorOccurred(QString("pcap_open_offline error: %1").arg(error));
+    }
+    if (!opened) {
+        if (merger.skippedFiles() > 0) {
+            emit errorOccurred("No packets in the selected time range");
+        }
         return;
     }
 
-    struct pcap_pkthdr* header;
+    const struct pcap_pkthdr* header;
     const u_char* data;
-    int res;
-    Parser parser;
-    QList<PacketData>* packetBatch = new QList<PacketData>();
-    packetBatch->reserve(FILE_READ_BATCH_SIZE);
+    uint32_t fileIndex;
+    uint64_t sliceIndex = 0;   // Số thứ tự trong dòng đã gộp + lọc thời gian (cho khoảng gói)
+    LoopContext ctx(batcherConfig(false));
+    ctx.waitForPipeline = true;
+    BatchMetrics::FlushReason reason;
 
-    while (m_isRunning && (res = pcap_next_ex(m_pcapHandle, &header, &data)) >= 0)
+    while (m_isRunning.load(std::memory_order_relaxed))
     {
-        if (res == 1) {
-            PacketData pkt;
-            if (parser.parse(&pkt, data, header->caplen)) {
-                pkt.cap_length = header->caplen;
-                pkt.wire_length = header->len;
-                pkt.packet_id = ++m_packetCounter;
-                packetBatch->append(pkt);
-            }
+        // Đọc file không có bộ đệm kernel để tràn: tạm dừng chỉ cần ngủ tới khi tiếp tục
+        if (m_isPaused.load(std::memory_order_acquire)) {
+            flushBatch(ctx, BatchMetrics::FLUSH_END, ctx.clock.nsecsElapsed());
+            publishStats(ctx.stats);
+            waitWhilePaused();
+            continue;
+        }
 
-            if (packetBatch->size() >= FILE_READ_BATCH_SIZE)
-            {
-                QMetaObject::invokeMethod(this, [this, packetBatch]() {
-                    emit packetsCaptured(packetBatch);
-                }, Qt::QueuedConnection);
-                packetBatch = new QList<PacketData>();
-                packetBatch->reserve(FILE_READ_BATCH_SIZE);
-            }
+        if (!merger.next(header, data, fileIndex)) {
+            break; // Hết mọi file (hoặc mọi file đã qua cuối khoảng thời gian)
         }
-        else if (res == -2) { // Hết file
-            break;
+        ++sliceIndex;
+        if (sliceIndex < m_fileSlice.firstPacket) continue;   // Trước khoảng gói: không parse
+        if (sliceIndex > m_fileSlice.lastPacket) break;
+
+        const int64_t now = ctx.clock.nsecsElapsed();
+        processPacket(ctx, header, data, fileIndex, now); // interface_id = vị trí file
+
+        // Đọc file nhanh nên lô lớn dần tới mức tối đa; hạn độ trễ giữ cho các dòng đầu hiện ngay
+        if (ctx.batcher.shouldFlush(now, reason))
+        {
+            flushBatch(ctx, reason, now);
+
+            if (now - ctx.lastStatsNs >= STATS_PUBLISH_INTERVAL_MS * 1000000LL) {
+                publishStats(ctx.stats);
+                ctx.lastStatsNs = now;
+            }
         }
     } // Kết thúc while
 
-    if (!packetBatch->isEmpty()) {
-        QMetaObject::invokeMethod(this, [this, packetBatch]() {
-            emit packetsCaptured(packetBatch);
-        }, Qt::QueuedConnection);
-    } else {
-        delete packetBatch;
-    }
+    flushBatch(ctx, BatchMetrics::FLUSH_END, ctx.clock.nsecsElapsed());
+    publishStats(ctx.stats);
 
-    closePcap();
+    for (const QString& error : merger.readErrors()) {
+        emit errorOccurred(error);
+    }
+    merger.close();
     qDebug() << "File reading thread finished.";
 }
@@ -3,27 +3,87 @@
 #include <QObject>
 #include <QTimer>
 #include <QString>
+#include <QStringList>
+#include <QList>
 #include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <pcap.h>
 #include "../../Common/PacketData.hpp"
+#include "../../Common/StatsShard.hpp"
+#include "AdaptiveBatcher.hpp"
+#include "CaptureFileIndex.hpp"
+#include "ReplayOptions.hpp"
+#include "WakeupFd.hpp"
+
+class PauseSpool;
+class InterfaceReader;
+class PacketSource;
+class ReplayReader;
+class TimestampMerger;
+struct RawPacket;
 
 class CaptureEngine : public QObject {
     Q_OBJECT
 public:
+    // Cách xử lý gói đến trong lúc tạm dừng (socket vẫn được đọc để bộ đệm kernel không tràn)
+    enum PauseMode {
+        PAUSE_DISCARD,      // Bỏ, chỉ đếm số gói / byte bị bỏ qua
+        PAUSE_COUNT_ONLY,   // Parse và cộng vào thống kê, không hiển thị
+        PAUSE_SPOOL         // Ghi ra file tạm, phát lại theo thứ tự khi tiếp tục
+    };
+
+    // Interface của phiên hiện tại; chỉ số trong danh sách là PacketData::interface_id
+    struct InterfaceInfo {
+        QString name;
+        int linkType;   // DLT_* của handle
+    };
+
     explicit CaptureEngine(QObject *parent = nullptr);
     ~CaptureEngine();
 
     void setInterface(const QString &interfaceName);
+    // Bắt đồng thời nhiều interface (mỗi interface một luồng đọc), gộp thành một dòng theo timestamp
+    void setInterfaces(const QStringList &interfaceNames);
+    QStringList interfaces() const { return m_interfaces; }
+    // Theo interface_id; đọc file: mỗi file một mục
+    QList<InterfaceInfo> sessionInterfaces() const;
     void setCaptureFilter(const QString &filter);
     void startCaptureFromFile(const QString &filePath);
+    // Đọc nhiều file gộp theo timestamp (interface_id = vị trí file trong danh sách), chỉ lấy phần trong slice
+    void startCaptureFromFiles(const QList<CaptureFileInfo> &files, const FileSlice &slice);
     void startCapture();
-    void stopCapture(); // (Hàm này giờ sẽ "chờ")
+    // Phát lại file qua đường bắt trực tiếp (luồng gộp, chia lô, tạm dừng) theo nhịp timestamp gốc
+    // nhân tốc độ; tùy chọn gửi từng gói ra interface. Dừng tự nhiên khi hết file.
+    void startReplay(const QString &filePath, const ReplayOptions &options);
+    bool isReplaying() const { return m_replayReader != nullptr; }
+    QString replayFile() const { return m_replayFile; }
+    ReplayOptions replayOptions() const { return m_replayOptions; }
+    // Dừng và chờ (join) luồng gộp và các luồng đọc; các luồng được đánh thức qua WakeupFd nên chỉ mất vài ms.
+    // Handle pcap trực tiếp vẫn mở để lần bắt sau cùng interface + filter dùng lại.
+    void stopCapture();
     void pauseCapture();
     void resumeCapture();
-    bool isPaused() const { return m_isPaused; }
+    bool isPaused() const { return m_isPaused.load(std::memory_order_relaxed); }
+    // Áp dụng từ lần tạm dừng tiếp theo
+    void setPauseMode(PauseMode mode);
+    PauseMode pauseMode() const { return static_cast<PauseMode>(m_pauseMode.load(std::memory_order_relaxed)); }
+
+    // Độ trễ mục tiêu từ lúc gói đến tới lúc được gửi lên tầng xử lý (áp dụng từ lần bắt sau)
+    void setLatencyTarget(int ms);
+    int latencyTarget() const { return m_latencyTargetMs; }
+
+    // Kênh snapshot thống kê của luồng capture (StatisticsManager đọc định kỳ)
+    StatsExchange* statsExchange() { return &m_statsExchange; }
+
+    // Tầng xử lý gọi (trên luồng của nó) sau mỗi lô nhận từ packetsCaptured: trả một chỗ trong
+    // giới hạn số lô đang chờ và đánh thức vòng lặp đang chờ / giữ lô
+    void batchProcessed();
 
 signals:
 
+    // Phát trực tiếp từ luồng capture; bên nhận sở hữu (delete) lô
     void packetsCaptured(QList<PacketData>* packetBatch);
     void errorOccurred(const QString &error);
 
@@ -32,22 +92,59 @@ private:
     void fileReadingLoop();
 
     // --- pcap ---
-    pcap_t* m_pcapHandle = nullptr;
-    char m_errbuf[PCAP_ERRBUF_SIZE]{};
+    std::vector<std::unique_ptr<InterfaceReader>> m_readers;   // Theo interface_id; giữ lại giữa các lần bắt
+    std::unique_ptr<ReplayReader> m_replayReader;                // Phiên phát lại file (nếu có)
+    std::vector<PacketSource*> m_sources;   // Nguồn của phiên hiện tại (theo interface_id); đặt trước khi luồng chạy
 
     // --- config ---
-    QString m_interface;
+    QStringList m_interfaces;
     QString m_captureFilter;
+    int m_latencyTargetMs;
+    bool m_readingFile = false;
+    QList<CaptureFileInfo> m_files;   // Đọc file: không đổi khi luồng đọc đang chạy
+    FileSlice m_fileSlice;
+    QString m_replayFile;             // Phát lại: file và tùy chọn của phiên gần nhất (để bắt lại)
+    ReplayOptions m_replayOptions;
 
-    // --- state ---
-    volatile bool m_isPaused = false;
-    volatile bool m_isRunning = false;
+    // --- state (luồng GUI ghi, luồng capture đọc; đổi cờ xong thì m_wakeup.notify()) ---
+    std::atomic<bool> m_isPaused{false};
+    std::atomic<bool> m_isRunning{false};
+    std::atomic<int> m_pauseMode{PAUSE_DISCARD};
+    WakeupFd m_wakeup;
     int m_packetCounter = 0;
+    // Lô đã phát mà tầng xử lý chưa xong (không đặt lại giữa các phiên: lô cũ vẫn được xử lý hết)
+    std::atomic<int> m_batchesInFlight{0};
+
+    // --- thống kê (luồng capture ghi, luồng GUI đọc, không khóa) ---
+    StatsExchange m_statsExchange;
 
     QThread* m_captureThread = nullptr; // Con trỏ theo dõi luồng
 
     // --- helper ---
-    bool setupPcap();
-    void closePcap();
-    bool applyCaptureFilter();
+    bool openReaders();   // Mở (hoặc dùng lại) một reader cho mỗi interface; lỗi -> errorOccurred
+    void stopReaders();
+    void closeReaders();
+    void waitWhilePaused();
+    void publishStats(const StatsShard& shard);
+    int kernelTimeoutMs() const;   // Timeout bộ đệm kernel (phần ngân sách độ trễ dành cho pcap)
+    int64_t mergeHoldNs() const;   // Thời gian tối đa bộ gộp chờ một interface im lặng (0 nếu chỉ một interface)
+    AdaptiveBatcher::Config batcherConfig(bool live) const;
+
+    // --- Vòng lặp (chỉ chạy trên luồng capture) ---
+    struct LoopContext;   // Parser + thống kê + bộ chia lô + lô hiện tại của một vòng lặp
+    void processPacket(LoopContext& ctx, const struct pcap_pkthdr* header, const u_char* data,
+                       uint32_t interfaceId, int64_t nowNs);
+    // Gửi lô hiện tại (lô rỗng thì bỏ qua) rồi tạo lô mới theo kích thước mục tiêu.
+    // Tầng xử lý đang có đủ MAX_BATCHES_IN_FLIGHT lô: chờ (đọc file, phát lại spool) hoặc giữ lô lại
+    // (bắt trực tiếp); FLUSH_END luôn gửi
+    void flushBatch(LoopContext& ctx, BatchMetrics::FlushReason reason, int64_t nowNs);
+    void waitForPipeline();
+    void handlePausedPacket(LoopContext& ctx, PauseMode mode, PauseSpool& spool, const RawPacket& packet);
+    // Chuyển gói từ hàng đợi các nguồn vào bộ gộp; false khi mọi nguồn đã dừng / hết gói và bộ gộp rỗng
+    bool collectFromReaders(TimestampMerger& merger, std::vector<RawPacket>& scratch);
+    // Phát lại spool; gói đến trong lúc phát lại được ghi nối vào cuối spool để giữ thứ tự.
+    // false nếu bị tạm dừng lại giữa chừng (spool vẫn mở, giữ phần chưa phát); true khi xong (spool đã đóng)
+    bool replaySpool(LoopContext& ctx, PauseSpool& spool, TimestampMerger& merger, std::vector<RawPacket>& scratch);
+    bool spoolArrivals(LoopContext& ctx, PauseSpool& spool, TimestampMerger& merger, std::vector<RawPacket>& scratch);
+    void updateDropCounters(LoopContext& ctx);
 };
@@ -0,0 +1,262 @@
+#include "CaptureFileIndex.hpp"
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QRegularExpression>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+const uint32_t PCAP_MAGIC_USEC = 0xA1B2C3D4;
+const uint32_t PCAP_MAGIC_NSEC = 0xA1B23C4D;
+const uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+const uint32_t PCAPNG_INTERFACE_DESCRIPTION = 0x00000001;
+const uint32_t PCAPNG_PACKET_OBSOLETE = 0x00000002;
+const uint32_t PCAPNG_SIMPLE_PACKET = 0x00000003;
+const uint32_t PCAPNG_ENHANCED_PACKET = 0x00000006;
+const uint32_t MAX_RECORD_BYTES = 256u << 20;     // Lớn hơn thế coi như file hỏng: dừng duyệt
+
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+struct FileCloser {
+    void operator()(FILE* f) const { if (f) fclose(f); }
+};
+using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+uint32_t swap32(uint32_t v) { return __builtin_bswap32(v); }
+uint16_t swap16(uint16_t v) { return __builtin_bswap16(v); }
+
+// Đọc số nguyên theo thứ tự byte của file
+struct ByteOrder {
+    bool swapped = false;
+    uint32_t u32(const uint8_t* p) const { uint32_t v; memcpy(&v, p, 4); return swapped ? swap32(v) : v; }
+    uint16_t u16(const uint8_t* p) const { uint16_t v; memcpy(&v, p, 2); return swapped ? swap16(v) : v; }
+};
+
+void addTimestamp(CaptureFileInfo& info, int64_t ns)
+{
+    if (info.packetCount == 0 || ns < info.firstNs) info.firstNs = ns;
+    if (info.packetCount == 0 || ns > info.lastNs) info.lastNs = ns;
+}
+
+// Gọi cho mỗi gói TRƯỚC addTimestamp / ++packetCount
+void addSeekPoint(CaptureFileInfo& info, int64_t& maxSoFar, uint64_t offset, int64_t ns, uint32_t section)
+{
+    if (info.packetCount % CaptureFileIndex::SEEK_POINT_INTERVAL == 0) {
+        info.seekPoints.push_back({ maxSoFar, offset, info.packetCount + 1, ns, section });
+    }
+    maxSoFar = std::max(maxSoFar, ns);
+}
+
+bool readPcapHeader(FILE* f, CaptureFileInfo& info, ByteOrder& order, bool& nanoseconds)
+{
+    uint8_t header[24];
+    if (fread(header, 1, sizeof(header), f) != sizeof(header)) return false;
+    uint32_t magic;
+    memcpy(&magic, header, 4);
+    if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+        order.swapped = false;
+    } else if (swap32(magic) == PCAP_MAGIC_USEC || swap32(magic) == PCAP_MAGIC_NSEC) {
+        order.swapped = true;
+        magic = swap32(magic);
+    } else {
+        return false;
+    }
+    nanoseconds = magic == PCAP_MAGIC_NSEC;
+    info.isPcapng = false;
+    info.swapped = order.swapped;
+    info.nanoseconds = nanoseconds;
+    info.linkType = static_cast<int>(order.u32(header + 20) & 0xFFFF); // Bit cao: thông tin FCS
+    return true;
+}
+
+void scanPcapRecords(FILE* f, CaptureFileInfo& info, const ByteOrder& order, bool nanoseconds)
+{
+    uint8_t record[16];
+    int64_t maxSoFar = std::numeric_limits<int64_t>::min();
+    uint64_t offset = 24;
+    while (fread(record, 1, sizeof(record), f) == sizeof(record)) {
+        const uint32_t capLength = order.u32(record + 8);
+        if (capLength > MAX_RECORD_BYTES) break;
+        const int64_t ns = static_cast<int64_t>(order.u32(record)) * 1000000000LL +
+                           static_cast<int64_t>(order.u32(record + 4)) * (nanoseconds ? 1 : 1000);
+        addSeekPoint(info, maxSoFar, offset, ns, 0);
+        addTimestamp(info, ns);
+        ++info.packetCount;
+        if (fseeko(f, capLength, SEEK_CUR) != 0) break;
+        offset += sizeof(record) + capLength;
+    }
+}
+
+void parseInterfaceOptions(const std::vector<uint8_t>& body, const ByteOrder& order, TsResolution& res)
+{
+    size_t pos = 8; // Sau linktype, reserved, snaplen
+    while (pos + 4 <= body.size()) {
+        const uint16_t code = order.u16(&body[pos]);
+        const uint16_t length = order.u16(&body[pos + 2]);
+        pos += 4;
+        if (code == 0 || pos + length > body.size()) break;
+        if (code == 9 && length >= 1) {          // if_tsresol
+            res.binary = (body[pos] & 0x80) != 0;
+            res.exponent = body[pos] & 0x7F;
+        } else if (code == 14 && length >= 8) {  // if_tsoffset
+            int64_t v;
+            memcpy(&v, &body[pos], 8);
+            if (order.swapped) v = static_cast<int64_t>(__builtin_bswap64(static_cast<uint64_t>(v)));
+            res.offsetSeconds = v;
+        }
+        pos += (length + 3u) & ~3u;
+    }
+}
+
+// pcapng: đọc SHB/IDB để biết thứ tự byte + link-type; scanAll thì duyệt tiếp mọi block gói
+bool walkPcapng(FILE* f, CaptureFileInfo& info, bool scanAll)
+{
+    ByteOrder order;
+    std::vector<TsResolution> interfaces;
+    bool sawInterface = false;
+    uint8_t head[12];
+    int64_t maxSoFar = std::numeric_limits<int64_t>::min();
+    uint64_t offset = 0;   // Vị trí đầu block đang đọc
+    auto currentSection = [&info]() { return static_cast<uint32_t>(info.sections.size() - 1); };
+
+    while (fread(head, 1, 8, f) == 8) {
+        uint32_t type;
+        memcpy(&type, head, 4);
+        if (type == PCAPNG_SECTION_HEADER) {
+            // Section mới: thứ tự byte có thể đổi, danh sách interface làm lại từ đầu
+            if (fread(head + 8, 1, 4, f) != 4) return sawInterface;
+            uint32_t bom;
+            memcpy(&bom, head + 8, 4);
+            if (bom == PCAPNG_BYTE_ORDER_MAGIC) order.swapped = false;
+            else if (swap32(bom) == PCAPNG_BYTE_ORDER_MAGIC) order.swapped = true;
+            else return false;
+            interfaces.clear();
+            info.sections.push_back(PcapngSection());
+            info.sections.back().swapped = order.swapped;
+            const uint32_t length = order.u32(head + 4);
+            if (length < 28 || length > MAX_RECORD_BYTES || fseeko(f, length - 12, SEEK_CUR) != 0) return sawInterface;
+            offset += length;
+            continue;
+        }
+
+        type = order.u32(head);
+        const uint32_t length = order.u32(head + 4);
+        if (length < 12 || length > MAX_RECORD_BYTES) break;
+        const uint32_t bodyLength = length - 12;
+
+        if (type == PCAPNG_INTERFACE_DESCRIPTION) {
+            std::vector<uint8_t> body(bodyLength);
+            if (bodyLength < 8 || fread(body.data(), 1, bodyLength, f) != bodyLength) break;
+            if (!sawInterface) info.linkType = order.u16(body.data());
+            sawInterface = true;
+            TsResolution res;
+            parseInterfaceOptions(body, order, res);
+            interfaces.push_back(res);
+            if (!info.sections.empty()) info.sections.back().interfaces.push_back(res);
+            if (fseeko(f, 4, SEEK_CUR) != 0) break;
+            if (!scanAll) return true;
+            offset += length;
+            continue;
+        }
+        // Block quá ngắn không phải gói (PacketIndex cũng bỏ qua): chỉ nhảy qua
+        if (scanAll && (type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_PACKET_OBSOLETE) &&
+            bodyLength >= CaptureFileIndex::PCAPNG_MIN_PACKET_BODY) {
+            uint8_t packet[12];
+            if (fread(packet, 1, sizeof(packet), f) != sizeof(packet)) break;
+            const uint32_t interfaceId = type == PCAPNG_ENHANCED_PACKET ? order.u32(packet) : order.u16(packet);
+            const uint64_t ticks = (static_cast<uint64_t>(order.u32(packet + 4)) << 32) | order.u32(packet + 8);
+            const TsResolution res = interfaceId < interfaces.size() ? interfaces[interfaceId] : TsResolution();
+            const int64_t ns = res.toNs(ticks);
+            addSeekPoint(info, maxSoFar, offset, ns, currentSection());
+            addTimestamp(info, ns);
+            ++info.packetCount;
+            if (fseeko(f, bodyLength - sizeof(packet) + 4, SEEK_CUR) != 0) break;
+            offset += length;
+            continue;
+        }
+        if (scanAll && type == PCAPNG_SIMPLE_PACKET && bodyLength >= CaptureFileIndex::PCAPNG_MIN_SIMPLE_BODY) {
+            // Không có timestamp (libpcap trả 0)
+            addSeekPoint(info, maxSoFar, offset, 0, currentSection());
+            ++info.packetCount;
+        }
+        if (fseeko(f, bodyLength + 4, SEEK_CUR) != 0) break;
+        offset += length;
+    }
+    return sawInterface;
+}
+
+bool readInfo(const QString& path, CaptureFileInfo& info, QString& error, bool scanAll)
+{
+    info = CaptureFileInfo();
+    info.path = path;
+    FilePtr f(fopen(QFile::encodeName(path).constData(), "rb"));
+    if (!f) {
+        error = QString("Cannot open %1").arg(path);
+        return false;
+    }
+    setvbuf(f.get(), nullptr, _IOFBF, 1 << 16);
+
+    ByteOrder order;
+    bool nanoseconds = false;
+    if (readPcapHeader(f.get(), info, order, nanoseconds)) {
+        if (scanAll) {
+            scanPcapRecords(f.get(), info, order, nanoseconds);
+            info.scanned = true;
+        }
+        return true;
+    }
+
+    rewind(f.get());
+    info.isPcapng = true;
+    if (walkPcapng(f.get(), info, scanAll)) {
+        info.scanned = scanAll;
+        return true;
+    }
+    error = QString("%1 is not a pcap / pcapng file").arg(path);
+    return false;
+}
+
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+bool CaptureFileIndex::probe(const QString& path, CaptureFileInfo& info, QString& error)
+{
+    return readInfo(path, info, error, false);
+}
+
+bool CaptureFileIndex::scan(const QString& path, CaptureFileInfo& info, QString& error)
+{
+    return readInfo(path, info, error, true);
+}
+
+QStringList CaptureFileIndex::captureFilesInDirectory(const QString& directory)
+{
+    // capture.pcap, capture.pcapng, capture.cap, capture.pcap1, ... (file nén .gz không đọc được: bỏ qua)
+    static const QRegularExpression pattern("\\.(pcap|pcapng|cap)\\d*$", QRegularExpression::CaseInsensitiveOption);
+    QStringList result;
+    QDir dir(directory);
+    const QFileInfoList entries = dir.entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+    for (const QFileInfo& entry : entries) {
+        if (pattern.match(entry.fileName()).hasMatch()) {
+            result.append(entry.absoluteFilePath());
+        }
+    }
+    return result;
+}
+
+int64_t CaptureFileIndex::seekOffset(const CaptureFileInfo& info, int64_t startNs)
+{
+    if (!info.scanned || info.isPcapng || info.seekPoints.empty()) return -1;
+    // Mốc cuối cùng mà mọi gói đứng trước nó đều sớm hơn startNs
+    auto it = std::partition_point(info.seekPoints.begin(), info.seekPoints.end(),
+                                   [startNs](const FileSeekPoint& p) { return p.maxTimestampBefore < startNs; });
+    if (it == info.seekPoints.begin()) return -1;
+    --it;
+    return it->byteOffset > 24 ? static_cast<int64_t>(it->byteOffset) : -1;
+}
@@ -0,0 +1,114 @@
+#ifndef CAPTUREFILEINDEX_HPP
+#define CAPTUREFILEINDEX_HPP
+
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Mốc để nhảy thẳng vào giữa file (mỗi SEEK_POINT_INTERVAL gói một mốc).
+ *
+ * maxTimestampBefore là timestamp lớn nhất của mọi gói ĐỨNG TRƯỚC mốc (không giảm theo offset,
+ * kể cả khi file có gói lệch thứ tự), nên nhảy tới mốc cuối cùng có giá trị < startNs không bỏ sót gói nào.
+ */
+struct FileSeekPoint {
+    int64_t maxTimestampBefore;
+    uint64_t byteOffset;       // Vị trí header bản ghi (pcapng: block) trong file
+    uint64_t packetNumber;     // Số thứ tự (từ 1) của gói tại byteOffset
+    int64_t timestampNs;       // Timestamp của gói đó
+    uint32_t section;          // pcapng: chỉ số trong CaptureFileInfo::sections
+};
+
+// Đơn vị timestamp của một interface pcapng (if_tsresol, if_tsoffset)
+struct TsResolution {
+    bool binary = false;
+    uint8_t exponent = 6;        // Mặc định: micro giây
+    int64_t offsetSeconds = 0;
+
+    int64_t toNs(uint64_t ticks) const {
+        int64_t ns;
+        if (binary) {
+            ns = static_cast<int64_t>(static_cast<__int128>(ticks) * 1000000000 >> exponent);
+        } else if (exponent <= 9) {
+            int64_t scale = 1;
+            for (int i = exponent; i < 9; ++i) scale *= 10;
+            ns = static_cast<int64_t>(ticks) * scale;
+        } else {
+            uint64_t scale = 1;
+            for (int i = 9; i < exponent; ++i) scale *= 10;
+            ns = static_cast<int64_t>(ticks / scale);
+        }
+        return ns + offsetSeconds * 1000000000LL;
+    }
+};
+
+// Một section pcapng: thứ tự byte và đơn vị timestamp của từng interface (theo interface id)
+struct PcapngSection {
+    bool swapped = false;
+    std::vector<TsResolution> interfaces;
+};
+
+/**
+ * @brief Thông tin một file capture: định dạng, link-type, và (sau scan) khoảng thời gian + số gói.
+ */
+struct CaptureFileInfo {
+    QString path;
+    int linkType = 1;           // DLT_EN10MB
+    bool isPcapng = false;
+    bool scanned = false;       // Các trường dưới hợp lệ
+    uint64_t packetCount = 0;
+    int64_t firstNs = 0;        // Timestamp nhỏ nhất / lớn nhất trong file
+    int64_t lastNs = 0;
+    std::vector<FileSeekPoint> seekPoints;
+    // Đủ để đọc lại bản ghi từ một mốc mà không đọc lại đầu file
+    bool swapped = false;        // pcap: thứ tự byte khác máy
+    bool nanoseconds = false;    // pcap: timestamp nano giây
+    std::vector<PcapngSection> sections;
+};
+
+/**
+ * @brief Vùng cần đọc khi mở file: khoảng thời gian [startNs, endNs] rồi khoảng số thứ tự gói.
+ *
+ * Số thứ tự gói (từ 1) tính trên dòng đã gộp và đã lọc thời gian.
+ */
+struct FileSlice {
+    int64_t startNs = std::numeric_limits<int64_t>::min();
+    int64_t endNs = std::numeric_limits<int64_t>::max();
+    uint64_t firstPacket = 1;
+    uint64_t lastPacket = std::numeric_limits<uint64_t>::max();
+
+    bool hasTimeRange() const {
+        return startNs != std::numeric_limits<int64_t>::min() || endNs != std::numeric_limits<int64_t>::max();
+    }
+};
+
+/**
+ * @brief Đọc header file pcap / pcapng mà không parse gói.
+ *
+ * probe() chỉ đọc header đầu file. scan() duyệt header của mọi bản ghi (bỏ qua dữ liệu gói)
+ * để lấy timestamp đầu / cuối, số gói và các mốc nhảy; nhanh hơn nhiều so với đọc bằng pcap.
+ */
+class CaptureFileIndex {
+public:
+    static bool probe(const QString& path, CaptureFileInfo& info, QString& error);
+    static bool scan(const QString& path, CaptureFileInfo& info, QString& error);
+
+    // File capture trong thư mục (pcap, pcapng, cap và tên xoay vòng kiểu x.pcap1), sắp theo tên
+    static QStringList captureFilesInDirectory(const QString& directory);
+
+    // Mốc nhảy cho startNs (pcap cổ điển, để libpcap đọc tiếp); -1 nếu phải đọc từ đầu
+    static int64_t seekOffset(const CaptureFileInfo& info, int64_t startNs);
+
+    static const uint64_t SEEK_POINT_INTERVAL = 4096;   // Mỗi 4096 gói một mốc
+
+    // Thân block pcapng (sau type + length) ngắn nhất được tính là một gói. Dùng chung cho scan()
+    // và PacketIndex để số gói đếm được luôn khớp với bản ghi đọc lại được.
+    // EPB / Packet Block cũ: interface id, timestamp (8), cap len, wire len = 20 byte
+    static const uint32_t PCAPNG_MIN_PACKET_BODY = 20;
+    // Simple Packet Block: wire len = 4 byte
+    static const uint32_t PCAPNG_MIN_SIMPLE_BODY = 4;
+};
+
+#endif // CAPTUREFILEINDEX_HPP
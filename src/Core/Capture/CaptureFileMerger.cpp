@@ -0,0 +1,118 @@
+#include "CaptureFileMerger.hpp"
+#include <QFile>
+#include <cstdio>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static int64_t timestampNs(const struct pcap_pkthdr* header)
+{
+    return static_cast<int64_t>(header->ts.tv_sec) * 1000000000LL + static_cast<int64_t>(header->ts.tv_usec) * 1000LL;
+}
+
+// --- Triển khai (Implementation) ---
+
+CaptureFileMerger::~CaptureFileMerger()
+{
+    close();
+}
+
+bool CaptureFileMerger::open(const QList<CaptureFileInfo>& files, int64_t startNs, int64_t endNs, QStringList& errors)
+{
+    close();
+    m_startNs = startNs;
+    m_endNs = endNs;
+    char errbuf[PCAP_ERRBUF_SIZE];
+
+    for (int i = 0; i < files.size(); ++i) {
+        const CaptureFileInfo& info = files[i];
+        // Dựa vào timestamp đầu / cuối đã scan: file nằm hẳn ngoài khoảng thì không cần mở
+        if (info.scanned && (info.packetCount == 0 || info.lastNs < startNs || info.firstNs > endNs)) {
+            ++m_skippedFiles;
+            continue;
+        }
+        pcap_t* handle = pcap_open_offline(QFile::encodeName(info.path).constData(), errbuf);
+        if (!handle) {
+            errors.append(QString("%1: %2").arg(info.path, errbuf));
+            continue;
+        }
+        const int64_t offset = CaptureFileIndex::seekOffset(info, startNs);
+        if (offset > 0 && fseeko(pcap_file(handle), offset, SEEK_SET) != 0) {
+            // Không nhảy được: mở lại và đọc từ đầu (bỏ qua gói trước startNs như bình thường)
+            pcap_close(handle);
+            handle = pcap_open_offline(QFile::encodeName(info.path).constData(), errbuf);
+            if (!handle) {
+                errors.append(QString("%1: %2").arg(info.path, errbuf));
+                continue;
+            }
+        }
+
+        Source source;
+        source.handle = handle;
+        source.fileIndex = static_cast<uint32_t>(i);
+        source.path = info.path;
+        m_sources.push_back(source);
+        const size_t index = m_sources.size() - 1;
+        if (advance(index)) {
+            m_heap.push({ timestampNs(m_sources[index].header), index });
+        }
+    }
+    return !m_sources.empty();
+}
+
+bool CaptureFileMerger::advance(size_t index)
+{
+    Source& source = m_sources[index];
+    if (!source.handle) return false;
+    struct pcap_pkthdr* header;
+    const u_char* data;
+    int ret;
+    while ((ret = pcap_next_ex(source.handle, &header, &data)) == 1) {
+        const int64_t ns = timestampNs(header);
+        if (ns < m_startNs) continue;   // Trước khoảng: bỏ qua, không parse
+        if (ns > m_endNs) break;        // Qua khoảng: file này xong
+        source.header = header;
+        source.data = data;
+        return true;
+    }
+    if (ret == -1) {
+        m_readErrors.append(QString("%1: %2").arg(source.path, pcap_geterr(source.handle)));
+    }
+    // Hết file: đóng ngay để giải phóng bộ đệm đọc
+    pcap_close(source.handle);
+    source.handle = nullptr;
+    source.header = nullptr;
+    source.data = nullptr;
+    return false;
+}
+
+bool CaptureFileMerger::next(const struct pcap_pkthdr*& header, const u_char*& data, uint32_t& fileIndex)
+{
+    // Gói trả về lần trước đã được dùng xong: giờ mới đọc tiếp file của nó
+    if (m_current != SIZE_MAX) {
+        if (advance(m_current)) {
+            m_heap.push({ timestampNs(m_sources[m_current].header), m_current });
+        }
+        m_current = SIZE_MAX;
+    }
+    if (m_heap.empty()) return false;
+
+    m_current = m_heap.top().source;
+    m_heap.pop();
+    const Source& source = m_sources[m_current];
+    header = source.header;
+    data = source.data;
+    fileIndex = source.fileIndex;
+    return true;
+}
+
+void CaptureFileMerger::close()
+{
+    for (Source& source : m_sources) {
+        if (source.handle) pcap_close(source.handle);
+    }
+    m_sources.clear();
+    m_heap = decltype(m_heap)();
+    m_current = SIZE_MAX;
+    m_skippedFiles = 0;
+    m_readErrors.clear();
+}
@@ -0,0 +1,65 @@
+#ifndef CAPTUREFILEMERGER_HPP
+#define CAPTUREFILEMERGER_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+#include <pcap.h>
+#include "CaptureFileIndex.hpp"
+
+/**
+ * @brief Đọc nhiều file capture cùng lúc và trả gói theo thứ tự timestamp (k-way merge, không tạo file gộp).
+ *
+ * Mỗi file chỉ giữ gói đầu của nó (con trỏ vào bộ đệm đọc của pcap), nên bộ nhớ là một bộ đệm
+ * mỗi file bất kể file lớn cỡ nào. Khi cắt theo thời gian: file đã scan nằm ngoài khoảng không
+ * được mở; file pcap cổ điển nhảy thẳng tới mốc gần startNs; mỗi file dừng ở gói đầu tiên sau endNs
+ * (giả định gói trong một file đã theo thứ tự thời gian, như file do capture ghi ra).
+ */
+class CaptureFileMerger {
+public:
+    CaptureFileMerger() = default;
+    ~CaptureFileMerger();
+    CaptureFileMerger(const CaptureFileMerger&) = delete;
+    CaptureFileMerger& operator=(const CaptureFileMerger&) = delete;
+
+    // File không mở được được ghi vào errors và bỏ qua; false nếu không mở được file nào
+    bool open(const QList<CaptureFileInfo>& files, int64_t startNs, int64_t endNs, QStringList& errors);
+    // Gói kế tiếp; header / data hợp lệ tới lần gọi next() sau. fileIndex là vị trí trong danh sách files
+    bool next(const struct pcap_pkthdr*& header, const u_char*& data, uint32_t& fileIndex);
+    void close();
+
+    int skippedFiles() const { return m_skippedFiles; }   // Nằm ngoài khoảng thời gian (không mở)
+    QStringList readErrors() const { return m_readErrors; }
+
+private:
+    struct Source {
+        pcap_t* handle = nullptr;
+        const struct pcap_pkthdr* header = nullptr;
+        const u_char* data = nullptr;
+        uint32_t fileIndex = 0;
+        QString path;
+    };
+    struct HeadEntry {
+        int64_t timestampNs;
+        size_t source;   // Cùng timestamp: file đứng trước ra trước
+        bool operator>(const HeadEntry& other) const {
+            if (timestampNs != other.timestampNs) return timestampNs > other.timestampNs;
+            return source > other.source;
+        }
+    };
+    bool advance(size_t source);   // Đọc gói kế tiếp trong khoảng; false khi file hết / đã qua endNs
+
+    std::vector<Source> m_sources;
+    std::priority_queue<HeadEntry, std::vector<HeadEntry>, std::greater<HeadEntry>> m_heap;
+    size_t m_current = SIZE_MAX;   // Nguồn của gói vừa trả về (đọc tiếp ở lần next() sau)
+    int64_t m_startNs = 0;
+    int64_t m_endNs = 0;
+    int m_skippedFiles = 0;
+    QStringList m_readErrors;
+};
+
+#endif // CAPTUREFILEMERGER_HPP
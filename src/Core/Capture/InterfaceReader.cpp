@@ -0,0 +1,168 @@
+#include "InterfaceReader.hpp"
+#include <QDebug>
+#include <cstring>
+#include <poll.h>
+
+const int IDLE_POLL_MS = 250;                   // Chờ tối đa khi không có gói (stop() đánh thức ngay)
+const int64_t DROP_STATS_INTERVAL_NS = 250000000LL; // Chu kỳ đọc pcap_stats
+const int MAX_DISCARD_BLOCKS = 64;              // Số lần pcap_dispatch tối đa khi bỏ gói tồn (handle dùng lại)
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static void discardPacket(u_char*, const struct pcap_pkthdr*, const u_char*)
+{
+}
+
+// --- Triển khai (Implementation) ---
+
+InterfaceReader::InterfaceReader(uint32_t interfaceId, const QString& name)
+    : PacketSource(interfaceId, name)
+{
+}
+
+InterfaceReader::~InterfaceReader()
+{
+    stop();
+    close();
+}
+
+bool InterfaceReader::open(const QString& filter, int kernelTimeoutMs)
+{
+    // Restart cùng filter và timeout: giữ handle đang mở, chỉ bỏ gói tồn từ lúc dừng
+    // (timeout chỉ đặt được lúc mở handle, nên đổi mục tiêu độ trễ thì phải mở lại)
+    if (m_handle && m_openFilter == filter && m_openTimeoutMs == kernelTimeoutMs) {
+        discardBuffered();
+        return true;
+    }
+
+    close();
+    m_handle = pcap_open_live(name().toUtf8().constData(), 65536, 1, kernelTimeoutMs, m_errbuf);
+    if (!m_handle) {
+        qDebug() << "pcap_open_live failed:" << m_errbuf;
+        m_openError = QString("Failed to open interface %1: %2").arg(name(), m_errbuf);
+        return false;
+    }
+    pcap_setnonblock(m_handle, 1, m_errbuf);
+    if (!applyFilter(filter)) {
+        m_openError = QString("Failed to set filter on %1: %2").arg(name(), m_errbuf);
+        close();
+        return false;
+    }
+    m_linkType = pcap_datalink(m_handle);
+    m_openFilter = filter;
+    m_openTimeoutMs = kernelTimeoutMs;
+    return true;
+}
+
+void InterfaceReader::close()
+{
+    if (m_handle) {
+        pcap_close(m_handle);
+        m_handle = nullptr;
+    }
+    m_openFilter.clear();
+    m_openTimeoutMs = -1;
+}
+
+bool InterfaceReader::applyFilter(const QString& filter)
+{
+    if (filter.isEmpty()) return true;
+    struct bpf_program fp;
+    if (pcap_compile(m_handle, &fp, filter.toUtf8().constData(), 0, PCAP_NETMASK_UNKNOWN) == -1) {
+        strncpy(m_errbuf, pcap_geterr(m_handle), PCAP_ERRBUF_SIZE - 1);
+        return false;
+    }
+    if (pcap_setfilter(m_handle, &fp) == -1) {
+        pcap_freecode(&fp);
+        strncpy(m_errbuf, pcap_geterr(m_handle), PCAP_ERRBUF_SIZE - 1);
+        return false;
+    }
+    pcap_freecode(&fp);
+    return true;
+}
+
+void InterfaceReader::discardBuffered()
+{
+    // Non-blocking: mỗi lần pcap_dispatch đọc tối đa một khối bộ đệm và trả 0 khi đã hết;
+    // giới hạn số khối để không quay mãi khi lưu lượng đến liên tục
+    for (int i = 0; i < MAX_DISCARD_BLOCKS; ++i) {
+        if (pcap_dispatch(m_handle, -1, discardPacket, nullptr) <= 0) break;
+    }
+}
+
+void InterfaceReader::addCounters(StatsShard& stats) const
+{
+    PacketSource::addCounters(stats);
+    stats.captureCounters().kernelDrops += kernelDrops();
+    stats.captureCounters().interfaceDrops += interfaceDrops();
+}
+
+void InterfaceReader::onPacket(u_char* user, const struct pcap_pkthdr* header, const u_char* data)
+{
+    InterfaceReader* self = reinterpret_cast<InterfaceReader*>(user);
+    RawPacket packet;
+    packet.header = *header;
+    packet.interfaceId = self->interfaceId();
+    packet.arrivalNs = monotonicNs();
+    packet.data.assign(data, data + header->caplen); // Bộ đệm pcap bị ghi đè ở lần đọc sau
+    self->m_local.push_back(std::move(packet));
+}
+
+void InterfaceReader::waitReadable(int selectableFd)
+{
+    if (selectableFd < 0) {
+        m_wakeup.wait(1); // Không có fd để chờ: tránh quay vòng bận
+        return;
+    }
+    struct pollfd pfds[2];
+    pfds[0].fd = selectableFd;
+    pfds[0].events = POLLIN;
+    pfds[0].revents = 0;
+    pfds[1].fd = m_wakeup.fd();
+    pfds[1].events = POLLIN;
+    pfds[1].revents = 0;
+    if (poll(pfds, 2, IDLE_POLL_MS) > 0 && (pfds[1].revents & POLLIN)) {
+        m_wakeup.drain(); // Cờ được kiểm tra lại ở đầu vòng lặp
+    }
+}
+
+void InterfaceReader::updateDrops(const struct pcap_stat& baseline)
+{
+    struct pcap_stat ps;
+    if (pcap_stats(m_handle, &ps) != 0) return;
+    // Bộ đếm của pcap tính từ lúc mở handle (có thể là handle dùng lại): trừ mốc lúc start()
+    m_kernelDrops.store(static_cast<u_int>(ps.ps_drop - baseline.ps_drop), std::memory_order_relaxed);
+    m_interfaceDrops.store(static_cast<u_int>(ps.ps_ifdrop - baseline.ps_ifdrop), std::memory_order_relaxed);
+}
+
+void InterfaceReader::run()
+{
+    const int selectableFd = pcap_get_selectable_fd(m_handle);
+    struct pcap_stat baseline{};
+    pcap_stats(m_handle, &baseline);
+    m_kernelDrops.store(0, std::memory_order_relaxed);
+    m_interfaceDrops.store(0, std::memory_order_relaxed);
+    int64_t lastStatsNs = monotonicNs();
+
+    while (isRunning()) {
+        const int ret = pcap_dispatch(m_handle, -1, onPacket, reinterpret_cast<u_char*>(this));
+        if (ret < 0) { // Lỗi (ví dụ interface bị gỡ): đẩy nốt gói đã đọc rồi mới báo lỗi
+            publish(m_local);
+            fail(QString("Capture on %1 stopped: %2").arg(name(), pcap_geterr(m_handle)));
+            close(); // Handle hỏng: lần bắt sau mở lại
+            return;
+        }
+        if (!m_local.empty()) {
+            publish(m_local);
+        } else {
+            waitReadable(selectableFd);
+        }
+
+        const int64_t now = monotonicNs();
+        if (now - lastStatsNs >= DROP_STATS_INTERVAL_NS) {
+            updateDrops(baseline);
+            lastStatsNs = now;
+        }
+    }
+    updateDrops(baseline);
+}
@@ -0,0 +1,59 @@
+#ifndef INTERFACEREADER_HPP
+#define INTERFACEREADER_HPP
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <pcap.h>
+#include "PacketSource.hpp"
+
+/**
+ * @brief Đọc một interface trên luồng riêng: pcap handle -> hàng đợi RawPacket cho luồng gộp.
+ *
+ * Mỗi interface một reader nên một interface bận không làm chậm việc đọc socket của interface khác.
+ * Reader luôn đọc hết bộ đệm kernel (kể cả khi capture tạm dừng); gói vượt giới hạn hàng đợi
+ * bị bỏ và được đếm. Handle vẫn mở sau stop() để lần bắt sau cùng filter và timeout dùng lại.
+ * open() / close() gọi từ luồng điều khiển khi reader không chạy.
+ */
+class InterfaceReader : public PacketSource {
+public:
+    InterfaceReader(uint32_t interfaceId, const QString& name);
+    ~InterfaceReader() override;
+
+    // Mở handle; nếu đang mở với cùng filter và timeout thì dùng lại và bỏ gói tồn từ lần bắt trước
+    bool open(const QString& filter, int kernelTimeoutMs);
+    void close();
+    bool isOpen() const { return m_handle != nullptr; }
+    QString openError() const { return m_openError; }
+
+    int linkType() const override { return m_linkType; }
+    // Tính từ lần start() gần nhất
+    uint64_t kernelDrops() const { return m_kernelDrops.load(std::memory_order_relaxed); }
+    uint64_t interfaceDrops() const { return m_interfaceDrops.load(std::memory_order_relaxed); }
+    void addCounters(StatsShard& stats) const override;
+
+protected:
+    void run() override;
+
+private:
+    static void onPacket(u_char* user, const struct pcap_pkthdr* header, const u_char* data);
+    void waitReadable(int selectableFd);
+    void updateDrops(const struct pcap_stat& baseline);
+    void discardBuffered();
+    bool applyFilter(const QString& filter);
+
+    QString m_openFilter;
+    int m_openTimeoutMs = -1;            // Timeout kernel của handle đang mở (-1 = chưa mở)
+    QString m_openError;
+    int m_linkType = DLT_EN10MB;
+    pcap_t* m_handle = nullptr;
+    char m_errbuf[PCAP_ERRBUF_SIZE]{};
+
+    std::vector<RawPacket> m_local;      // Gói của lần pcap_dispatch hiện tại (chỉ luồng đọc)
+
+    std::atomic<uint64_t> m_kernelDrops{0};
+    std::atomic<uint64_t> m_interfaceDrops{0};
+};
+
+#endif // INTERFACEREADER_HPP
@@ -0,0 +1,242 @@
+#include "PacketIndex.hpp"
+#include "RawPacket.hpp"
+#include <QFile>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+const uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+const uint32_t PCAPNG_PACKET_OBSOLETE = 0x00000002;
+const uint32_t PCAPNG_SIMPLE_PACKET = 0x00000003;
+const uint32_t PCAPNG_ENHANCED_PACKET = 0x00000006;
+const uint32_t MAX_RECORD_BYTES = 256u << 20;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+namespace {
+
+struct FileCloser {
+    void operator()(FILE* f) const { if (f) fclose(f); }
+};
+using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+struct RecordHeader {
+    uint64_t number = 0;       // Số thứ tự gói (từ 1)
+    int64_t ns = 0;
+    uint32_t capLength = 0;
+    uint32_t wireLength = 0;
+    uint32_t interfaceId = 0;
+};
+
+/**
+ * Đọc tuần tự bản ghi gói từ một mốc. next() chỉ đọc header; readData() đọc dữ liệu của bản ghi
+ * vừa lấy (không gọi thì lần next() sau nhảy qua), nên duyệt tới đích không tốn đọc dữ liệu.
+ */
+class RecordCursor {
+public:
+    RecordCursor(const CaptureFileInfo& info, const FileSeekPoint& from)
+        : m_info(info)
+        , m_section(from.section)
+        , m_number(from.packetNumber - 1)
+    {
+        m_file.reset(fopen(QFile::encodeName(info.path).constData(), "rb"));
+        if (!m_file) return;
+        setvbuf(m_file.get(), nullptr, _IOFBF, 1 << 16);
+        if (fseeko(m_file.get(), static_cast<off_t>(from.byteOffset), SEEK_SET) != 0) {
+            m_file.reset();
+            return;
+        }
+        m_swapped = info.isPcapng ? (m_section < info.sections.size() && info.sections[m_section].swapped)
+                                  : info.swapped;
+    }
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    bool next(RecordHeader& header)
+    {
+        if (!m_file || (m_skipBytes > 0 && fseeko(m_file.get(), m_skipBytes, SEEK_CUR) != 0)) return false;
+        m_skipBytes = 0;
+        m_dataLength = 0;
+        return m_info.isPcapng ? nextPcapng(header) : nextPcap(header);
+    }
+
+    bool readData(std::vector<uint8_t>& data)
+    {
+        data.resize(m_dataLength);
+        if (m_dataLength > 0 && fread(data.data(), 1, m_dataLength, m_file.get()) != m_dataLength) return false;
+        m_skipBytes -= m_dataLength;
+        m_dataLength = 0;
+        return true;
+    }
+
+private:
+    uint32_t u32(const uint8_t* p) const {
+        uint32_t v;
+        memcpy(&v, p, 4);
+        return m_swapped ? __builtin_bswap32(v) : v;
+    }
+    uint16_t u16(const uint8_t* p) const {
+        uint16_t v;
+        memcpy(&v, p, 2);
+        return m_swapped ? __builtin_bswap16(v) : v;
+    }
+
+    bool nextPcap(RecordHeader& header)
+    {
+        uint8_t record[16];
+        if (fread(record, 1, sizeof(record), m_file.get()) != sizeof(record)) return false;
+        header.capLength = u32(record + 8);
+        if (header.capLength > MAX_RECORD_BYTES) return false;
+        header.wireLength = u32(record + 12);
+        header.ns = static_cast<int64_t>(u32(record)) * 1000000000LL +
+                    static_cast<int64_t>(u32(record + 4)) * (m_info.nanoseconds ? 1 : 1000);
+        header.interfaceId = 0;
+        header.number = ++m_number;
+        m_dataLength = header.capLength;
+        m_skipBytes = header.capLength;
+        return true;
+    }
+
+    bool nextPcapng(RecordHeader& header)
+    {
+        uint8_t head[8];
+        while (fread(head, 1, sizeof(head), m_file.get()) == sizeof(head)) {
+            uint32_t type;
+            memcpy(&type, head, 4);
+            if (type == PCAPNG_SECTION_HEADER) {
+                // Section kế tiếp theo thứ tự file (đã ghi lại khi scan)
+                if (++m_section >= m_info.sections.size()) return false;
+                m_swapped = m_info.sections[m_section].swapped;
+            } else {
+                type = u32(head);
+            }
+            const uint32_t length = u32(head + 4);
+            if (length < 12 || length > MAX_RECORD_BYTES) return false;
+            const uint32_t bodyLength = length - 12;
+
+            if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_PACKET_OBSOLETE) &&
+                bodyLength >= CaptureFileIndex::PCAPNG_MIN_PACKET_BODY) {
+                uint8_t packet[CaptureFileIndex::PCAPNG_MIN_PACKET_BODY];
+                if (fread(packet, 1, sizeof(packet), m_file.get()) != sizeof(packet)) return false;
+                header.interfaceId = type == PCAPNG_ENHANCED_PACKET ? u32(packet) : u16(packet);
+                const uint64_t ticks = (static_cast<uint64_t>(u32(packet + 4)) << 32) | u32(packet + 8);
+                header.ns = resolution(header.interfaceId).toNs(ticks);
+                header.capLength = std::min(u32(packet + 12), bodyLength - CaptureFileIndex::PCAPNG_MIN_PACKET_BODY);
+                header.wireLength = u32(packet + 16);
+                header.number = ++m_number;
+                m_dataLength = header.capLength;
+                m_skipBytes = bodyLength - CaptureFileIndex::PCAPNG_MIN_PACKET_BODY + 4; // Dữ liệu + đệm + option + độ dài cuối block
+                return true;
+            }
+            if (type == PCAPNG_SIMPLE_PACKET && bodyLength >= CaptureFileIndex::PCAPNG_MIN_SIMPLE_BODY) {
+                uint8_t packet[CaptureFileIndex::PCAPNG_MIN_SIMPLE_BODY];
+                if (fread(packet, 1, sizeof(packet), m_file.get()) != sizeof(packet)) return false;
+                header.wireLength = u32(packet);
+                header.capLength = std::min(header.wireLength, bodyLength - CaptureFileIndex::PCAPNG_MIN_SIMPLE_BODY);
+                header.ns = 0; // Không có timestamp
+                header.interfaceId = 0;
+                header.number = ++m_number;
+                m_dataLength = header.capLength;
+                m_skipBytes = bodyLength - CaptureFileIndex::PCAPNG_MIN_SIMPLE_BODY + 4;
+                return true;
+            }
+            if (fseeko(m_file.get(), static_cast<off_t>(length) - 8, SEEK_CUR) != 0) return false;
+        }
+        return false;
+    }
+
+    TsResolution resolution(uint32_t interfaceId) const
+    {
+        if (m_section >= m_info.sections.size()) return TsResolution();
+        const std::vector<TsResolution>& interfaces = m_info.sections[m_section].interfaces;
+        return interfaceId < interfaces.size() ? interfaces[interfaceId] : TsResolution();
+    }
+
+    const CaptureFileInfo& m_info;
+    FilePtr m_file;
+    uint32_t m_section;
+    bool m_swapped = false;
+    uint64_t m_number;
+    uint32_t m_dataLength = 0;   // Dữ liệu gói còn chưa đọc của bản ghi hiện tại
+    off_t m_skipBytes = 0;       // Số byte còn lại tới bản ghi kế tiếp
+};
+
+} // namespace
+
+// --- Triển khai (Implementation) ---
+
+bool PacketIndex::build(const QString& path, QString& error)
+{
+    if (!CaptureFileIndex::scan(path, m_info, error)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+const FileSeekPoint* PacketIndex::seekPointForPacket(uint64_t packetNumber) const
+{
+    auto it = std::partition_point(m_info.seekPoints.begin(), m_info.seekPoints.end(),
+                                   [packetNumber](const FileSeekPoint& p) { return p.packetNumber <= packetNumber; });
+    if (it == m_info.seekPoints.begin()) return nullptr;
+    return &*(it - 1);
+}
+
+const FileSeekPoint* PacketIndex::seekPointForTime(int64_t ns) const
+{
+    // Mốc cuối cùng mà mọi gói đứng trước nó đều sớm hơn ns: gói đầu tiên >= ns nằm từ mốc này trở đi,
+    // và trước mốc kế tiếp (vì mốc kế tiếp đã thấy một gói >= ns)
+    auto it = std::partition_point(m_info.seekPoints.begin(), m_info.seekPoints.end(),
+                                   [ns](const FileSeekPoint& p) { return p.maxTimestampBefore < ns; });
+    if (it == m_info.seekPoints.begin()) return nullptr;
+    return &*(it - 1);
+}
+
+uint64_t PacketIndex::findTime(int64_t ns, QString& error) const
+{
+    const FileSeekPoint* from = seekPointForTime(ns);
+    if (!from) return 0;
+    RecordCursor cursor(m_info, *from);
+    if (!cursor.isOpen()) {
+        error = QString("Cannot read %1").arg(m_info.path);
+        return 0;
+    }
+    RecordHeader header;
+    while (cursor.next(header)) {
+        if (header.ns >= ns) return header.number;
+    }
+    return 0;
+}
+
+bool PacketIndex::readPackets(uint64_t first, size_t count, std::vector<RawPacket>& out, QString& error) const
+{
+    out.clear();
+    const FileSeekPoint* from = seekPointForPacket(first);
+    if (!from) {
+        error = QString("Packet %1 is not in %2").arg(first).arg(m_info.path);
+        return false;
+    }
+    RecordCursor cursor(m_info, *from);
+    if (!cursor.isOpen()) {
+        error = QString("Cannot read %1").arg(m_info.path);
+        return false;
+    }
+
+    RecordHeader header;
+    while (out.size() < count && cursor.next(header)) {
+        if (header.number < first) continue; // Chỉ đọc header tới đích
+        RawPacket packet;
+        packet.header.ts.tv_sec = header.ns / 1000000000LL;
+        packet.header.ts.tv_usec = (header.ns % 1000000000LL) / 1000;
+        packet.header.caplen = header.capLength;
+        packet.header.len = header.wireLength;
+        packet.interfaceId = header.interfaceId;
+        if (!cursor.readData(packet.data)) {
+            error = QString("%1 is truncated at packet %2").arg(m_info.path).arg(header.number);
+            return !out.empty();
+        }
+        out.push_back(std::move(packet));
+    }
+    return !out.empty();
+}
@@ -0,0 +1,41 @@
+#ifndef PACKETINDEX_HPP
+#define PACKETINDEX_HPP
+
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include "CaptureFileIndex.hpp"
+
+struct RawPacket;
+
+/**
+ * @brief Chỉ mục thưa của một file capture: tới gói số N hoặc thời điểm T mà không cần nạp cả file.
+ *
+ * Dựa trên các mốc (số gói, offset, timestamp) của CaptureFileIndex::scan, mỗi 4096 gói một mốc:
+ * tìm nhị phân mốc gần nhất, chỉ duyệt header từ mốc đó tới đích (tối đa một khoảng mốc),
+ * rồi chỉ đọc dữ liệu của cửa sổ gói cần hiển thị. Đọc được pcap và pcapng (kể cả nhiều section).
+ * Số thứ tự gói là thứ tự bản ghi trong file, trùng packet_id khi file được mở một mình.
+ */
+class PacketIndex {
+public:
+    // Duyệt header cả file (không parse gói); false + error nếu không đọc được
+    bool build(const QString& path, QString& error);
+    void clear() { m_info = CaptureFileInfo(); }
+
+    bool isValid() const { return m_info.scanned; }
+    const CaptureFileInfo& info() const { return m_info; }
+    uint64_t packetCount() const { return m_info.packetCount; }
+
+    // Số thứ tự (từ 1) của gói đầu tiên theo thứ tự file có timestamp >= ns; 0 nếu không có
+    uint64_t findTime(int64_t ns, QString& error) const;
+    // Đọc tối đa count gói bắt đầu từ gói số first (từ 1); RawPacket::interfaceId = interface pcapng
+    bool readPackets(uint64_t first, size_t count, std::vector<RawPacket>& out, QString& error) const;
+
+private:
+    const FileSeekPoint* seekPointForPacket(uint64_t packetNumber) const;   // Mốc cuối cùng <= packetNumber
+    const FileSeekPoint* seekPointForTime(int64_t ns) const;
+
+    CaptureFileInfo m_info;
+};
+
+#endif // PACKETINDEX_HPP
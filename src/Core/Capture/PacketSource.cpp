@@ -0,0 +1,116 @@
+#include "PacketSource.hpp"
+#include <QMutexLocker>
+
+const uint64_t MAX_QUEUE_BYTES = 64ull << 20;  // Hàng đợi tối đa mỗi nguồn khi luồng gộp chậm (64 MiB)
+const int FULL_QUEUE_WAIT_MS = 1;               // Chu kỳ kiểm tra lại khi chờ hàng đợi bớt đầy
+
+// --- Triển khai (Implementation) ---
+
+PacketSource::PacketSource(uint32_t interfaceId, const QString& name)
+    : m_interfaceId(interfaceId)
+    , m_name(name)
+{
+}
+
+PacketSource::~PacketSource()
+{
+    // Lớp con phải stop() trong destructor của nó (run() là hàm ảo của lớp con)
+    stop();
+}
+
+void PacketSource::start(WakeupFd* consumerWakeup)
+{
+    stop();
+    m_consumer = consumerWakeup;
+    m_failed.store(false, std::memory_order_release);
+    m_finished.store(false, std::memory_order_release);
+    m_isRunning.store(true, std::memory_order_release);
+    m_wakeup.drain();
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queue.clear();
+        m_queueBytes = 0;
+        m_error.clear();
+    }
+    m_queueDrops.store(0, std::memory_order_relaxed);
+
+    m_thread = QThread::create([this]() { run(); });
+    m_thread->start();
+}
+
+void PacketSource::stop()
+{
+    m_isRunning.store(false, std::memory_order_release);
+    m_wakeup.notify();
+    if (m_thread) {
+        m_thread->wait();
+        delete m_thread;
+        m_thread = nullptr;
+    }
+}
+
+QString PacketSource::errorString() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+void PacketSource::takePackets(std::vector<RawPacket>& out)
+{
+    QMutexLocker locker(&m_mutex);
+    out.swap(m_queue);
+    m_queueBytes = 0;
+}
+
+void PacketSource::addCounters(StatsShard& stats) const
+{
+    stats.captureCounters().queueDrops += queueDrops();
+}
+
+void PacketSource::publish(std::vector<RawPacket>& local, bool waitIfFull)
+{
+    if (local.empty()) return;
+    uint64_t dropped = 0;
+    size_t next = 0;
+    while (next < local.size()) {
+        {
+            // Khóa một lần cho cả nhóm gói thay vì mỗi gói
+            QMutexLocker locker(&m_mutex);
+            for (; next < local.size(); ++next) {
+                RawPacket& packet = local[next];
+                if (m_queueBytes + packet.data.size() > MAX_QUEUE_BYTES) {
+                    if (waitIfFull) break;
+                    ++dropped;
+                    continue;
+                }
+                m_queueBytes += packet.data.size();
+                m_queue.push_back(std::move(packet));
+            }
+        }
+        m_consumer->notify();
+        if (next < local.size()) {
+            // Hàng đợi đầy và không được bỏ gói: chờ luồng gộp lấy bớt (stop() đánh thức ngay)
+            if (!isRunning()) break;
+            m_wakeup.wait(FULL_QUEUE_WAIT_MS);
+            m_wakeup.drain();
+        }
+    }
+    local.clear();
+    if (dropped) m_queueDrops.fetch_add(dropped, std::memory_order_relaxed);
+}
+
+void PacketSource::fail(const QString& error)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_error = error;
+    }
+    m_failed.store(true, std::memory_order_release);
+    m_consumer->notify();
+}
+
+void PacketSource::finish()
+{
+    m_finished.store(true, std::memory_order_release);
+    m_consumer->notify();
+}
@@ -0,0 +1,76 @@
+#ifndef PACKETSOURCE_HPP
+#define PACKETSOURCE_HPP
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "RawPacket.hpp"
+#include "WakeupFd.hpp"
+#include "../../Common/StatsShard.hpp"
+
+/**
+ * @brief Nguồn gói cho luồng gộp của CaptureEngine: chạy trên luồng riêng, đẩy RawPacket vào hàng đợi.
+ *
+ * Lớp con cài run() (chạy trên luồng của nguồn, lặp tới khi isRunning() = false) và gọi publish()
+ * để chuyển gói sang luồng gộp; hàng đợi bị giới hạn byte, gói vượt giới hạn bị bỏ và được đếm.
+ * Nguồn hữu hạn gọi finish() khi hết gói, nguồn hỏng gọi fail(); luồng gộp thôi chờ nguồn đó.
+ *
+ * start() / stop() gọi từ luồng điều khiển; takePackets() và addCounters() từ luồng gộp.
+ */
+class PacketSource {
+public:
+    PacketSource(uint32_t interfaceId, const QString& name);
+    virtual ~PacketSource();
+    PacketSource(const PacketSource&) = delete;
+    PacketSource& operator=(const PacketSource&) = delete;
+
+    uint32_t interfaceId() const { return m_interfaceId; }
+    const QString& name() const { return m_name; }
+    virtual int linkType() const = 0;
+
+    void start(WakeupFd* consumerWakeup);
+    void stop();   // Dừng và chờ (join) luồng của nguồn
+    bool hasFailed() const { return m_failed.load(std::memory_order_acquire); }
+    bool isFinished() const { return m_finished.load(std::memory_order_acquire); }
+    QString errorString() const;
+
+    // Đổi hàng đợi với out (out nên rỗng): lấy toàn bộ gói đang chờ trong một lần khóa
+    void takePackets(std::vector<RawPacket>& out);
+    uint64_t queueDrops() const { return m_queueDrops.load(std::memory_order_relaxed); }
+    // Cộng bộ đếm của nguồn vào snapshot thống kê (mặc định: gói bỏ do hàng đợi đầy)
+    virtual void addCounters(StatsShard& stats) const;
+
+protected:
+    virtual void run() = 0;
+
+    bool isRunning() const { return m_isRunning.load(std::memory_order_acquire); }
+    // Chuyển gói trong local vào hàng đợi rồi đánh thức luồng gộp (local được làm rỗng).
+    // waitIfFull: chờ luồng gộp lấy bớt thay vì bỏ gói (nguồn không có bộ đệm kernel để tràn)
+    void publish(std::vector<RawPacket>& local, bool waitIfFull = false);
+    void fail(const QString& error);
+    void finish();
+
+    WakeupFd m_wakeup;   // Đánh thức luồng của nguồn khi stop()
+
+private:
+    uint32_t m_interfaceId;
+    QString m_name;
+
+    QThread* m_thread = nullptr;
+    std::atomic<bool> m_isRunning{false};
+    std::atomic<bool> m_failed{false};
+    std::atomic<bool> m_finished{false};
+    WakeupFd* m_consumer = nullptr;   // WakeupFd của luồng gộp
+
+    // --- hàng đợi (luồng nguồn ghi, luồng gộp lấy) ---
+    mutable QMutex m_mutex;
+    std::vector<RawPacket> m_queue;
+    uint64_t m_queueBytes = 0;
+    QString m_error;
+    std::atomic<uint64_t> m_queueDrops{0};
+};
+
+#endif // PACKETSOURCE_HPP
@@ -11,6 +11,7 @@
 #include "../Protocols/TransportLayer/UDPParser.hpp"
 #include "../Protocols/ApplicationLayer/ApplicationParser.hpp"
 
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <arpa/inet.h>
@@ -21,13 +22,98 @@ void Parser::appendTree(PacketData* pkt, const std::string& line) {
     pkt->tree_view += std::string(pkt->tree_depth * 2, ' ') + line + "\n";
 }
 
-bool Parser::parse(PacketData* pkt, const uint8_t* data, size_t len) {
+void Parser::parseTransport(PacketData* pkt, uint8_t proto, const uint8_t* data,
+                            const uint8_t* ptr, size_t remaining, size_t ip_payload_length) {
+    if (proto == 6 && remaining >= 20) { // TCP
+        pkt->is_tcp = TCPParser::parse(pkt->tcp, ptr, remaining);
+        if (pkt->is_tcp) {
+            pkt->proto_path.push(PROTO_TCP);
+            size_t tcp_hdr_len = pkt->tcp.data_offset * 4;
+            ptr += tcp_hdr_len; remaining -= tcp_hdr_len;
+            TCPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->tcp);
+            pkt->payload_offset = static_cast<uint32_t>(ptr - data);
+            pkt->payload_length = static_cast<uint32_t>(remaining);
+            // Độ dài segment thật theo header IP (không phụ thuộc snaplen)
+            pkt->tcp_segment_length = ip_payload_length >= tcp_hdr_len + remaining
+                                          ? static_cast<uint32_t>(ip_payload_length - tcp_hdr_len)
+                                          : static_cast<uint32_t>(remaining);
+            // --- KÍCH HOẠT TẦNG 7 ---
+            ApplicationParser::parse(pkt->app, ptr, remaining, pkt->tcp.src_port, pkt->tcp.dest_port, true);
+        }
+    }
+    else if (proto == 17 && remaining >= 8) { // UDP
+        pkt->is_udp = UDPParser::parse(pkt->udp, ptr, remaining);
+        if (pkt->is_udp) {
+            pkt->proto_path.push(PROTO_UDP);
+            ptr += 8; remaining -= 8;
+            UDPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->udp);
+            pkt->payload_offset = static_cast<uint32_t>(ptr - data);
+            pkt->payload_length = static_cast<uint32_t>(remaining);
+            // --- KÍCH HOẠT TẦNG 7 ---
+            ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.dest_port, false);
+        }
+    }
+    else if ((proto == 1 || proto == 58) && remaining >= 4) { // ICMPv4 / ICMPv6
+        pkt->is_icmp = ICMPParser::parse(pkt->icmp, ptr, remaining);
+        if (pkt->is_icmp) {
+            pkt->proto_path.push(proto == 58 ? PROTO_ICMPV6 : PROTO_ICMP);
+            ICMPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->icmp);
+        }
+    }
+}
+
+bool Parser::reassembleFragment(PacketData* pkt, const FragmentKey& key, uint32_t offset, bool more,
+                                const uint8_t* ptr, size_t remaining, size_t ip_payload_length) {
+    pkt->is_ip_fragment = true;
+
+    int64_t now_ns = static_cast<int64_t>(pkt->timestamp.tv_sec) * 1000000000LL + pkt->timestamp.tv_nsec;
+    std::vector<uint8_t> datagram;
+    std::vector<uint32_t> ids;
+    IPFragmentReassembler::Result result;
+    const bool truncated = remaining < ip_payload_length;
+    if (truncated) {
+        // Mảnh bị cắt bởi snaplen: ghép phần đã bắt được sẽ cho datagram sai -> bỏ datagram
+        m_fragments.discard(key);
+        result = IPFragmentReassembler::DROPPED;
+    } else {
+        result = m_fragments.addFragment(key, offset, ptr, remaining, more, pkt->packet_id, now_ns,
+                                         datagram, ids);
+    }
+
+    if (result != IPFragmentReassembler::COMPLETE) {
+        char id_hex[16];
+        snprintf(id_hex, sizeof(id_hex), "0x%x", key.id);
+        pkt->app.protocol = key.is_ipv6 ? "IPv6" : "IPv4";
+        pkt->app.info = "Fragmented IP protocol (proto=" + IPv4Parser::protocolToString(key.protocol) +
+                        " " + std::to_string(key.protocol) + ", off=" + std::to_string(offset) +
+                        ", ID=" + id_hex + ")";
+        appendTree(pkt, "[Fragment: offset " + std::to_string(offset) + ", " +
+                            std::to_string(remaining) + " bytes" +
+                            (truncated ? ", truncated, not reassembled]"
+                                       : result == IPFragmentReassembler::DROPPED ? ", dropped]" : "]"));
+        return false;
+    }
+
+    pkt->reassembled = std::move(datagram);
+    pkt->fragment_ids = std::move(ids);
+    pkt->reassembled_in = pkt->packet_id;
+    appendTree(pkt, "[" + std::to_string(pkt->fragment_ids.size()) + " IP Fragments (" +
+                        std::to_string(pkt->reassembled.size()) + " bytes) reassembled]");
+    return true;
+}
+
+bool Parser::parse(PacketData* pkt, const uint8_t* data, size_t len, const struct timeval* ts) {
     if (!pkt || !data || len == 0) return false;
 
     pkt->clear();
     pkt->raw_packet.assign(data, data + len);
     pkt->cap_length = pkt->wire_length = len;
-    clock_gettime(CLOCK_REALTIME, &pkt->timestamp);
+    if (ts) {
+        pkt->timestamp.tv_sec = ts->tv_sec;
+        pkt->timestamp.tv_nsec = ts->tv_usec * 1000;
+    } else {
+        clock_gettime(CLOCK_REALTIME, &pkt->timestamp);
+    }
 
     const uint8_t* ptr = data;
     size_t remaining = len;
@@ -42,6 +128,7 @@ bool Parser::parse(PacketData* pkt, const uint8_t* data, size_t len) {
     }
 
     ptr += 14; remaining -= 14;
+    pkt->proto_path.push(PROTO_ETHERNET);
     EthernetParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->eth, pkt->has_vlan, pkt->vlan);
 
     uint16_t next_proto = pkt->has_vlan ? pkt->vlan.ether_type : pkt->eth.ether_type;
@@ -54,6 +141,7 @@ bool Parser::parse(PacketData* pkt, const uint8_t* data, size_t len) {
             return false;
         }
         ptr += 4; remaining -= 4;
+        pkt->proto_path.push(PROTO_VLAN);
         VLANParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->vlan);
         next_proto = pkt->vlan.ether_type;
     }
@@ -68,33 +156,39 @@ bool Parser::parse(PacketData* pkt, const uint8_t* data, size_t len) {
             return false;
         }
 
+        pkt->proto_path.push(PROTO_IPV4);
         size_t ip_hdr_len = pkt->ipv4.ihl * 4;
         ptr += ip_hdr_len;
         remaining -= ip_hdr_len;
+        // Total Length = 0 (TSO) hoặc sai: coi như độ dài là phần đã bắt được
+        const size_t ip_payload_length = pkt->ipv4.total_length >= ip_hdr_len
+                                             ? pkt->ipv4.total_length - ip_hdr_len : remaining;
+        // Bỏ padding Ethernet: chỉ giữ đúng phần payload theo Total Length
+        if (pkt->ipv4.total_length >= ip_hdr_len &&
+            pkt->ipv4.total_length - ip_hdr_len < remaining) {
+            remaining = pkt->ipv4.total_length - ip_hdr_len;
+        }
         IPv4Parser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->ipv4);
 
-        // --- Layer 4 (cho IPv4) ---
-        uint8_t proto = pkt->ipv4.protocol;
-        if (proto == 6 && remaining >= 20) { // TCP
-            pkt->is_tcp = TCPParser::parse(pkt->tcp, ptr, remaining);
-            if (pkt->is_tcp) {
-                size_t tcp_hdr_len = pkt->tcp.data_offset * 4;
-                ptr += tcp_hdr_len; remaining -= tcp_hdr_len;
-                TCPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->tcp);
-ApplicationParser::parse(pkt->app, ptr, remaining, pkt->tcp.src_port, pkt->tcp.dest_port, true);            }
-        }
-        else if (proto == 17 && remaining >= 8) { // UDP
-            pkt->is_udp = UDPParser::parse(pkt->udp, ptr, remaining);
-            if (pkt->is_udp) {
-                ptr += 8; remaining -= 8;
-                UDPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->udp);
-ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.dest_port, false);            }
-        }
-        else if (proto == 1 && remaining >= 4) { // ICMPv4
-            pkt->is_icmp = ICMPParser::parse(pkt->icmp, ptr, remaining);
-            if (pkt->is_icmp) {
-                ICMPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->icmp);
+        // --- Phân mảnh IPv4 (MF = 0x2000, Offset = 13 bit thấp) ---
+        uint16_t frag_offset = pkt->ipv4.flags_frag_offset & 0x1FFF;
+        bool more_fragments = (pkt->ipv4.flags_frag_offset & 0x2000) != 0;
+        if (frag_offset != 0 || more_fragments) {
+            FragmentKey key;
+            memcpy(key.src.data(), &pkt->ipv4.src_ip, 4);
+            memcpy(key.dst.data(), &pkt->ipv4.dest_ip, 4);
+            key.id = pkt->ipv4.id;
+            key.protocol = pkt->ipv4.protocol;
+            if (!reassembleFragment(pkt, key, frag_offset * 8u, more_fragments, ptr, remaining,
+                                    ip_payload_length)) {
+                return true;
             }
+            // Datagram hoàn tất: Tầng 4 đi theo đường bình thường trên payload đã ghép
+            parseTransport(pkt, pkt->ipv4.protocol, pkt->reassembled.data(),
+                           pkt->reassembled.data(), pkt->reassembled.size(), pkt->reassembled.size());
+        } else {
+            // --- Layer 4 (cho IPv4) ---
+            parseTransport(pkt, pkt->ipv4.protocol, data, ptr, remaining, ip_payload_length);
         }
     }
 
@@ -102,36 +196,50 @@ ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.d
     else if (next_proto == 0x86DD && remaining >= 40) {
         // --- IPv6 ---
         // 'ptr' và 'remaining' sẽ bị thay đổi bởi hàm parse()
+        const uint8_t* ip6_start = ptr;
         pkt->is_ipv6 = IPv6Parser::parse(pkt->ipv6, ptr, remaining);
 
         if (pkt->is_ipv6) {
+            pkt->proto_path.push(PROTO_IPV6);
             IPv6Parser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->ipv6);
 
-            //  Layer 4 (cho IPv6) ---
-            uint8_t proto = pkt->ipv6.next_header;
-
-            if (proto == 6 && remaining >= 20) { // TCP
-                pkt->is_tcp = TCPParser::parse(pkt->tcp, ptr, remaining);
-                if (pkt->is_tcp) {
-                    size_t tcp_hdr_len = pkt->tcp.data_offset * 4;
-                    ptr += tcp_hdr_len; remaining -= tcp_hdr_len;
-                    TCPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->tcp);
-                     // --- KÍCH HOẠT TẦNG 7 ---
-ApplicationParser::parse(pkt->app, ptr, remaining, pkt->tcp.src_port, pkt->tcp.dest_port, true);                }
+            // Payload Length tính cả extension header đã bỏ qua và header Fragment (0 = Jumbogram)
+            size_t ext_len = (ptr - ip6_start) - 40;
+            const size_t ip_payload_length = pkt->ipv6.payload_length >= ext_len
+                                                 ? pkt->ipv6.payload_length - ext_len : remaining;
+            if (pkt->ipv6.payload_length >= ext_len &&
+                pkt->ipv6.payload_length - ext_len < remaining) {
+                remaining = pkt->ipv6.payload_length - ext_len;
             }
-            else if (proto == 17 && remaining >= 8) { // UDP
-                pkt->is_udp = UDPParser::parse(pkt->udp, ptr, remaining);
-                if (pkt->is_udp) {
-                    ptr += 8; remaining -= 8;
-                    UDPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->udp);
-                     // --- KÍCH HOẠT TẦNG 7 ---
-ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.dest_port, false);                }
-            }
-            else if (proto == 58 && remaining >= 4) { // 58 = ICMPv6
-                pkt->is_icmp = ICMPParser::parse(pkt->icmp, ptr, remaining);
-                if (pkt->is_icmp) {
-                    ICMPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->icmp);
+
+            // --- Phân mảnh IPv6 (bỏ qua "atomic fragment": offset 0 và M = 0) ---
+            // IPv6Parser dừng ở header Fragment với mọi mảnh: khóa (src, dst, ident, ip6f_nxt) và
+            // offset tính từ đầu phần được phân mảnh giống nhau cho mảnh đầu và các mảnh sau
+            if (pkt->ipv6.has_fragment && (pkt->ipv6.frag_offset != 0 || pkt->ipv6.frag_more)) {
+                FragmentKey key;
+                key.src = pkt->ipv6.src_ip;
+                key.dst = pkt->ipv6.dest_ip;
+                key.id = pkt->ipv6.frag_id;
+                key.protocol = pkt->ipv6.next_header;
+                key.is_ipv6 = true;
+                if (!reassembleFragment(pkt, key, pkt->ipv6.frag_offset * 8u, pkt->ipv6.frag_more,
+                                        ptr, remaining, ip_payload_length)) {
+                    return true;
+                }
+                // Extension header của phần được phân mảnh chỉ được bỏ qua sau khi ghép
+                uint8_t proto = pkt->ipv6.next_header;
+                const uint8_t* payload = pkt->reassembled.data();
+                size_t payload_len = pkt->reassembled.size();
+                if (!IPv6Parser::skipExtensionHeaders(proto, payload, payload_len)) {
+                    appendTree(pkt, "[Malformed IPv6 Extension Header in reassembled datagram]");
+                    pkt->is_malformed = true;
+                    return true;
                 }
+                pkt->ipv6.next_header = proto;
+                parseTransport(pkt, proto, pkt->reassembled.data(), payload, payload_len, payload_len);
+            } else {
+                //  Layer 4 (cho IPv6) ---
+                parseTransport(pkt, pkt->ipv6.next_header, data, ptr, remaining, ip_payload_length);
             }
         }
     }
@@ -139,6 +247,7 @@ ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.d
     else if (next_proto == 0x0806 && remaining >= 28) { // <-- ARP
         pkt->is_arp = ARPParser::parse(pkt->arp, ptr, remaining);
         if (pkt->is_arp) {
+            pkt->proto_path.push(PROTO_ARP);
             ARPParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->arp);
         }
     }
@@ -151,5 +260,16 @@ ApplicationParser::parse(pkt->app, ptr, remaining, pkt->udp.src_port, pkt->udp.d
         ApplicationParser::appendTreeView(pkt->tree_view, pkt->tree_depth++, pkt->app);
     }
 
+    // Nút Tầng 7 của cây Protocol Hierarchy (chỉ gói có Tầng 4)
+    if (pkt->is_tcp || pkt->is_udp) {
+        if (pkt->app.quic_type != ApplicationLayer::NOT_QUIC) {
+            pkt->proto_path.push(PROTO_QUIC);
+        } else if (!pkt->app.protocol.empty()) {
+            pkt->proto_path.push(protocolIdFromName(pkt->app.protocol));
+        } else if (pkt->payload_length > 0) {
+            pkt->proto_path.push(PROTO_DATA);
+        }
+    }
+
     return true;
 }
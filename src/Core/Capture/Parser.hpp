@@ -2,18 +2,36 @@
 #define PARSER_HPP
 
 #include "../../Common/PacketData.hpp"
+#include "../Protocols/NetworkLayer/IPFragmentReassembler.hpp"
 #include <cstddef>
+#include <sys/time.h>
 
 class Parser {
 public:
     Parser() = default;
     ~Parser() = default;
 
-    // Parse gói tin và điền vào PacketData
-    bool parse(PacketData* pkt, const uint8_t* data, size_t len);
+    // Parse gói tin và điền vào PacketData.
+    // 'ts' là timestamp của pcap header (nullptr -> dùng giờ hệ thống).
+    // pkt->packet_id nên được gán trước khi gọi (dùng để ghi nhận các mảnh IP).
+    bool parse(PacketData* pkt, const uint8_t* data, size_t len, const struct timeval* ts = nullptr);
 
 private:
     // Helper để tránh lặp code
     void appendTree(PacketData* pkt, const std::string& line);
+
+    // Parse Tầng 4 (+ Tầng 7) dùng chung cho IPv4 và IPv6.
+    // 'remaining' đã được cắt theo độ dài payload của IP (số byte thực có trong bộ đệm);
+    // 'ip_payload_length' là độ dài khai báo trong header IP (> remaining khi bị cắt bởi snaplen).
+    void parseTransport(PacketData* pkt, uint8_t proto, const uint8_t* data,
+                        const uint8_t* ptr, size_t remaining, size_t ip_payload_length);
+
+    // Đưa một mảnh IP vào bảng ghép. Trả về true nếu datagram vừa hoàn tất
+    // (khi đó pkt->reassembled chứa payload đã ghép).
+    // Mảnh bị cắt bởi snaplen (remaining < ip_payload_length) không được ghép: datagram bị bỏ.
+    bool reassembleFragment(PacketData* pkt, const FragmentKey& key, uint32_t offset, bool more,
+                            const uint8_t* ptr, size_t remaining, size_t ip_payload_length);
+
+    IPFragmentReassembler m_fragments;
 };
 #endif
@@ -0,0 +1,109 @@
+#include "PauseSpool.hpp"
+#include <QDir>
+#include <QDebug>
+
+// Header bản ghi trong file spool (cùng máy ghi và đọc nên dùng thứ tự byte của máy)
+struct SpoolRecord {
+    int64_t tsSec;
+    int64_t tsUsec;
+    uint32_t capLength;
+    uint32_t wireLength;
+    uint32_t interfaceId;
+    uint32_t reserved;
+};
+
+// --- Triển khai (Implementation) ---
+
+PauseSpool::PauseSpool(uint64_t maxBytes)
+    : m_maxBytes(maxBytes)
+{
+}
+
+PauseSpool::~PauseSpool()
+{
+    close();
+}
+
+bool PauseSpool::open()
+{
+    close();
+
+    m_file = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/pbl4-pause-XXXXXX.spool");
+    if (!m_file->open()) {
+        qDebug() << "Cannot create pause spool:" << m_file->errorString();
+        m_file.reset();
+        return false;
+    }
+    m_limitBytes = m_maxBytes;
+    return true;
+}
+
+bool PauseSpool::write(const RawPacket& packet)
+{
+    if (!m_file) return false;
+    const uint64_t recordBytes = sizeof(SpoolRecord) + packet.data.size();
+    if (m_writtenBytes + recordBytes > m_limitBytes) return false;
+
+    SpoolRecord record{};
+    record.tsSec = packet.header.ts.tv_sec;
+    record.tsUsec = packet.header.ts.tv_usec;
+    record.capLength = static_cast<uint32_t>(packet.data.size());
+    record.wireLength = packet.header.len;
+    record.interfaceId = packet.interfaceId;
+    if (m_file->write(reinterpret_cast<const char*>(&record), sizeof(record)) != sizeof(record) ||
+        m_file->write(reinterpret_cast<const char*>(packet.data.data()), record.capLength) != record.capLength) {
+        qDebug() << "Pause spool write failed:" << m_file->errorString();
+        m_limitBytes = m_writtenBytes; // Không ghi tiếp sau bản ghi dở: phần đọc dừng ở bản ghi hợp lệ cuối
+        return false;
+    }
+    m_writtenBytes += recordBytes;
+    m_unflushed = true;
+    return true;
+}
+
+bool PauseSpool::beginReplay()
+{
+    if (!m_file) return false;
+    m_file->flush();
+    m_unflushed = false;
+    if (m_reader) return true; // Phát lại tiếp: giữ vị trí đọc
+    m_reader = std::make_unique<QFile>(m_file->fileName());
+    if (!m_reader->open(QIODevice::ReadOnly)) {
+        qDebug() << "Cannot reopen pause spool:" << m_reader->errorString();
+        m_reader.reset();
+        return false;
+    }
+    m_readBytes = 0;
+    return true;
+}
+
+bool PauseSpool::readNext(RawPacket& out)
+{
+    if (!m_reader || m_readBytes >= m_writtenBytes) return false;
+    // Phần ghi thêm trong lúc phát lại có thể còn trong bộ đệm của QFile ghi
+    if (m_unflushed) {
+        m_file->flush();
+        m_unflushed = false;
+    }
+
+    SpoolRecord record;
+    if (m_reader->read(reinterpret_cast<char*>(&record), sizeof(record)) != sizeof(record)) return false;
+    out.header.ts.tv_sec = record.tsSec;
+    out.header.ts.tv_usec = record.tsUsec;
+    out.header.caplen = record.capLength;
+    out.header.len = record.wireLength;
+    out.interfaceId = record.interfaceId;
+    out.data.resize(record.capLength);
+    if (m_reader->read(reinterpret_cast<char*>(out.data.data()), record.capLength) != record.capLength) return false;
+    m_readBytes += sizeof(record) + record.capLength;
+    return true;
+}
+
+void PauseSpool::close()
+{
+    m_reader.reset();
+    m_file.reset(); // Xóa file tạm
+    m_writtenBytes = 0;
+    m_readBytes = 0;
+    m_unflushed = false;
+}
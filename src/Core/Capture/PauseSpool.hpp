@@ -0,0 +1,49 @@
+#ifndef PAUSESPOOL_HPP
+#define PAUSESPOOL_HPP
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <cstdint>
+#include <memory>
+#include "RawPacket.hpp"
+
+/**
+ * @brief File tạm giữ các gói đến trong lúc tạm dừng (chế độ Spool), để phát lại khi tiếp tục.
+ *
+ * Mỗi bản ghi là header cố định (timestamp, caplen, len, interface) + dữ liệu, nên gói của
+ * nhiều interface giữ nguyên timestamp, độ dài gốc và interface id. Dung lượng bị giới hạn
+ * (maxBytes); gói vượt giới hạn không được ghi và bên gọi đếm là bị bỏ.
+ *
+ * Trong lúc phát lại vẫn ghi tiếp được vào cuối file: readNext() đọc theo thứ tự tới khi bắt
+ * kịp phần đã ghi, nên gói đến trong lúc phát lại nối tiếp đúng thứ tự.
+ * File bị xóa khi close() hoặc khi đối tượng bị hủy. Chỉ dùng trên luồng gộp của capture.
+ */
+class PauseSpool {
+public:
+    explicit PauseSpool(uint64_t maxBytes);
+    ~PauseSpool();
+
+    // Tạo file tạm; false nếu không tạo được
+    bool open();
+    bool isOpen() const { return m_file != nullptr; }
+    // false nếu spool đầy hoặc lỗi ghi (gói không được ghi)
+    bool write(const RawPacket& packet);
+
+    // Mở phần đọc từ đầu file; nếu đang phát lại dở (bị tạm dừng giữa chừng) thì đọc tiếp từ chỗ dừng.
+    // false nếu lỗi
+    bool beginReplay();
+    // Bản ghi kế tiếp; false khi đã đọc hết phần đã ghi (hoặc lỗi đọc)
+    bool readNext(RawPacket& out);
+    void close();
+
+private:
+    uint64_t m_maxBytes;
+    uint64_t m_limitBytes = 0;   // = m_maxBytes; hạ xuống khi lỗi ghi
+    uint64_t m_writtenBytes = 0;
+    uint64_t m_readBytes = 0;
+    bool m_unflushed = false;
+    std::unique_ptr<QTemporaryFile> m_file;
+    std::unique_ptr<QFile> m_reader;
+};
+
+#endif // PAUSESPOOL_HPP
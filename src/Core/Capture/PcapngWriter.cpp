@@ -0,0 +1,101 @@
+#include "PcapngWriter.hpp"
+
+const uint32_t BLOCK_SECTION_HEADER = 0x0A0D0D0A;
+const uint32_t BLOCK_INTERFACE_DESCRIPTION = 0x00000001;
+const uint32_t BLOCK_ENHANCED_PACKET = 0x00000006;
+const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+const uint16_t OPT_END = 0;
+const uint16_t OPT_IF_NAME = 2;
+const uint16_t OPT_IF_TSRESOL = 9;
+const uint8_t TSRESOL_NANOSECONDS = 9;   // 10^-9 giây
+
+// --- Các hàm trợ giúp nội bộ ---
+
+template <typename T>
+static void appendValue(QByteArray& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Các trường của block đều căn theo 4 byte
+static void padTo32(QByteArray& out)
+{
+    while (out.size() % 4 != 0) out.append('\0');
+}
+
+static void appendOption(QByteArray& out, uint16_t code, const QByteArray& value)
+{
+    appendValue<uint16_t>(out, code);
+    appendValue<uint16_t>(out, static_cast<uint16_t>(value.size()));
+    out.append(value);
+    padTo32(out);
+}
+
+// --- Triển khai (Implementation) ---
+
+PcapngWriter::~PcapngWriter()
+{
+    close();
+}
+
+bool PcapngWriter::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    m_interfaceCount = 0;
+
+    QByteArray body;
+    appendValue<uint32_t>(body, BYTE_ORDER_MAGIC);
+    appendValue<uint16_t>(body, 1);          // Major version
+    appendValue<uint16_t>(body, 0);          // Minor version
+    appendValue<int64_t>(body, -1);          // Section length: không xác định
+    return writeBlock(BLOCK_SECTION_HEADER, body);
+}
+
+uint32_t PcapngWriter::addInterface(int linkType, const QString& name, uint32_t snapLength)
+{
+    QByteArray body;
+    appendValue<uint16_t>(body, static_cast<uint16_t>(linkType));
+    appendValue<uint16_t>(body, 0);          // Reserved
+    appendValue<uint32_t>(body, snapLength);
+    if (!name.isEmpty()) appendOption(body, OPT_IF_NAME, name.toUtf8());
+    appendOption(body, OPT_IF_TSRESOL, QByteArray(1, static_cast<char>(TSRESOL_NANOSECONDS)));
+    appendOption(body, OPT_END, QByteArray());
+    writeBlock(BLOCK_INTERFACE_DESCRIPTION, body);
+    return m_interfaceCount++;
+}
+
+bool PcapngWriter::writePacket(uint32_t interfaceId, const timespec& timestamp,
+                               const uint8_t* data, uint32_t capLength, uint32_t wireLength)
+{
+    const uint64_t ns = static_cast<uint64_t>(timestamp.tv_sec) * 1000000000ULL + static_cast<uint64_t>(timestamp.tv_nsec);
+    QByteArray body;
+    body.reserve(20 + static_cast<int>(capLength) + 3);
+    appendValue<uint32_t>(body, interfaceId);
+    appendValue<uint32_t>(body, static_cast<uint32_t>(ns >> 32));          // Timestamp (high)
+    appendValue<uint32_t>(body, static_cast<uint32_t>(ns & 0xFFFFFFFFu));  // Timestamp (low)
+    appendValue<uint32_t>(body, capLength);
+    appendValue<uint32_t>(body, wireLength);
+    body.append(reinterpret_cast<const char*>(data), static_cast<int>(capLength));
+    padTo32(body);
+    return writeBlock(BLOCK_ENHANCED_PACKET, body);
+}
+
+bool PcapngWriter::writeBlock(uint32_t type, const QByteArray& body)
+{
+    // Type + Total Length + body + Total Length (lặp lại để đọc ngược được)
+    const uint32_t totalLength = static_cast<uint32_t>(body.size()) + 12;
+    QByteArray block;
+    block.reserve(static_cast<int>(totalLength));
+    appendValue<uint32_t>(block, type);
+    appendValue<uint32_t>(block, totalLength);
+    block.append(body);
+    appendValue<uint32_t>(block, totalLength);
+    return m_file.write(block) == block.size();
+}
+
+void PcapngWriter::close()
+{
+    if (m_file.isOpen()) m_file.close();
+}
@@ -0,0 +1,37 @@
+#ifndef PCAPNGWRITER_HPP
+#define PCAPNGWRITER_HPP
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief Ghi file pcapng: Section Header, một Interface Description Block mỗi interface, rồi các Enhanced Packet Block.
+ *
+ * libpcap chỉ ghi được pcap cổ điển (một link-type, không có interface), nên pcapng được ghi trực tiếp.
+ * Timestamp ghi với độ phân giải nano giây (if_tsresol = 9); thứ tự byte là của máy ghi
+ * (đầu đọc nhận biết qua byte-order magic của Section Header).
+ */
+class PcapngWriter {
+public:
+    PcapngWriter() = default;
+    ~PcapngWriter();
+
+    // Tạo file và ghi Section Header Block
+    bool open(const QString& path);
+    // Ghi Interface Description Block; trả về interface id (thứ tự gọi, bắt đầu từ 0)
+    uint32_t addInterface(int linkType, const QString& name, uint32_t snapLength = 65535);
+    bool writePacket(uint32_t interfaceId, const timespec& timestamp,
+                     const uint8_t* data, uint32_t capLength, uint32_t wireLength);
+    void close();
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    bool writeBlock(uint32_t type, const QByteArray& body);
+
+    QFile m_file;
+    uint32_t m_interfaceCount = 0;
+};
+
+#endif // PCAPNGWRITER_HPP
@@ -0,0 +1,34 @@
+#ifndef RAWPACKET_HPP
+#define RAWPACKET_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <pcap.h>
+
+/**
+ * @brief Một gói thô (chưa parse) do InterfaceReader chép ra khỏi bộ đệm pcap.
+ *
+ * Bộ đệm của pcap chỉ hợp lệ tới lần đọc kế tiếp, nên gói phải được chép trước khi chuyển
+ * sang luồng gộp (merge). arrivalNs là lúc reader nhận gói (đồng hồ đơn điệu, xem monotonicNs()),
+ * dùng để giới hạn thời gian gói bị giữ lại trong bộ gộp.
+ */
+struct RawPacket {
+    struct pcap_pkthdr header{};   // ts, caplen, len gốc từ pcap
+    uint32_t interfaceId = 0;
+    int64_t arrivalNs = 0;
+    std::vector<uint8_t> data;
+
+    int64_t timestampNs() const {
+        return static_cast<int64_t>(header.ts.tv_sec) * 1000000000LL + static_cast<int64_t>(header.ts.tv_usec) * 1000LL;
+    }
+};
+
+// Đồng hồ đơn điệu dùng chung giữa các luồng reader và luồng gộp
+inline int64_t monotonicNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // RAWPACKET_HPP
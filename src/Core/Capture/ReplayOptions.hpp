@@ -0,0 +1,13 @@
+#ifndef REPLAYOPTIONS_HPP
+#define REPLAYOPTIONS_HPP
+
+#include <QString>
+
+// Tùy chọn phát lại file qua đường bắt trực tiếp (tách riêng để UI không phải include pcap.h)
+struct ReplayOptions {
+    double speed = 1.0;                   // 1 = đúng nhịp gốc, 10 = nhanh gấp 10; 0 = nhanh nhất có thể
+    bool keepOriginalTimestamps = false;  // false: timestamp = lúc gói được phát (như bắt trực tiếp)
+    QString injectInterface;              // Khác rỗng: gửi từng gói ra interface này bằng pcap_inject
+};
+
+#endif // REPLAYOPTIONS_HPP
@@ -0,0 +1,212 @@
+#include "ReplayReader.hpp"
+#include <QFile>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+const int64_t SPIN_NS = 200000;        // Quay vòng bận 200 µs cuối trước hạn (timerfd dậy trễ cỡ 50-100 µs)
+const size_t PUBLISH_BATCH = 256;      // Đẩy sang luồng gộp mỗi chừng này gói khi không phải chờ
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static int64_t realtimeNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t timestampNs(const struct timeval& tv)
+{
+    return static_cast<int64_t>(tv.tv_sec) * 1000000000LL + static_cast<int64_t>(tv.tv_usec) * 1000LL;
+}
+
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// --- Triển khai (Implementation) ---
+
+ReplayReader::ReplayReader(uint32_t interfaceId, const QString& filePath, const ReplayOptions& options)
+    : PacketSource(interfaceId, filePath)
+    , m_options(options)
+{
+    m_metrics.speed = options.speed;
+}
+
+ReplayReader::~ReplayReader()
+{
+    stop();
+    close();
+}
+
+bool ReplayReader::open(QString& errorMessage)
+{
+    close();
+    char errbuf[PCAP_ERRBUF_SIZE];
+    m_file = pcap_open_offline(QFile::encodeName(name()).constData(), errbuf);
+    if (!m_file) {
+        errorMessage = QString("pcap_open_offline error: %1").arg(errbuf);
+        return false;
+    }
+    m_linkType = pcap_datalink(m_file);
+
+    if (!m_options.injectInterface.isEmpty()) {
+        m_inject = pcap_open_live(m_options.injectInterface.toUtf8().constData(), 65535, 0, 100, errbuf);
+        if (!m_inject) {
+            errorMessage = QString("Cannot open %1 for sending: %2").arg(m_options.injectInterface, errbuf);
+            close();
+            return false;
+        }
+    }
+
+    // CLOCK_MONOTONIC: cùng đồng hồ với monotonicNs() (steady_clock trên Linux)
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    return true;
+}
+
+void ReplayReader::close()
+{
+    if (m_file) {
+        pcap_close(m_file);
+        m_file = nullptr;
+    }
+    if (m_inject) {
+        pcap_close(m_inject);
+        m_inject = nullptr;
+    }
+    if (m_timerFd >= 0) {
+        ::close(m_timerFd);
+        m_timerFd = -1;
+    }
+}
+
+void ReplayReader::addCounters(StatsShard& stats) const
+{
+    PacketSource::addCounters(stats);
+    QMutexLocker locker(&m_metricsMutex);
+    stats.replayMetrics() = m_metrics;
+}
+
+bool ReplayReader::waitUntil(int64_t targetNs, std::vector<RawPacket>& local)
+{
+    int64_t remaining = targetNs - monotonicNs();
+    if (remaining > SPIN_NS) {
+        // Sắp ngủ: gói đã tới hạn phải sang luồng gộp ngay, không đợi đủ nhóm
+        publish(local);
+        if (m_timerFd >= 0) {
+            struct itimerspec spec{};
+            const int64_t wakeNs = targetNs - SPIN_NS;
+            spec.it_value.tv_sec = wakeNs / 1000000000LL;
+            spec.it_value.tv_nsec = wakeNs % 1000000000LL;
+            timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+
+            struct pollfd pfds[2];
+            pfds[0].fd = m_timerFd;
+            pfds[0].events = POLLIN;
+            pfds[0].revents = 0;
+            pfds[1].fd = m_wakeup.fd();
+            pfds[1].events = POLLIN;
+            pfds[1].revents = 0;
+            while (isRunning() && poll(pfds, 2, -1) < 0 && errno == EINTR) {
+            }
+            uint64_t expirations;
+            if (read(m_timerFd, &expirations, sizeof(expirations)) < 0) {
+                // Chưa hết hạn (bị đánh thức bởi stop()): vòng quay bên dưới kiểm tra cờ
+            }
+            if (pfds[1].revents & POLLIN) m_wakeup.drain();
+        } else {
+            m_wakeup.wait(static_cast<int>((remaining - SPIN_NS) / 1000000));
+            m_wakeup.drain();
+        }
+    }
+    // Phần cuối: quay vòng bận tới đúng hạn
+    while (monotonicNs() < targetNs) {
+        if (!isRunning()) return false;
+        cpuRelax();
+    }
+    return isRunning();
+}
+
+void ReplayReader::run()
+{
+    const bool paced = m_options.speed > 0.0;
+    std::vector<RawPacket> local;
+    local.reserve(PUBLISH_BATCH);
+    ReplayMetrics metrics;
+    metrics.speed = m_options.speed;
+    int64_t firstTs = 0;
+    int64_t startMono = 0;
+    int64_t startWall = 0;
+
+    struct pcap_pkthdr* header;
+    const u_char* data;
+    int ret = 0;
+    while (isRunning() && (ret = pcap_next_ex(m_file, &header, &data)) == 1) {
+        const int64_t originalTs = timestampNs(header->ts);
+        if (metrics.packets == 0) {
+            firstTs = originalTs;
+            startMono = monotonicNs();
+            startWall = realtimeNs();
+        }
+
+        // Lịch: khoảng cách tới gói đầu / hệ số tốc độ (gói lệch thứ tự trong file phát ngay)
+        const int64_t scheduled = paced
+            ? static_cast<int64_t>(std::max<int64_t>(originalTs - firstTs, 0) / m_options.speed)
+            : 0;
+        const int64_t target = startMono + scheduled;
+        if (paced && !waitUntil(target, local)) break;
+
+        const int64_t now = monotonicNs();
+        RawPacket packet;
+        packet.header = *header;
+        if (!m_options.keepOriginalTimestamps) {
+            const int64_t wall = startWall + (now - startMono);
+            packet.header.ts.tv_sec = wall / 1000000000LL;
+            packet.header.ts.tv_usec = (wall % 1000000000LL) / 1000;
+        }
+        packet.interfaceId = interfaceId();
+        packet.arrivalNs = now;
+        packet.data.assign(data, data + header->caplen);
+
+        if (m_inject) {
+            if (pcap_inject(m_inject, data, header->caplen) < 0) metrics.injectErrors++;
+            else metrics.injectedPackets++;
+        }
+
+        metrics.packets++;
+        metrics.bytes += header->len;
+        metrics.elapsedNs = now - startMono;
+        metrics.scheduledNs = scheduled;
+        if (paced) metrics.lateNs.add(static_cast<uint64_t>(std::max<int64_t>(now - target, 0)));
+        local.push_back(std::move(packet));
+
+        if (local.size() >= PUBLISH_BATCH) {
+            {
+                QMutexLocker locker(&m_metricsMutex);
+                m_metrics = metrics;
+            }
+            publish(local, !paced); // Tốc độ tối đa: chờ luồng gộp thay vì bỏ gói
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_metricsMutex);
+        m_metrics = metrics;
+    }
+    publish(local, !paced);
+    if (ret == -1) {
+        fail(QString("Replay of %1 stopped: %2").arg(name(), pcap_geterr(m_file)));
+    } else if (ret == -2 || ret == 0) {
+        finish(); // Hết file
+    }
+}
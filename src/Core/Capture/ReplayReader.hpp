@@ -0,0 +1,49 @@
+#ifndef REPLAYREADER_HPP
+#define REPLAYREADER_HPP
+
+#include <QMutex>
+#include <QString>
+#include <cstdint>
+#include <vector>
+#include <pcap.h>
+#include "PacketSource.hpp"
+#include "ReplayOptions.hpp"
+#include "../../Common/ReplayMetrics.hpp"
+
+/**
+ * @brief Nguồn gói đọc một file pcap và phát lại theo nhịp timestamp gốc (nhân hệ số tốc độ).
+ *
+ * Gói đi qua cùng đường với bắt trực tiếp (luồng gộp, chia lô, tạm dừng), nên dùng để tái hiện
+ * lỗi và thử tải pipeline. Nhịp: chờ tới sát hạn bằng timerfd (poll cùng fd dừng, không tốn CPU),
+ * rồi quay vòng bận SPIN_NS cuối để gói ra đúng hạn cỡ micro giây. Tốc độ tối đa thì không chờ,
+ * và khi hàng đợi đầy thì chờ luồng gộp thay vì bỏ gói.
+ */
+class ReplayReader : public PacketSource {
+public:
+    ReplayReader(uint32_t interfaceId, const QString& filePath, const ReplayOptions& options);
+    ~ReplayReader() override;
+
+    // Mở file (và interface gửi nếu có); false + errorMessage nếu lỗi
+    bool open(QString& errorMessage);
+
+    int linkType() const override { return m_linkType; }
+    void addCounters(StatsShard& stats) const override;
+
+protected:
+    void run() override;
+
+private:
+    bool waitUntil(int64_t targetNs, std::vector<RawPacket>& local);   // false nếu bị dừng
+    void close();
+
+    ReplayOptions m_options;
+    int m_linkType = DLT_EN10MB;
+    pcap_t* m_file = nullptr;
+    pcap_t* m_inject = nullptr;
+    int m_timerFd = -1;
+
+    mutable QMutex m_metricsMutex;
+    ReplayMetrics m_metrics;   // Bản chép từ luồng phát lại (cập nhật mỗi lần publish)
+};
+
+#endif // REPLAYREADER_HPP
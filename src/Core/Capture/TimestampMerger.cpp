@@ -0,0 +1,71 @@
+#include "TimestampMerger.hpp"
+
+// --- Triển khai (Implementation) ---
+
+TimestampMerger::TimestampMerger(size_t sourceCount)
+{
+    reset(sourceCount);
+}
+
+void TimestampMerger::reset(size_t sourceCount)
+{
+    m_queues.clear();
+    m_queues.resize(sourceCount);
+    m_closed.assign(sourceCount, false);
+    m_heap = decltype(m_heap)();
+    m_waitingSources = sourceCount;
+    m_pending = 0;
+}
+
+void TimestampMerger::pushHead(size_t source)
+{
+    m_heap.push({ m_queues[source].front().timestampNs(), source });
+}
+
+void TimestampMerger::push(size_t source, RawPacket&& packet)
+{
+    std::deque<RawPacket>& queue = m_queues[source];
+    queue.push_back(std::move(packet));
+    ++m_pending;
+    if (queue.size() == 1) {
+        // Hàng vừa hết rỗng: gói này là đầu hàng mới
+        pushHead(source);
+        if (!m_closed[source]) --m_waitingSources;
+    }
+}
+
+void TimestampMerger::closeSource(size_t source)
+{
+    if (m_closed[source]) return;
+    m_closed[source] = true;
+    if (m_queues[source].empty()) --m_waitingSources;
+}
+
+bool TimestampMerger::pop(int64_t nowNs, int64_t maxHoldNs, RawPacket& out)
+{
+    if (m_heap.empty()) return false;
+    const HeadEntry head = m_heap.top();
+    std::deque<RawPacket>& queue = m_queues[head.source];
+
+    // Còn nguồn rỗng thì gói của nó (nếu đến) có thể sớm hơn: chỉ lấy khi đã giữ quá hạn
+    if (m_waitingSources > 0 && nowNs - queue.front().arrivalNs < maxHoldNs) return false;
+
+    m_heap.pop();
+    out = std::move(queue.front());
+    queue.pop_front();
+    --m_pending;
+    if (!queue.empty()) {
+        pushHead(head.source);
+    } else if (!m_closed[head.source]) {
+        ++m_waitingSources;
+    }
+    return true;
+}
+
+int64_t TimestampMerger::nsUntilRelease(int64_t nowNs, int64_t maxHoldNs) const
+{
+    if (m_heap.empty()) return -1;
+    if (m_waitingSources == 0) return 0;
+    const int64_t held = nowNs - m_queues[m_heap.top().source].front().arrivalNs;
+    return held >= maxHoldNs ? 0 : maxHoldNs - held;
+}
@@ -0,0 +1,57 @@
+#ifndef TIMESTAMPMERGER_HPP
+#define TIMESTAMPMERGER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <vector>
+#include "RawPacket.hpp"
+
+/**
+ * @brief Gộp k hàng đợi gói (mỗi interface một hàng) thành một dòng theo thứ tự timestamp.
+ *
+ * Min-heap chỉ chứa gói đầu của mỗi hàng đợi khác rỗng, nên pop() là O(log k).
+ * Gói sớm nhất chỉ được lấy ra khi chắc chắn đúng thứ tự (mọi nguồn còn mở đều có gói chờ),
+ * HOẶC khi nó đã bị giữ quá maxHoldNs: một interface im lặng không làm các interface khác
+ * đứng mãi. Gói của interface im lặng đến sau hạn đó có thể lệch thứ tự tối đa ~maxHoldNs.
+ * Không tự khóa: chỉ dùng trên luồng gộp.
+ */
+class TimestampMerger {
+public:
+    explicit TimestampMerger(size_t sourceCount = 0);
+
+    void reset(size_t sourceCount);
+    void push(size_t source, RawPacket&& packet);
+    // Nguồn đã dừng (lỗi): không chờ nguồn này nữa; gói còn lại của nó vẫn được lấy ra
+    void closeSource(size_t source);
+    bool isSourceClosed(size_t source) const { return m_closed[source]; }
+
+    // Lấy gói sớm nhất nếu đã được phép (xem mô tả lớp); false nếu chưa có gói nào được phép
+    bool pop(int64_t nowNs, int64_t maxHoldNs, RawPacket& out);
+    // Thời gian tới lúc gói đầu heap hết hạn giữ (0: lấy được ngay, -1: không có gói)
+    int64_t nsUntilRelease(int64_t nowNs, int64_t maxHoldNs) const;
+
+    bool isEmpty() const { return m_heap.empty(); }
+    size_t pendingPackets() const { return m_pending; }
+
+private:
+    struct HeadEntry {
+        int64_t timestampNs;
+        size_t source;   // Cùng timestamp: interface có chỉ số nhỏ ra trước
+        bool operator>(const HeadEntry& other) const {
+            if (timestampNs != other.timestampNs) return timestampNs > other.timestampNs;
+            return source > other.source;
+        }
+    };
+    void pushHead(size_t source);
+
+    std::vector<std::deque<RawPacket>> m_queues;
+    std::vector<bool> m_closed;
+    std::priority_queue<HeadEntry, std::vector<HeadEntry>, std::greater<HeadEntry>> m_heap;
+    size_t m_waitingSources = 0;   // Số nguồn còn mở nhưng đang rỗng (phải chờ chúng)
+    size_t m_pending = 0;
+};
+
+#endif // TIMESTAMPMERGER_HPP
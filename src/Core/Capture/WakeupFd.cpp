@@ -0,0 +1,61 @@
+#include "WakeupFd.hpp"
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// --- Triển khai (Implementation) ---
+
+WakeupFd::WakeupFd()
+{
+    m_readFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_readFd >= 0) {
+        m_writeFd = m_readFd;
+        return;
+    }
+
+    // Không có eventfd: dùng pipe không chặn
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0) {
+        m_readFd = fds[0];
+        m_writeFd = fds[1];
+    }
+}
+
+WakeupFd::~WakeupFd()
+{
+    if (m_writeFd >= 0 && m_writeFd != m_readFd) close(m_writeFd);
+    if (m_readFd >= 0) close(m_readFd);
+}
+
+void WakeupFd::notify()
+{
+    if (m_writeFd < 0) return;
+    // eventfd cộng dồn bộ đếm; pipe đầy (EAGAIN) nghĩa là đã có tín hiệu chờ sẵn
+    const uint64_t one = 1;
+    const ssize_t written = write(m_writeFd, &one, m_writeFd == m_readFd ? sizeof(one) : 1);
+    (void)written;
+}
+
+void WakeupFd::drain()
+{
+    if (m_readFd < 0) return;
+    uint64_t buffer[8];
+    while (read(m_readFd, buffer, sizeof(buffer)) > 0) {
+        if (m_writeFd == m_readFd) break; // eventfd: một lần read lấy hết bộ đếm
+    }
+}
+
+void WakeupFd::wait(int timeoutMs)
+{
+    if (m_readFd < 0) {
+        usleep(1000);
+        return;
+    }
+    struct pollfd pfd;
+    pfd.fd = m_readFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    poll(&pfd, 1, timeoutMs);
+}
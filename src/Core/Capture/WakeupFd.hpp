@@ -0,0 +1,30 @@
+#ifndef WAKEUPFD_HPP
+#define WAKEUPFD_HPP
+
+/**
+ * @brief Fd đánh thức luồng capture đang chờ trong poll() (eventfd, hoặc pipe nếu không có).
+ *
+ * Luồng điều khiển gọi notify() sau khi đổi cờ (dừng / tạm dừng / tiếp tục); luồng capture
+ * poll fd này cùng fd của pcap nên thức dậy ngay, không phải chờ hết timeout hay msleep.
+ * notify() và drain() không chặn, gọi được từ bất kỳ luồng nào.
+ */
+class WakeupFd {
+public:
+    WakeupFd();
+    ~WakeupFd();
+    WakeupFd(const WakeupFd&) = delete;
+    WakeupFd& operator=(const WakeupFd&) = delete;
+
+    int fd() const { return m_readFd; }   // Đưa vào poll() với POLLIN
+    void notify();
+    void drain();                         // Xóa các lần notify() đã nhận
+
+    // Chờ tới khi có notify() hoặc hết timeoutMs (-1: chờ mãi)
+    void wait(int timeoutMs);
+
+private:
+    int m_readFd = -1;
+    int m_writeFd = -1;   // Bằng m_readFd khi dùng eventfd
+};
+
+#endif // WAKEUPFD_HPP
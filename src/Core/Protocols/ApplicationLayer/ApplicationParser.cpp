@@ -1,6 +1,7 @@
 #include "ApplicationParser.hpp"
 #include "HTTPParser.hpp"
 #include "DNSParser.hpp"
+#include "TLSParser.hpp"
 #include <string>
 #include <sstream>
 #include <iomanip>
@@ -17,6 +18,23 @@ static std::string hexStr(const uint8_t* data, size_t len) {
 }
 // ---------------------------------------------------------
 
+// --- HÀM HELPER: Các cổng TLS phổ biến (nhận mọi loại record trên các cổng này) ---
+static bool isTLSPort(uint16_t port) {
+    switch (port) {
+    case 443:  // https
+    case 465:  // smtps
+    case 636:  // ldaps
+    case 853:  // dns-over-tls
+    case 993:  // imaps
+    case 995:  // pop3s
+    case 5061: // sips
+    case 8443:
+        return true;
+    default:
+        return false;
+    }
+}
+
 // --- HÀM HELPER: Parse SSDP (Port 1900) ---
 static bool parseSSDP(const uint8_t* data, size_t len, std::string& infoOutput) {
     if (len == 0) return false;
@@ -48,6 +66,15 @@ static bool parseSSDP(const uint8_t* data, size_t len, std::string& infoOutput)
 bool ApplicationParser::parse(ApplicationLayer& app, const uint8_t* data, size_t len,
                               uint16_t src_port, uint16_t dest_port, bool is_tcp)
 {
+    // 0. TLS: nhận diện theo nội dung (heuristic) trên MỌI cổng TCP.
+    // Cổng lạ chỉ nhận ClientHello/ServerHello để tránh nhận nhầm dữ liệu nhị phân.
+    if (is_tcp && len >= 5) {
+        bool tlsPort = isTLSPort(src_port) || isTLSPort(dest_port);
+        if (TLSParser::looksLikeTLS(data, len, !tlsPort)) {
+            return TLSParser::parse(app, data, len);
+        }
+    }
+
     // --- Quyết định dựa trên cổng (Port) ---
     if ((src_port == 1900 || dest_port == 1900) && !is_tcp) {
         std::string ssdpInfo;
@@ -87,10 +114,11 @@ bool ApplicationParser::parse(ApplicationLayer& app, const uint8_t* data, size_t
 
         // --- TRƯỜNG HỢP A: LÀ TCP ---
         if (is_tcp) {
-            // Chỉ gán nhãn "TLS" nếu nó là TCP VÀ có mang dữ liệu (payload).
+            // Payload không bắt đầu bằng record header (phần tiếp theo của
+            // một record lớn bị chia nhiều segment) -> vẫn là TLS.
             if (len > 0) {
-            app.protocol = "TLS"; // (TCP/443 là TLS, ra quyết định ngay)
-                app.info = "Transport Layer Security";
+                app.protocol = "TLS";
+                app.info = "Continuation Data";
                 return true; // Đánh dấu là đã xử lý
             }
         }
@@ -173,4 +201,7 @@ void ApplicationParser::appendTreeView(std::string& tree, int depth, const Appli
     else if (app.protocol == "DNS") {
         DNSParser::appendTreeView(tree, depth, app);
     }
+    else if (app.protocol == "TLS") {
+        TLSParser::appendTreeView(tree, depth, app);
+    }
 }
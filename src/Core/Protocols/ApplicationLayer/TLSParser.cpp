@@ -0,0 +1,649 @@
+#include "TLSParser.hpp"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// --- Hằng số TLS ---
+static const uint8_t  TLS_CONTENT_CCS        = 20;
+static const uint8_t  TLS_CONTENT_ALERT      = 21;
+static const uint8_t  TLS_CONTENT_HANDSHAKE  = 22;
+static const uint8_t  TLS_CONTENT_APP_DATA   = 23;
+static const uint8_t  TLS_CONTENT_HEARTBEAT  = 24;
+static const uint16_t TLS_MAX_RECORD_LEN     = 16384 + 2048; // 2^14 + phần mở rộng tối đa
+
+static const uint8_t  HS_CLIENT_HELLO = 1;
+static const uint8_t  HS_SERVER_HELLO = 2;
+
+static const uint16_t EXT_SERVER_NAME          = 0x0000;
+static const uint16_t EXT_SUPPORTED_GROUPS     = 0x000a;
+static const uint16_t EXT_EC_POINT_FORMATS     = 0x000b;
+static const uint16_t EXT_SIGNATURE_ALGORITHMS = 0x000d;
+static const uint16_t EXT_ALPN                 = 0x0010;
+static const uint16_t EXT_SUPPORTED_VERSIONS   = 0x002b;
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static void appendTree(std::string& tree, int depth, const std::string& line) {
+    tree += std::string(depth * 2, ' ') + line + "\n";
+}
+
+// Hàm trợ giúp chuyển số sang hex
+template <typename T>
+static std::string to_hex(T val) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::setw(4) << std::setfill('0') << val;
+    return ss.str();
+}
+
+/**
+ * @brief Bộ đọc có kiểm tra biên, trỏ thẳng vào buffer gốc (không copy).
+ * Mọi hàm đọc trả về false nếu không đủ dữ liệu, khi đó con trỏ không bị thay đổi.
+ */
+struct ByteReader {
+    const uint8_t* ptr = nullptr;
+    size_t remaining = 0;
+
+    bool u8(uint8_t& v) {
+        if (remaining < 1) return false;
+        v = ptr[0];
+        ptr++; remaining--;
+        return true;
+    }
+    bool u16(uint16_t& v) {
+        if (remaining < 2) return false;
+        v = static_cast<uint16_t>((ptr[0] << 8) | ptr[1]);
+        ptr += 2; remaining -= 2;
+        return true;
+    }
+    bool u24(uint32_t& v) {
+        if (remaining < 3) return false;
+        v = (static_cast<uint32_t>(ptr[0]) << 16) | (ptr[1] << 8) | ptr[2];
+        ptr += 3; remaining -= 3;
+        return true;
+    }
+    bool skip(size_t n) {
+        if (remaining < n) return false;
+        ptr += n; remaining -= n;
+        return true;
+    }
+    // Tách một vùng con n byte (các "vector" có tiền tố độ dài của TLS)
+    bool sub(size_t n, ByteReader& out) {
+        if (remaining < n) return false;
+        out.ptr = ptr;
+        out.remaining = n;
+        ptr += n; remaining -= n;
+        return true;
+    }
+};
+
+// Giá trị GREASE (RFC 8701) có dạng 0x?A?A, bị loại khỏi vân tay JA3/JA4
+static bool isGrease(uint16_t v) {
+    return (v & 0x0F0F) == 0x0A0A && (v >> 8) == (v & 0xFF);
+}
+
+static bool isRecordHeader(const uint8_t* d, size_t len) {
+    if (len < 5) return false;
+    if (d[0] < TLS_CONTENT_CCS || d[0] > TLS_CONTENT_HEARTBEAT) return false;
+    if (d[1] != 3 || d[2] > 4) return false; // SSL 3.0 .. TLS 1.3
+    uint16_t rec_len = static_cast<uint16_t>((d[3] << 8) | d[4]);
+    return rec_len > 0 && rec_len <= TLS_MAX_RECORD_LEN;
+}
+
+// ==================== MD5 / SHA-256 (cho JA3 / JA4) ====================
+
+static inline uint32_t rotl32(uint32_t x, int c) { return (x << c) | (x >> (32 - c)); }
+static inline uint32_t rotr32(uint32_t x, int c) { return (x >> c) | (x << (32 - c)); }
+
+static std::string bytesToHex(const uint8_t* data, size_t len) {
+    static const char* digits = "0123456789abcdef";
+    std::string out;
+    out.reserve(len * 2);
+    for (size_t i = 0; i < len; ++i) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 0x0F];
+    }
+    return out;
+}
+
+static std::string md5Hex(const std::string& msg) {
+    static const uint32_t K[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+    };
+    static const int S[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+    };
+
+    std::vector<uint8_t> buf(msg.begin(), msg.end());
+    uint64_t bit_len = static_cast<uint64_t>(msg.size()) * 8;
+    buf.push_back(0x80);
+    while (buf.size() % 64 != 56) buf.push_back(0);
+    for (int i = 0; i < 8; ++i) buf.push_back(static_cast<uint8_t>(bit_len >> (8 * i)));
+
+    uint32_t h[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    for (size_t off = 0; off < buf.size(); off += 64) {
+        uint32_t w[16];
+        for (int i = 0; i < 16; ++i) {
+            const uint8_t* p = &buf[off + i * 4];
+            w[i] = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t f;
+            int g;
+            if (i < 16)      { f = (b & c) | (~b & d); g = i; }
+            else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) % 16; }
+            else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) % 16; }
+            else             { f = c ^ (b | ~d);       g = (7 * i) % 16; }
+            uint32_t tmp = d;
+            d = c;
+            c = b;
+            b = b + rotl32(a + f + K[i] + w[g], S[i]);
+            a = tmp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    }
+
+    uint8_t digest[16];
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) digest[i * 4 + j] = static_cast<uint8_t>(h[i] >> (8 * j));
+    }
+    return bytesToHex(digest, 16);
+}
+
+static std::string sha256Hex(const std::string& msg) {
+    static const uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    std::vector<uint8_t> buf(msg.begin(), msg.end());
+    uint64_t bit_len = static_cast<uint64_t>(msg.size()) * 8;
+    buf.push_back(0x80);
+    while (buf.size() % 64 != 56) buf.push_back(0);
+    for (int i = 7; i >= 0; --i) buf.push_back(static_cast<uint8_t>(bit_len >> (8 * i)));
+
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    for (size_t off = 0; off < buf.size(); off += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            const uint8_t* p = &buf[off + i * 4];
+            w[i] = (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t S1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = hh + S1 + ch + K[i] + w[i];
+            uint32_t S0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = S0 + maj;
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+
+    uint8_t digest[32];
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) digest[i * 4 + j] = static_cast<uint8_t>(h[i] >> (24 - 8 * j));
+    }
+    return bytesToHex(digest, 32);
+}
+
+// ==================== VÂN TAY JA3 / JA4 ====================
+
+template <typename T>
+static std::string joinDecimal(const std::vector<T>& values) {
+    std::string out;
+    for (T v : values) {
+        if (sizeof(T) == 2 && isGrease(static_cast<uint16_t>(v))) continue;
+        if (!out.empty()) out += "-";
+        out += std::to_string(v);
+    }
+    return out;
+}
+
+static std::string joinHex4(const std::vector<uint16_t>& values) {
+    std::string out;
+    char buf[8];
+    for (uint16_t v : values) {
+        if (!out.empty()) out += ",";
+        snprintf(buf, sizeof(buf), "%04x", v);
+        out += buf;
+    }
+    return out;
+}
+
+static std::string twoDigits(size_t n) {
+    if (n > 99) n = 99;
+    char buf[4];
+    snprintf(buf, sizeof(buf), "%02zu", n);
+    return buf;
+}
+
+// Chỉ 0-9, A-Z, a-z (không phụ thuộc locale như isalnum)
+static bool isAsciiAlnum(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+static std::string ja4VersionCode(uint16_t version) {
+    switch (version) {
+    case 0x0304: return "13";
+    case 0x0303: return "12";
+    case 0x0302: return "11";
+    case 0x0301: return "10";
+    case 0x0300: return "s3";
+    default:     return "00";
+    }
+}
+
+static std::string buildJA4(const ApplicationLayer& app,
+                            const std::vector<uint16_t>& extensions,
+                            const std::vector<uint16_t>& sigalgs)
+{
+    // --- Phần a: t + version + (d|i) + số cipher + số extension + ALPN ---
+    uint16_t best = 0;
+    for (uint16_t v : app.tls_supported_versions) {
+        if (!isGrease(v)) best = std::max(best, v);
+    }
+    if (best == 0) best = app.tls_hello_version;
+
+    std::vector<uint16_t> ciphers;
+    for (uint16_t c : app.tls_cipher_suites) {
+        if (!isGrease(c)) ciphers.push_back(c);
+    }
+    std::vector<uint16_t> exts;
+    size_t ext_count = 0;
+    for (uint16_t e : extensions) {
+        if (isGrease(e)) continue;
+        ext_count++;
+        if (e != EXT_SERVER_NAME && e != EXT_ALPN) exts.push_back(e);
+    }
+
+    std::string alpn_code = "00";
+    if (!app.tls_alpn.empty()) {
+        std::string first = app.tls_alpn.substr(0, app.tls_alpn.find(','));
+        if (!first.empty()) {
+            const unsigned char head = static_cast<unsigned char>(first.front());
+            const unsigned char tail = static_cast<unsigned char>(first.back());
+            if (isAsciiAlnum(head) && isAsciiAlnum(tail)) {
+                alpn_code = std::string(1, first.front()) + first.back();
+            } else {
+                // Theo JA4: ký tự hex đầu của byte đầu + ký tự hex cuối của byte cuối (0xAB 0xCD -> "ad")
+                static const char HEX[] = "0123456789abcdef";
+                alpn_code = std::string(1, HEX[head >> 4]) + HEX[tail & 0x0F];
+            }
+        }
+    }
+
+    std::string a = "t" + ja4VersionCode(best) + (app.tls_sni.empty() ? "i" : "d") +
+                    twoDigits(ciphers.size()) + twoDigits(ext_count) + alpn_code;
+
+    // --- Phần b: SHA-256 (12 ký tự) của danh sách cipher đã sắp xếp ---
+    std::sort(ciphers.begin(), ciphers.end());
+    std::string b = ciphers.empty() ? "000000000000" : sha256Hex(joinHex4(ciphers)).substr(0, 12);
+
+    // --- Phần c: extension đã sắp xếp (bỏ SNI/ALPN) + signature algorithms theo thứ tự gốc ---
+    std::sort(exts.begin(), exts.end());
+    std::string c_input = joinHex4(exts);
+    std::vector<uint16_t> algs;
+    for (uint16_t s : sigalgs) {
+        if (!isGrease(s)) algs.push_back(s);
+    }
+    if (!algs.empty()) c_input += "_" + joinHex4(algs);
+    std::string c = exts.empty() ? "000000000000" : sha256Hex(c_input).substr(0, 12);
+
+    return a + "_" + b + "_" + c;
+}
+
+// ==================== PHÂN TÍCH HANDSHAKE ====================
+
+static void parseSNI(ByteReader ext, std::string& sni) {
+    uint16_t list_len;
+    ByteReader list;
+    if (!ext.u16(list_len) || !ext.sub(list_len, list)) return;
+
+    uint8_t name_type;
+    uint16_t name_len;
+    while (list.u8(name_type) && list.u16(name_len)) {
+        ByteReader name;
+        if (!list.sub(name_len, name)) return;
+        if (name_type == 0) { // host_name
+            sni.assign(reinterpret_cast<const char*>(name.ptr), name.remaining);
+            return;
+        }
+    }
+}
+
+static void parseALPN(ByteReader ext, std::string& alpn) {
+    uint16_t list_len;
+    ByteReader list;
+    if (!ext.u16(list_len) || !ext.sub(list_len, list)) return;
+
+    uint8_t proto_len;
+    ByteReader proto;
+    while (list.u8(proto_len) && list.sub(proto_len, proto)) {
+        if (!alpn.empty()) alpn += ",";
+        alpn.append(reinterpret_cast<const char*>(proto.ptr), proto.remaining);
+    }
+}
+
+static void parseU16List(ByteReader ext, std::vector<uint16_t>& out) {
+    uint16_t list_len;
+    ByteReader list;
+    if (!ext.u16(list_len) || !ext.sub(list_len, list)) return;
+    uint16_t v;
+    while (list.u16(v)) out.push_back(v);
+}
+
+/**
+ * @brief Phân tích ClientHello.
+ * @param complete true nếu toàn bộ message nằm trong segment này
+ * (chỉ khi đó mới tính vân tay, tránh JA3/JA4 sai do bị cắt).
+ */
+static void parseClientHello(ApplicationLayer& app, ByteReader body, bool complete) {
+    uint16_t legacy_version;
+    if (!body.u16(legacy_version)) return;
+    app.tls_hello_version = legacy_version;
+
+    uint8_t sid_len;
+    if (!body.skip(32) || !body.u8(sid_len) || !body.skip(sid_len)) return; // random + session_id
+
+    uint16_t cs_len;
+    ByteReader suites;
+    if (!body.u16(cs_len) || !body.sub(cs_len, suites)) return;
+    uint16_t suite;
+    while (suites.u16(suite)) app.tls_cipher_suites.push_back(suite);
+
+    uint8_t comp_len;
+    if (!body.u8(comp_len) || !body.skip(comp_len)) return;
+
+    std::vector<uint16_t> extensions, groups, sigalgs;
+    std::vector<uint8_t> point_formats;
+
+    uint16_t ext_total;
+    ByteReader exts;
+    if (body.u16(ext_total) && body.sub(ext_total, exts)) { // Hello cũ có thể không có extension
+        uint16_t type, ext_len;
+        ByteReader ext;
+        while (exts.u16(type) && exts.u16(ext_len) && exts.sub(ext_len, ext)) {
+            extensions.push_back(type);
+            switch (type) {
+            case EXT_SERVER_NAME:
+                parseSNI(ext, app.tls_sni);
+                break;
+            case EXT_ALPN:
+                parseALPN(ext, app.tls_alpn);
+                break;
+            case EXT_SUPPORTED_GROUPS:
+                parseU16List(ext, groups);
+                break;
+            case EXT_SIGNATURE_ALGORITHMS:
+                parseU16List(ext, sigalgs);
+                break;
+            case EXT_EC_POINT_FORMATS: {
+                uint8_t list_len;
+                ByteReader list;
+                if (ext.u8(list_len) && ext.sub(list_len, list)) {
+                    uint8_t f;
+                    while (list.u8(f)) point_formats.push_back(f);
+                }
+                break;
+            }
+            case EXT_SUPPORTED_VERSIONS: {
+                uint8_t list_len;
+                ByteReader list;
+                if (ext.u8(list_len) && ext.sub(list_len, list)) {
+                    uint16_t v;
+                    while (list.u16(v)) app.tls_supported_versions.push_back(v);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    if (!complete) return;
+
+    // JA3 = SSLVersion,Ciphers,Extensions,EllipticCurves,EllipticCurvePointFormats
+    app.tls_ja3 = std::to_string(legacy_version) + "," +
+                  joinDecimal(app.tls_cipher_suites) + "," +
+                  joinDecimal(extensions) + "," +
+                  joinDecimal(groups) + "," +
+                  joinDecimal(point_formats);
+    app.tls_ja3_hash = md5Hex(app.tls_ja3);
+    app.tls_ja4 = buildJA4(app, extensions, sigalgs);
+}
+
+static void parseServerHello(ApplicationLayer& app, ByteReader body) {
+    uint16_t legacy_version;
+    if (!body.u16(legacy_version)) return;
+    app.tls_hello_version = legacy_version;
+
+    uint8_t sid_len;
+    if (!body.skip(32) || !body.u8(sid_len) || !body.skip(sid_len)) return;
+    if (!body.u16(app.tls_selected_cipher)) return;
+
+    uint8_t compression;
+    if (!body.u8(compression)) return;
+
+    uint16_t ext_total;
+    ByteReader exts;
+    if (!body.u16(ext_total) || !body.sub(ext_total, exts)) return;
+
+    uint16_t type, ext_len;
+    ByteReader ext;
+    while (exts.u16(type) && exts.u16(ext_len) && exts.sub(ext_len, ext)) {
+        if (type == EXT_SUPPORTED_VERSIONS) {
+            ext.u16(app.tls_selected_version);
+        } else if (type == EXT_ALPN) {
+            parseALPN(ext, app.tls_alpn);
+        }
+    }
+}
+
+static std::string handshakeTypeName(uint8_t type) {
+    switch (type) {
+    case 0:  return "Hello Request";
+    case 1:  return "Client Hello";
+    case 2:  return "Server Hello";
+    case 4:  return "New Session Ticket";
+    case 8:  return "Encrypted Extensions";
+    case 11: return "Certificate";
+    case 12: return "Server Key Exchange";
+    case 13: return "Certificate Request";
+    case 14: return "Server Hello Done";
+    case 15: return "Certificate Verify";
+    case 16: return "Client Key Exchange";
+    case 20: return "Finished";
+    default: return "";
+    }
+}
+
+/**
+ * @brief Mô tả một record (dùng cho cột Info). Với Handshake sẽ phân tích
+ * từng message bên trong record.
+ */
+static std::string describeRecord(ApplicationLayer& app, uint8_t type, ByteReader record) {
+    switch (type) {
+    case TLS_CONTENT_CCS:       return "Change Cipher Spec";
+    case TLS_CONTENT_ALERT:     return "Alert";
+    case TLS_CONTENT_APP_DATA:  return "Application Data";
+    case TLS_CONTENT_HEARTBEAT: return "Heartbeat";
+    default: break;
+    }
+
+    // --- Handshake: có thể chứa nhiều message ---
+    std::string out;
+    uint8_t hs_type;
+    uint32_t hs_len;
+    while (record.u8(hs_type) && record.u24(hs_len)) {
+        std::string name = handshakeTypeName(hs_type);
+        if (name.empty()) {
+            // Sau ChangeCipherSpec, handshake đã mã hóa -> không còn đọc được
+            if (out.empty()) out = "Encrypted Handshake Message";
+            break;
+        }
+        if (app.tls_handshake_type == 0) app.tls_handshake_type = hs_type;
+
+        bool complete = hs_len <= record.remaining;
+        ByteReader body;
+        record.sub(std::min<size_t>(hs_len, record.remaining), body);
+
+        if (hs_type == HS_CLIENT_HELLO) {
+            parseClientHello(app, body, complete);
+            if (!app.tls_sni.empty()) name += " (SNI=" + app.tls_sni + ")";
+        } else if (hs_type == HS_SERVER_HELLO) {
+            parseServerHello(app, body);
+        }
+
+        if (!out.empty()) out += ", ";
+        out += name;
+        if (!complete) break;
+    }
+    return out.empty() ? "Handshake" : out;
+}
+
+// --- Triển khai (Implementation) ---
+
+bool TLSParser::looksLikeTLS(const uint8_t* data, size_t len, bool strict) {
+    if (!isRecordHeader(data, len)) return false;
+    if (!strict) return true;
+
+    // Cổng lạ: chỉ nhận Handshake mở đầu bằng ClientHello/ServerHello có độ dài hợp lý
+    if (data[0] != TLS_CONTENT_HANDSHAKE || len < 11) return false;
+    uint8_t hs_type = data[5];
+    if (hs_type != HS_CLIENT_HELLO && hs_type != HS_SERVER_HELLO) return false;
+
+    uint32_t hs_len = (static_cast<uint32_t>(data[6]) << 16) | (data[7] << 8) | data[8];
+    uint16_t rec_len = static_cast<uint16_t>((data[3] << 8) | data[4]);
+    if (hs_len < 38 || hs_len + 4 > rec_len) return false; // version + random + session_id tối thiểu
+
+    // legacy_version trong Hello cũng phải là 3.x
+    return data[9] == 3 && data[10] <= 4;
+}
+
+bool TLSParser::parse(ApplicationLayer& app, const uint8_t* data, size_t len) {
+    ByteReader reader{data, len};
+    std::string info;
+    bool found = false;
+
+    // Một segment có thể chứa nhiều record (vd: Server Hello, Change Cipher Spec, ...)
+    while (isRecordHeader(reader.ptr, reader.remaining)) {
+        uint8_t type = reader.ptr[0];
+        uint16_t rec_len = static_cast<uint16_t>((reader.ptr[3] << 8) | reader.ptr[4]);
+
+        if (!found) {
+            app.tls_content_type = type;
+            app.tls_version_major = reader.ptr[1];
+            app.tls_version_minor = reader.ptr[2];
+            found = true;
+        }
+        reader.skip(5);
+
+        // Record có thể bị cắt ở cuối segment -> chỉ đọc phần đang có
+        size_t available = std::min<size_t>(rec_len, reader.remaining);
+        ByteReader record;
+        reader.sub(available, record);
+
+        if (!info.empty()) info += ", ";
+        info += describeRecord(app, type, record);
+
+        if (available < rec_len) break;
+    }
+
+    if (!found) return false;
+
+    app.protocol = "TLS";
+    app.info = info;
+    return true;
+}
+
+std::string TLSParser::versionToString(uint16_t version) {
+    switch (version) {
+    case 0x0300: return "SSL 3.0";
+    case 0x0301: return "TLS 1.0";
+    case 0x0302: return "TLS 1.1";
+    case 0x0303: return "TLS 1.2";
+    case 0x0304: return "TLS 1.3";
+    default:     return isGrease(version) ? "GREASE" : "Unknown";
+    }
+}
+
+void TLSParser::appendTreeView(std::string& tree, int depth, const ApplicationLayer& app) {
+    appendTree(tree, depth, "Transport Layer Security");
+    depth++;
+
+    uint16_t record_version = static_cast<uint16_t>((app.tls_version_major << 8) | app.tls_version_minor);
+    appendTree(tree, depth, "Record Layer: " + versionToString(record_version) +
+                                " (" + to_hex(record_version) + ")");
+    appendTree(tree, depth, "Content Type: " + std::to_string(app.tls_content_type));
+
+    if (app.tls_handshake_type == 0) return;
+
+    appendTree(tree, depth, "Handshake Type: " + handshakeTypeName(app.tls_handshake_type) +
+                                " (" + std::to_string(app.tls_handshake_type) + ")");
+    if (app.tls_hello_version != 0) {
+        appendTree(tree, depth, "Version: " + versionToString(app.tls_hello_version) +
+                                    " (" + to_hex(app.tls_hello_version) + ")");
+    }
+    if (!app.tls_sni.empty()) {
+        appendTree(tree, depth, "Server Name: " + app.tls_sni);
+    }
+    if (!app.tls_alpn.empty()) {
+        appendTree(tree, depth, "ALPN: " + app.tls_alpn);
+    }
+    if (!app.tls_supported_versions.empty()) {
+        std::string versions;
+        for (uint16_t v : app.tls_supported_versions) {
+            if (isGrease(v)) continue;
+            if (!versions.empty()) versions += ", ";
+            versions += versionToString(v);
+        }
+        appendTree(tree, depth, "Supported Versions: " + versions);
+    }
+    if (app.tls_selected_version != 0) {
+        appendTree(tree, depth, "Selected Version: " + versionToString(app.tls_selected_version));
+    }
+    if (!app.tls_cipher_suites.empty()) {
+        appendTree(tree, depth, "Cipher Suites: " + std::to_string(app.tls_cipher_suites.size()) + " suites");
+    }
+    if (app.tls_handshake_type == HS_SERVER_HELLO) {
+        appendTree(tree, depth, "Cipher Suite: " + to_hex(app.tls_selected_cipher));
+    }
+    if (!app.tls_ja3.empty()) {
+        appendTree(tree, depth, "JA3: " + app.tls_ja3);
+        appendTree(tree, depth, "JA3 Hash: " + app.tls_ja3_hash);
+    }
+    if (!app.tls_ja4.empty()) {
+        appendTree(tree, depth, "JA4: " + app.tls_ja4);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef TLS_PARSER_HPP
+#define TLS_PARSER_HPP
+
+#include "../../../Common/PacketData.hpp"
+#include <string>
+#include <cstdint>
+
+class TLSParser {
+public:
+    /**
+     * @brief Kiểm tra nhanh (heuristic) xem payload có bắt đầu bằng một TLS record không.
+     * Chỉ đọc vài byte đầu, không cấp phát bộ nhớ -> dùng được cho mọi cổng.
+     * @param data Con trỏ đến đầu payload (sau header TCP).
+     * @param len Kích thước payload.
+     * @param strict true: chỉ chấp nhận record Handshake chứa ClientHello/ServerHello
+     * (dùng cho cổng lạ để tránh nhận nhầm). false: chấp nhận mọi record hợp lệ.
+     */
+    static bool looksLikeTLS(const uint8_t* data, size_t len, bool strict);
+
+    /**
+     * @brief Phân tích (parse) các TLS record trong payload.
+     * Giải mã ClientHello/ServerHello để lấy SNI, ALPN, supported_versions,
+     * cipher suites và vân tay JA3/JA4. Đọc trực tiếp trên buffer (zero-copy),
+     * mọi truy cập đều được kiểm tra biên.
+     * @param app Struct ApplicationLayer (trong PacketData) để điền dữ liệu vào.
+     * @param data Con trỏ đến đầu payload.
+     * @param len Kích thước payload.
+     * @return true nếu payload là TLS.
+     */
+    static bool parse(ApplicationLayer& app, const uint8_t* data, size_t len);
+
+    /**
+     * @brief Thêm thông tin TLS vào cây chi tiết (tree view).
+     */
+    static void appendTreeView(std::string& tree, int depth, const ApplicationLayer& app);
+
+    // Hàm helper lấy tên phiên bản (0x0303 -> "TLS 1.2")
+    static std::string versionToString(uint16_t version);
+};
+
+#endif // TLS_PARSER_HPP
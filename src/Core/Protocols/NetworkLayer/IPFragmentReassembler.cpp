@@ -0,0 +1,161 @@
+#include "IPFragmentReassembler.hpp"
+#include <algorithm>
+#include <cstring>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+size_t FragmentKeyHash::operator()(const FragmentKey& k) const {
+    // FNV-1a trên toàn bộ các trường của khóa
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const uint8_t* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    mix(k.src.data(), k.is_ipv6 ? 16 : 4);
+    mix(k.dst.data(), k.is_ipv6 ? 16 : 4);
+    mix(reinterpret_cast<const uint8_t*>(&k.id), sizeof(k.id));
+    mix(&k.protocol, 1);
+    return static_cast<size_t>(h);
+}
+
+// --- Triển khai (Implementation) ---
+
+void IPFragmentReassembler::clear()
+{
+    m_entries.clear();
+    m_age.clear();
+    m_totalBytes = 0;
+    m_timedOut = 0;
+}
+
+void IPFragmentReassembler::removeEntry(std::unordered_map<FragmentKey, Entry, FragmentKeyHash>::iterator it)
+{
+    m_totalBytes -= it->second.buffer.size();
+    m_age.erase(it->second.age_it);
+    m_entries.erase(it);
+}
+
+void IPFragmentReassembler::discard(const FragmentKey& key)
+{
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) removeEntry(it);
+}
+
+void IPFragmentReassembler::expire(int64_t nowNs)
+{
+    while (!m_age.empty()) {
+        auto it = m_entries.find(m_age.front());
+        if (it == m_entries.end()) { m_age.pop_front(); continue; }
+        if (nowNs - it->second.first_seen_ns < DEFAULT_TIMEOUT_NS) break;
+        removeEntry(it);
+        m_timedOut++;
+    }
+}
+
+void IPFragmentReassembler::fillGaps(Entry& e, uint32_t offset, const uint8_t* data, uint32_t len)
+{
+    const uint32_t end = offset + len;
+    if (e.buffer.size() < end) e.buffer.resize(end);
+
+    // Bắt đầu từ sau khoảng đã có chứa 'offset' (nếu có)
+    uint32_t pos = offset;
+    auto it = e.covered.upper_bound(offset);
+    if (it != e.covered.begin()) {
+        auto prev = std::prev(it);
+        if (prev->second > pos) pos = prev->second;
+    }
+
+    while (pos < end) {
+        auto next = e.covered.lower_bound(pos);
+        uint32_t gapEnd = end;
+        if (next != e.covered.end() && next->first < gapEnd) gapEnd = next->first;
+
+        if (gapEnd > pos) {
+            memcpy(e.buffer.data() + pos, data + (pos - offset), gapEnd - pos);
+            e.covered[pos] = gapEnd;
+        }
+        if (next == e.covered.end() || next->first >= end) break;
+        pos = std::max(pos, next->second);
+    }
+
+    // Gộp các khoảng liền kề
+    for (auto cur = e.covered.begin(); cur != e.covered.end();) {
+        auto nxt = std::next(cur);
+        if (nxt != e.covered.end() && nxt->first <= cur->second) {
+            cur->second = std::max(cur->second, nxt->second);
+            e.covered.erase(nxt);
+        } else {
+            cur = nxt;
+        }
+    }
+}
+
+bool IPFragmentReassembler::isComplete(const Entry& e)
+{
+    if (!e.saw_last || e.covered.size() != 1) return false;
+    const auto& range = *e.covered.begin();
+    return range.first == 0 && range.second >= e.total_length;
+}
+
+IPFragmentReassembler::Result IPFragmentReassembler::addFragment(
+    const FragmentKey& key, uint32_t offset, const uint8_t* data, size_t len,
+    bool more, uint32_t packetId, int64_t nowNs,
+    std::vector<uint8_t>& out, std::vector<uint32_t>& fragmentIds)
+{
+    expire(nowNs);
+
+    if (len == 0 && more) return DROPPED;
+    if (static_cast<uint64_t>(offset) + len > MAX_DATAGRAM_SIZE) return DROPPED;
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        // Bảng đầy: bỏ datagram cũ nhất
+        while (m_entries.size() >= MAX_ENTRIES && !m_age.empty()) {
+            removeEntry(m_entries.find(m_age.front()));
+        }
+        Entry entry;
+        entry.first_seen_ns = nowNs;
+        m_age.push_back(key);
+        entry.age_it = std::prev(m_age.end());
+        it = m_entries.emplace(key, std::move(entry)).first;
+    }
+    Entry& e = it->second;
+
+    if (e.packet_ids.size() >= MAX_FRAGMENTS) {
+        removeEntry(it);
+        return DROPPED;
+    }
+    e.packet_ids.push_back(packetId);
+
+    uint32_t end = offset + static_cast<uint32_t>(len);
+    if (!more && !e.saw_last) {
+        e.saw_last = true;
+        e.total_length = end;
+    }
+    // Dữ liệu vượt quá mảnh cuối: bỏ phần thừa
+    if (e.saw_last && end > e.total_length) {
+        end = std::max(offset, e.total_length);
+    }
+
+    if (end > offset) {
+        size_t before = e.buffer.size();
+        fillGaps(e, offset, data, end - offset);
+        m_totalBytes += e.buffer.size() - before;
+    }
+
+    if (isComplete(e)) {
+        out.assign(e.buffer.begin(), e.buffer.begin() + e.total_length);
+        fragmentIds = e.packet_ids;
+        removeEntry(it);
+        return COMPLETE;
+    }
+
+    // Vượt tổng bộ nhớ: bỏ các datagram cũ (trừ datagram hiện tại)
+    while (m_totalBytes > MAX_TOTAL_BYTES && m_age.size() > 1 && !(m_age.front() == key)) {
+        removeEntry(m_entries.find(m_age.front()));
+    }
+
+    return INCOMPLETE;
+}
@@ -0,0 +1,99 @@
+#ifndef IPFRAGMENTREASSEMBLER_HPP
+#define IPFRAGMENTREASSEMBLER_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Khóa của một datagram đang ghép: (src, dst, id, proto).
+ * IPv4 dùng 4 byte đầu của mảng địa chỉ.
+ */
+struct FragmentKey {
+    std::array<uint8_t, 16> src{};
+    std::array<uint8_t, 16> dst{};
+    uint32_t id = 0;
+    uint8_t  protocol = 0;
+    bool     is_ipv6 = false;
+
+    bool operator==(const FragmentKey& other) const {
+        return id == other.id && protocol == other.protocol && is_ipv6 == other.is_ipv6 &&
+               src == other.src && dst == other.dst;
+    }
+};
+
+struct FragmentKeyHash {
+    size_t operator()(const FragmentKey& k) const;
+};
+
+/**
+ * @brief Bảng ghép phân mảnh IPv4/IPv6.
+ *
+ * - Mỗi datagram có thời hạn (timeout) tính theo timestamp của gói tin.
+ * - Giới hạn số mảnh / datagram, kích thước datagram, số datagram và tổng bộ nhớ.
+ * - Chồng lấn (overlap): giữ dữ liệu đến trước, phần trùng của mảnh sau bị bỏ.
+ */
+class IPFragmentReassembler {
+public:
+    static constexpr int64_t DEFAULT_TIMEOUT_NS = 30LL * 1000000000LL; // 30 giây
+    static constexpr size_t  MAX_FRAGMENTS      = 64;     // Mảnh / datagram
+    static constexpr size_t  MAX_DATAGRAM_SIZE  = 65535;
+    static constexpr size_t  MAX_ENTRIES        = 1024;   // Datagram đang ghép cùng lúc
+    static constexpr size_t  MAX_TOTAL_BYTES    = 4 * 1024 * 1024;
+
+    enum Result {
+        INCOMPLETE,  // Đã nhận, chờ thêm mảnh
+        COMPLETE,    // Datagram hoàn tất (out / fragmentIds đã được điền)
+        DROPPED      // Mảnh không hợp lệ hoặc vượt giới hạn
+    };
+
+    /**
+     * @brief Thêm một mảnh.
+     * @param offset Vị trí của mảnh (byte) trong payload của datagram.
+     * @param more Cờ More Fragments.
+     * @param packetId packet_id của gói chứa mảnh.
+     * @param nowNs Timestamp của gói (ns), dùng cho timeout.
+     * @param out (COMPLETE) Payload đã ghép.
+     * @param fragmentIds (COMPLETE) packet_id của các mảnh theo thứ tự nhận.
+     */
+    Result addFragment(const FragmentKey& key, uint32_t offset, const uint8_t* data, size_t len,
+                       bool more, uint32_t packetId, int64_t nowNs,
+                       std::vector<uint8_t>& out, std::vector<uint32_t>& fragmentIds);
+
+    // Bỏ datagram đang ghép (ví dụ một mảnh bị cắt bởi snaplen: không thể ghép đủ)
+    void discard(const FragmentKey& key);
+
+    // Xóa các datagram quá hạn
+    void expire(int64_t nowNs);
+    void clear();
+
+    size_t pendingDatagrams() const { return m_entries.size(); }
+    uint64_t timedOutDatagrams() const { return m_timedOut; }
+
+private:
+    struct Entry {
+        std::vector<uint8_t> buffer;
+        std::map<uint32_t, uint32_t> covered; // Các khoảng đã có dữ liệu: start -> end
+        uint32_t total_length = 0;            // Biết khi nhận mảnh cuối (MF = 0)
+        bool     saw_last = false;
+        std::vector<uint32_t> packet_ids;
+        int64_t  first_seen_ns = 0;
+        std::list<FragmentKey>::iterator age_it;
+    };
+
+    // Ghi phần chưa có của [offset, offset + len) vào buffer
+    static void fillGaps(Entry& e, uint32_t offset, const uint8_t* data, uint32_t len);
+    static bool isComplete(const Entry& e);
+    void removeEntry(std::unordered_map<FragmentKey, Entry, FragmentKeyHash>::iterator it);
+
+    std::unordered_map<FragmentKey, Entry, FragmentKeyHash> m_entries;
+    std::list<FragmentKey> m_age;   // Theo thứ tự tạo (đầu = cũ nhất)
+    size_t m_totalBytes = 0;
+    uint64_t m_timedOut = 0;
+};
+
+#endif // IPFRAGMENTREASSEMBLER_HPP
@@ -71,9 +71,9 @@ public:
 
     static std::string flagsToString(uint16_t flags) {
         std::string s;
-        if (flags & 0x4000) s += "Reserved, ";
-        if (flags & 0x2000) s += "Don't Fragment, ";
-        if (flags & 0x1000) s += "More Fragments, ";
+        if (flags & 0x8000) s += "Reserved, ";
+        if (flags & 0x4000) s += "Don't Fragment, ";
+        if (flags & 0x2000) s += "More Fragments, ";
         if (!s.empty()) s.resize(s.size() - 2);
         return s.empty() ? "0" : s;
     }
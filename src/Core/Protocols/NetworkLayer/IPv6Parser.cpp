@@ -46,10 +46,41 @@ bool IPv6Parser::parse(IPv6Header& ipv6, const uint8_t*& data, size_t& len) {
     len -= 40;
 
     uint8_t current_next_header = ipv6.next_header;
-    bool parsing_extensions = true;
+    if (!skipExtensionHeaders(current_next_header, data, len)) return false;
+
+    // Header Phân mảnh (Fragment): dừng ở đây, phần sau nó thuộc phần được phân mảnh
+    if (current_next_header == IPPROTO_FRAGMENT) { // (44)
+        if (len < 8) return false; // Header Fragment cố định 8 byte
+        const struct ip6_frag* frag_hdr = (const struct ip6_frag*)data;
+        current_next_header = frag_hdr->ip6f_nxt;
+
+        // Lưu thông tin phân mảnh để ghép lại (offset tính theo đơn vị 8 byte)
+        uint16_t offlg = ntohs(frag_hdr->ip6f_offlg);
+        ipv6.has_fragment = true;
+        ipv6.frag_id = ntohl(frag_hdr->ip6f_ident);
+        ipv6.frag_offset = offlg >> 3;
+        ipv6.frag_more = (offlg & 0x0001) != 0;
+
+        data += 8;
+        len -= 8;
+
+        // "Atomic fragment" (offset 0, M = 0): datagram đủ, tiếp tục như không phân mảnh.
+        // Mảnh thật: mọi mảnh dừng tại đây (cùng khóa ip6f_nxt, cùng gốc offset);
+        // extension header còn lại được bỏ qua sau khi ghép (skipExtensionHeaders)
+        if (ipv6.frag_offset == 0 && !ipv6.frag_more) {
+            if (!skipExtensionHeaders(current_next_header, data, len)) return false;
+        }
+    }
+
+    // Cập nhật 'next_header' thành protocol Tầng 4 thực sự (mảnh: Next Header của header Fragment)
+    ipv6.next_header = current_next_header;
+
+    return true;
+}
 
-    while (parsing_extensions) {
-        switch (current_next_header) {
+bool IPv6Parser::skipExtensionHeaders(uint8_t& nextHeader, const uint8_t*& data, size_t& len) {
+    while (true) {
+        switch (nextHeader) {
 
         // Các Extension Header cần bỏ qua
         case IPPROTO_HOPOPTS:  // Hop-by-Hop (0)
@@ -58,46 +89,23 @@ bool IPv6Parser::parse(IPv6Header& ipv6, const uint8_t*& data, size_t& len) {
         {
             if (len < 8) return false; // Ít nhất 8 byte cho ext header
             const struct ip6_ext* ext_hdr = (const struct ip6_ext*)data;
-            current_next_header = ext_hdr->ip6e_nxt; // Chuyển sang header tiếp theo
 
             // Độ dài của header này (tính bằng 8-byte, *không* bao gồm 8 byte đầu)
             size_t ext_len = (ext_hdr->ip6e_len + 1) * 8;
 
             if (len < ext_len) return false; // Gói tin bị cắt
+            nextHeader = ext_hdr->ip6e_nxt; // Chuyển sang header tiếp theo
             data += ext_len;
             len -= ext_len;
             break;
         }
 
-        // Header Phân mảnh (Fragment)
-        case IPPROTO_FRAGMENT: // (44)
-        {
-            if (len < 8) return false; // Header Fragment cố định 8 byte
-            const struct ip6_frag* frag_hdr = (const struct ip6_frag*)data;
-            current_next_header = frag_hdr->ip6f_nxt; // Chuyển sang header tiếp theo
-
-            data += 8;
-            len -= 8;
-            break;
-        }
-
-        // Đây là các header Tầng 4 (hoặc không phải extension)
-        // Chúng ta dừng vòng lặp
-        case IPPROTO_TCP:    // 6
-        case IPPROTO_UDP:    // 17
-        case IPPROTO_ICMPV6: // 58
-        case IPPROTO_NONE:   // 59 (Không có header tiếp theo)
-        default:             // Bất kỳ protocol nào khác (ví dụ: ESP, AH)
-            parsing_extensions = false;
-            break;
+        // Fragment (44), các header Tầng 4 (TCP/UDP/ICMPv6), No Next Header (59)
+        // hoặc protocol khác (ESP, AH): dừng vòng lặp
+        default:
+            return true;
         }
     }
-
-
-    // Cập nhật 'next_header' thành protocol Tầng 4 thực sự
-    ipv6.next_header = current_next_header;
-
-    return true;
 }
 
 void IPv6Parser::appendTreeView(std::string& tree, int depth, const IPv6Header& ipv6) {
@@ -119,4 +127,10 @@ void IPv6Parser::appendTreeView(std::string& tree, int depth, const IPv6Header&
     appendTree(tree, depth, "Hop Limit: " + to_string_8(ipv6.hop_limit));
     appendTree(tree, depth, "Source: " + ipv6ToString(ipv6.src_ip));
     appendTree(tree, depth, "Destination: " + ipv6ToString(ipv6.dest_ip));
+
+    if (ipv6.has_fragment) {
+        appendTree(tree, depth, "Fragment Header: Offset " + std::to_string(ipv6.frag_offset * 8) +
+                                    ", More: " + (ipv6.frag_more ? "Yes" : "No") +
+                                    ", Identification: " + std::to_string(ipv6.frag_id));
+    }
 }
@@ -11,13 +11,21 @@ public:
      * @brief (ĐÃ THAY ĐỔI) Phân tích header IPv6 VÀ tất cả các extension header.
      * @param ipv6 Struct IPv6Header để điền dữ liệu vào.
      * @param data (Tham chiếu) Con trỏ đến đầu header IPv6. Sẽ bị thay đổi
-     * để trỏ đến đầu header Tầng 4 (ví dụ: TCP/UDP).
+     * để trỏ đến đầu header Tầng 4 (ví dụ: TCP/UDP), hoặc (mảnh thật) ngay sau header Fragment.
      * @param len (Tham chiếu) Kích thước còn lại. Sẽ bị giảm đi
      * theo kích thước của header IPv6 + extension headers.
      * @return true nếu phân tích thành công.
      */
     static bool parse(IPv6Header& ipv6, const uint8_t*& data, size_t& len); // <-- ĐÃ THAY ĐỔI
 
+    /**
+     * @brief Bỏ qua các extension header Hop-by-Hop / Routing / Destination Options liên tiếp.
+     * Dừng tại header Fragment hoặc header Tầng 4. Dùng cả cho payload đã ghép từ các mảnh.
+     * @param nextHeader (Tham chiếu) Loại header đầu tiên; trả về loại header nơi dừng.
+     * @return false nếu một extension header bị cắt.
+     */
+    static bool skipExtensionHeaders(uint8_t& nextHeader, const uint8_t*& data, size_t& len);
+
     /**
      * @brief Thêm thông tin IPv6 vào cây chi tiết (tree view).
      */
@@ -2,11 +2,13 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <cstring>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
 #define TCPOPT_EOL 0
 #define TCPOPT_NOP 1
+#define TCPOPT_WINDOW 3
 #define TCPOPT_TIMESTAMP 8
 // -----------------------------------------
 
@@ -48,6 +50,7 @@ void TCPParser::parseTCPOptions(TCPHeader& tcp, const uint8_t* options_data, siz
 
     // (Reset cờ timestamp trước khi bắt đầu)
     tcp.has_timestamp = false;
+    tcp.window_scale = -1;
 
     while (remaining > 0)
     {
@@ -88,6 +91,11 @@ void TCPParser::parseTCPOptions(TCPHeader& tcp, const uint8_t* options_data, siz
             memcpy(&ts_ecr_net, ptr + 6, 4);
             tcp.ts_ecr = ntohl(ts_ecr_net); // Chuyển sang Host Order
         }
+        // --- KIỂM TRA WINDOW SCALE (Kind = 3, Length = 3; chỉ có trong SYN) ---
+        else if (kind == TCPOPT_WINDOW && len == 3)
+        {
+            tcp.window_scale = static_cast<int8_t>(std::min<uint8_t>(ptr[2], 14)); // RFC 7323: tối đa 14
+        }
 
         // Chuyển sang Option tiếp theo
         ptr += len;
@@ -170,6 +178,10 @@ void TCPParser::appendTreeView(std::string& tree, int depth, const TCPHeader& tc
     appendTree(tree, depth, "Urgent Pointer: " + std::to_string(tcp.urgent_pointer));
 
     // --- Hiển thị Timestamp trong Packet Details ---
+    if (tcp.window_scale >= 0) {
+        appendTree(tree, depth, "Options: (Window scale) " + std::to_string(tcp.window_scale) +
+                                " (multiply by " + std::to_string(1 << tcp.window_scale) + ")");
+    }
     if (tcp.has_timestamp) {
         appendTree(tree, depth, "Options: (Timestamps)");
         appendTree(tree, depth + 1, "Timestamp value: " + std::to_string(tcp.ts_val));
@@ -13,9 +13,15 @@ AnalyzeMenu::AnalyzeMenu(QWidget *parent)
     QAction *flowAct = menu->addAction("Packet Flow");
     QAction *statsAct = menu->addAction("Statistics");
 QAction *ioGraphAct = menu->addAction("I/O Graph");
+    QAction *convAct = menu->addAction("Conversations");
+    QAction *endpointsAct = menu->addAction("Endpoints");
+    QAction *hierarchyAct = menu->addAction("Protocol Hierarchy");
     setMenu(menu);
 
     connect(flowAct, &QAction::triggered, this, &AnalyzeMenu::analyzeFlowRequested);
     connect(statsAct, &QAction::triggered, this, &AnalyzeMenu::analyzeStatisticsRequested);
 connect(ioGraphAct, &QAction::triggered, this, &AnalyzeMenu::analyzeIOGraphRequested);
+    connect(convAct, &QAction::triggered, this, &AnalyzeMenu::analyzeConversationsRequested);
+    connect(endpointsAct, &QAction::triggered, this, &AnalyzeMenu::analyzeEndpointsRequested);
+    connect(hierarchyAct, &QAction::triggered, this, &AnalyzeMenu::analyzeProtocolHierarchyRequested);
 }
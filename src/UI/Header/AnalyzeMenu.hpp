@@ -13,4 +13,7 @@ signals:
     void analyzeFlowRequested();
     void analyzeStatisticsRequested();
     void analyzeIOGraphRequested(); // <-- THÊM MỚI
+    void analyzeConversationsRequested();
+    void analyzeEndpointsRequested();
+    void analyzeProtocolHierarchyRequested();
 };
@@ -11,7 +11,16 @@ CaptureMenu::CaptureMenu(QWidget *parent)
                         "QMenu::item:selected { background-color: #4A90E2; color: white; }");
 
     QAction *startAct = menu->addAction("Start");
+    QAction *replayAct = menu->addAction("Replay File...");
+    menu->addSeparator();
+    QAction *budgetAct = menu->addAction("Memory Budget...");
+    QAction *compressAct = menu->addAction("Compress Packet Bytes");
+    compressAct->setCheckable(true);
+    compressAct->setChecked(true); // Như mặc định của PacketStore
     setMenu(menu);
 
     connect(startAct, &QAction::triggered, this, &CaptureMenu::captureStartRequested);
+    connect(replayAct, &QAction::triggered, this, &CaptureMenu::replayFileRequested);
+    connect(budgetAct, &QAction::triggered, this, &CaptureMenu::memoryBudgetRequested);
+    connect(compressAct, &QAction::toggled, this, &CaptureMenu::compressionToggled);
 }
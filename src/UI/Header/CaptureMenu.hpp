@@ -11,4 +11,7 @@ public:
 
 signals:
     void captureStartRequested();
+    void replayFileRequested();   // Phát lại file pcap qua đường bắt trực tiếp
+    void memoryBudgetRequested(); // Giới hạn RAM cho danh sách gói (phần cũ đổ ra đĩa)
+    void compressionToggled(bool enabled); // Nén byte thô của các gói trong RAM
 };
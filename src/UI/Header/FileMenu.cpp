@@ -12,6 +12,7 @@ FileMenu::FileMenu(QWidget *parent)
                         "QMenu::item:selected { background-color: #4A90E2; color: white; }");
 
     QAction *openAct = menu->addAction("Open...");
+    QAction *openFolderAct = menu->addAction("Open Folder...");
     QAction *saveAsAct = menu->addAction("Save As...");
     menu->addSeparator();
     QAction *exitAct = menu->addAction("Exit");
@@ -19,6 +20,7 @@ FileMenu::FileMenu(QWidget *parent)
     setMenu(menu);
 
     connect(openAct, &QAction::triggered, this, &FileMenu::openFileRequested);
+    connect(openFolderAct, &QAction::triggered, this, &FileMenu::openFolderRequested);
     connect(saveAsAct, &QAction::triggered, this, &FileMenu::saveFileRequested);
     connect(exitAct, &QAction::triggered, this, &FileMenu::closeRequested);
 }
@@ -11,6 +11,7 @@ public:
 
 signals:
     void openFileRequested();
+    void openFolderRequested();
     void saveFileRequested();
     void closeRequested();
 };
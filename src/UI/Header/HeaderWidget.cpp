@@ -54,11 +54,15 @@ void HeaderWidget::setupMenuBar(QWidget *parent, QVBoxLayout *mainLayout)
 
     // --- File Menu Connections ---
     connect(fileMenu, &FileMenu::openFileRequested, this, &HeaderWidget::openFileRequested);
+    connect(fileMenu, &FileMenu::openFolderRequested, this, &HeaderWidget::openFolderRequested);
     connect(fileMenu, &FileMenu::saveFileRequested, this, &HeaderWidget::saveFileRequested);
     connect(fileMenu, &FileMenu::closeRequested, this, &HeaderWidget::closeRequested);
 
     // --- Capture Menu Connections ---
     connect(captureMenu, &CaptureMenu::captureStartRequested, this, &HeaderWidget::captureStartRequested);
+    connect(captureMenu, &CaptureMenu::replayFileRequested, this, &HeaderWidget::replayFileRequested);
+    connect(captureMenu, &CaptureMenu::memoryBudgetRequested, this, &HeaderWidget::memoryBudgetRequested);
+    connect(captureMenu, &CaptureMenu::compressionToggled, this, &HeaderWidget::compressionToggled);
 
     // --- Analyze Menu Connections ---
     connect(analyzeMenu, &AnalyzeMenu::analyzeFlowRequested, this, &HeaderWidget::analyzeFlowRequested);
@@ -66,6 +70,9 @@ void HeaderWidget::setupMenuBar(QWidget *parent, QVBoxLayout *mainLayout)
 
     // [QUAN TRỌNG] THÊM DÒNG NÀY ĐỂ KẾT NỐI I/O GRAPH
     connect(analyzeMenu, &AnalyzeMenu::analyzeIOGraphRequested, this, &HeaderWidget::analyzeIOGraphRequested);
+    connect(analyzeMenu, &AnalyzeMenu::analyzeConversationsRequested, this, &HeaderWidget::analyzeConversationsRequested);
+    connect(analyzeMenu, &AnalyzeMenu::analyzeEndpointsRequested, this, &HeaderWidget::analyzeEndpointsRequested);
+    connect(analyzeMenu, &AnalyzeMenu::analyzeProtocolHierarchyRequested, this, &HeaderWidget::analyzeProtocolHierarchyRequested);
 
     menuLayout->addWidget(fileMenu);
     menuLayout->addWidget(captureMenu);
@@ -12,11 +12,18 @@ signals:
     void closeRequested();
 
     void openFileRequested();
+    void openFolderRequested();
     void saveFileRequested();
     void captureStartRequested();
+    void replayFileRequested();
+    void memoryBudgetRequested();
+    void compressionToggled(bool enabled);
     void analyzeFlowRequested();
     void analyzeStatisticsRequested();
     void analyzeIOGraphRequested();
+    void analyzeConversationsRequested();
+    void analyzeEndpointsRequested();
+    void analyzeProtocolHierarchyRequested();
 
 private:
     void setupTitleBar(QWidget *parent, QVBoxLayout *mainLayout);
@@ -42,16 +42,32 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::saveFileRequested);
     connect(header, &HeaderWidget::openFileRequested,
             this, &MainWindow::openFileRequested);
+    connect(header, &HeaderWidget::openFolderRequested,
+            this, &MainWindow::openFolderRequested);
+    connect(header, &HeaderWidget::replayFileRequested,
+            this, &MainWindow::replayFileRequested);
+    connect(header, &HeaderWidget::memoryBudgetRequested,
+            this, &MainWindow::memoryBudgetRequested);
+    connect(header, &HeaderWidget::compressionToggled,
+            this, &MainWindow::compressionToggled);
     connect(header, &HeaderWidget::analyzeStatisticsRequested,
             this, &MainWindow::analyzeStatisticsRequested);
     connect(header, &HeaderWidget::analyzeIOGraphRequested,
              this, &MainWindow::analyzeIOGraphRequested);
+    connect(header, &HeaderWidget::analyzeConversationsRequested,
+            this, &MainWindow::analyzeConversationsRequested);
+    connect(header, &HeaderWidget::analyzeEndpointsRequested,
+            this, &MainWindow::analyzeEndpointsRequested);
+    connect(header, &HeaderWidget::analyzeProtocolHierarchyRequested,
+            this, &MainWindow::analyzeProtocolHierarchyRequested);
 
     // --- Forward signal từ WelcomePage sang Controller ---
-    connect(welcomePage, &WelcomePage::interfaceSelected,
-            this, &MainWindow::interfaceSelected);
+    connect(welcomePage, &WelcomePage::interfacesSelected,
+            this, &MainWindow::interfacesSelected);
     connect(welcomePage, &WelcomePage::openFileRequested,
             this, &MainWindow::openFileRequested);
+    connect(welcomePage, &WelcomePage::openFolderRequested,
+            this, &MainWindow::openFolderRequested);
 
     // --- Forward signal từ CapturePage sang Controller ---
     connect(capturePage, &CapturePage::onRestartCaptureClicked,
@@ -60,12 +76,20 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::onStopCaptureClicked);
     connect(capturePage, &CapturePage::onPauseCaptureClicked,
             this, &MainWindow::onPauseCaptureClicked);
+    connect(capturePage, &CapturePage::pauseModeChanged,
+            this, &MainWindow::pauseModeChanged);
     connect(capturePage, &CapturePage::onApplyFilterClicked,
             this, &MainWindow::onApplyFilterClicked);
     connect(capturePage, &CapturePage::onStatisticsClicked,
             this, &MainWindow::analyzeStatisticsRequested);
+    connect(capturePage, &CapturePage::goToPacketRequested,
+            this, &MainWindow::goToPacketRequested);
+    connect(capturePage, &CapturePage::goToTimeRequested,
+            this, &MainWindow::goToTimeRequested);
     connect(capturePage->packetTable, &PacketTable::filterRequested,
             this, &MainWindow::applyStreamFilter);
+    connect(capturePage->packetTable, &PacketTable::followTcpStreamRequested,
+            this, &MainWindow::followTcpStreamRequested);
 
     // Mặc định hiển thị WelcomePage
     showWelcomePage();
@@ -83,13 +107,13 @@ void MainWindow::showCapturePage() {
 // --- SLOTS CÔNG KHAI (do AppController gọi) ---
 
 
-void MainWindow::addPacketsToTable(QList<PacketData>* packets)
+void MainWindow::addPacketsToTable(QList<quint32>* packetIds)
 {
     if (capturePage) {
-        capturePage->packetTable->onPacketsReceived(packets);
+        capturePage->packetTable->onRowsReceived(packetIds);
     } else {
         // Nếu trang không hiển thị, phải xóa con trỏ để tránh rò rỉ
-        delete packets;
+        delete packetIds;
     }
 }
 
@@ -137,6 +161,27 @@ void MainWindow::updateInterfaceLabel(const QString &name, const QString &filter
         capturePage->setInterfaceName(name, filter);
     }
 }
+void MainWindow::setPacketLookup(PacketTable::PacketLookup lookup)
+{
+    if (capturePage) {
+        capturePage->packetTable->setPacketLookup(std::move(lookup));
+    }
+}
+
+void MainWindow::setPacketSorter(PacketTable::PacketSorter sorter)
+{
+    if (capturePage) {
+        capturePage->packetTable->setPacketSorter(std::move(sorter));
+    }
+}
+
+void MainWindow::selectPacket(quint32 packetId)
+{
+    if (capturePage) {
+        capturePage->packetTable->selectPacket(packetId);
+    }
+}
+
 void MainWindow::applyStreamFilter(const QString &filterText)
 {
     // 1. Cập nhật giao diện (Điền text vào ô tìm kiếm bên trong CapturePage)
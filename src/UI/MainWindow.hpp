@@ -4,9 +4,11 @@
 #include <QStackedWidget>
 #include <QVector>
 #include <QPair>
+#include <QStringList>
 #include "../Common/PacketData.hpp"
 #include <QMessageBox>
 #include "Header/AnalyzeMenu.hpp"
+#include "Widgets/PacketTable.hpp"
 
 class HeaderWidget;
 class WelcomePage;
@@ -22,14 +24,20 @@ public:
     void showCapturePage();
     void setDevices(const QVector<QPair<QString, QString>> &devices);
 void updateInterfaceLabel(const QString &name, const QString &filter);
+    // Nguồn gói gốc cho bảng (chi tiết / hex dump khi chọn dòng)
+    void setPacketLookup(PacketTable::PacketLookup lookup);
+    // Sắp xếp bảng gói theo cột (chạy trên luồng nền của AppController)
+    void setPacketSorter(PacketTable::PacketSorter sorter);
+    // Chọn và cuộn tới gói trong bảng (Go to Packet / Go to Time)
+    void selectPacket(quint32 packetId);
 public slots:
     // --- CÁC SLOT CÔNG KHAI (để AppController kết nối) ---
 
     /**
-     * @brief Slot nhận tín hiệu "lô" (batch) từ AppController
+     * @brief Slot nhận tín hiệu "lô" (batch) packet_id của các dòng mới từ AppController
      * và chuyển tiếp "lô" đó xuống PacketTable.
      */
-    void addPacketsToTable(QList<PacketData>* packets);
+    void addPacketsToTable(QList<quint32>* packetIds);
 
     /**
      * @brief Slot nhận tín hiệu từ AppController
@@ -55,17 +63,28 @@ signals:
     // (Đây là các tín hiệu được "forward" (chuyển tiếp) từ các Page con)
 
     // Signals từ WelcomePage
-    void interfaceSelected(const QString &interfaceName, const QString &filterText);
+    void interfacesSelected(const QStringList &interfaceNames, const QString &filterText);
     void openFileRequested();
+    void openFolderRequested();   // Thư mục file capture xoay vòng
+    void replayFileRequested();   // Phát lại file qua đường bắt trực tiếp (menu Capture)
+    void memoryBudgetRequested(); // Ngân sách RAM của danh sách gói (menu Capture)
+    void compressionToggled(bool enabled); // Nén byte thô của gói trong RAM (menu Capture)
 
     // Signals từ CapturePage
     void saveFileRequested();
     void onRestartCaptureClicked();
     void onStopCaptureClicked();
     void onPauseCaptureClicked();
+    void pauseModeChanged(int mode);
     void onApplyFilterClicked(const QString &filterText);
     void analyzeStatisticsRequested();
     void analyzeIOGraphRequested();
+    void analyzeConversationsRequested();
+    void analyzeEndpointsRequested();
+    void analyzeProtocolHierarchyRequested();
+    void followTcpStreamRequested(const PacketData &packet);
+    void goToPacketRequested();
+    void goToTimeRequested();
 private:
     HeaderWidget *header;
     QStackedWidget *stack;
@@ -2,6 +2,8 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QSpacerItem>
+#include <QMenu>
+#include <QAction>
 
 CapturePage::CapturePage(QWidget *parent)
     : QWidget(parent),
@@ -10,7 +12,9 @@ CapturePage::CapturePage(QWidget *parent)
     restartBtn(new QPushButton("Restart", this)),
     stopBtn(new QPushButton("Stop", this)),
     pauseBtn(new QPushButton("Pause", this)),
+    pauseModeCombo(new QComboBox(this)),
     statisticsBtn(new QPushButton("Statistics", this)),
+    goToBtn(new QPushButton("Go to", this)),
     isPaused(false),
     filterLineEdit(new QLineEdit(this)),
     applyFilterButton(new QPushButton("Apply", this)),
@@ -22,11 +26,24 @@ CapturePage::CapturePage(QWidget *parent)
     connect(restartBtn, &QPushButton::clicked, this, &CapturePage::onRestartCaptureClicked);
     connect(stopBtn, &QPushButton::clicked, this, &CapturePage::onStopCaptureClicked);
     connect(pauseBtn, &QPushButton::clicked, this, &CapturePage::onPauseCaptureClicked);
+    connect(pauseModeCombo, &QComboBox::currentIndexChanged, this, &CapturePage::pauseModeChanged);
     connect(applyFilterButton, &QPushButton::clicked, this, [=](){
         emit onApplyFilterClicked(filterLineEdit->text());
     });
     connect(statisticsBtn, &QPushButton::clicked, this, &CapturePage::onStatisticsClicked);
 
+    // Action gắn cả vào trang để phím tắt chạy khi menu đang đóng
+    QMenu *goToMenu = new QMenu(goToBtn);
+    QAction *goToPacketAct = goToMenu->addAction("Go to Packet...");
+    goToPacketAct->setShortcut(QKeySequence("Ctrl+G"));
+    QAction *goToTimeAct = goToMenu->addAction("Go to Time...");
+    goToTimeAct->setShortcut(QKeySequence("Ctrl+Shift+G"));
+    goToBtn->setMenu(goToMenu);
+    addAction(goToPacketAct);
+    addAction(goToTimeAct);
+    connect(goToPacketAct, &QAction::triggered, this, &CapturePage::goToPacketRequested);
+    connect(goToTimeAct, &QAction::triggered, this, &CapturePage::goToTimeRequested);
+
     // Cho phép nhấn Enter ở thanh Filter để Apply luôn
     connect(filterLineEdit, &QLineEdit::returnPressed, applyFilterButton, &QPushButton::click);
 }
@@ -44,7 +61,13 @@ void CapturePage::setupUI()
     controlLayout->addWidget(restartBtn);
     controlLayout->addWidget(stopBtn);
     controlLayout->addWidget(pauseBtn);
+
+    // Gói đến trong lúc tạm dừng: bỏ / chỉ đếm thống kê / ghi file tạm rồi phát lại khi tiếp tục
+    pauseModeCombo->addItems({"While paused: Discard", "While paused: Count only", "While paused: Spool to disk"});
+    pauseModeCombo->setToolTip("Packets keep being read while paused, so resuming never causes kernel drops");
+    controlLayout->addWidget(pauseModeCombo);
     controlLayout->addWidget(statisticsBtn);
+    controlLayout->addWidget(goToBtn);
     controlLayout->addStretch();
 
     // --- Thanh filter ---
@@ -4,6 +4,7 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QLineEdit>
+#include <QComboBox>
 #include "../Widgets/PacketTable.hpp"
 
 class CapturePage : public QWidget
@@ -23,12 +24,17 @@ signals:
     void onRestartCaptureClicked();
     void onStopCaptureClicked();
     void onPauseCaptureClicked();
+    // Chế độ tạm dừng: 0 = Discard, 1 = Count only, 2 = Spool (cùng thứ tự CaptureEngine::PauseMode)
+    void pauseModeChanged(int mode);
     void onApplyFilterClicked(const QString &filterText);
     /**
      * @brief Tín hiệu này được phát ra
      * khi người dùng nhấn nút "Statistics".
      */
     void onStatisticsClicked();
+    // "Go to Packet..." (Ctrl+G) / "Go to Time..." (Ctrl+Shift+G)
+    void goToPacketRequested();
+    void goToTimeRequested();
 
 private:
     void setupUI();
@@ -41,7 +47,9 @@ private:
     QPushButton *restartBtn;
     QPushButton *stopBtn;
     QPushButton *pauseBtn;
+    QComboBox *pauseModeCombo;
     QPushButton *statisticsBtn;
+    QPushButton *goToBtn;
     bool isPaused;
 
     // --- Thanh Filter ---
@@ -8,6 +8,7 @@
 #include <QGraphicsDropShadowEffect>
 #include <QFont>
 #include <QPair>
+#include <QStringList>
 
 WelcomePage::WelcomePage(QWidget *parent)
     : QWidget(parent),
@@ -77,10 +78,22 @@ void WelcomePage::setupUI()
     captureSectionLayout->addLayout(filterLayout);
     pageLayout->addLayout(captureSectionLayout);
 
-    // --- Interface List ---
+    // --- Interface List (Ctrl/Shift để chọn nhiều interface) ---
     deviceList = new QListWidget(this);
+    deviceList->setSelectionMode(QAbstractItemView::ExtendedSelection);
     pageLayout->addWidget(deviceList);
 
+    // --- Nút bắt trên các interface đã chọn ---
+    auto *captureSelectedBtn = new QPushButton("Capture Selected Interfaces", this);
+    captureSelectedBtn->setMinimumHeight(40);
+    captureSelectedBtn->setCursor(Qt::PointingHandCursor);
+    captureSelectedBtn->setStyleSheet(R"(
+        QPushButton { font-size: 14px; font-weight: bold; color: white; padding: 10px; margin-top: 10px; background-color: #4A90E2; border: 1px solid #357ABD; border-radius: 5px; }
+        QPushButton:hover { background-color: #357ABD; }
+    )");
+    pageLayout->addWidget(captureSelectedBtn);
+    pageLayout->setAlignment(captureSelectedBtn, Qt::AlignCenter);
+
     // --- Nút "Mở File Pcap" ---
     auto *openFileBtn = new QPushButton("Mở File Pcap...", this);
     openFileBtn->setMinimumHeight(40);
@@ -89,20 +102,55 @@ void WelcomePage::setupUI()
         QPushButton { font-size: 14px; font-weight: bold; color: #34495e; padding: 10px; margin-top: 15px; background-color: #ecf0f1; border: 1px solid #bdc3c7; border-radius: 5px; }
         QPushButton:hover { background-color: #dbe0e2; border-color: #a1a6a9; }
     )");
-    pageLayout->addWidget(openFileBtn);
-    pageLayout->setAlignment(openFileBtn, Qt::AlignCenter);
+    // --- Nút "Mở Thư Mục Pcap" (nhiều file xoay vòng, gộp theo thời gian) ---
+    auto *openFolderBtn = new QPushButton("Mở Thư Mục Pcap...", this);
+    openFolderBtn->setMinimumHeight(40);
+    openFolderBtn->setCursor(Qt::PointingHandCursor);
+    openFolderBtn->setStyleSheet(openFileBtn->styleSheet());
+
+    auto *openLayout = new QHBoxLayout();
+    openLayout->addWidget(openFileBtn);
+    openLayout->addWidget(openFolderBtn);
+    pageLayout->addLayout(openLayout);
+    pageLayout->setAlignment(openLayout, Qt::AlignCenter);
 
     mainLayout->addWidget(pageContent);
 
     // --- KẾT NỐI TÍN HIỆU ---
     connect(deviceList, &QListWidget::itemDoubleClicked, this, [this](QListWidgetItem *item) {
-        QString interfaceName = item->data(Qt::UserRole).toString();
-        if (!interfaceName.isEmpty()) {
+        // Double-click trong vùng đang chọn nhiều: bắt tất cả; ngược lại chỉ interface này
+        QStringList interfaceNames = selectedInterfaces();
+        const QString clickedName = item->data(Qt::UserRole).toString();
+        if (!interfaceNames.contains(clickedName)) {
+            interfaceNames = QStringList{ clickedName };
+        }
+        if (!clickedName.isEmpty()) {
             QString filterText = filterEdit->text();// Lấy text từ ô filter
-            emit interfaceSelected(interfaceName, filterText);// Gửi cả 2 thông tin đi
+            emit interfacesSelected(interfaceNames, filterText);// Gửi cả 2 thông tin đi
+        }
+    });
+    connect(captureSelectedBtn, &QPushButton::clicked, this, [this]() {
+        const QStringList interfaceNames = selectedInterfaces();
+        if (!interfaceNames.isEmpty()) {
+            emit interfacesSelected(interfaceNames, filterEdit->text());
         }
     });
     connect(openFileBtn, &QPushButton::clicked, this, &WelcomePage::openFileRequested);
+    connect(openFolderBtn, &QPushButton::clicked, this, &WelcomePage::openFolderRequested);
+}
+
+QStringList WelcomePage::selectedInterfaces() const
+{
+    // selectedItems() theo thứ tự click: duyệt theo hàng để interface id ổn định
+    QStringList names;
+    for (int row = 0; row < deviceList->count(); ++row) {
+        QListWidgetItem *item = deviceList->item(row);
+        const QString name = item->data(Qt::UserRole).toString();
+        if (item->isSelected() && !name.isEmpty()) {
+            names.append(name);
+        }
+    }
+    return names;
 }
 
 void WelcomePage::setDevices(const QVector<QPair<QString, QString>> &devices)
@@ -1,6 +1,7 @@
 #pragma once
 #include <QWidget>
 #include <QListWidget>
+#include <QStringList>
 
 class QLineEdit;
 
@@ -13,11 +14,14 @@ public:
     void setDevices(const QVector<QPair<QString, QString>> &devices);
 
 signals:
-    void interfaceSelected(const QString &interfaceName, const QString &filterText);
+    // Một hoặc nhiều interface (bắt đồng thời, gộp theo timestamp); thứ tự = interface id
+    void interfacesSelected(const QStringList &interfaceNames, const QString &filterText);
     void openFileRequested();
+    void openFolderRequested();
 
 private:
     QLineEdit *filterEdit;
     QListWidget *deviceList;
     void setupUI();
+    QStringList selectedInterfaces() const;   // Theo thứ tự trong danh sách
 };
@@ -0,0 +1,559 @@
+#include "ConversationTableModel.hpp"
+#include <QColor>
+#include <QMutexLocker>
+#include <algorithm>
+#include <utility>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+enum ConversationColumn {
+    CONV_STREAM, CONV_PROTO, CONV_ADDR_A, CONV_PORT_A, CONV_ADDR_B, CONV_PORT_B,
+    CONV_PACKETS, CONV_BYTES, CONV_PACKETS_AB, CONV_BYTES_AB, CONV_PACKETS_BA, CONV_BYTES_BA,
+    CONV_REL_START, CONV_DURATION, CONV_BPS_AB, CONV_BPS_BA, CONV_STATE,
+    CONV_IRTT, CONV_RTT_SAMPLES, CONV_RTT_MIN, CONV_RTT_P50, CONV_RTT_P90, CONV_RTT_P99, CONV_RTT_MAX,
+    CONV_TS_P50, CONV_TS_P99,
+    CONV_COUNT
+};
+
+enum PairColumn {
+    PAIR_ADDR_A, PAIR_ADDR_B, PAIR_FLOWS, PAIR_PACKETS, PAIR_BYTES,
+    PAIR_PACKETS_AB, PAIR_BYTES_AB, PAIR_PACKETS_BA, PAIR_BYTES_BA,
+    PAIR_REL_START, PAIR_DURATION, PAIR_BPS_AB, PAIR_BPS_BA,
+    PAIR_COUNT
+};
+
+enum EndpointColumn {
+    EP_ADDR, EP_FLOWS, EP_PACKETS, EP_BYTES,
+    EP_TX_PACKETS, EP_TX_BYTES, EP_RX_PACKETS, EP_RX_BYTES,
+    EP_REL_START, EP_DURATION, EP_TX_BPS, EP_RX_BPS,
+    EP_COUNT
+};
+
+static const char* const CONV_HEADERS[CONV_COUNT] = {
+    "Stream", "Protocol", "Address A", "Port A", "Address B", "Port B",
+    "Packets", "Bytes", "Packets A→B", "Bytes A→B", "Packets B→A", "Bytes B→A",
+    "Rel Start (s)", "Duration (s)", "Bits/s A→B", "Bits/s B→A", "State",
+    "iRTT (ms)", "RTT Samples", "RTT Min (ms)", "RTT p50 (ms)", "RTT p90 (ms)", "RTT p99 (ms)", "RTT Max (ms)",
+    "TS RTT p50 (ms)", "TS RTT p99 (ms)"
+};
+
+static const char* const PAIR_HEADERS[PAIR_COUNT] = {
+    "Address A", "Address B", "Flows", "Packets", "Bytes",
+    "Packets A→B", "Bytes A→B", "Packets B→A", "Bytes B→A",
+    "Rel Start (s)", "Duration (s)", "Bits/s A→B", "Bits/s B→A"
+};
+
+static const char* const EP_HEADERS[EP_COUNT] = {
+    "Address", "Flows", "Packets", "Bytes",
+    "Tx Packets", "Tx Bytes", "Rx Packets", "Rx Bytes",
+    "Rel Start (s)", "Duration (s)", "Tx Bits/s", "Rx Bits/s"
+};
+
+// Giá trị "không có" (ô trống, đứng đầu khi sắp xếp tăng dần)
+static const double NO_VALUE = -1.0;
+
+static double seconds(int64_t ns) { return ns / 1e9; }
+
+// Bits/s trên thời lượng của dòng (không tính được khi chỉ có một thời điểm)
+static double bitsPerSecond(quint64 bytes, int64_t first, int64_t last)
+{
+    if (last <= first) return NO_VALUE;
+    return bytes * 8.0 / seconds(last - first);
+}
+
+static double rttMs(int32_t us) { return us < 0 ? NO_VALUE : us / 1000.0; }
+
+static QString tcpStateName(quint8 state)
+{
+    switch (state) {
+    case 1: return "SYN_SENT";
+    case 2: return "SYN_RCVD";
+    case 3: return "ESTABLISHED";
+    case 4: return "FIN_WAIT";
+    case 5: return "CLOSED";
+    default: return "";
+    }
+}
+
+// Cột số lẻ (thời gian, bits/s, RTT): số chữ số thập phân; -1 = cột số nguyên
+static int decimalsFor(ConversationTableModel::Kind kind, int column)
+{
+    switch (kind) {
+    case ConversationTableModel::CONVERSATIONS:
+        if (column == CONV_REL_START || column == CONV_DURATION) return 6;
+        if (column == CONV_BPS_AB || column == CONV_BPS_BA) return 0;
+        if (column >= CONV_IRTT && column != CONV_RTT_SAMPLES) return 3;
+        return -1;
+    case ConversationTableModel::ADDRESS_PAIRS:
+        if (column == PAIR_REL_START || column == PAIR_DURATION) return 6;
+        if (column == PAIR_BPS_AB || column == PAIR_BPS_BA) return 0;
+        return -1;
+    case ConversationTableModel::ENDPOINTS:
+        if (column == EP_REL_START || column == EP_DURATION) return 6;
+        if (column == EP_TX_BPS || column == EP_RX_BPS) return 0;
+        return -1;
+    }
+    return -1;
+}
+
+// Chép các dòng có revision mới hơn lần trước vào bản chép; dòng cũ vừa đổi ghi vào changed
+template <typename Record>
+static void copyChangedRows(const std::vector<Record>& rows, const std::vector<quint64>& revisions,
+                            quint64 seenRevision, std::vector<Record>& snapshot, std::vector<uint32_t>& changed)
+{
+    const size_t known = snapshot.size();
+    snapshot.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (revisions[i] <= seenRevision) continue;
+        snapshot[i] = rows[i];
+        if (i < known) changed.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+// --- Triển khai (Implementation) ---
+
+ConversationTableModel::ConversationTableModel(const ConversationTable* table, Kind kind,
+                                               QRecursiveMutex* lock, QObject *parent)
+    : QAbstractTableModel(parent),
+    m_table(table),
+    m_lock(lock),
+    m_kind(kind)
+{
+    // Bản chép bắt đầu rỗng: lần refresh() đầu tiên (không đổi resetCount) chép mọi dòng
+    QMutexLocker locker(m_lock);
+    m_seenReset = m_table->resetCount();
+}
+
+int ConversationTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_order.size());
+}
+
+int ConversationTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+    switch (m_kind) {
+    case CONVERSATIONS: return CONV_COUNT;
+    case ADDRESS_PAIRS: return PAIR_COUNT;
+    case ENDPOINTS: return EP_COUNT;
+    }
+    return 0;
+}
+
+QVariant ConversationTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0) return QVariant();
+    switch (m_kind) {
+    case CONVERSATIONS: return section < CONV_COUNT ? QString(CONV_HEADERS[section]) : QVariant();
+    case ADDRESS_PAIRS: return section < PAIR_COUNT ? QString(PAIR_HEADERS[section]) : QVariant();
+    case ENDPOINTS: return section < EP_COUNT ? QString(EP_HEADERS[section]) : QVariant();
+    }
+    return QVariant();
+}
+
+QVariant ConversationTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(m_order.size())) return QVariant();
+    const uint32_t source = m_order[index.row()];
+
+    if (role == Qt::DisplayRole) {
+        return displayValue(source, index.column());
+    }
+    if (role == Qt::TextAlignmentRole) {
+        if (isAddressColumn(index.column())) return QVariant();
+        if (m_kind == CONVERSATIONS && (index.column() == CONV_PROTO || index.column() == CONV_STATE)) return QVariant();
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role == Qt::ForegroundRole && m_kind == CONVERSATIONS && !m_conversations[source].active) {
+        return QColor(Qt::gray); // Luồng đã bị loại khỏi bộ nhớ (hết hạn / LRU)
+    }
+    return QVariant();
+}
+
+bool ConversationTableModel::isAddressColumn(int column) const
+{
+    switch (m_kind) {
+    case CONVERSATIONS: return column == CONV_ADDR_A || column == CONV_ADDR_B;
+    case ADDRESS_PAIRS: return column == PAIR_ADDR_A || column == PAIR_ADDR_B;
+    case ENDPOINTS: return column == EP_ADDR;
+    }
+    return false;
+}
+
+size_t ConversationTableModel::sourceCount() const
+{
+    switch (m_kind) {
+    case CONVERSATIONS: return m_conversations.size();
+    case ADDRESS_PAIRS: return m_pairs.size();
+    case ENDPOINTS: return m_endpoints.size();
+    }
+    return 0;
+}
+
+double ConversationTableModel::sortKey(uint32_t source, int column) const
+{
+    const int64_t start = m_startNs;
+
+    if (m_kind == CONVERSATIONS) {
+        const ConversationRecord& c = m_conversations[source];
+        switch (column) {
+        case CONV_STREAM: return static_cast<double>(c.stream_index);
+        case CONV_PROTO: return c.protocol;
+        case CONV_PORT_A: return c.port_a;
+        case CONV_PORT_B: return c.port_b;
+        case CONV_PACKETS: return static_cast<double>(c.packets_ab + c.packets_ba);
+        case CONV_BYTES: return static_cast<double>(c.bytes_ab + c.bytes_ba);
+        case CONV_PACKETS_AB: return static_cast<double>(c.packets_ab);
+        case CONV_BYTES_AB: return static_cast<double>(c.bytes_ab);
+        case CONV_PACKETS_BA: return static_cast<double>(c.packets_ba);
+        case CONV_BYTES_BA: return static_cast<double>(c.bytes_ba);
+        case CONV_REL_START: return seconds(c.first_ns - start);
+        case CONV_DURATION: return seconds(c.last_ns - c.first_ns);
+        case CONV_BPS_AB: return bitsPerSecond(c.bytes_ab, c.first_ns, c.last_ns);
+        case CONV_BPS_BA: return bitsPerSecond(c.bytes_ba, c.first_ns, c.last_ns);
+        case CONV_STATE: return c.active ? c.tcp_state : 100 + c.tcp_state;
+        case CONV_IRTT: return rttMs(c.irtt_us);
+        case CONV_RTT_SAMPLES: return c.rtt_samples;
+        case CONV_RTT_MIN: return rttMs(c.rtt_min_us);
+        case CONV_RTT_P50: return rttMs(c.rtt_p50_us);
+        case CONV_RTT_P90: return rttMs(c.rtt_p90_us);
+        case CONV_RTT_P99: return rttMs(c.rtt_p99_us);
+        case CONV_RTT_MAX: return rttMs(c.rtt_max_us);
+        case CONV_TS_P50: return rttMs(c.ts_p50_us);
+        case CONV_TS_P99: return rttMs(c.ts_p99_us);
+        }
+    } else if (m_kind == ADDRESS_PAIRS) {
+        const AddressPairRecord& p = m_pairs[source];
+        switch (column) {
+        case PAIR_FLOWS: return p.flows;
+        case PAIR_PACKETS: return static_cast<double>(p.packets_ab + p.packets_ba);
+        case PAIR_BYTES: return static_cast<double>(p.bytes_ab + p.bytes_ba);
+        case PAIR_PACKETS_AB: return static_cast<double>(p.packets_ab);
+        case PAIR_BYTES_AB: return static_cast<double>(p.bytes_ab);
+        case PAIR_PACKETS_BA: return static_cast<double>(p.packets_ba);
+        case PAIR_BYTES_BA: return static_cast<double>(p.bytes_ba);
+        case PAIR_REL_START: return seconds(p.first_ns - start);
+        case PAIR_DURATION: return seconds(p.last_ns - p.first_ns);
+        case PAIR_BPS_AB: return bitsPerSecond(p.bytes_ab, p.first_ns, p.last_ns);
+        case PAIR_BPS_BA: return bitsPerSecond(p.bytes_ba, p.first_ns, p.last_ns);
+        }
+    } else {
+        const EndpointRecord& e = m_endpoints[source];
+        switch (column) {
+        case EP_FLOWS: return e.flows;
+        case EP_PACKETS: return static_cast<double>(e.tx_packets + e.rx_packets);
+        case EP_BYTES: return static_cast<double>(e.tx_bytes + e.rx_bytes);
+        case EP_TX_PACKETS: return static_cast<double>(e.tx_packets);
+        case EP_TX_BYTES: return static_cast<double>(e.tx_bytes);
+        case EP_RX_PACKETS: return static_cast<double>(e.rx_packets);
+        case EP_RX_BYTES: return static_cast<double>(e.rx_bytes);
+        case EP_REL_START: return seconds(e.first_ns - start);
+        case EP_DURATION: return seconds(e.last_ns - e.first_ns);
+        case EP_TX_BPS: return bitsPerSecond(e.tx_bytes, e.first_ns, e.last_ns);
+        case EP_RX_BPS: return bitsPerSecond(e.rx_bytes, e.first_ns, e.last_ns);
+        }
+    }
+    return 0.0;
+}
+
+QVariant ConversationTableModel::displayValue(uint32_t source, int column) const
+{
+    // Cột chuỗi
+    if (m_kind == CONVERSATIONS) {
+        const ConversationRecord& c = m_conversations[source];
+        switch (column) {
+        case CONV_PROTO: return QString(c.protocol == 6 ? "TCP" : "UDP");
+        case CONV_ADDR_A: return streamAddressToString(c.addr_a, c.is_ipv6);
+        case CONV_ADDR_B: return streamAddressToString(c.addr_b, c.is_ipv6);
+        case CONV_STATE: {
+            QString state = tcpStateName(c.tcp_state);
+            if (!c.active) state = state.isEmpty() ? "Expired" : state + " (expired)";
+            return state;
+        }
+        case CONV_RTT_SAMPLES:
+            if (c.protocol != 6) return QVariant();
+            break;
+        }
+    } else if (m_kind == ADDRESS_PAIRS) {
+        const AddressPairRecord& p = m_pairs[source];
+        if (column == PAIR_ADDR_A) return streamAddressToString(p.addr_a, p.is_ipv6);
+        if (column == PAIR_ADDR_B) return streamAddressToString(p.addr_b, p.is_ipv6);
+    } else if (column == EP_ADDR) {
+        const EndpointRecord& e = m_endpoints[source];
+        return streamAddressToString(e.addr, e.is_ipv6);
+    }
+
+    // Cột số
+    const double value = sortKey(source, column);
+    const int decimals = decimalsFor(m_kind, column);
+    if (decimals < 0) return static_cast<qlonglong>(value);
+    if (value < 0) return QVariant(); // Chưa đo được / không tính được
+    return QString::number(value, 'f', decimals);
+}
+
+// --- Thứ tự hiển thị ---
+
+bool ConversationTableModel::acceptRow(uint32_t source) const
+{
+    if (m_kind == CONVERSATIONS && m_tcpOnly) {
+        return m_conversations[source].protocol == 6;
+    }
+    return true;
+}
+
+void ConversationTableModel::rebuildOrder()
+{
+    const size_t count = sourceCount();
+    m_order.clear();
+    m_order.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (acceptRow(i)) m_order.push_back(i);
+    }
+    m_seenSource = count;
+    sortOrder();
+    rebuildRowOf();
+}
+
+void ConversationTableModel::rebuildRowOf()
+{
+    m_rowOf.assign(sourceCount(), -1);
+    for (size_t i = 0; i < m_order.size(); ++i) m_rowOf[m_order[i]] = static_cast<int>(i);
+}
+
+bool ConversationTableModel::rowLess(uint32_t left, uint32_t right) const
+{
+    const bool ascending = (m_sortOrderValue == Qt::AscendingOrder);
+
+    if (isAddressColumn(m_sortColumn)) {
+        // Địa chỉ: so sánh byte (IPv4 trước IPv6), phụ bằng chỉ số dòng để thứ tự ổn định
+        auto addressOf = [this](uint32_t source) -> std::pair<bool, const std::array<uint8_t, 16>*> {
+            if (m_kind == CONVERSATIONS) {
+                const ConversationRecord& c = m_conversations[source];
+                return { c.is_ipv6, m_sortColumn == CONV_ADDR_A ? &c.addr_a : &c.addr_b };
+            }
+            if (m_kind == ADDRESS_PAIRS) {
+                const AddressPairRecord& p = m_pairs[source];
+                return { p.is_ipv6, m_sortColumn == PAIR_ADDR_A ? &p.addr_a : &p.addr_b };
+            }
+            const EndpointRecord& e = m_endpoints[source];
+            return { e.is_ipv6, &e.addr };
+        };
+        auto a = addressOf(left);
+        auto b = addressOf(right);
+        if (a.first != b.first) return ascending ? !a.first : a.first;
+        if (*a.second != *b.second) return ascending ? *a.second < *b.second : *a.second > *b.second;
+        return left < right;
+    }
+
+    const double a = sortKey(left, m_sortColumn);
+    const double b = sortKey(right, m_sortColumn);
+    if (a != b) return ascending ? a < b : a > b;
+    return left < right;
+}
+
+void ConversationTableModel::sortOrder()
+{
+    if (m_sortColumn < 0) return;
+    const bool ascending = (m_sortOrderValue == Qt::AscendingOrder);
+
+    if (isAddressColumn(m_sortColumn)) {
+        std::sort(m_order.begin(), m_order.end(),
+                  [this](uint32_t l, uint32_t r) { return rowLess(l, r); });
+        return;
+    }
+
+    // Cột số: tính khóa một lần cho mỗi dòng rồi sắp xếp cặp (khóa, chỉ số) (cùng thứ tự với rowLess)
+    std::vector<std::pair<double, uint32_t>> keys;
+    keys.reserve(m_order.size());
+    for (uint32_t source : m_order) keys.emplace_back(sortKey(source, m_sortColumn), source);
+    if (ascending) {
+        std::sort(keys.begin(), keys.end());
+    } else {
+        std::sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+    }
+    for (size_t i = 0; i < keys.size(); ++i) m_order[i] = keys[i].second;
+}
+
+bool ConversationTableModel::outOfPlace(uint32_t source) const
+{
+    // Mảng đã sắp xếp khi mọi cặp kề nhau đúng thứ tự: chỉ cần xét hai hàng xóm của dòng vừa đổi
+    const int row = m_rowOf[source];
+    if (row > 0 && rowLess(source, m_order[row - 1])) return true;
+    if (row + 1 < static_cast<int>(m_order.size()) && rowLess(m_order[row + 1], source)) return true;
+    return false;
+}
+
+void ConversationTableModel::relayout(const std::function<void()>& change)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList persistent = persistentIndexList();
+    std::vector<uint32_t> persistentSources;
+    persistentSources.reserve(persistent.size());
+    for (const QModelIndex& idx : persistent) persistentSources.push_back(m_order[idx.row()]);
+
+    change();
+    rebuildRowOf();
+
+    // Giữ vùng chọn: ánh xạ lại theo dòng nguồn
+    if (!persistent.isEmpty()) {
+        QModelIndexList updated;
+        updated.reserve(persistent.size());
+        for (int i = 0; i < persistent.size(); ++i) {
+            const int row = m_rowOf[persistentSources[i]];
+            updated.append(row < 0 ? QModelIndex() : index(row, persistent[i].column()));
+        }
+        changePersistentIndexList(persistent, updated);
+    }
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void ConversationTableModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrderValue = order;
+    relayout([this] { sortOrder(); });
+}
+
+void ConversationTableModel::reorder(const std::vector<uint32_t>& moved)
+{
+    relayout([&] {
+        // Gỡ các dòng nằm sai chỗ, sắp riêng chúng rồi trộn vào phần còn lại (vẫn đang đúng thứ tự)
+        std::vector<char> isMoved(sourceCount(), 0);
+        for (uint32_t source : moved) isMoved[source] = 1;
+        m_order.erase(std::remove_if(m_order.begin(), m_order.end(),
+                                     [&](uint32_t source) { return isMoved[source] != 0; }),
+                      m_order.end());
+        const size_t kept = m_order.size();
+
+        auto less = [this](uint32_t l, uint32_t r) { return rowLess(l, r); };
+        m_order.insert(m_order.end(), moved.begin(), moved.end());
+        std::sort(m_order.begin() + kept, m_order.end(), less);
+        std::inplace_merge(m_order.begin(), m_order.begin() + kept, m_order.end(), less);
+    });
+}
+
+void ConversationTableModel::setTcpOnly(bool tcpOnly)
+{
+    if (m_tcpOnly == tcpOnly) return;
+    m_tcpOnly = tcpOnly;
+    beginResetModel();
+    rebuildOrder();
+    endResetModel();
+}
+
+void ConversationTableModel::refresh()
+{
+    // 1. Giữ khóa chỉ trong lúc chép các dòng mới / đã đổi vào bản chép
+    std::vector<uint32_t> changed;
+    bool startChanged = false;
+    {
+        QMutexLocker locker(m_lock);
+        const bool reset = (m_table->resetCount() != m_seenReset);
+        if (!reset && m_table->revision() == m_seenRevision) return;
+
+        if (reset) {
+            // Bảng đã bị xóa (bắt gói mới / mở file mới): chép lại toàn bộ
+            beginResetModel();
+            m_seenReset = m_table->resetCount();
+            m_seenRevision = 0;
+            m_conversations.clear();
+            m_pairs.clear();
+            m_endpoints.clear();
+        }
+        switch (m_kind) {
+        case CONVERSATIONS:
+            copyChangedRows(m_table->conversations(), m_table->conversationRevisions(), m_seenRevision,
+                            m_conversations, changed);
+            break;
+        case ADDRESS_PAIRS:
+            copyChangedRows(m_table->addressPairs(), m_table->addressPairRevisions(), m_seenRevision,
+                            m_pairs, changed);
+            break;
+        case ENDPOINTS:
+            copyChangedRows(m_table->endpoints(), m_table->endpointRevisions(), m_seenRevision,
+                            m_endpoints, changed);
+            break;
+        }
+        m_seenRevision = m_table->revision();
+        startChanged = (m_startNs != m_table->startNs());
+        m_startNs = m_table->startNs();
+
+        if (reset) {
+            locker.unlock();
+            rebuildOrder();
+            endResetModel();
+            return;
+        }
+    }
+
+    // 2. Đang sắp xếp: dòng cũ vừa đổi mà nằm sai chỗ (xét trước khi thêm dòng mới vào cuối)
+    std::vector<uint32_t> moved;
+    if (m_sortColumn >= 0) {
+        for (uint32_t source : changed) {
+            if (m_rowOf[source] >= 0 && outOfPlace(source)) moved.push_back(source);
+        }
+    }
+
+    // 3. Dòng mới: thêm vào cuối (đang sắp xếp thì trộn vào đúng chỗ ở bước 4)
+    const size_t count = sourceCount();
+    std::vector<uint32_t> added;
+    for (size_t i = m_seenSource; i < count; ++i) {
+        if (acceptRow(static_cast<uint32_t>(i))) added.push_back(static_cast<uint32_t>(i));
+    }
+    m_seenSource = count;
+    m_rowOf.resize(count, -1);
+    if (!added.empty()) {
+        const int first = static_cast<int>(m_order.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+        m_order.insert(m_order.end(), added.begin(), added.end());
+        for (size_t i = 0; i < added.size(); ++i) m_rowOf[added[i]] = first + static_cast<int>(i);
+        endInsertRows();
+    }
+
+    // 4. Chỉ dời các dòng sai chỗ; không dòng nào đổi vị trí thì không sắp xếp lại
+    if (m_sortColumn >= 0 && (!moved.empty() || !added.empty())) {
+        moved.insert(moved.end(), added.begin(), added.end());
+        reorder(moved);
+    }
+
+    // 5. Vẽ lại các dòng đã đổi (đổi mốc thời gian đầu thì mọi cột Rel Start đều đổi)
+    if (m_order.empty()) return;
+    int firstRow = static_cast<int>(m_order.size());
+    int lastRow = -1;
+    if (startChanged) {
+        firstRow = 0;
+        lastRow = static_cast<int>(m_order.size()) - 1;
+    } else {
+        for (uint32_t source : changed) {
+            const int row = m_rowOf[source];
+            if (row < 0) continue;
+            firstRow = std::min(firstRow, row);
+            lastRow = std::max(lastRow, row);
+        }
+    }
+    if (lastRow >= firstRow) {
+        emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1), {Qt::DisplayRole});
+    }
+}
+
+QString ConversationTableModel::filterForRow(int row) const
+{
+    if (row < 0 || row >= static_cast<int>(m_order.size())) return QString();
+    const uint32_t source = m_order[row];
+
+    if (m_kind == CONVERSATIONS) {
+        return QString("stream == %1").arg(m_conversations[source].stream_index);
+    }
+    if (m_kind == ADDRESS_PAIRS) {
+        const AddressPairRecord& p = m_pairs[source];
+        const QString key = p.is_ipv6 ? "ipv6.addr" : "ip.addr";
+        return QString("%1 == %2 && %1 == %3").arg(key,
+                                                   streamAddressToString(p.addr_a, p.is_ipv6),
+                                                   streamAddressToString(p.addr_b, p.is_ipv6));
+    }
+    const EndpointRecord& e = m_endpoints[source];
+    const QString key = e.is_ipv6 ? "ipv6.addr" : "ip.addr";
+    return QString("%1 == %2").arg(key, streamAddressToString(e.addr, e.is_ipv6));
+}
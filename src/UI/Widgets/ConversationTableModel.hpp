@@ -0,0 +1,83 @@
+#ifndef CONVERSATIONTABLEMODEL_HPP
+#define CONVERSATIONTABLEMODEL_HPP
+
+#include <QAbstractTableModel>
+#include <QRecursiveMutex>
+#include <functional>
+#include <vector>
+#include "../../Controller/ControllerLib/ConversationTable.hpp"
+
+/**
+ * @brief Model ảo (virtualized) trên ConversationTable cho QTableView.
+ *
+ * Không tạo item cho từng ô: view chỉ hỏi các dòng đang hiển thị. Model giữ bản chép các bản ghi
+ * của loại bảng mình hiển thị; refresh() chỉ giữ khóa của bảng trong lúc chép các dòng đã đổi
+ * (theo revision từng dòng), còn data() và sắp xếp đọc bản chép nên không khóa luồng xử lý.
+ * Thứ tự hiển thị là một mảng chỉ số (m_order). sort() sắp lại toàn bộ bằng khóa số tính trước;
+ * refresh() chỉ dời các dòng đã đổi mà nằm sai chỗ so với hàng xóm (gỡ ra rồi trộn lại).
+ */
+class ConversationTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Kind {
+        CONVERSATIONS,   // Theo 5-tuple (TCP/UDP)
+        ADDRESS_PAIRS,   // Theo cặp IP
+        ENDPOINTS        // Theo địa chỉ IP
+    };
+
+    // lock: khóa của bên ghi bảng (luồng xử lý); nullptr nếu bảng chỉ được dùng trên luồng GUI
+    ConversationTableModel(const ConversationTable* table, Kind kind, QRecursiveMutex* lock = nullptr,
+                           QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Đồng bộ với ConversationTable (gọi định kỳ từ timer của dialog)
+    void refresh();
+
+    // Chỉ hiện luồng TCP (chỉ áp dụng cho CONVERSATIONS)
+    void setTcpOnly(bool tcpOnly);
+
+    // Chuỗi display filter tương ứng với một dòng ("stream == 3", "ip.addr == ...")
+    QString filterForRow(int row) const;
+
+private:
+    bool acceptRow(uint32_t source) const;
+    void rebuildOrder();
+    void sortOrder();
+    void rebuildRowOf();
+    bool rowLess(uint32_t left, uint32_t right) const;
+    bool outOfPlace(uint32_t source) const;
+    void reorder(const std::vector<uint32_t>& moved);
+    void relayout(const std::function<void()>& change);
+    double sortKey(uint32_t source, int column) const;
+    bool isAddressColumn(int column) const;
+    QVariant displayValue(uint32_t source, int column) const;
+    size_t sourceCount() const;
+
+    const ConversationTable* m_table;
+    QRecursiveMutex* m_lock;
+    Kind m_kind;
+    bool m_tcpOnly = false;
+
+    // Bản chép (chỉ vector của m_kind có dữ liệu), cập nhật trong refresh()
+    std::vector<ConversationRecord> m_conversations;
+    std::vector<AddressPairRecord> m_pairs;
+    std::vector<EndpointRecord> m_endpoints;
+    int64_t m_startNs = -1;
+
+    std::vector<uint32_t> m_order;   // Dòng hiển thị -> dòng trong ConversationTable
+    std::vector<int> m_rowOf;        // Dòng nguồn -> dòng hiển thị (-1 = bị lọc)
+    size_t m_seenSource = 0;         // Số dòng nguồn đã đưa vào m_order
+    quint64 m_seenRevision = 0;
+    quint64 m_seenReset = 0;
+
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrderValue = Qt::AscendingOrder;
+};
+
+#endif // CONVERSATIONTABLEMODEL_HPP
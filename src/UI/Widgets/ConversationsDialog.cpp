@@ -0,0 +1,158 @@
+#include "ConversationsDialog.hpp"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTableView>
+#include <QTabWidget>
+#include <QHeaderView>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QMenu>
+#include <QMutexLocker>
+
+// --- Triển khai (Implementation) ---
+
+ConversationsDialog::ConversationsDialog(ConversationManager* manager, QWidget *parent)
+    : QDialog(parent),
+    m_manager(manager)
+{
+    // Bảng được luồng xử lý ghi: model giữ khóa của ConversationManager khi đọc
+    const ConversationTable* table = &m_manager->conversationTable();
+    QRecursiveMutex* lock = m_manager->mutex();
+    m_conversationModel = new ConversationTableModel(table, ConversationTableModel::CONVERSATIONS, lock, this);
+    m_pairModel = new ConversationTableModel(table, ConversationTableModel::ADDRESS_PAIRS, lock, this);
+    m_endpointModel = new ConversationTableModel(table, ConversationTableModel::ENDPOINTS, lock, this);
+
+    setupUi();
+    setWindowTitle("Conversations / Endpoints (Live)");
+    resize(1200, 500);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setInterval(1000); // 1 giây
+    connect(m_updateTimer, &QTimer::timeout, this, &ConversationsDialog::onUpdateTimerTimeout);
+}
+
+QTableView* ConversationsDialog::createView(ConversationTableModel* model)
+{
+    QTableView* view = new QTableView(this);
+    view->setModel(model);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->setSelectionMode(QAbstractItemView::SingleSelection);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->verticalHeader()->setVisible(false);
+    // Chiều cao dòng cố định: view không phải đo từng dòng (cần cho hàng triệu dòng)
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 6);
+    view->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    view->horizontalHeader()->setDefaultSectionSize(110);
+    view->setSortingEnabled(true);
+    view->setContextMenuPolicy(Qt::CustomContextMenu);
+
+    connect(view, &QTableView::doubleClicked, this, [this, model](const QModelIndex& index) {
+        applyFilterForRow(model, index.row());
+    });
+    connect(view, &QTableView::customContextMenuRequested, this, [this, view, model](const QPoint& pos) {
+        const QModelIndex index = view->indexAt(pos);
+        if (!index.isValid()) return;
+        QMenu menu(this);
+        QAction* applyAct = menu.addAction("Apply as Filter");
+        if (menu.exec(view->viewport()->mapToGlobal(pos)) == applyAct) {
+            applyFilterForRow(model, index.row());
+        }
+    });
+    return view;
+}
+
+void ConversationsDialog::setupUi()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // --- 1. TIÊU ĐỀ + TÙY CHỌN ---
+    QHBoxLayout* headerLayout = new QHBoxLayout();
+    m_summaryLabel = new QLabel("Conversations: 0", this);
+    m_summaryLabel->setStyleSheet("font-weight: bold;");
+    m_tcpOnlyCheck = new QCheckBox("TCP only", this);
+    headerLayout->addWidget(m_summaryLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(m_tcpOnlyCheck);
+    layout->addLayout(headerLayout);
+
+    // --- 2. CÁC TAB (thứ tự khớp enum Tab) ---
+    m_tabs = new QTabWidget(this);
+    QTableView* conversationView = createView(m_conversationModel);
+    conversationView->sortByColumn(0, Qt::AscendingOrder); // Theo stream index
+    m_tabs->addTab(conversationView, "TCP/UDP");
+    m_tabs->addTab(createView(m_pairModel), "IP Pairs");
+    m_tabs->addTab(createView(m_endpointModel), "Endpoints");
+    layout->addWidget(m_tabs);
+
+    // --- 3. NÚT ĐÓNG ---
+    QHBoxLayout* buttonLayout = new QHBoxLayout();
+    QPushButton* closeButton = new QPushButton("Close", this);
+    buttonLayout->addWidget(new QLabel("Double-click a row (or right-click > Apply as Filter) to filter by it.", this));
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+    layout->addLayout(buttonLayout);
+    setLayout(layout);
+
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+    connect(m_tcpOnlyCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_conversationModel->setTcpOnly(checked);
+        onUpdateTimerTimeout();
+    });
+    connect(m_tabs, &QTabWidget::currentChanged, this, [this](int index) {
+        m_tcpOnlyCheck->setVisible(index == TAB_CONVERSATIONS);
+        onUpdateTimerTimeout();
+    });
+}
+
+void ConversationsDialog::showTab(Tab tab)
+{
+    m_tabs->setCurrentIndex(tab);
+}
+
+void ConversationsDialog::applyFilterForRow(ConversationTableModel* model, int row)
+{
+    const QString filter = model->filterForRow(row);
+    if (!filter.isEmpty()) emit filterRequested(filter);
+}
+
+void ConversationsDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    onUpdateTimerTimeout();
+    m_updateTimer->start();
+}
+
+void ConversationsDialog::closeEvent(QCloseEvent *event)
+{
+    m_updateTimer->stop();
+    QDialog::closeEvent(event);
+}
+
+void ConversationsDialog::onUpdateTimerTimeout()
+{
+    // Chỉ làm mới tab đang xem; các tab khác tự đồng bộ khi được chọn
+    switch (m_tabs->currentIndex()) {
+    case TAB_CONVERSATIONS: {
+        m_conversationModel->refresh();
+        size_t activeFlows = 0;
+        {
+            QMutexLocker locker(m_manager->mutex());
+            activeFlows = m_manager->activeFlows();
+        }
+        m_summaryLabel->setText(QString("Conversations: %1 (active flows: %2)")
+                                    .arg(m_conversationModel->rowCount())
+                                    .arg(activeFlows));
+        break;
+    }
+    case TAB_ADDRESS_PAIRS:
+        m_pairModel->refresh();
+        m_summaryLabel->setText(QString("IP pairs: %1").arg(m_pairModel->rowCount()));
+        break;
+    case TAB_ENDPOINTS:
+        m_endpointModel->refresh();
+        m_summaryLabel->setText(QString("Endpoints: %1").arg(m_endpointModel->rowCount()));
+        break;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef CONVERSATIONSDIALOG_HPP
+#define CONVERSATIONSDIALOG_HPP
+
+#include <QDialog>
+#include <QTimer>
+#include <QLabel>
+#include "../../Controller/ControllerLib/ConversationManager.hpp"
+#include "ConversationTableModel.hpp"
+
+class QTableView;
+class QTabWidget;
+class QCheckBox;
+
+/**
+ * @brief Cửa sổ "Conversations / Endpoints" gồm 3 tab:
+ * - TCP/UDP: mỗi dòng là một luồng (gói/byte theo từng chiều, bits/s, trạng thái TCP, RTT).
+ * - IP Pairs: tổng hợp theo cặp địa chỉ IP.
+ * - Endpoints: tổng hợp theo địa chỉ IP (Tx/Rx).
+ * Dữ liệu lấy từ ConversationTable (QTableView + model ảo, sắp xếp được hàng triệu dòng),
+ * làm mới mỗi giây khi đang mở. Double-click hoặc menu chuột phải "Apply as Filter" để lọc.
+ */
+class ConversationsDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    enum Tab {
+        TAB_CONVERSATIONS,
+        TAB_ADDRESS_PAIRS,
+        TAB_ENDPOINTS
+    };
+
+    explicit ConversationsDialog(ConversationManager* manager, QWidget *parent = nullptr);
+
+    void showTab(Tab tab);
+
+signals:
+    void filterRequested(const QString& filterText);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onUpdateTimerTimeout();
+
+private:
+    void setupUi();
+    QTableView* createView(ConversationTableModel* model);
+    void applyFilterForRow(ConversationTableModel* model, int row);
+
+    // --- BIẾN UI ---
+    QLabel* m_summaryLabel;
+    QCheckBox* m_tcpOnlyCheck;
+    QTabWidget* m_tabs;
+
+    // --- BIẾN LOGIC ---
+    ConversationManager* m_manager;
+    ConversationTableModel* m_conversationModel;
+    ConversationTableModel* m_pairModel;
+    ConversationTableModel* m_endpointModel;
+    QTimer* m_updateTimer;
+};
+
+#endif // CONVERSATIONSDIALOG_HPP
@@ -0,0 +1,134 @@
+#include "FileSliceDialog.hpp"
+#include <QVBoxLayout>
+#include <QGridLayout>
+#include <QCheckBox>
+#include <QDateTimeEdit>
+#include <QSpinBox>
+#include <QLabel>
+#include <QDialogButtonBox>
+#include <QDateTime>
+#include <algorithm>
+#include <climits>
+
+static const char* DATE_TIME_FORMAT = "yyyy-MM-dd hh:mm:ss.zzz";
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static QDateTime toDateTime(int64_t ns)
+{
+    return QDateTime::fromMSecsSinceEpoch(ns / 1000000).toLocalTime();
+}
+
+static int64_t toNs(const QDateTime& dateTime)
+{
+    return dateTime.toMSecsSinceEpoch() * 1000000LL;
+}
+
+// --- Triển khai (Implementation) ---
+
+FileSliceDialog::FileSliceDialog(const QList<CaptureFileInfo>& files, QWidget *parent)
+    : QDialog(parent),
+    m_files(files)
+{
+    bool first = true;
+    for (const CaptureFileInfo& file : m_files) {
+        m_totalPackets += file.packetCount;
+        if (!file.scanned || file.packetCount == 0) continue;
+        m_firstNs = first ? file.firstNs : std::min(m_firstNs, file.firstNs);
+        m_lastNs = first ? file.lastNs : std::max(m_lastNs, file.lastNs);
+        first = false;
+    }
+
+    setupUi();
+    setWindowTitle("Open Capture Files");
+    updateSummary();
+}
+
+void FileSliceDialog::setupUi()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    QLabel* spanLabel = new QLabel(QString("%1 files, %2 packets, %3  →  %4")
+                                       .arg(m_files.size())
+                                       .arg(m_totalPackets)
+                                       .arg(toDateTime(m_firstNs).toString(DATE_TIME_FORMAT))
+                                       .arg(toDateTime(m_lastNs).toString(DATE_TIME_FORMAT)), this);
+    layout->addWidget(spanLabel);
+
+    // --- 1. KHOẢNG THỜI GIAN ---
+    QGridLayout* grid = new QGridLayout();
+    m_timeCheck = new QCheckBox("Time range", this);
+    m_fromEdit = new QDateTimeEdit(toDateTime(m_firstNs), this);
+    m_toEdit = new QDateTimeEdit(toDateTime(m_lastNs + 999999), this); // Làm tròn lên ms: giữ gói cuối
+    for (QDateTimeEdit* edit : { m_fromEdit, m_toEdit }) {
+        edit->setDisplayFormat(DATE_TIME_FORMAT);
+        edit->setCalendarPopup(true);
+        edit->setEnabled(false);
+    }
+    grid->addWidget(m_timeCheck, 0, 0);
+    grid->addWidget(new QLabel("from", this), 0, 1);
+    grid->addWidget(m_fromEdit, 0, 2);
+    grid->addWidget(new QLabel("to", this), 0, 3);
+    grid->addWidget(m_toEdit, 0, 4);
+
+    // --- 2. KHOẢNG GÓI (tính sau khi cắt thời gian) ---
+    m_packetCheck = new QCheckBox("Packet range", this);
+    m_firstPacketSpin = new QSpinBox(this);
+    m_lastPacketSpin = new QSpinBox(this);
+    const int maxPacket = static_cast<int>(std::min<uint64_t>(std::max<uint64_t>(m_totalPackets, 1), INT_MAX));
+    m_firstPacketSpin->setRange(1, maxPacket);
+    m_firstPacketSpin->setValue(1);
+    m_lastPacketSpin->setRange(1, maxPacket);
+    m_lastPacketSpin->setValue(maxPacket);
+    m_firstPacketSpin->setEnabled(false);
+    m_lastPacketSpin->setEnabled(false);
+    grid->addWidget(m_packetCheck, 1, 0);
+    grid->addWidget(new QLabel("from", this), 1, 1);
+    grid->addWidget(m_firstPacketSpin, 1, 2);
+    grid->addWidget(new QLabel("to", this), 1, 3);
+    grid->addWidget(m_lastPacketSpin, 1, 4);
+    layout->addLayout(grid);
+
+    m_summaryLabel = new QLabel(this);
+    layout->addWidget(m_summaryLabel);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    layout->addWidget(buttons);
+
+    connect(m_timeCheck, &QCheckBox::toggled, m_fromEdit, &QWidget::setEnabled);
+    connect(m_timeCheck, &QCheckBox::toggled, m_toEdit, &QWidget::setEnabled);
+    connect(m_timeCheck, &QCheckBox::toggled, this, &FileSliceDialog::updateSummary);
+    connect(m_fromEdit, &QDateTimeEdit::dateTimeChanged, this, &FileSliceDialog::updateSummary);
+    connect(m_toEdit, &QDateTimeEdit::dateTimeChanged, this, &FileSliceDialog::updateSummary);
+    connect(m_packetCheck, &QCheckBox::toggled, m_firstPacketSpin, &QWidget::setEnabled);
+    connect(m_packetCheck, &QCheckBox::toggled, m_lastPacketSpin, &QWidget::setEnabled);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+void FileSliceDialog::updateSummary()
+{
+    // Số file giao với khoảng đang chọn (chỉ các file này được mở khi đọc)
+    const FileSlice current = slice();
+    int overlapping = 0;
+    for (const CaptureFileInfo& file : m_files) {
+        if (file.packetCount > 0 && file.lastNs >= current.startNs && file.firstNs <= current.endNs) {
+            ++overlapping;
+        }
+    }
+    m_summaryLabel->setText(QString("Files to read: %1 of %2").arg(overlapping).arg(m_files.size()));
+}
+
+FileSlice FileSliceDialog::slice() const
+{
+    FileSlice result;
+    if (m_timeCheck->isChecked()) {
+        result.startNs = toNs(m_fromEdit->dateTime());
+        result.endNs = toNs(m_toEdit->dateTime());
+    }
+    if (m_packetCheck->isChecked()) {
+        result.firstPacket = static_cast<uint64_t>(m_firstPacketSpin->value());
+        result.lastPacket = static_cast<uint64_t>(m_lastPacketSpin->value());
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef FILESLICEDIALOG_HPP
+#define FILESLICEDIALOG_HPP
+
+#include <QDialog>
+#include <QList>
+#include "../../Core/Capture/CaptureFileIndex.hpp"
+
+class QCheckBox;
+class QDateTimeEdit;
+class QSpinBox;
+class QLabel;
+
+/**
+ * @brief Hỏi khoảng cần đọc khi mở nhiều file: khoảng thời gian và/hoặc khoảng số thứ tự gói.
+ *
+ * Hiển thị tổng khoảng thời gian, số gói của các file (từ scan) và số file giao với khoảng đang chọn
+ * (file ngoài khoảng không được mở).
+ */
+class FileSliceDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit FileSliceDialog(const QList<CaptureFileInfo>& files, QWidget *parent = nullptr);
+
+    FileSlice slice() const;
+
+private slots:
+    void updateSummary();
+
+private:
+    void setupUi();
+
+    QList<CaptureFileInfo> m_files;
+    int64_t m_firstNs = 0;
+    int64_t m_lastNs = 0;
+    uint64_t m_totalPackets = 0;
+
+    // --- BIẾN UI ---
+    QCheckBox* m_timeCheck;
+    QDateTimeEdit* m_fromEdit;
+    QDateTimeEdit* m_toEdit;
+    QCheckBox* m_packetCheck;
+    QSpinBox* m_firstPacketSpin;
+    QSpinBox* m_lastPacketSpin;
+    QLabel* m_summaryLabel;
+};
+
+#endif // FILESLICEDIALOG_HPP
@@ -0,0 +1,137 @@
+#include "FollowStreamDialog.hpp"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTextEdit>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QFontDatabase>
+
+FollowStreamDialog::FollowStreamDialog(const FollowStreamData& data, const QString& title, QWidget *parent)
+    : QDialog(parent),
+    m_data(data)
+{
+    setupUi();
+    setWindowTitle(title);
+    resize(800, 600);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    refreshView();
+}
+
+void FollowStreamDialog::setupUi()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    // --- 1. VÙNG HIỂN THỊ DỮ LIỆU ---
+    m_textView = new QTextEdit(this);
+    m_textView->setReadOnly(true);
+    m_textView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    m_textView->setLineWrapMode(QTextEdit::NoWrap);
+    layout->addWidget(m_textView);
+
+    // --- 2. TỔNG KẾT ---
+    m_summaryLabel = new QLabel(this);
+    layout->addWidget(m_summaryLabel);
+
+    // --- 3. TÙY CHỌN ---
+    QHBoxLayout* optionsLayout = new QHBoxLayout();
+
+    m_directionCombo = new QComboBox(this);
+    m_directionCombo->addItem("Entire conversation");
+    m_directionCombo->addItem("Client → Server");
+    m_directionCombo->addItem("Server → Client");
+
+    m_formatCombo = new QComboBox(this);
+    m_formatCombo->addItem("ASCII");
+    m_formatCombo->addItem("Hex Dump");
+
+    QPushButton* closeButton = new QPushButton("Close", this);
+
+    optionsLayout->addWidget(m_directionCombo);
+    optionsLayout->addWidget(new QLabel("Show data as:", this));
+    optionsLayout->addWidget(m_formatCombo);
+    optionsLayout->addStretch();
+    optionsLayout->addWidget(closeButton);
+    layout->addLayout(optionsLayout);
+
+    connect(m_directionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &FollowStreamDialog::refreshView);
+    connect(m_formatCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &FollowStreamDialog::refreshView);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+
+    QString summary = QString("Client → Server: %1 bytes   ·   Server → Client: %2 bytes")
+                          .arg(m_data.data[0].size())
+                          .arg(m_data.data[1].size());
+    if (m_data.truncated) {
+        summary += "   ·   (Stream truncated: per-flow memory limit reached)";
+    }
+    m_summaryLabel->setText(summary);
+}
+
+QString FollowStreamDialog::renderAscii(const uint8_t* p, size_t len) const
+{
+    QString text;
+    text.reserve(static_cast<int>(len));
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t c = p[i];
+        if (c == '\n' || c == '\t') text += QChar(c);
+        else if (c == '\r') continue;
+        else if (c >= 0x20 && c < 0x7F) text += QChar(c);
+        else text += '.';
+    }
+    return text;
+}
+
+QString FollowStreamDialog::renderHex(const uint8_t* p, size_t len, uint64_t baseOffset) const
+{
+    QString text;
+    for (size_t line = 0; line < len; line += 16) {
+        text += QString("%1  ").arg(baseOffset + line, 8, 16, QChar('0'));
+        QString ascii;
+        for (size_t i = 0; i < 16; ++i) {
+            if (line + i < len) {
+                uint8_t c = p[line + i];
+                text += QString("%1 ").arg(static_cast<uint>(c), 2, 16, QChar('0'));
+                ascii += (c >= 0x20 && c < 0x7F) ? QChar(c) : QChar('.');
+            } else {
+                text += "   ";
+            }
+            if (i == 7) text += ' ';
+        }
+        text += ' ' + ascii + '\n';
+    }
+    return text;
+}
+
+void FollowStreamDialog::refreshView()
+{
+    const int directionFilter = m_directionCombo->currentIndex(); // 0: cả hai, 1: Client, 2: Server
+    const bool hex = (m_formatCombo->currentIndex() == 1);
+
+    // Màu giống Wireshark: Client đỏ, Server xanh
+    static const char* colors[2] = {
+        "color:#a00000; background-color:#fbeded;",
+        "color:#000080; background-color:#ededfb;"
+    };
+
+    QString html = "<pre style=\"margin:0;\">";
+    for (const TcpStreamChunk& chunk : m_data.chunks) {
+        if (directionFilter != 0 && chunk.direction != directionFilter - 1) continue;
+
+        if (chunk.missing_before > 0) {
+            html += QString("<span style=\"color:#808080;\">[%1 bytes missing in capture]</span>\n")
+                        .arg(chunk.missing_before);
+        }
+
+        const uint8_t* p = m_data.data[chunk.direction].data() + chunk.offset;
+        QString body = hex ? renderHex(p, chunk.length, chunk.offset) : renderAscii(p, chunk.length);
+        html += QString("<span style=\"%1\">%2</span>")
+                    .arg(QString(colors[chunk.direction]), body.toHtmlEscaped());
+        if (hex) html += '\n';
+    }
+    html += "</pre>";
+
+    m_textView->setHtml(html);
+}
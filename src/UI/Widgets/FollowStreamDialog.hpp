@@ -0,0 +1,39 @@
+#ifndef FOLLOWSTREAMDIALOG_HPP
+#define FOLLOWSTREAMDIALOG_HPP
+
+#include <QDialog>
+#include <QString>
+#include "../../Controller/ControllerLib/TcpReassembler.hpp"
+
+class QTextEdit;
+class QComboBox;
+class QLabel;
+
+/**
+ * @brief Cửa sổ "Follow TCP Stream": hiển thị dòng byte đã ghép của một luồng,
+ * Client (đỏ) và Server (xanh) xen kẽ theo thứ tự xuất hiện.
+ */
+class FollowStreamDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit FollowStreamDialog(const FollowStreamData& data, const QString& title, QWidget *parent = nullptr);
+
+private slots:
+    void refreshView();
+
+private:
+    void setupUi();
+    QString renderAscii(const uint8_t* p, size_t len) const;
+    QString renderHex(const uint8_t* p, size_t len, uint64_t baseOffset) const;
+
+    FollowStreamData m_data;
+
+    // --- BIẾN UI ---
+    QTextEdit* m_textView;
+    QComboBox* m_directionCombo;
+    QComboBox* m_formatCombo;
+    QLabel* m_summaryLabel;
+};
+
+#endif // FOLLOWSTREAMDIALOG_HPP
@@ -1,141 +1,401 @@
 #include "IOGraphDialog.hpp"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QHeaderView>
 #include <QLabel>
+#include <QMessageBox>
+#include <QSet>
+#include <QMutexLocker>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
 
-IOGraphDialog::IOGraphDialog(const QList<PacketData>& packets, StatisticsManager* statsManager, QWidget *parent)
-    : QDialog(parent), m_packets(packets), m_statsManager(statsManager)
+// Cột của bảng đường
+enum SeriesColumn {
+    COL_NAME,       // Tên (bộ lọc) + ô chọn hiện / ẩn
+    COL_FIELD,
+    COL_AGGREGATE,
+    COL_STATUS,
+    COL_COUNT
+};
+
+IOGraphDialog::IOGraphDialog(IOGraphManager* manager, QWidget *parent)
+    : QDialog(parent), m_manager(manager)
 {
     setWindowTitle("I/O Graph - Traffic Analysis");
-    resize(900, 600);
+    resize(1000, 700);
     setAttribute(Qt::WA_DeleteOnClose); // Tự xóa khi đóng để giải phóng RAM
 
     setupUi();
-    updateGraph(); // Vẽ lần đầu
+    syncSeries(); // Vẽ lần đầu
+
+    // Thêm / xóa đường hoặc tính lại xong ở luồng nền -> cập nhật bảng và biểu đồ
+    connect(m_manager, &IOGraphManager::seriesChanged, this, &IOGraphDialog::syncSeries);
+
+    // Làm mới mỗi giây khi đang mở (chỉ vẽ lại nếu có gói mới)
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setInterval(1000);
+    connect(m_updateTimer, &QTimer::timeout, this, [this]() {
+        if (m_manager && m_manager->revision() != m_drawnRevision) updateGraph();
+    });
+}
+
+void IOGraphDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    m_updateTimer->start();
+}
+
+void IOGraphDialog::closeEvent(QCloseEvent *event)
+{
+    m_updateTimer->stop();
+    QDialog::closeEvent(event);
+}
+
+void IOGraphDialog::resizeEvent(QResizeEvent *event)
+{
+    QDialog::resizeEvent(event);
+    if (isVisible()) updateGraph(); // Số điểm vẽ phụ thuộc bề rộng vùng vẽ
+}
+
+void IOGraphDialog::resetZoom()
+{
+    m_followLive = true;
+    updateGraph();
+}
+
+bool IOGraphDialog::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched != m_chartView->viewport()) return QDialog::eventFilter(watched, event);
+
+    const QRectF plot = m_chart->plotArea();
+    const double span = m_viewEnd - m_viewStart;
+    if (plot.width() <= 0 || span <= 0) return QDialog::eventFilter(watched, event);
+
+    switch (event->type()) {
+    case QEvent::Wheel: {
+        // Zoom quanh vị trí con trỏ; dữ liệu được lấy lại từ các ô đã gộp sẵn
+        QWheelEvent* wheel = static_cast<QWheelEvent*>(event);
+        const double frac = std::clamp((wheel->position().x() - plot.left()) / plot.width(), 0.0, 1.0);
+        const double anchor = m_viewStart + frac * span;
+        const double minSpan = TimeSeriesStore::resolutionNs(
+            static_cast<TimeSeriesStore::Resolution>(m_comboInterval->currentData().toInt())) / 1e9 * 4;
+        const double newSpan = std::max(minSpan, span * (wheel->angleDelta().y() > 0 ? 0.8 : 1.25));
+        m_viewStart = std::max(0.0, anchor - frac * newSpan);
+        m_viewEnd = m_viewStart + newSpan;
+        m_followLive = false;
+        updateGraph();
+        return true;
+    }
+    case QEvent::MouseButtonPress: {
+        QMouseEvent* mouse = static_cast<QMouseEvent*>(event);
+        if (mouse->button() != Qt::LeftButton) break;
+        m_panning = true;
+        m_panLastX = mouse->position().x();
+        return true;
+    }
+    case QEvent::MouseMove: {
+        if (!m_panning) break;
+        QMouseEvent* mouse = static_cast<QMouseEvent*>(event);
+        double shift = -(mouse->position().x() - m_panLastX) / plot.width() * span;
+        m_panLastX = mouse->position().x();
+        if (m_viewStart + shift < 0) shift = -m_viewStart;
+        m_viewStart += shift;
+        m_viewEnd += shift;
+        m_followLive = false;
+        updateGraph();
+        return true;
+    }
+    case QEvent::MouseButtonRelease:
+        if (!m_panning) break;
+        m_panning = false;
+        return true;
+    case QEvent::MouseButtonDblClick:
+        resetZoom();
+        return true;
+    default:
+        break;
+    }
+    return QDialog::eventFilter(watched, event);
+}
+
+QColor IOGraphDialog::seriesColor(int id)
+{
+    static const QColor PALETTE[] = {
+        QColor(31, 119, 180), QColor(214, 39, 40), QColor(44, 160, 44), QColor(255, 127, 14),
+        QColor(148, 103, 189), QColor(140, 86, 75), QColor(227, 119, 194), QColor(23, 190, 207)
+    };
+    return PALETTE[id % (sizeof(PALETTE) / sizeof(PALETTE[0]))];
 }
 
 void IOGraphDialog::setupUi()
 {
-    // 1. Setup Chart
-    m_series = new QLineSeries();
-    m_series->setPointsVisible(true);
-    m_series->setPointLabelsVisible(false);
+    // 1. Setup Chart (mỗi đường một QLineSeries, tạo trong syncSeries())
     m_chart = new QChart();
-    m_chart->addSeries(m_series);
     m_chart->setTitle("Network Traffic");
-    m_chart->legend()->hide();m_series->setPointsVisible(true);
+    m_chart->legend()->setVisible(true);
+    m_chart->legend()->setAlignment(Qt::AlignBottom);
 
     m_axisX = new QValueAxis();
     m_axisX->setTitleText("Time (s)");
     m_axisX->setLabelFormat("%.1f");
     m_chart->addAxis(m_axisX, Qt::AlignBottom);
-    m_series->attachAxis(m_axisX);
 
     m_axisY = new QValueAxis();
     m_chart->addAxis(m_axisY, Qt::AlignLeft);
-    m_series->attachAxis(m_axisY);
 
     m_chartView = new QChartView(m_chart);
     m_chartView->setRenderHint(QPainter::Antialiasing);
+    m_chartView->viewport()->installEventFilter(this);
+
+    // 2. Bảng các đường
+    m_seriesTable = new QTableWidget(0, COL_COUNT, this);
+    m_seriesTable->setHorizontalHeaderLabels({"Graph (display filter)", "Y Field", "Y Axis", "Status"});
+    m_seriesTable->verticalHeader()->setVisible(false);
+    m_seriesTable->horizontalHeader()->setSectionResizeMode(COL_NAME, QHeaderView::Stretch);
+    m_seriesTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_seriesTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_seriesTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_seriesTable->setMaximumHeight(150);
 
-    // 2. Setup Controls (Thanh điều khiển bên dưới)
+    // Ô chọn ở cột tên: hiện / ẩn đường
+    connect(m_seriesTable, &QTableWidget::itemChanged, this, [this](QTableWidgetItem* item) {
+        if (item->column() != COL_NAME) return;
+        m_manager->setVisible(item->data(Qt::UserRole).toInt(), item->checkState() == Qt::Checked);
+        updateGraph();
+    });
+
+    // 3. Thêm đường mới: bộ lọc + trường + phép gộp
+    QHBoxLayout *addLayout = new QHBoxLayout();
+    m_filterEdit = new QLineEdit();
+    m_filterEdit->setPlaceholderText("Display filter (e.g. tcp.analysis.retransmission, dns, ip.addr == 10.0.0.1)");
+
+    m_comboField = new QComboBox();
+    for (int f = 0; f < IOGraphSeries::FIELD_COUNT; ++f) {
+        m_comboField->addItem(IOGraphSeries::fieldName(static_cast<IOGraphSeries::Field>(f)), f);
+    }
+    m_comboAggregate = new QComboBox();
+    for (int a = 0; a < IOGraphSeries::AGG_COUNT; ++a) {
+        m_comboAggregate->addItem(IOGraphSeries::aggregateName(static_cast<IOGraphSeries::Aggregate>(a)), a);
+    }
+
+    m_btnAdd = new QPushButton("Add Graph");
+    m_btnRemove = new QPushButton("Remove");
+    connect(m_btnAdd, &QPushButton::clicked, this, &IOGraphDialog::onAddSeriesClicked);
+    connect(m_filterEdit, &QLineEdit::returnPressed, this, &IOGraphDialog::onAddSeriesClicked);
+    connect(m_btnRemove, &QPushButton::clicked, this, &IOGraphDialog::onRemoveSeriesClicked);
+
+    addLayout->addWidget(m_filterEdit, 1);
+    addLayout->addWidget(m_comboAggregate);
+    addLayout->addWidget(new QLabel("of"));
+    addLayout->addWidget(m_comboField);
+    addLayout->addWidget(m_btnAdd);
+    addLayout->addWidget(m_btnRemove);
+
+    // 4. Setup Controls (Thanh điều khiển bên dưới)
     QHBoxLayout *controlLayout = new QHBoxLayout();
 
+    // Mỗi interval ứng với một độ phân giải có sẵn trong TimeSeriesStore (đổi interval là tức thì)
     m_comboInterval = new QComboBox();
-    m_comboInterval->addItem("1 sec", 1000);
-    m_comboInterval->addItem("0.1 sec", 100);
-    m_comboInterval->addItem("10 sec", 10000);
-    m_comboInterval->addItem("1 min", 60000);
+    m_comboInterval->addItem("1 sec", TimeSeriesStore::RES_1S);
+    m_comboInterval->addItem("0.1 sec", TimeSeriesStore::RES_100MS);
+    m_comboInterval->addItem("1 ms", TimeSeriesStore::RES_1MS);
+    m_comboInterval->addItem("10 sec", TimeSeriesStore::RES_10S);
+    m_comboInterval->addItem("1 min", TimeSeriesStore::RES_1MIN);
 
-    m_comboUnit = new QComboBox();
-    m_comboUnit->addItem("Bytes/Tick", 1);
-    m_comboUnit->addItem("Packets/Tick", 0);
+    m_btnResetZoom = new QPushButton("Reset Zoom");
+    connect(m_btnResetZoom, &QPushButton::clicked, this, &IOGraphDialog::resetZoom);
 
     m_btnClose = new QPushButton("Close");
     connect(m_btnClose, &QPushButton::clicked, this, &QDialog::accept);
 
     controlLayout->addWidget(new QLabel("Interval:"));
     controlLayout->addWidget(m_comboInterval);
-    controlLayout->addWidget(new QLabel("Unit:"));
-    controlLayout->addWidget(m_comboUnit);
+    controlLayout->addWidget(new QLabel("Wheel: zoom, drag: pan, double-click: reset"));
     controlLayout->addStretch();
+    controlLayout->addWidget(m_btnResetZoom);
     controlLayout->addWidget(m_btnClose);
 
     // Connect Combobox changes
     connect(m_comboInterval, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &IOGraphDialog::updateGraph);
-    connect(m_comboUnit, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &IOGraphDialog::updateGraph);
 
-    // 3. Main Layout
+    // 5. Main Layout
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
-    mainLayout->addWidget(m_chartView);
+    mainLayout->addWidget(m_chartView, 1);
+    mainLayout->addWidget(m_seriesTable);
+    mainLayout->addLayout(addLayout);
     mainLayout->addLayout(controlLayout);
     setLayout(mainLayout);
 }
 
-void IOGraphDialog::updateGraph()
+void IOGraphDialog::onAddSeriesClicked()
+{
+    // Gói đã có được tính ở luồng nền; đường hiện "Computing..." cho tới khi xong
+    QString error;
+    const int id = m_manager->addSeries(m_filterEdit->text(),
+                                        static_cast<IOGraphSeries::Field>(m_comboField->currentData().toInt()),
+                                        static_cast<IOGraphSeries::Aggregate>(m_comboAggregate->currentData().toInt()),
+                                        &error);
+    if (id < 0) {
+        // Giữ nguyên chuỗi lọc để người dùng sửa
+        QMessageBox::warning(this, "Display Filter Error", "Error: " + error);
+        return;
+    }
+    m_filterEdit->clear();
+}
+
+void IOGraphDialog::onRemoveSeriesClicked()
 {
-    if (!m_statsManager) return;
+    const int row = m_seriesTable->currentRow();
+    if (row < 0) return;
+    QTableWidgetItem* item = m_seriesTable->item(row, COL_NAME);
+    if (item) m_manager->removeSeries(item->data(Qt::UserRole).toInt());
+}
 
-    // Lấy interval (ms) từ combobox
-    int intervalMs = m_comboInterval->currentData().toInt();
-    bool modeBytes = m_comboUnit->currentData().toInt() == 1;
+void IOGraphDialog::syncSeries()
+{
+    if (!m_manager) return;
+    syncSeriesTable();
+    updateGraph();
+}
 
-    // Tính toán dữ liệu (Giả sử hàm này trả về X là giây: 0.1, 0.2, 1, 2, 60...)
-    QVector<QPointF> data = m_statsManager->calculateIOGraphData(m_packets, intervalMs, modeBytes);
+void IOGraphDialog::syncSeriesTable()
+{
+    // Danh sách đường do luồng xử lý cập nhật song song: đọc khi giữ khóa
+    QMutexLocker locker(m_manager->mutex());
+    const auto& allSeries = m_manager->series();
 
-    if (intervalMs < 1000) {
-        // Nếu nhỏ hơn 1 giây (ví dụ 0.1s), cần hiển thị số lẻ
-        m_axisX->setTitleText("Time (s)");
-        m_axisX->setLabelFormat("%.1f"); // Hiển thị 1 số sau dấu phẩy (0.1, 0.2)
+    // 1. Xóa đường không còn, tạo đường mới
+    QSet<int> ids;
+    for (const auto& s : allSeries) ids.insert(s->id);
+    for (auto it = m_lines.begin(); it != m_lines.end();) {
+        if (!ids.contains(it.key())) {
+            m_chart->removeSeries(it.value());
+            delete it.value();
+            it = m_lines.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& s : allSeries) {
+        if (m_lines.contains(s->id)) continue;
+        QLineSeries* line = new QLineSeries();
+        line->setName(s->name);
+        line->setColor(seriesColor(s->id));
+        m_chart->addSeries(line);
+        line->attachAxis(m_axisX);
+        line->attachAxis(m_axisY);
+        m_lines.insert(s->id, line);
     }
-    else if (intervalMs >= 60000) {
 
-        m_axisX->setTitleText("Time (s)");
-        m_axisX->setLabelFormat("%.0f");
+    // 2. Dựng lại bảng (chặn itemChanged trong lúc dựng)
+    m_seriesTable->blockSignals(true);
+    m_seriesTable->setRowCount(static_cast<int>(allSeries.size()));
+    for (int row = 0; row < static_cast<int>(allSeries.size()); ++row) {
+        const IOGraphSeries& s = *allSeries[row];
 
+        QTableWidgetItem* nameItem = new QTableWidgetItem(s.name);
+        nameItem->setData(Qt::UserRole, s.id);
+        nameItem->setFlags(nameItem->flags() | Qt::ItemIsUserCheckable);
+        nameItem->setCheckState(s.visible ? Qt::Checked : Qt::Unchecked);
+        nameItem->setForeground(seriesColor(s.id));
+        m_seriesTable->setItem(row, COL_NAME, nameItem);
+        m_seriesTable->setItem(row, COL_FIELD, new QTableWidgetItem(IOGraphSeries::fieldName(s.field)));
+        m_seriesTable->setItem(row, COL_STATUS, new QTableWidgetItem());
 
+        // Đổi phép gộp chỉ đọc lại các ô đã có (không tính lại)
+        QComboBox* aggregateCombo = new QComboBox();
+        for (int a = 0; a < IOGraphSeries::AGG_COUNT; ++a) {
+            aggregateCombo->addItem(IOGraphSeries::aggregateName(static_cast<IOGraphSeries::Aggregate>(a)), a);
+        }
+        aggregateCombo->setCurrentIndex(s.aggregate);
+        const int id = s.id;
+        connect(aggregateCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this, id](int index) {
+            m_manager->setAggregate(id, static_cast<IOGraphSeries::Aggregate>(index));
+            updateGraph();
+        });
+        m_seriesTable->setCellWidget(row, COL_AGGREGATE, aggregateCombo);
     }
-    else {
-        // Mặc định (1s, 10s)
-        m_axisX->setTitleText("Time (s)");
-        m_axisX->setLabelFormat("%.0f"); // Số nguyên (1, 2, 3...)
-    }
-    // ---------------------------------------------
+    m_seriesTable->blockSignals(false);
+}
 
-    // Cập nhật biểu đồ
-    m_series->replace(data);
+void IOGraphDialog::updateGraph()
+{
+    if (!m_manager) return;
 
-    // Cập nhật tiêu đề trục Y
-    m_axisY->setTitleText(modeBytes ? "Bytes" : "Packets");
+    // Lấy độ phân giải từ combobox
+    const TimeSeriesStore::Resolution res =
+        static_cast<TimeSeriesStore::Resolution>(m_comboInterval->currentData().toInt());
+    const int64_t intervalMs = TimeSeriesStore::resolutionNs(res) / 1000000;
+    const double widthSec = TimeSeriesStore::resolutionNs(res) / 1e9;
+    QMutexLocker locker(m_manager->mutex());
+    m_drawnRevision = m_manager->revision();
+    const auto& allSeries = m_manager->series();
 
-    // Xử lý hiển thị số trục Y cho đẹp (nếu số quá lớn dùng k/M/G)
-    // Ở đây dùng đơn giản %.0f
-    m_axisY->setLabelFormat("%.0f");
+    // 1. Khoảng đang xem: theo dữ liệu (follow) hoặc khoảng người dùng đã zoom / pan
+    if (m_followLive) {
+        double dataStart = -1, dataEnd = 0;
+        for (const auto& s : allSeries) {
+            if (!s->visible || s->store.isEmpty()) continue;
+            const double start = s->store.firstAvailableIndex(res) * widthSec;
+            if (dataStart < 0 || start < dataStart) dataStart = start;
+            dataEnd = std::max(dataEnd, s->store.bucketCount(res) * widthSec);
+        }
+        m_viewStart = std::max(0.0, dataStart);
+        // Fix lỗi nếu chỉ có 1 điểm hoặc min=max
+        m_viewEnd = std::max(dataEnd, m_viewStart + widthSec * 10);
+    }
 
-    // Rescale trục (Zoom fit)
-    if (!data.isEmpty()) {
-        double minX = data.first().x();
-        double maxX = data.last().x();
+    // 2. Mỗi đường chỉ lấy các ô trong khoảng xem, tối đa ~2 điểm / cột pixel
+    const int64_t firstIndex = static_cast<int64_t>(std::floor(m_viewStart / widthSec));
+    const int64_t lastIndex = static_cast<int64_t>(std::ceil(m_viewEnd / widthSec)) + 1;
+    const int columns = std::max(1, static_cast<int>(m_chart->plotArea().width()));
 
-        // Fix lỗi nếu chỉ có 1 điểm hoặc min=max
-        if (maxX <= minX) maxX = minX + (intervalMs / 1000.0) * 10;
+    double maxY = 0;
+    QSet<int> visibleAggregates; // Các phép gộp đang hiện
+    for (int row = 0; row < static_cast<int>(allSeries.size()); ++row) {
+        const IOGraphSeries& s = *allSeries[row];
+        QTableWidgetItem* statusItem = m_seriesTable->item(row, COL_STATUS);
+        if (statusItem) {
+            statusItem->setText(s.computing ? QString("Computing...")
+                                            : QString("%1 packets").arg(s.store.totalCount()));
+        }
 
-        m_axisX->setRange(minX, maxX);
+        QLineSeries* line = m_lines.value(s.id, nullptr);
+        if (!line) continue;
+        line->setVisible(s.visible);
+        if (!s.visible) continue;
+        visibleAggregates.insert(s.aggregate);
 
-        double maxY = 0;
-        for(const auto& p : data) if(p.y() > maxY) maxY = p.y();
+        const QVector<QPointF> data = s.points(res, firstIndex, lastIndex, columns);
+        for (const QPointF& p : data) maxY = std::max(maxY, p.y());
+        line->replace(data);
+    }
 
-        if (maxY == 0) maxY = 10; // Tránh biểu đồ bẹp dí nếu không có data
-        m_axisY->setRange(0, maxY * 1.1);
+    if (intervalMs < 100) {
+        m_axisX->setTitleText("Time (s)");
+        m_axisX->setLabelFormat("%.3f");
+    }
+    else if (intervalMs < 1000) {
+        // Nếu nhỏ hơn 1 giây (ví dụ 0.1s), cần hiển thị số lẻ
+        m_axisX->setTitleText("Time (s)");
+        m_axisX->setLabelFormat("%.1f"); // Hiển thị 1 số sau dấu phẩy (0.1, 0.2)
+    }
+    else {
+        // Mặc định (1s, 10s, 1 phút)
+        m_axisX->setTitleText("Time (s)");
+        m_axisX->setLabelFormat("%.0f"); // Số nguyên (1, 2, 3...)
     }
-}
-void IOGraphDialog::appendPackets(const QList<PacketData>& newPackets)
-{
-    if (newPackets.isEmpty()) return;
 
-    // 1. Thêm gói mới vào danh sách đang lưu trữ
-    m_packets.append(newPackets);
+    // Cập nhật tiêu đề trục Y (chung cho mọi đường; ghi rõ phép gộp nếu chỉ có một loại)
+    m_axisY->setTitleText(visibleAggregates.size() == 1
+                              ? IOGraphSeries::aggregateName(static_cast<IOGraphSeries::Aggregate>(*visibleAggregates.begin())) + " / Tick"
+                              : QString("Value / Tick"));
+    m_axisY->setLabelFormat("%.0f");
 
-    // 2. Vẽ lại biểu đồ
-    updateGraph();
+    // Rescale trục theo khoảng xem (trục Y theo các điểm đang thấy)
+    m_axisX->setRange(m_viewStart, m_viewEnd);
+    if (maxY == 0) maxY = 10; // Tránh biểu đồ bẹp dí nếu không có data
+    m_axisY->setRange(0, maxY * 1.1);
 }
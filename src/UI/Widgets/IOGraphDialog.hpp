@@ -6,9 +6,12 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
 #include <QComboBox>
+#include <QLineEdit>
+#include <QMap>
 #include <QPushButton>
-#include "../../Controller/StatisticsManager.hpp"
-#include "../../Common/PacketData.hpp"
+#include <QTableWidget>
+#include <QTimer>
+#include "../../Controller/IOGraphManager.hpp"
 
 // Dùng namespace của Qt Charts
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -21,29 +24,58 @@ using namespace QtCharts;
 {
     Q_OBJECT
 public:
-    // Nhận danh sách packet vào để xử lý
-    explicit IOGraphDialog(const QList<PacketData>& packets, StatisticsManager* statsManager, QWidget *parent = nullptr);
+    // Đọc chuỗi thời gian đã gộp sẵn của IOGraphManager (không copy gói tin)
+    explicit IOGraphDialog(IOGraphManager* manager, QWidget *parent = nullptr);
 
 public slots:
-    void appendPackets(const QList<PacketData>& newPackets);
     void updateGraph();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    // Zoom (lăn chuột) / pan (kéo) / reset (double-click) trên biểu đồ
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void onAddSeriesClicked();
+    void onRemoveSeriesClicked();
+    void syncSeries();   // Đồng bộ bảng + các QLineSeries với danh sách đường của manager
+    void syncSeriesTable();
+
 private:
     void setupUi();
+    void resetZoom();
+    static QColor seriesColor(int id);
 
     // Dữ liệu
-    QList<PacketData> m_packets;
-    StatisticsManager* m_statsManager;
+    IOGraphManager* m_manager;
+    QTimer *m_updateTimer;
+    quint64 m_drawnRevision = 0;  // revision() lúc vẽ lần trước (bỏ qua nếu không đổi)
+    QMap<int, QLineSeries*> m_lines; // id đường -> đường trên biểu đồ
+
+    // Khoảng thời gian đang xem (giây từ mốc 0). m_followLive: tự giãn theo dữ liệu mới
+    bool m_followLive = true;
+    double m_viewStart = 0;
+    double m_viewEnd = 0;
+    bool m_panning = false;
+    double m_panLastX = 0;
 
     // UI Components
     QChartView *m_chartView;
-    QLineSeries *m_series;
     QChart *m_chart;
     QValueAxis *m_axisX;
     QValueAxis *m_axisY;
 
+    QTableWidget *m_seriesTable;
+    QLineEdit *m_filterEdit;
+    QComboBox *m_comboField;
+    QComboBox *m_comboAggregate;
+    QPushButton *m_btnAdd;
+    QPushButton *m_btnRemove;
+
     QComboBox *m_comboInterval;
-    QComboBox *m_comboUnit;
+    QPushButton *m_btnResetZoom;
     QPushButton *m_btnClose;
 };
 
@@ -4,6 +4,7 @@
 #include "../../Common/MacResolver.hpp"
 #include <QDateTime>
 #include <QRegularExpression>
+#include <functional>
 
 // === 1. LOGIC PHÂN TÍCH GÓI TIN VÀO CÂY (Main Logic) ===
 void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
@@ -27,6 +28,7 @@ void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
 
     QDateTime timestamp = QDateTime::fromSecsSinceEpoch(packet.timestamp.tv_sec);
     timestamp = timestamp.addMSecs(packet.timestamp.tv_nsec / 1000000);
+    addField(root, "Interface id", QString::number(packet.interface_id));
     addField(root, "Arrival Time", timestamp.toLocalTime().toString("MMM d, yyyy hh:mm:ss.zzz"));
     addField(root, "Frame Number", QString::number(packet.packet_id));
     addField(root, "Frame Length", QString("%1 bytes").arg(packet.wire_length));
@@ -99,6 +101,24 @@ void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
         addField(arp, "Target IP", ipToString(packet.arp.target_ip), l3_offset + 24, 4);
     }
 
+    // --- PHÂN MẢNH IP ---
+    if (packet.is_ip_fragment) {
+        if (!packet.fragment_ids.empty()) {
+            QTreeWidgetItem *frag = new QTreeWidgetItem(root);
+            frag->setText(0, QString("[%1 IP Fragments (%2 bytes)]")
+                                 .arg(packet.fragment_ids.size())
+                                 .arg(packet.reassembled.size()));
+            for (uint32_t id : packet.fragment_ids) {
+                addField(frag, "Frame", QString("#%1").arg(id));
+            }
+        } else if (packet.reassembled_in != 0) {
+            addField(root, "[Reassembled in]", QString("#%1").arg(packet.reassembled_in));
+        } else {
+            addField(root, "[Fragment]", "Datagram not reassembled");
+        }
+    }
+    const int firstUpperLayerItem = root->childCount();
+
     // --- TẦNG 4: TCP/UDP/ICMP ---
     if (l4_offset != -1) {
         if (packet.is_tcp) {
@@ -114,9 +134,39 @@ void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
             addField(tcp, "Seq", QString::number(packet.tcp.seq_num), l4_offset + 4, 4);
             addField(tcp, "Ack", QString::number(packet.tcp.ack_num), l4_offset + 8, 4);
             addField(tcp, "Flags", toHex(packet.tcp.flags, 2), l4_offset + 13, 1);
+            addField(tcp, "Window", QString::number(packet.tcp.window), l4_offset + 14, 2);
             if (packet.tcp.options_len > 0) {
                 addField(tcp, "Options", QString("%1 bytes").arg(packet.tcp.options_len), l4_offset + 20, packet.tcp.options_len);
             }
+
+            // --- Phân tích SEQ/ACK ---
+            const TCPAnalysis& ta = packet.tcp_analysis;
+            if (ta.flags != 0 || ta.ack_rtt_ns >= 0 || ta.ts_rtt_ns >= 0 || ta.initial_rtt_ns >= 0) {
+                auto seconds = [](int64_t ns) { return QString("%1 seconds").arg(ns / 1e9, 0, 'f', 9); };
+                QTreeWidgetItem *analysis = new QTreeWidgetItem(tcp);
+                analysis->setText(0, "[SEQ/ACK analysis]");
+                if (ta.ack_rtt_ns >= 0) {
+                    addField(analysis, "[This is an ACK to the segment in frame]", QString::number(ta.ack_rtt_frame));
+                    addField(analysis, "[The RTT to ACK the segment was]", seconds(ta.ack_rtt_ns));
+                }
+                if (ta.ts_rtt_ns >= 0) {
+                    addField(analysis, "[Timestamp RTT (TSval -> TSecr)]", seconds(ta.ts_rtt_ns));
+                }
+                if (ta.initial_rtt_ns >= 0) {
+                    addField(analysis, "[iRTT]", seconds(ta.initial_rtt_ns));
+                }
+                if (ta.flags != 0) {
+                    addField(analysis, "[Flags]", getTcpAnalysisFlags(packet));
+                }
+                if (!packet.expert_info.empty()) {
+                    addField(analysis, "[Expert Info]", QString::fromStdString(packet.expert_info));
+                }
+                if (packet.tcp_analysis.has(TCPAnalysis::DUPLICATE_ACK)) {
+                    addField(analysis, "[Duplicate ACK #]", QString::number(packet.tcp_analysis.dup_ack_num));
+                    addField(analysis, "[Duplicate to the ACK in frame]", QString::number(packet.tcp_analysis.dup_ack_frame));
+                }
+                analysis->setExpanded(true);
+            }
         }
         else if (packet.is_udp) {
             l7_offset = l4_offset + 8;
@@ -143,8 +193,8 @@ void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
     }
 
     // --- TẦNG 7: APP ---
-    if (l7_offset != -1 && l7_offset < packet.cap_length) {
-        int app_len = packet.cap_length - l7_offset;
+    if (l7_offset != -1 && (l7_offset < packet.cap_length || !packet.reassembled.empty())) {
+        int app_len = packet.reassembled.empty() ? packet.cap_length - l7_offset : packet.payload_length;
         QTreeWidgetItem *app = new QTreeWidgetItem(root);
         app->setText(0, QString::fromStdString("Application: " + packet.app.protocol));
         app->setData(0, Qt::UserRole + 1, l7_offset);
@@ -154,6 +204,43 @@ void PacketFormatter::populateTree(QTreeWidget* tree, const PacketData& packet)
         if (!packet.app.info.empty()) {
             addField(app, "Info", QString::fromStdString(packet.app.info));
         }
+        if (packet.is_reassembled_pdu) {
+            addField(app, "[Reassembled PDU]", "Dissected from multiple TCP segments");
+        }
+
+        // --- Chi tiết TLS handshake ---
+        if (packet.app.protocol == "TLS") {
+            if (!packet.app.tls_sni.empty()) {
+                addField(app, "Server Name", QString::fromStdString(packet.app.tls_sni));
+            }
+            if (!packet.app.tls_alpn.empty()) {
+                addField(app, "ALPN", QString::fromStdString(packet.app.tls_alpn));
+            }
+            if (packet.app.tls_selected_version != 0) {
+                addField(app, "Selected Version", toHex(packet.app.tls_selected_version));
+            }
+            if (!packet.app.tls_cipher_suites.empty()) {
+                addField(app, "Cipher Suites", QString("%1 suites").arg(packet.app.tls_cipher_suites.size()));
+            }
+            if (!packet.app.tls_ja3_hash.empty()) {
+                addField(app, "JA3", QString::fromStdString(packet.app.tls_ja3_hash));
+            }
+            if (!packet.app.tls_ja4.empty()) {
+                addField(app, "JA4", QString::fromStdString(packet.app.tls_ja4));
+            }
+        }
+    }
+
+    // Datagram ghép từ nhiều mảnh: header Tầng 4+ không nằm trong frame này -> bỏ highlight
+    if (!packet.reassembled.empty()) {
+        std::function<void(QTreeWidgetItem*)> clearHighlight = [&](QTreeWidgetItem* item) {
+            item->setData(0, Qt::UserRole + 1, QVariant());
+            item->setData(0, Qt::UserRole + 2, QVariant());
+            for (int i = 0; i < item->childCount(); ++i) clearHighlight(item->child(i));
+        };
+        for (int i = firstUpperLayerItem; i < root->childCount(); ++i) {
+            clearHighlight(root->child(i));
+        }
     }
 
     tree->expandAll();
@@ -234,19 +321,41 @@ QColor PacketFormatter::getRowColor(const QString& proto) {
 
 QString PacketFormatter::formatTime(const struct timespec& ts) {
     char timeStr[64];
-    struct tm *tm_info = localtime(&ts.tv_sec);
-    strftime(timeStr, sizeof(timeStr), "%H:%M:%S", tm_info);
+    struct tm tm_info;
+    localtime_r(&ts.tv_sec, &tm_info); // Có thể gọi ngoài luồng GUI: không dùng bộ đệm tĩnh của localtime()
+    strftime(timeStr, sizeof(timeStr), "%H:%M:%S", &tm_info);
 
     // timespec dùng tv_nsec (nanosecond), chia 1.000.000 để ra millisecond
     return QString("%1.%2").arg(timeStr).arg(ts.tv_nsec / 1000000, 3, 10, QChar('0'));
 }
 
+PacketRow PacketFormatter::makeRow(const PacketData& packet) {
+    PacketRow row;
+    row.packet_id = packet.packet_id;
+
+    const QString proto = getProtocolName(packet);
+    row.cells[PacketRow::COL_NO] = QString::number(packet.packet_id);
+    row.cells[PacketRow::COL_TIME] = formatTime(packet.timestamp);
+    row.cells[PacketRow::COL_SOURCE] = getSource(packet);
+    row.cells[PacketRow::COL_DEST] = getDest(packet);
+    row.cells[PacketRow::COL_PROTOCOL] = proto;
+    row.cells[PacketRow::COL_LENGTH] = QString::number(packet.wire_length);
+    row.cells[PacketRow::COL_FLAGS] = getTcpAnalysisFlags(packet);
+    row.cells[PacketRow::COL_INFO] = getInfo(packet);
+
+    // "Bad TCP": nền tối, chữ đỏ (giống Wireshark)
+    row.bad_tcp = packet.is_tcp && (packet.tcp_analysis.flags & TCPAnalysis::PROBLEM_MASK);
+    row.background = row.bad_tcp ? QColor(18, 39, 46) : getRowColor(proto);
+    return row;
+}
+
 QString PacketFormatter::getProtocolName(const PacketData& p) {
     if (!p.app.protocol.empty()) return QString::fromStdString(p.app.protocol);
     if (p.is_tcp) return "TCP";
     if (p.is_udp) return "UDP";
     if (p.is_icmp) return "ICMP";
     if (p.is_arp) return "ARP";
+    if (p.is_malformed) return "Malformed";
     return QString("0x%1").arg(p.eth.ether_type, 4, 16, QChar('0')).toUpper();
 }
 
@@ -264,9 +373,57 @@ QString PacketFormatter::getDest(const PacketData& p) {
     return getResolvedMacLabel(macToString(p.eth.dest_mac));
 }
 
+QString PacketFormatter::getTcpAnalysisFlags(const PacketData& p) {
+    if (!p.is_tcp || p.tcp_analysis.flags == 0) return QString();
+    static const struct { uint16_t flag; const char* text; } kShort[] = {
+        { TCPAnalysis::FAST_RETRANSMISSION, "FastRetr" },
+        { TCPAnalysis::RETRANSMISSION,      "Retr" },
+        { TCPAnalysis::OUT_OF_ORDER,        "OoO" },
+        { TCPAnalysis::LOST_SEGMENT,        "Lost" },
+        { TCPAnalysis::ACKED_UNSEEN,        "AckUnseen" },
+        { TCPAnalysis::DUPLICATE_ACK,       "DupACK" },
+        { TCPAnalysis::ZERO_WINDOW,         "ZeroWin" },
+        { TCPAnalysis::WINDOW_FULL,         "WinFull" },
+        { TCPAnalysis::WINDOW_UPDATE,       "WinUpd" },
+        { TCPAnalysis::KEEP_ALIVE,          "KeepAlive" },
+    };
+    QStringList parts;
+    for (const auto& s : kShort) {
+        if (!p.tcp_analysis.has(s.flag)) continue;
+        if (s.flag == TCPAnalysis::RETRANSMISSION && p.tcp_analysis.has(TCPAnalysis::FAST_RETRANSMISSION)) continue;
+        parts << s.text;
+    }
+    return parts.join(", ");
+}
+
+QString PacketFormatter::getTcpAnalysisLabel(const PacketData& p) {
+    if (!p.is_tcp) return QString();
+    const TCPAnalysis& a = p.tcp_analysis;
+    // Theo thứ tự ưu tiên (chỉ hiện nhãn quan trọng nhất)
+    if (a.has(TCPAnalysis::FAST_RETRANSMISSION)) return "TCP Fast Retransmission";
+    if (a.has(TCPAnalysis::RETRANSMISSION))      return "TCP Retransmission";
+    if (a.has(TCPAnalysis::OUT_OF_ORDER))        return "TCP Out-Of-Order";
+    if (a.has(TCPAnalysis::KEEP_ALIVE))          return "TCP Keep-Alive";
+    if (a.has(TCPAnalysis::DUPLICATE_ACK))
+        return QString("TCP Dup ACK %1#%2").arg(a.dup_ack_frame).arg(a.dup_ack_num);
+    if (a.has(TCPAnalysis::ZERO_WINDOW))         return "TCP ZeroWindow";
+    if (a.has(TCPAnalysis::WINDOW_FULL))         return "TCP Window Full";
+    if (a.has(TCPAnalysis::WINDOW_UPDATE))       return "TCP Window Update";
+    if (a.has(TCPAnalysis::LOST_SEGMENT))        return "TCP Previous segment not captured";
+    if (a.has(TCPAnalysis::ACKED_UNSEEN))        return "TCP ACKed unseen segment";
+    return QString();
+}
+
 QString PacketFormatter::getInfo(const PacketData& p) {
+    const QString analysis = getTcpAnalysisLabel(p);
+    const QString prefix = analysis.isEmpty() ? QString() : QString("[%1] ").arg(analysis);
+
     if (!p.app.info.empty()) {
-        return QString::fromStdString(p.app.info);
+        QString info = prefix + QString::fromStdString(p.app.info);
+        if (p.is_ip_fragment && p.fragment_ids.empty() && p.reassembled_in != 0) {
+            info += QString(" [Reassembled in #%1]").arg(p.reassembled_in);
+        }
+        return info;
     }
 
     if (p.app.is_http_request) {
@@ -280,7 +437,7 @@ QString PacketFormatter::getInfo(const PacketData& p) {
     }
 
     if (p.is_tcp) {
-        QString info = QString("%1 → %2 ")
+        QString info = prefix + QString("%1 → %2 ")
                            .arg(p.tcp.src_port)
                            .arg(p.tcp.dest_port);
         QString f;
@@ -298,13 +455,7 @@ QString PacketFormatter::getInfo(const PacketData& p) {
                     .arg(p.tcp.ack_num)
                     .arg(p.tcp.window);
 
-        int payload_len = 0;
-        if (p.is_ipv4) {
-            int ip_total_len = p.ipv4.total_length;
-            int ip_header_len = p.ipv4.ihl * 4;
-            int tcp_header_len = p.tcp.data_offset * 4;
-            payload_len = ip_total_len - ip_header_len - tcp_header_len;
-        }
+        int payload_len = static_cast<int>(p.payload_length);
 
         info += QString(" Len=%1").arg(payload_len);
 
@@ -352,6 +503,7 @@ QString PacketFormatter::getInfo(const PacketData& p) {
         return info;
     }
 
+    if (p.is_malformed) return QString("[Malformed Packet] Len=%1").arg(p.cap_length);
     return QString("Len=%1").arg(p.cap_length);
 }
 
@@ -7,10 +7,27 @@
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <array>
 #include "../../Common/PacketData.hpp"
 
+/**
+ * @brief Một dòng của bảng gói đã định dạng (PacketListModel tạo khi dòng hiện lên màn hình).
+ * Gói gốc không đi kèm: packet_id là tham chiếu tới danh sách gói chính.
+ */
+struct PacketRow {
+    enum Column { COL_NO, COL_TIME, COL_SOURCE, COL_DEST, COL_PROTOCOL, COL_LENGTH, COL_FLAGS, COL_INFO, COL_COUNT };
+
+    quint32 packet_id = 0;
+    std::array<QString, COL_COUNT> cells;
+    QColor background;
+    bool bad_tcp = false;    // "Bad TCP": chữ đỏ
+};
+
 class PacketFormatter {
 public:
+    // Định dạng các cột của bảng gói (an toàn khi gọi ngoài luồng GUI)
+    static PacketRow makeRow(const PacketData& packet);
+
     static void populateTree(QTreeWidget* tree, const PacketData& packet);
     static void displayHexDump(QTextEdit* textEdit, const PacketData& packet, int hl_offset = -1, int hl_len = 0);
 
@@ -21,6 +38,9 @@ public:
     static QString getSource(const PacketData& p);
     static QString getDest(const PacketData& p);
     static QString getInfo(const PacketData& p);
+    static QString getTcpAnalysisFlags(const PacketData& p); // Cột "Flags": nhãn ngắn, vd "Retr, DupACK"
+    static QString getTcpAnalysisLabel(const PacketData& p); // Nhãn chính cho cột Info, vd "TCP Retransmission"
+
     static QColor getRowColor(const QString& proto);
 
 private:
@@ -0,0 +1,207 @@
+#include "PacketListModel.hpp"
+#include <QColor>
+#include <QCoreApplication>
+#include <QPointer>
+#include <algorithm>
+#include <utility>
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Số dòng đã định dạng giữ lại (vài màn hình); đầy thì xóa hết và định dạng lại khi cần
+static const int ROW_CACHE_SIZE = 2048;
+
+static const char* const HEADERS[PacketRow::COL_COUNT] = {
+    "No.", "Time", "Source", "Destination", "Protocol", "Length", "Flags", "Info"
+};
+
+// --- Triển khai (Implementation) ---
+
+PacketListModel::PacketListModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void PacketListModel::setPacketLookup(PacketLookup lookup)
+{
+    m_lookup = std::move(lookup);
+    m_rowCache.clear();
+}
+
+void PacketListModel::setPacketSorter(PacketSorter sorter)
+{
+    m_sorter = std::move(sorter);
+}
+
+int PacketListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_ids.size());
+}
+
+int PacketListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : PacketRow::COL_COUNT;
+}
+
+QVariant PacketListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    if (section < 0 || section >= PacketRow::COL_COUNT) return QVariant();
+    return QString(HEADERS[section]);
+}
+
+QVariant PacketListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(m_ids.size())) return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return rowAt(index.row())->cells[index.column()];
+    case Qt::BackgroundRole: {
+        const QColor& background = rowAt(index.row())->background;
+        return background.isValid() ? QVariant(background) : QVariant();
+    }
+    case Qt::ForegroundRole:
+        // "Bad TCP": chữ đỏ
+        return rowAt(index.row())->bad_tcp ? QVariant(QColor(247, 135, 135)) : QVariant();
+    }
+    return QVariant();
+}
+
+const PacketRow* PacketListModel::rowAt(int row) const
+{
+    const quint32 packetId = m_ids[row];
+    auto it = m_rowCache.constFind(packetId);
+    if (it != m_rowCache.constEnd()) return &it.value();
+
+    if (m_rowCache.size() >= ROW_CACHE_SIZE) m_rowCache.clear();
+    PacketData packet;
+    PacketRow formatted;
+    if (m_lookup && m_lookup(packetId, packet)) {
+        formatted = PacketFormatter::makeRow(packet);
+    } else {
+        // Gói không còn (đang xóa phiên): chỉ hiện số thứ tự
+        formatted.packet_id = packetId;
+        formatted.cells[PacketRow::COL_NO] = QString::number(packetId);
+    }
+    return &m_rowCache.insert(packetId, std::move(formatted)).value();
+}
+
+void PacketListModel::appendPackets(const QList<quint32>& packetIds)
+{
+    if (packetIds.isEmpty()) return;
+    const int first = static_cast<int>(m_ids.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(packetIds.size()) - 1);
+    m_ids.insert(m_ids.end(), packetIds.begin(), packetIds.end());
+    endInsertRows();
+}
+
+void PacketListModel::clear()
+{
+    beginResetModel();
+    ++m_sortGeneration;                 // Job sắp xếp đang chạy thuộc phiên trước
+    std::vector<quint32>().swap(m_ids); // Trả bộ nhớ của phiên trước
+    m_rowCache.clear();
+    endResetModel();
+}
+
+quint32 PacketListModel::packetIdAt(int row) const
+{
+    return (row >= 0 && row < static_cast<int>(m_ids.size())) ? m_ids[row] : 0;
+}
+
+bool PacketListModel::packetAt(int row, PacketData& out) const
+{
+    const quint32 packetId = packetIdAt(row);
+    return packetId != 0 && m_lookup && m_lookup(packetId, out);
+}
+
+bool PacketListModel::inCaptureOrder() const
+{
+    return m_sortColumn < 0 || (m_sortColumn == PacketRow::COL_NO && m_sortOrderValue == Qt::AscendingOrder);
+}
+
+int PacketListModel::rowForPacket(quint32 packetId) const
+{
+    // Thứ tự bắt gói: packet_id tăng dần nên tìm nhị phân
+    if (inCaptureOrder()) {
+        auto it = std::lower_bound(m_ids.begin(), m_ids.end(), packetId);
+        return it == m_ids.end() ? -1 : static_cast<int>(it - m_ids.begin());
+    }
+    int target = -1;
+    quint32 bestId = 0;
+    for (size_t row = 0; row < m_ids.size(); ++row) {
+        const quint32 id = m_ids[row];
+        if (id == packetId) return static_cast<int>(row);
+        if (id > packetId && (bestId == 0 || id < bestId)) {
+            bestId = id;
+            target = static_cast<int>(row);
+        }
+    }
+    return target;
+}
+
+void PacketListModel::sort(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrderValue = order;
+    const quint64 generation = ++m_sortGeneration;
+
+    if (column < 0 || column == PacketRow::COL_NO) {
+        // Không cần tra gói: sắp trực tiếp theo packet_id
+        std::vector<quint32> ids = m_ids;
+        if (column < 0 || order == Qt::AscendingOrder) std::sort(ids.begin(), ids.end());
+        else std::sort(ids.begin(), ids.end(), std::greater<quint32>());
+        applyOrder(std::move(ids));
+        return;
+    }
+    if (!m_sorter) return;
+
+    // Khóa được tính trên luồng nền; luồng GUI chỉ nhận lại mảng packet_id đã hoán vị.
+    // Trong lúc chờ, rowForPacket() tìm tuần tự (đúng với mọi thứ tự)
+    const size_t sortedCount = m_ids.size();
+    QPointer<PacketListModel> model(this);
+    m_sorter(m_ids, column, order, [model, generation, sortedCount](std::vector<quint32> sorted) {
+        // QCoreApplication luôn còn sống; model có thể đã bị hủy (kiểm tra trên luồng GUI)
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [model, generation, sortedCount,
+                                                                 sorted = std::move(sorted)]() mutable {
+            if (model) model->finishSort(generation, sortedCount, std::move(sorted));
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PacketListModel::finishSort(quint64 generation, size_t sortedCount, std::vector<quint32> sorted)
+{
+    // Đã sắp xếp lại / xóa bảng sau khi job bắt đầu: bỏ kết quả
+    if (generation != m_sortGeneration || sorted.size() != sortedCount || m_ids.size() < sortedCount) return;
+    sorted.insert(sorted.end(), m_ids.begin() + static_cast<std::ptrdiff_t>(sortedCount), m_ids.end());
+    applyOrder(std::move(sorted));
+}
+
+void PacketListModel::applyOrder(std::vector<quint32> ids)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    const QModelIndexList persistent = persistentIndexList();
+    std::vector<quint32> persistentIds;
+    persistentIds.reserve(persistent.size());
+    for (const QModelIndex& idx : persistent) persistentIds.push_back(m_ids[idx.row()]);
+
+    m_ids = std::move(ids);
+
+    // Giữ vùng chọn: ánh xạ lại theo packet_id
+    if (!persistent.isEmpty()) {
+        QHash<quint32, int> rowOf;
+        for (quint32 id : persistentIds) rowOf.insert(id, -1);
+        for (size_t i = 0; i < m_ids.size(); ++i) {
+            auto it = rowOf.find(m_ids[i]);
+            if (it != rowOf.end()) it.value() = static_cast<int>(i);
+        }
+        QModelIndexList updated;
+        updated.reserve(persistent.size());
+        for (int i = 0; i < persistent.size(); ++i) {
+            const int row = rowOf.value(persistentIds[i], -1);
+            updated.append(row < 0 ? QModelIndex() : index(row, persistent[i].column()));
+        }
+        changePersistentIndexList(persistent, updated);
+    }
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
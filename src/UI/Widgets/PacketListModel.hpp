@@ -0,0 +1,69 @@
+#ifndef PACKETLISTMODEL_HPP
+#define PACKETLISTMODEL_HPP
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QList>
+#include <functional>
+#include <vector>
+#include "../../Common/PacketData.hpp"
+#include "PacketFormatter.hpp"
+
+/**
+ * @brief Model ảo (virtualized) của bảng gói cho QTableView.
+ *
+ * Chỉ giữ packet_id của các dòng (4 byte mỗi dòng); view chỉ hỏi các dòng đang hiển thị,
+ * và dòng được định dạng khi cần từ gói gốc (PacketStore / cửa sổ đọc từ file) qua PacketLookup.
+ * Một bộ đệm nhỏ giữ các dòng vừa định dạng để vẽ lại không phải tra gói lần nữa.
+ * Sắp xếp theo No. (hoặc bỏ sắp xếp, cột -1) chỉ sắp mảng packet_id trên luồng GUI. Các cột khác
+ * được giao cho PacketSorter (luồng nền), model chỉ nhận lại mảng packet_id đã hoán vị;
+ * dòng đến trong lúc / sau khi sắp xếp được thêm vào cuối.
+ */
+class PacketListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    // Tra gói gốc theo packet_id; false nếu không còn
+    using PacketLookup = std::function<bool(quint32 packetId, PacketData& out)>;
+    // Gọi trên luồng GUI: sắp packetIds theo cột trên luồng nền rồi gọi done(kết quả) từ luồng đó
+    // (cùng khóa thì giữ thứ tự bắt gói)
+    using SortDone = std::function<void(std::vector<quint32> sorted)>;
+    using PacketSorter = std::function<void(std::vector<quint32> packetIds, int column, Qt::SortOrder order,
+                                            SortDone done)>;
+
+    explicit PacketListModel(QObject *parent = nullptr);
+
+    void setPacketLookup(PacketLookup lookup);
+    void setPacketSorter(PacketSorter sorter);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void appendPackets(const QList<quint32>& packetIds);
+    void clear();
+
+    quint32 packetIdAt(int row) const;
+    bool packetAt(int row, PacketData& out) const;
+    // Dòng của gói, hoặc dòng có số nhỏ nhất lớn hơn nó (gói bị lọc); -1 nếu không có
+    int rowForPacket(quint32 packetId) const;
+
+private:
+    const PacketRow* rowAt(int row) const;
+    bool inCaptureOrder() const;
+    void applyOrder(std::vector<quint32> ids);
+    void finishSort(quint64 generation, size_t sortedCount, std::vector<quint32> sorted);
+
+    std::vector<quint32> m_ids;              // Dòng hiển thị -> packet_id
+    PacketLookup m_lookup;
+    PacketSorter m_sorter;
+    mutable QHash<quint32, PacketRow> m_rowCache;
+
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrderValue = Qt::AscendingOrder;
+    quint64 m_sortGeneration = 0;            // Tăng khi sắp xếp / xóa: kết quả của job cũ bị bỏ
+};
+
+#endif // PACKETLISTMODEL_HPP
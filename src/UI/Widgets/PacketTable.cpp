@@ -3,7 +3,7 @@
 #include "PacketFormatter.hpp"
 #include <QVBoxLayout>
 #include <QSplitter>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTreeWidget>
 #include <QTextEdit>
 #include <QHeaderView>
@@ -11,7 +11,6 @@
 #include <QMenu>
 #include <QTimer>
 
-const int CHUNK_SIZE = 500;
 const int TIMER_INTERVAL_MS = 30;
 
 PacketTable::PacketTable(QWidget *parent) : QWidget(parent)
@@ -20,10 +19,10 @@ PacketTable::PacketTable(QWidget *parent) : QWidget(parent)
 
     // Setup Context Menu
     packetList->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(packetList, &QTableWidget::customContextMenuRequested, this, &PacketTable::showContextMenu);
+    connect(packetList, &QTableView::customContextMenuRequested, this, &PacketTable::showContextMenu);
 
     // Click Events
-    connect(packetList, &QTableWidget::itemClicked, this, &PacketTable::onPacketRowSelected);
+    connect(packetList, &QTableView::clicked, this, &PacketTable::onPacketRowSelected);
     connect(packetDetails, &QTreeWidget::itemClicked, this, &PacketTable::onDetailRowSelected);
 
     // Timer Update
@@ -42,16 +41,20 @@ PacketTable::PacketTable(QWidget *parent) : QWidget(parent)
 void PacketTable::setupUI()
 {
     QVBoxLayout *layout = new QVBoxLayout(this);
-    packetList = new QTableWidget(this);
+    packetList = new QTableView(this);
+    m_model = new PacketListModel(this);
+    packetList->setModel(m_model);
 
-    packetList->setColumnCount(8);
-    QStringList headers = {"No.", "Time", "Source", "Destination", "Protocol", "Length", "Info"};
-    packetList->setHorizontalHeaderLabels(headers);
     packetList->horizontalHeader()->setStretchLastSection(true);
     packetList->setSelectionBehavior(QAbstractItemView::SelectRows);
     packetList->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    packetList->hideColumn(7); // Cột ẩn chứa dữ liệu
     packetList->verticalHeader()->setVisible(false);
+    // Mọi dòng cao như nhau: view không phải hỏi kích thước từng dòng
+    packetList->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    // Bắt đầu theo thứ tự bắt gói; bấm lại lần ba vào tiêu đề cột để bỏ sắp xếp
+    packetList->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    packetList->horizontalHeader()->setSortIndicatorClearable(true);
+    packetList->setSortingEnabled(true);
 
     packetDetails = new QTreeWidget(this);
     packetDetails->setHeaderLabel("Packet Details");
@@ -77,104 +80,59 @@ void PacketTable::setupUI()
 
 void PacketTable::clearData()
 {
-    packetList->setRowCount(0);
+    m_model->clear();
     packetDetails->clear();
     packetBytes->clear();
-    m_packetBuffer.clear();
-    m_allPackets.clear();
+    m_idBuffer.clear();
+    m_pendingSelectId = 0;
 }
 
-void PacketTable::applyFilter(const QString& filterText)
+void PacketTable::onRowsReceived(QList<quint32>* packetIds)
 {
-    m_currentFilter = filterText;
-    refreshTable();
-}
-
-void PacketTable::refreshTable()
-{
-    packetList->setUpdatesEnabled(false);
-    packetList->setSortingEnabled(false);
-    packetList->setRowCount(0);
-
-    for (const auto& packet : m_allPackets) {
-        if (m_filterEngine.match(packet, m_currentFilter)) {
-            insertPacketRow(packet);
-        }
-    }
-
-    packetList->setSortingEnabled(true);
-    packetList->setUpdatesEnabled(true);
-    if (m_isUserAtBottom) packetList->scrollToBottom();
-}
-
-void PacketTable::onPacketReceived(const PacketData &packet)
-{
-    m_allPackets.append(packet);
-    m_packetBuffer.append(packet);
-}
-
-void PacketTable::onPacketsReceived(QList<PacketData>* packets)
-{
-    m_allPackets.append(*packets);
-    m_packetBuffer.append(std::move(*packets));
-    delete packets;
+    m_idBuffer.append(*packetIds);
+    delete packetIds;
 }
 
 void PacketTable::processPacketChunk()
 {
-    if (m_packetBuffer.isEmpty()) return;
+    if (m_idBuffer.isEmpty()) return;
 
-    packetList->setUpdatesEnabled(false);
-    packetList->setSortingEnabled(false);
+    // Model chỉ nối thêm packet_id: chèn cả bộ đệm một lần, view chỉ vẽ các dòng đang hiện
+    m_model->appendPackets(m_idBuffer);
+    m_idBuffer.clear();
 
-    int packetsToProcess = qMin(CHUNK_SIZE, (int)m_packetBuffer.size());
-    for (int i = 0; i < packetsToProcess; ++i) {
-        insertPacketRow(m_packetBuffer.takeFirst());
+    if (m_pendingSelectId != 0) {
+        selectPendingPacket();
+    } else if (m_isUserAtBottom) {
+        packetList->scrollToBottom();
     }
-
-    packetList->setSortingEnabled(true);
-    packetList->setUpdatesEnabled(true);
-
-    if (m_isUserAtBottom) packetList->scrollToBottom();
 }
 
-void PacketTable::insertPacketRow(const PacketData &packet)
+void PacketTable::selectPacket(quint32 packetId)
 {
-    int row = packetList->rowCount();
-    packetList->insertRow(row);
-
-    QString proto = PacketFormatter::getProtocolName(packet);
-
-    QList<QTableWidgetItem*> items = {
-        new QTableWidgetItem(QString::number(packet.packet_id)),
-        new QTableWidgetItem(PacketFormatter::formatTime(packet.timestamp)),
-        new QTableWidgetItem(PacketFormatter::getSource(packet)),
-        new QTableWidgetItem(PacketFormatter::getDest(packet)),
-        new QTableWidgetItem(proto),
-        new QTableWidgetItem(QString::number(packet.wire_length)),
-        new QTableWidgetItem(PacketFormatter::getInfo(packet))
-    };
-
-    QColor color = PacketFormatter::getRowColor(proto);
-
-    for(int i = 0; i < items.size(); ++i) {
-        items[i]->setBackground(color);
-        packetList->setItem(row, i, items[i]);
-    }
-
-    QTableWidgetItem* hidden = new QTableWidgetItem();
-    hidden->setData(Qt::UserRole, QVariant::fromValue(packet));
-    hidden->setFlags(Qt::NoItemFlags);
-    packetList->setItem(row, 7, hidden);
+    m_pendingSelectId = packetId;
+    selectPendingPacket();
 }
 
-void PacketTable::onPacketRowSelected(QTableWidgetItem *item)
+void PacketTable::selectPendingPacket()
 {
-    if (!item) return;
-    QTableWidgetItem *hidden = packetList->item(item->row(), 7);
-    if (!hidden) return;
+    // Dòng khớp đúng, hoặc dòng có số nhỏ nhất lớn hơn (gói đích bị display filter loại)
+    const int target = m_model->rowForPacket(m_pendingSelectId);
+    // Chưa thấy đúng gói mà còn dòng trong bộ đệm: chờ lần chèn sau
+    if (target < 0 || (m_model->packetIdAt(target) != m_pendingSelectId && !m_idBuffer.isEmpty())) return;
+
+    m_pendingSelectId = 0;
+    m_isUserAtBottom = false;
+    packetList->selectRow(target);
+    const QModelIndex index = m_model->index(target, 0);
+    packetList->scrollTo(index, QAbstractItemView::PositionAtCenter);
+    onPacketRowSelected(index);
+}
 
-    m_currentSelectedPacket = hidden->data(Qt::UserRole).value<PacketData>();
+void PacketTable::onPacketRowSelected(const QModelIndex &index)
+{
+    if (!index.isValid()) return;
+    if (!m_model->packetAt(index.row(), m_currentSelectedPacket)) return;
 
     PacketFormatter::populateTree(packetDetails, m_currentSelectedPacket);
     PacketFormatter::displayHexDump(packetBytes, m_currentSelectedPacket);
@@ -195,12 +153,11 @@ void PacketTable::onDetailRowSelected(QTreeWidgetItem *item, int column)
 
 void PacketTable::showContextMenu(const QPoint &pos)
 {
-    QTableWidgetItem *item = packetList->itemAt(pos);
-    if (!item) return;
+    const QModelIndex index = packetList->indexAt(pos);
+    if (!index.isValid()) return;
 
-    QTableWidgetItem *hidden = packetList->item(item->row(), 7);
-    PacketData packet = hidden->data(Qt::UserRole).value<PacketData>();
-    if (packet.stream_index < 0) return;
+    PacketData packet;
+    if (!m_model->packetAt(index.row(), packet) || packet.stream_index < 0) return;
 
     QMenu contextMenu(this);
     QString streamName = (packet.app.protocol == "QUIC") ? "QUIC" : "TCP/UDP";
@@ -208,6 +165,9 @@ void PacketTable::showContextMenu(const QPoint &pos)
 
     connect(actionFollow, &QAction::triggered, [this, packet]() {
         emit filterRequested(QString("stream == %1").arg(packet.stream_index));
+        if (packet.is_tcp) {
+            emit followTcpStreamRequested(packet);
+        }
     });
 
     contextMenu.exec(packetList->viewport()->mapToGlobal(pos));
@@ -5,13 +5,14 @@
 #include <QList>
 #include <QTimer>
 #include <QTreeWidget>
+#include <functional>
 #include "../../Common/PacketData.hpp"
-#include "../../Controller/ControllerLib/DisplayFilterEngine.hpp"
+#include "PacketFormatter.hpp"
+#include "PacketListModel.hpp"
 
 // Forward declarations
-class QTableWidget;
+class QTableView;
 class QTextEdit;
-class QTableWidgetItem;
 class QTreeWidgetItem;
 
 class PacketTable : public QWidget
@@ -19,38 +20,49 @@ class PacketTable : public QWidget
     Q_OBJECT
 
 public:
+    // Tra gói gốc theo packet_id (bảng chỉ giữ packet_id, dòng được định dạng khi hiển thị)
+    using PacketLookup = PacketListModel::PacketLookup;
+    using PacketSorter = PacketListModel::PacketSorter;
+
     explicit PacketTable(QWidget *parent = nullptr);
 
+    void setPacketLookup(PacketLookup lookup) { m_model->setPacketLookup(std::move(lookup)); }
+    void setPacketSorter(PacketSorter sorter) { m_model->setPacketSorter(std::move(sorter)); }
+
 signals:
     // Bắn tín hiệu khi chọn "Follow Stream"
     void filterRequested(const QString &filterText);
+    // Bắn tín hiệu khi chọn "Follow TCP Stream" (mở cửa sổ dữ liệu đã ghép)
+    void followTcpStreamRequested(const PacketData &packet);
 
 public slots:
-    // Nhận dữ liệu
-    void onPacketReceived(const PacketData &packet);
-    void onPacketsReceived(QList<PacketData>* packets);
+    // Nhận lô packet_id của các gói khớp display filter (từ luồng xử lý)
+    void onRowsReceived(QList<quint32>* packetIds);
 
     // Xử lý dữ liệu
     void clearData();
-    void applyFilter(const QString& filterText);
+
+    // Chọn (và cuộn tới) dòng của gói. Dòng chưa được chèn (còn trong bộ đệm) thì chọn khi tới lượt;
+    // gói không có trong bảng (bị lọc) thì chọn dòng kế tiếp sau nó.
+    void selectPacket(quint32 packetId);
 
 private slots:
     // Slot nội bộ
     void processPacketChunk();
-    void onPacketRowSelected(QTableWidgetItem *item);
+    void onPacketRowSelected(const QModelIndex &index);
     void onDetailRowSelected(QTreeWidgetItem *item, int column);
 
 private:
     // UI Setup & Logic hiển thị bảng
     void setupUI();
     void showContextMenu(const QPoint &pos);
-    void refreshTable();
-    void insertPacketRow(const PacketData& packet);
+    void selectPendingPacket();
 
 
 private:
     // --- UI COMPONENTS ---
-    QTableWidget *packetList;
+    QTableView *packetList;
+    PacketListModel *m_model;
     QTreeWidget *packetDetails;
     QTextEdit *packetBytes;
 
@@ -58,14 +70,10 @@ private:
     PacketData m_currentSelectedPacket;
 
     // --- BUFFER & TIMER (Anti-lag) ---
-    QList<PacketData> m_packetBuffer;
+    QList<quint32> m_idBuffer;       // Gộp các lô đến giữa hai lần vẽ thành một lần chèn
     QTimer* m_updateTimer;
     bool m_isUserAtBottom = true;
-
-    // --- DISPLAY FILTER DATA ---
-    QList<PacketData> m_allPackets;      // Kho lưu trữ gốc
-    QString m_currentFilter;             // Filter text hiện tại
-    DisplayFilterEngine m_filterEngine;  // Engine lọc
+    quint32 m_pendingSelectId = 0;   // Gói cần chọn khi dòng của nó được chèn (0 = không có)
 };
 
 #endif // PACKETTABLE_HPP
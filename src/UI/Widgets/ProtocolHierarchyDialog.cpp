@@ -0,0 +1,108 @@
+#include "ProtocolHierarchyDialog.hpp"
+#include "../../Controller/StatisticsManager.hpp"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QHeaderView>
+
+// Cột của cây
+enum HierarchyColumn {
+    COL_PROTOCOL,
+    COL_PERCENT_PACKETS,
+    COL_PACKETS,
+    COL_PERCENT_BYTES,
+    COL_BYTES
+};
+
+// --- Triển khai (Implementation) ---
+
+ProtocolHierarchyDialog::ProtocolHierarchyDialog(StatisticsManager* manager, QWidget *parent)
+    : QDialog(parent),
+    m_manager(manager)
+{
+    setupUi();
+    setWindowTitle("Protocol Hierarchy (Live)");
+    resize(700, 450);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    m_updateTimer = new QTimer(this);
+    m_updateTimer->setInterval(1000); // 1 giây
+    connect(m_updateTimer, &QTimer::timeout, this, &ProtocolHierarchyDialog::onUpdateTimerTimeout);
+}
+
+void ProtocolHierarchyDialog::setupUi()
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+
+    m_summaryLabel = new QLabel("Total Packets: 0", this);
+    m_summaryLabel->setStyleSheet("font-weight: bold;");
+    layout->addWidget(m_summaryLabel);
+
+    m_tree = new QTreeWidget(this);
+    m_tree->setHeaderLabels({"Protocol", "Percent Packets", "Packets", "Percent Bytes", "Bytes"});
+    m_tree->header()->setSectionResizeMode(COL_PROTOCOL, QHeaderView::Stretch);
+    m_tree->setSortingEnabled(true);
+    m_tree->sortByColumn(COL_PACKETS, Qt::DescendingOrder);
+    layout->addWidget(m_tree);
+    setLayout(layout);
+}
+
+void ProtocolHierarchyDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    onUpdateTimerTimeout();
+    m_updateTimer->start();
+}
+
+void ProtocolHierarchyDialog::closeEvent(QCloseEvent *event)
+{
+    m_updateTimer->stop();
+    QDialog::closeEvent(event);
+}
+
+void ProtocolHierarchyDialog::onUpdateTimerTimeout()
+{
+    const ProtocolHierarchy& hierarchy = m_manager->protocolHierarchy();
+    if (hierarchy.revision() == m_drawnRevision && !m_items.isEmpty()) return;
+    m_drawnRevision = hierarchy.revision();
+
+    const std::vector<ProtocolHierarchy::Node>& nodes = hierarchy.nodes();
+
+    // 1. Cây đã bị clear() (phiên bắt mới): dựng lại từ đầu
+    if (static_cast<qsizetype>(nodes.size()) < m_items.size()) {
+        m_tree->clear();
+        m_items.clear();
+    }
+
+    // 2. Thêm dòng cho các nút mới (nút cha luôn có chỉ số nhỏ hơn nút con)
+    for (qsizetype i = m_items.size(); i < static_cast<qsizetype>(nodes.size()); ++i) {
+        const ProtocolHierarchy::Node& node = nodes[i];
+        QTreeWidgetItem* item = node.parent < 0 ? new QTreeWidgetItem(m_tree)
+                                                : new QTreeWidgetItem(m_items[node.parent]);
+        item->setText(COL_PROTOCOL, protocolIdName(node.id));
+        for (int col = COL_PERCENT_PACKETS; col <= COL_BYTES; ++col) {
+            item->setTextAlignment(col, Qt::AlignRight | Qt::AlignVCenter);
+        }
+        item->setExpanded(true);
+        m_items.append(item);
+    }
+
+    // 3. Cập nhật số (phần trăm so với tổng ở nút gốc)
+    const double totalPackets = static_cast<double>(nodes[0].packets);
+    const double totalBytes = static_cast<double>(nodes[0].bytes);
+    m_tree->setUpdatesEnabled(false);
+    for (qsizetype i = 0; i < static_cast<qsizetype>(nodes.size()); ++i) {
+        const ProtocolHierarchy::Node& node = nodes[i];
+        QTreeWidgetItem* item = m_items[i];
+        item->setText(COL_PERCENT_PACKETS, totalPackets > 0
+                          ? QString::number(node.packets * 100.0 / totalPackets, 'f', 2) + "%" : QString("0.00%"));
+        item->setData(COL_PACKETS, Qt::DisplayRole, static_cast<qulonglong>(node.packets));
+        item->setText(COL_PERCENT_BYTES, totalBytes > 0
+                          ? QString::number(node.bytes * 100.0 / totalBytes, 'f', 2) + "%" : QString("0.00%"));
+        item->setData(COL_BYTES, Qt::DisplayRole, static_cast<qulonglong>(node.bytes));
+    }
+    m_tree->setUpdatesEnabled(true);
+
+    m_summaryLabel->setText(QString("Total Packets: %1 (%2 bytes)").arg(nodes[0].packets).arg(nodes[0].bytes));
+}
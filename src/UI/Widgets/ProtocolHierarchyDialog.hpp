@@ -0,0 +1,42 @@
+#ifndef PROTOCOLHIERARCHYDIALOG_HPP
+#define PROTOCOLHIERARCHYDIALOG_HPP
+
+#include <QDialog>
+#include <QTimer>
+#include <QLabel>
+#include <QVector>
+
+class QTreeWidget;
+class QTreeWidgetItem;
+class StatisticsManager;
+
+/**
+ * @brief Cây Protocol Hierarchy (Live): gói / byte và phần trăm ở mỗi tầng.
+ * Cập nhật tại chỗ mỗi giây: nút mới được thêm, nút cũ chỉ đổi số.
+ */
+class ProtocolHierarchyDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit ProtocolHierarchyDialog(StatisticsManager* manager, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+
+private slots:
+    void onUpdateTimerTimeout();
+
+private:
+    void setupUi();
+
+    QLabel* m_summaryLabel;
+    QTreeWidget* m_tree;
+    QVector<QTreeWidgetItem*> m_items;   // Chỉ số nút của ProtocolHierarchy -> dòng trên cây
+    quint64 m_drawnRevision = 0;
+
+    StatisticsManager* m_manager;
+    QTimer* m_updateTimer;
+};
+
+#endif // PROTOCOLHIERARCHYDIALOG_HPP
@@ -0,0 +1,55 @@
+#include "ReplayDialog.hpp"
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QLabel>
+#include <QDialogButtonBox>
+#include <QFileInfo>
+
+// --- Triển khai (Implementation) ---
+
+ReplayDialog::ReplayDialog(const QString& filePath, const QVector<QPair<QString, QString>>& devices, QWidget *parent)
+    : QDialog(parent)
+{
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel("Replay " + QFileInfo(filePath).fileName() + " through the live capture path", this));
+
+    QFormLayout* form = new QFormLayout();
+    m_speedCombo = new QComboBox(this);
+    m_speedCombo->addItem("1x (original timing)", 1.0);
+    m_speedCombo->addItem("2x", 2.0);
+    m_speedCombo->addItem("10x", 10.0);
+    m_speedCombo->addItem("100x", 100.0);
+    m_speedCombo->addItem("Top speed", 0.0);
+    form->addRow("Speed:", m_speedCombo);
+
+    m_keepTimestampsCheck = new QCheckBox("Keep original timestamps", this);
+    m_keepTimestampsCheck->setToolTip("Unchecked: packets are stamped with the time they are replayed, like a live capture");
+    form->addRow(QString(), m_keepTimestampsCheck);
+
+    // Gửi ra interface là tùy chọn (cần quyền gửi gói thô)
+    m_injectCombo = new QComboBox(this);
+    m_injectCombo->addItem("(none)", QString());
+    for (const auto& device : devices) {
+        m_injectCombo->addItem(device.second.isEmpty() ? device.first : device.first + " - " + device.second, device.first);
+    }
+    form->addRow("Also transmit on:", m_injectCombo);
+    layout->addLayout(form);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    layout->addWidget(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    setWindowTitle("Replay Capture File");
+}
+
+ReplayOptions ReplayDialog::options() const
+{
+    ReplayOptions result;
+    result.speed = m_speedCombo->currentData().toDouble();
+    result.keepOriginalTimestamps = m_keepTimestampsCheck->isChecked();
+    result.injectInterface = m_injectCombo->currentData().toString();
+    return result;
+}
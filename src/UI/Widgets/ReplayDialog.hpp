@@ -0,0 +1,32 @@
+#ifndef REPLAYDIALOG_HPP
+#define REPLAYDIALOG_HPP
+
+#include <QDialog>
+#include <QVector>
+#include <QPair>
+#include "../../Core/Capture/ReplayOptions.hpp"
+
+class QComboBox;
+class QCheckBox;
+
+/**
+ * @brief Hỏi tùy chọn phát lại file: tốc độ (1x / 2x / 10x / 100x / nhanh nhất),
+ * giữ timestamp gốc hay không, và interface để gửi gói ra (pcap_inject, tùy chọn).
+ */
+class ReplayDialog : public QDialog
+{
+    Q_OBJECT
+public:
+    // devices: (tên, mô tả) như InterfaceManager::getDevices()
+    ReplayDialog(const QString& filePath, const QVector<QPair<QString, QString>>& devices, QWidget *parent = nullptr);
+
+    ReplayOptions options() const;
+
+private:
+    // --- BIẾN UI ---
+    QComboBox* m_speedCombo;
+    QCheckBox* m_keepTimestampsCheck;
+    QComboBox* m_injectCombo;
+};
+
+#endif // REPLAYDIALOG_HPP
@@ -1,5 +1,9 @@
 #include "StatisticsDialog.hpp"
 #include "../../Controller/StatisticsManager.hpp"
+#include "../../Controller/ControllerLib/ConversationManager.hpp"
+#include "../../Common/LogHistogram.hpp"
+#include "../../Common/BatchMetrics.hpp"
+#include "../../Common/CaptureCounters.hpp"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QTabWidget>
@@ -7,10 +11,25 @@
 #include <QTreeWidgetItem>
 #include <QHeaderView>
 #include <QLabel>
+#include <QComboBox>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <QMutexLocker>
 
-StatisticsDialog::StatisticsDialog(StatisticsManager* manager, QWidget *parent)
+// Số địa chỉ hiển thị trong tab Sources / Destinations
+static const int TOP_ADDRESSES = 50;
+
+// Các phân vị hiển thị và xuất CSV
+static const double PERCENTILES[] = { 0.50, 0.90, 0.99, 0.999 };
+static const char* PERCENTILE_NAMES[] = { "p50", "p90", "p99", "p99.9" };
+
+StatisticsDialog::StatisticsDialog(StatisticsManager* manager, ConversationManager* convManager, QWidget *parent)
     : QDialog(parent),
-    m_manager(manager)
+    m_manager(manager),
+    m_convManager(convManager)
 {
     setupUi();
     setWindowTitle("Packet Statistics (Live)");
@@ -35,24 +54,214 @@ void StatisticsDialog::setupUi()
     m_totalPacketsLabel->setStyleSheet("font-weight: bold;");
     m_totalTypesLabel->setStyleSheet("font-weight: bold;");
 
+    m_distinctLabel = new QLabel("Distinct IPs: 0 / 0", this);
+    m_rankCombo = new QComboBox(this);
+    m_rankCombo->addItems({"Top by Packets", "Top by Bytes"});
+
     headerLayout->addWidget(m_totalPacketsLabel);
     headerLayout->addWidget(m_totalTypesLabel);
+    headerLayout->addWidget(m_distinctLabel);
     headerLayout->addStretch(); // Đẩy về bên trái
+    headerLayout->addWidget(m_rankCombo);
 
     layout->addLayout(headerLayout); // Thêm các label vào layout chính
+
+    m_captureLabel = new QLabel(this);
+    layout->addWidget(m_captureLabel);
+    m_replayLabel = new QLabel(this);
+    m_replayLabel->setVisible(false);
+    layout->addWidget(m_replayLabel);
     // ------------------------------------
 
     // --- 2. TẠO THANH TAB ---
     m_tabWidget = new QTabWidget(this);
     m_protocolTree = createTreeWidget({"Protocol", "Packets", "Percent"});
-    m_sourceTree = createTreeWidget({"Source IPs", "Packet Count"});
-    m_destTree = createTreeWidget({"Destination IPs", "Packet Count"});
+    // Giá trị là cận trên; giá trị thật nằm trong [giá trị - sai số, giá trị]
+    m_sourceTree = createTreeWidget({"Source IPs", "Packets", "± Packets", "Bytes", "± Bytes"});
+    m_destTree = createTreeWidget({"Destination IPs", "Packets", "± Packets", "Bytes", "± Bytes"});
     m_tabWidget->addTab(m_protocolTree, "Protocols");
     m_tabWidget->addTab(m_sourceTree, "Sources");
     m_tabWidget->addTab(m_destTree, "Destinations");
+    m_tabWidget->addTab(createDistributionTab(), "Distributions");
 
     layout->addWidget(m_tabWidget); // Thêm tab widget vào layout chính
     setLayout(layout);
+
+    connect(m_rankCombo, &QComboBox::currentIndexChanged, this, &StatisticsDialog::onUpdateTimerTimeout);
+}
+
+QWidget* StatisticsDialog::createDistributionTab()
+{
+    QWidget* tab = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(tab);
+
+    QHBoxLayout* topLayout = new QHBoxLayout();
+    m_distCombo = new QComboBox(tab);
+    for (int d = 0; d < DIST_COUNT; ++d) m_distCombo->addItem(distributionName(static_cast<Distribution>(d)));
+    QPushButton* exportButton = new QPushButton("Export CSV...", tab);
+    topLayout->addWidget(m_distCombo);
+    topLayout->addStretch();
+    topLayout->addWidget(exportButton);
+    layout->addLayout(topLayout);
+
+    m_percentileLabel = new QLabel(tab);
+    m_percentileLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    layout->addWidget(m_percentileLabel);
+
+    // Các bucket theo thứ tự giá trị (không sắp xếp lại)
+    m_distTree = new QTreeWidget(tab);
+    m_distTree->setHeaderLabels({"Range", "Count", "Percent", "Cumulative"});
+    m_distTree->setRootIsDecorated(false);
+    m_distTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    layout->addWidget(m_distTree);
+
+    connect(m_distCombo, &QComboBox::currentIndexChanged, this, &StatisticsDialog::populateDistribution);
+    connect(exportButton, &QPushButton::clicked, this, &StatisticsDialog::onExportCsvClicked);
+    return tab;
+}
+
+QString StatisticsDialog::distributionName(Distribution dist)
+{
+    switch (dist) {
+    case DIST_FRAME_LENGTH:    return "Frame length";
+    case DIST_FLOW_IAT:        return "Per-flow inter-arrival time";
+    case DIST_FLOW_THROUGHPUT: return "Per-flow throughput";
+    case DIST_BATCH_SIZE:      return "Capture batch size";
+    case DIST_BATCH_DELAY:     return "Capture batch delay";
+    default:                   return "";
+    }
+}
+
+LogHistogram StatisticsDialog::distribution(Distribution dist) const
+{
+    // Phân bố theo luồng do luồng xử lý cập nhật: copy trong lúc giữ khóa
+    QMutexLocker locker(m_convManager ? m_convManager->mutex() : nullptr);
+    switch (dist) {
+    case DIST_FRAME_LENGTH:    return m_manager->frameLengths();
+    case DIST_FLOW_IAT:        return m_convManager ? m_convManager->flowInterArrival() : LogHistogram();
+    case DIST_FLOW_THROUGHPUT: return m_convManager ? m_convManager->flowThroughput() : LogHistogram();
+    case DIST_BATCH_SIZE:      return m_manager->batchMetrics().batchPackets;
+    case DIST_BATCH_DELAY:     return m_manager->batchMetrics().batchDelayNs;
+    default:                   return LogHistogram();
+    }
+}
+
+QString StatisticsDialog::formatValue(Distribution dist, double value)
+{
+    switch (dist) {
+    case DIST_FLOW_IAT:
+    case DIST_BATCH_DELAY:
+        if (value < 1e3) return QString("%1 ns").arg(value, 0, 'f', 0);
+        if (value < 1e6) return QString("%1 us").arg(value / 1e3, 0, 'f', 1);
+        if (value < 1e9) return QString("%1 ms").arg(value / 1e6, 0, 'f', 2);
+        return QString("%1 s").arg(value / 1e9, 0, 'f', 3);
+    case DIST_FLOW_THROUGHPUT:
+        if (value < 1e3) return QString("%1 bit/s").arg(value, 0, 'f', 0);
+        if (value < 1e6) return QString("%1 kbit/s").arg(value / 1e3, 0, 'f', 1);
+        if (value < 1e9) return QString("%1 Mbit/s").arg(value / 1e6, 0, 'f', 2);
+        return QString("%1 Gbit/s").arg(value / 1e9, 0, 'f', 2);
+    case DIST_BATCH_SIZE:
+        return QString("%1 pkts").arg(value, 0, 'f', 0);
+    default:
+        return QString("%1 B").arg(value, 0, 'f', 0);
+    }
+}
+
+void StatisticsDialog::populateDistribution()
+{
+    const Distribution dist = static_cast<Distribution>(m_distCombo->currentIndex());
+    const LogHistogram hist = distribution(dist);
+
+    // 1. Phân vị
+    QString summary = QString("Samples: %1").arg(hist.count());
+    if (hist.count() > 0) {
+        for (int i = 0; i < 4; ++i) {
+            summary += QString("   %1: %2").arg(PERCENTILE_NAMES[i], formatValue(dist, hist.quantile(PERCENTILES[i])));
+        }
+        summary += QString("   min: %1   max: %2   mean: %3")
+                       .arg(formatValue(dist, hist.min()), formatValue(dist, hist.max()), formatValue(dist, hist.mean()));
+    }
+    if (dist == DIST_BATCH_SIZE || dist == DIST_BATCH_DELAY) {
+        summary += "\n" + batchSummary();
+    }
+    m_percentileLabel->setText(summary);
+
+    // 2. Các bucket (chỉ bucket khác 0)
+    m_distTree->clear();
+    const double total = hist.count() > 0 ? static_cast<double>(hist.count()) : 1.0;
+    uint64_t cumulative = 0;
+    QList<QTreeWidgetItem*> items;
+    hist.forEachBucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+        cumulative += count;
+        QTreeWidgetItem* item = new QTreeWidgetItem();
+        item->setText(0, lower == upper ? formatValue(dist, lower)
+                                        : formatValue(dist, lower) + " - " + formatValue(dist, upper));
+        item->setData(1, Qt::DisplayRole, static_cast<qulonglong>(count));
+        item->setText(2, QString::number(count * 100.0 / total, 'f', 2) + "%");
+        item->setText(3, QString::number(cumulative * 100.0 / total, 'f', 2) + "%");
+        items.append(item);
+    });
+    m_distTree->addTopLevelItems(items);
+}
+
+QString StatisticsDialog::batchSummary() const
+{
+    const BatchMetrics& metrics = m_manager->batchMetrics();
+    QString text = QString("Batches: %1").arg(metrics.totalBatches());
+    for (int r = 0; r < BatchMetrics::FLUSH_REASON_COUNT; ++r) {
+        text += QString("   %1: %2").arg(BatchMetrics::reasonName(r)).arg(metrics.flushes[r]);
+    }
+    text += QString("   arrival: %1 pkt/s   target: %2 pkts")
+                .arg(metrics.arrivalRate, 0, 'f', 0)
+                .arg(metrics.targetPackets);
+    return text;
+}
+
+void StatisticsDialog::onExportCsvClicked()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Export Distributions"), QString(),
+                                                    tr("CSV Files (*.csv)"));
+    if (filePath.isEmpty()) return;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QMessageBox::warning(this, "Export Failed", "Cannot write file: " + file.errorString());
+        return;
+    }
+
+    // Mỗi dòng một bucket; giá trị thô (byte, ns, bit/s) để dễ xử lý tiếp
+    static const char* UNITS[DIST_COUNT] = { "bytes", "ns", "bit/s", "packets", "ns" };
+    QTextStream out(&file);
+    out << "distribution,unit,lower,upper,count,cumulative_fraction\n";
+    for (int d = 0; d < DIST_COUNT; ++d) {
+        const LogHistogram hist = distribution(static_cast<Distribution>(d));
+        const QString name = distributionName(static_cast<Distribution>(d));
+        uint64_t cumulative = 0;
+        hist.forEachBucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+            cumulative += count;
+            out << '"' << name << "\"," << UNITS[d] << ',' << lower << ',' << upper << ',' << count << ','
+                << QString::number(static_cast<double>(cumulative) / hist.count(), 'f', 6) << '\n';
+        });
+    }
+
+    // Phân vị của từng phân bố (lower = upper = giá trị phân vị)
+    out << "\ndistribution,unit,percentile,value\n";
+    for (int d = 0; d < DIST_COUNT; ++d) {
+        const LogHistogram hist = distribution(static_cast<Distribution>(d));
+        if (hist.count() == 0) continue;
+        const QString name = distributionName(static_cast<Distribution>(d));
+        for (int i = 0; i < 4; ++i) {
+            out << '"' << name << "\"," << UNITS[d] << ',' << PERCENTILE_NAMES[i] << ','
+                << hist.quantile(PERCENTILES[i]) << '\n';
+        }
+    }
+
+    // Số lô theo lý do gửi
+    const BatchMetrics& metrics = m_manager->batchMetrics();
+    out << "\nflush_reason,batches\n";
+    for (int r = 0; r < BatchMetrics::FLUSH_REASON_COUNT; ++r) {
+        out << BatchMetrics::reasonName(r) << ',' << metrics.flushes[r] << '\n';
+    }
 }
 
 QTreeWidget* StatisticsDialog::createTreeWidget(const QStringList& headers)
@@ -81,19 +290,90 @@ void StatisticsDialog::onUpdateTimerTimeout()
 {
     // 1. Lấy dữ liệu MỚI NHẤT
     QMap<QString, qint64> protocols = m_manager->getProtocolCounts();
-    QMap<QString, qint64> sources = m_manager->getSourceIpCounts();
-    QMap<QString, qint64> dests = m_manager->getDestIpCounts();
+    const bool byBytes = (m_rankCombo->currentIndex() == 1);
+    QList<HeavyHitter> sources = m_manager->getTopSources(TOP_ADDRESSES, byBytes);
+    QList<HeavyHitter> dests = m_manager->getTopDestinations(TOP_ADDRESSES, byBytes);
     qint64 totalPackets = m_manager->getTotalPackets(); // <-- Lấy tổng số
 
     // --- 2.CẬP NHẬT LABEL TIÊU ĐỀ ---
     m_totalPacketsLabel->setText("Total Packets: " + QString::number(totalPackets));
     m_totalTypesLabel->setText("Total Protocol Types: " + QString::number(protocols.size()));
+    m_distinctLabel->setText(QString("Distinct IPs (src / dst): ~%1 / ~%2 (±%3%)")
+                                 .arg(qRound64(m_manager->getDistinctSources()))
+                                 .arg(qRound64(m_manager->getDistinctDestinations()))
+                                 .arg(m_manager->distinctRelativeError() * 100.0, 0, 'f', 1));
+    const CaptureCounters& counters = m_manager->captureCounters();
+    m_captureLabel->setText(QString("While paused: %1 skipped (%2 bytes), %3 counted only, %4 spooled, "
+                                    "%5 lost to a full spool (%6 bytes), %7 replayed"
+                                    "   |   Dropped by kernel: %8, by interface: %9, by reader queue: %10, "
+                                    "by processing backlog: %11")
+                                .arg(counters.pausedSkippedPackets)
+                                .arg(counters.pausedSkippedBytes)
+                                .arg(counters.pausedCountedPackets)
+                                .arg(counters.spooledPackets)
+                                .arg(counters.spoolOverflowPackets)
+                                .arg(counters.spoolOverflowBytes)
+                                .arg(counters.replayedPackets)
+                                .arg(counters.kernelDrops)
+                                .arg(counters.interfaceDrops)
+                                .arg(counters.queueDrops)
+                                .arg(counters.backlogDrops));
+
+    const ReplayMetrics& replay = m_manager->replayMetrics();
+    m_replayLabel->setVisible(replay.active());
+    if (replay.active()) {
+        QString text;
+        if (replay.speed > 0) {
+            const double target = replay.targetRate();
+            const double achieved = replay.achievedRate();
+            text = QString("Replay %1x: target %2 pps, achieved %3 pps (%4%), late p50 %5 µs / p99 %6 µs")
+                       .arg(replay.speed)
+                       .arg(target, 0, 'f', 0)
+                       .arg(achieved, 0, 'f', 0)
+                       .arg(target > 0 ? achieved * 100.0 / target : 100.0, 0, 'f', 1)
+                       .arg(replay.lateNs.quantile(0.5) / 1000.0, 0, 'f', 1)
+                       .arg(replay.lateNs.quantile(0.99) / 1000.0, 0, 'f', 1);
+        } else {
+            text = QString("Replay at top speed: %1 pps (%2 Mbit/s)")
+                       .arg(replay.achievedRate(), 0, 'f', 0)
+                       .arg(replay.elapsedNs > 0 ? replay.bytes * 8000.0 / replay.elapsedNs : 0.0, 0, 'f', 1);
+        }
+        if (replay.injectedPackets > 0 || replay.injectErrors > 0) {
+            text += QString("   |   Transmitted: %1, send errors: %2").arg(replay.injectedPackets).arg(replay.injectErrors);
+        }
+        m_replayLabel->setText(text);
+    }
     // ------------------------------------
 
     // 3. Điền dữ liệu vào 3 tab (truyền totalPackets vào)
     populateTree(m_protocolTree, protocols, true, totalPackets);
-    populateTree(m_sourceTree, sources, false, 0); // (Không cần totalPackets)
-    populateTree(m_destTree, dests, false, 0);  // (Không cần totalPackets)
+    populateHeavyHitters(m_sourceTree, sources);
+    populateHeavyHitters(m_destTree, dests);
+    if (m_tabWidget->currentIndex() == m_tabWidget->count() - 1) populateDistribution();
+}
+
+void StatisticsDialog::populateHeavyHitters(QTreeWidget* tree, const QList<HeavyHitter>& hitters)
+{
+    int sortColumn = tree->sortColumn();
+    Qt::SortOrder sortOrder = tree->header()->sortIndicatorOrder();
+
+    tree->clear();
+
+    QList<QTreeWidgetItem*> items;
+    for (const HeavyHitter& h : hitters)
+    {
+        QTreeWidgetItem* item = new QTreeWidgetItem();
+        item->setText(0, StatisticsManager::addressToString(h.key));
+        // DisplayRole số: sắp xếp theo giá trị thay vì theo chuỗi
+        item->setData(1, Qt::DisplayRole, static_cast<qulonglong>(h.packets));
+        item->setData(2, Qt::DisplayRole, static_cast<qulonglong>(h.packets_error));
+        item->setData(3, Qt::DisplayRole, static_cast<qulonglong>(h.bytes));
+        item->setData(4, Qt::DisplayRole, static_cast<qulonglong>(h.bytes_error));
+        items.append(item);
+    }
+
+    tree->addTopLevelItems(items);
+    tree->sortByColumn(sortColumn, sortOrder);
 }
 
 
@@ -9,13 +9,19 @@
 
 class QTabWidget;
 class QTreeWidget;
+class QComboBox;
 class StatisticsManager;
+class ConversationManager;
+class LogHistogram;
+struct HeavyHitter;
 
 class StatisticsDialog : public QDialog
 {
     Q_OBJECT
 public:
-    explicit StatisticsDialog(StatisticsManager* manager, QWidget *parent = nullptr);
+    // convManager: nguồn các phân bố theo luồng (inter-arrival, throughput)
+    explicit StatisticsDialog(StatisticsManager* manager, ConversationManager* convManager,
+                              QWidget *parent = nullptr);
 
 protected:
     void showEvent(QShowEvent *event) override;
@@ -23,6 +29,7 @@ protected:
 
 private slots:
     void onUpdateTimerTimeout();
+    void onExportCsvClicked();
 
 private:
     void setupUi();
@@ -32,17 +39,43 @@ private:
                       const QMap<QString, qint64>& data,
                       bool showPercent,
                       qint64 totalPackets);
+    // Top-K địa chỉ (heavy hitter) kèm cận sai số
+    void populateHeavyHitters(QTreeWidget* tree, const QList<HeavyHitter>& hitters);
+
+    // --- Phân bố (tab Distributions) ---
+    enum Distribution {
+        DIST_FRAME_LENGTH,      // byte
+        DIST_FLOW_IAT,          // ns
+        DIST_FLOW_THROUGHPUT,   // bit/s
+        DIST_BATCH_SIZE,        // gói / lô gửi từ luồng capture
+        DIST_BATCH_DELAY,       // ns (tuổi gói cũ nhất khi gửi lô)
+        DIST_COUNT
+    };
+    QWidget* createDistributionTab();
+    LogHistogram distribution(Distribution dist) const;
+    static QString distributionName(Distribution dist);
+    static QString formatValue(Distribution dist, double value);
+    void populateDistribution();
+    QString batchSummary() const;   // Lý do gửi lô + tốc độ / lô mục tiêu hiện tại
 
     // --- BIẾN UI ---
     QLabel* m_totalPacketsLabel;
     QLabel* m_totalTypesLabel;
+    QLabel* m_distinctLabel;
+    QLabel* m_captureLabel;     // Gói bỏ / chỉ đếm / spool khi tạm dừng + gói kernel làm rơi
+    QLabel* m_replayLabel;      // Phát lại file: tốc độ đạt được so với mục tiêu (ẩn khi không phát lại)
+    QComboBox* m_rankCombo;
     QTabWidget* m_tabWidget;
     QTreeWidget* m_protocolTree;
     QTreeWidget* m_sourceTree;
     QTreeWidget* m_destTree;
+    QComboBox* m_distCombo;
+    QLabel* m_percentileLabel;
+    QTreeWidget* m_distTree;
 
     // --- BIẾN LOGIC ---
     StatisticsManager* m_manager;
+    ConversationManager* m_convManager;
     QTimer* m_updateTimer;
 };
 
@@ -0,0 +1,31 @@
+#ifndef TESTUTIL_HPP
+#define TESTUTIL_HPP
+
+/**
+ * @brief Tiện ích chung của các test: CHECK ghi lỗi và đếm, main trả về số lỗi (0 = đạt).
+ * Không dùng framework: mỗi test là một chương trình nhỏ chạy qua ctest.
+ */
+#include <cstdio>
+
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);  \
+            ++testFailures();                                                         \
+        }                                                                             \
+    } while (0)
+
+inline int testResult(const char* name)
+{
+    if (testFailures() == 0) printf("%s: ok\n", name);
+    else printf("%s: %d failure(s)\n", name, testFailures());
+    return testFailures() == 0 ? 0 : 1;
+}
+
+#endif // TESTUTIL_HPP
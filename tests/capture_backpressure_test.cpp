@@ -0,0 +1,117 @@
+/**
+ * @brief Test giới hạn số lô đang chờ giữa CaptureEngine và tầng xử lý khi đọc file.
+ *
+ * Bên nhận không trả lô nào: luồng đọc file phải dừng ở MAX_BATCHES_IN_FLIGHT lô (không đọc
+ * tiếp vào RAM). Sau đó trả từng lô (batchProcessed): mọi gói tới đủ, packet_id liên tục từ 1.
+ * Nhánh bắt trực tiếp (giữ lô, bỏ gói khi đầy) cần interface thật nên không có ở đây.
+ */
+#include <QDir>
+#include <QList>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <pcap.h>
+#include "CaptureEngine.hpp"
+#include "TestUtil.hpp"
+
+static const int PACKETS = 200000;
+static const size_t MAX_BATCHES_IN_FLIGHT = 8;   // Như CaptureEngine.cpp
+
+// --- Các hàm trợ giúp nội bộ ---
+
+// Ethernet + IPv4 + UDP tối thiểu, mỗi gói một cổng nguồn khác
+static bool writeCapture(const QString& path)
+{
+    pcap_t* dead = pcap_open_dead(DLT_EN10MB, 65535);
+    pcap_dumper_t* dumper = pcap_dump_open(dead, path.toStdString().c_str());
+    if (!dumper) {
+        pcap_close(dead);
+        return false;
+    }
+    u_char frame[42] = {};
+    frame[12] = 0x08;                         // ether_type IPv4
+    frame[14] = 0x45;                         // IPv4, IHL 5
+    frame[17] = 28;                           // total length
+    frame[22] = 64;                           // TTL
+    frame[23] = 17;                           // UDP
+    frame[39] = 8;                            // UDP length
+    for (int i = 0; i < PACKETS; ++i) {
+        frame[34] = static_cast<u_char>(i >> 8);
+        frame[35] = static_cast<u_char>(i);
+        pcap_pkthdr header{};
+        header.ts.tv_sec = 1700000000 + i / 1000;
+        header.ts.tv_usec = (i % 1000) * 1000;
+        header.caplen = header.len = sizeof(frame);
+        pcap_dump(reinterpret_cast<u_char*>(dumper), &header, frame);
+    }
+    pcap_dump_close(dumper);
+    pcap_close(dead);
+    return true;
+}
+
+// --- Triển khai (Implementation) ---
+
+int main()
+{
+    QTemporaryDir dir(QDir::tempPath() + "/backpressure-test-XXXXXX");
+    const QString path = dir.filePath("capture.pcap");
+    CHECK(writeCapture(path));
+
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::deque<QList<PacketData>*> queued;
+    size_t maxQueued = 0;
+
+    CaptureEngine engine;
+    QObject::connect(&engine, &CaptureEngine::packetsCaptured, &engine, [&](QList<PacketData>* batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(batch);
+        maxQueued = std::max(maxQueued, queued.size());
+        arrived.notify_all();
+    }, Qt::DirectConnection);
+    engine.startCaptureFromFile(path);
+
+    // 1. Chưa trả lô nào: luồng đọc dừng ở giới hạn
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        arrived.wait_for(lock, std::chrono::seconds(30), [&] { return queued.size() >= MAX_BATCHES_IN_FLIGHT; });
+        CHECK(queued.size() == MAX_BATCHES_IN_FLIGHT);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(queued.size() == MAX_BATCHES_IN_FLIGHT);
+    }
+
+    // 2. Trả từng lô: đủ gói, đúng thứ tự
+    uint32_t nextId = 1;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (nextId <= PACKETS && std::chrono::steady_clock::now() < deadline) {
+        QList<PacketData>* batch = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            arrived.wait_for(lock, std::chrono::milliseconds(100), [&] { return !queued.empty(); });
+            if (queued.empty()) continue;
+            batch = queued.front();
+            queued.pop_front();
+        }
+        for (const PacketData& packet : *batch) {
+            CHECK(packet.packet_id == nextId);
+            nextId = packet.packet_id + 1;
+        }
+        delete batch;
+        engine.batchProcessed();
+    }
+    CHECK(nextId == static_cast<uint32_t>(PACKETS) + 1);
+    engine.stopCapture();
+
+    // Lô cuối (FLUSH_END, hết file) luôn được gửi nên có thể vượt giới hạn một lô
+    CHECK(maxQueued <= MAX_BATCHES_IN_FLIGHT + 1);
+    for (QList<PacketData>* batch : queued) delete batch;
+    return testResult("capture_backpressure_test");
+}
@@ -0,0 +1,124 @@
+/**
+ * @brief Test đếm gói pcapng của CaptureFileIndex::scan so với bản ghi PacketIndex đọc lại được.
+ *
+ * File có một EPB bị cắt (thân 16 byte, ngắn hơn 20 byte trường cố định) nằm giữa hai EPB hợp lệ.
+ * scan() không được tính nó là gói: số gói, timestamp cuối và số thứ tự mà readPackets() / findTime()
+ * trả về phải khớp nhau (gói số 2 là EPB hợp lệ thứ hai, không phải block bị cắt).
+ */
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "CaptureFileIndex.hpp"
+#include "PacketIndex.hpp"
+#include "RawPacket.hpp"
+#include "TestUtil.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static void put32(std::vector<uint8_t>& out, uint32_t v)
+{
+    const size_t at = out.size();
+    out.resize(at + 4);
+    memcpy(out.data() + at, &v, 4);
+}
+
+// Block pcapng (thứ tự byte của máy): type, độ dài, thân (đệm tới bội số 4), độ dài
+static void putBlock(std::vector<uint8_t>& out, uint32_t type, const std::vector<uint8_t>& body)
+{
+    const uint32_t padded = static_cast<uint32_t>((body.size() + 3) & ~size_t(3));
+    put32(out, type);
+    put32(out, padded + 12);
+    out.insert(out.end(), body.begin(), body.end());
+    out.resize(out.size() + padded - body.size(), 0);
+    put32(out, padded + 12);
+}
+
+// EPB trên interface 0 (độ phân giải mặc định: micro giây)
+static std::vector<uint8_t> epbBody(uint64_t usec, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> body;
+    put32(body, 0);
+    put32(body, static_cast<uint32_t>(usec >> 32));
+    put32(body, static_cast<uint32_t>(usec));
+    put32(body, static_cast<uint32_t>(data.size()));
+    put32(body, static_cast<uint32_t>(data.size()));
+    body.insert(body.end(), data.begin(), data.end());
+    return body;
+}
+
+static bool writeCapture(const QString& path)
+{
+    std::vector<uint8_t> file;
+
+    std::vector<uint8_t> shb;
+    put32(shb, 0x1A2B3C4D);                 // Byte-order magic
+    put32(shb, 1);                          // Phiên bản 1.0
+    put32(shb, 0xFFFFFFFF);                 // Độ dài section: không rõ
+    put32(shb, 0xFFFFFFFF);
+    putBlock(file, 0x0A0D0D0A, shb);
+
+    std::vector<uint8_t> idb;
+    put32(idb, 1);                          // DLT_EN10MB, reserved
+    put32(idb, 65535);                      // snaplen
+    putBlock(file, 0x00000001, idb);
+
+    putBlock(file, 0x00000006, epbBody(1000000, std::vector<uint8_t>(14, 0xAA)));
+
+    // EPB bị cắt: còn interface id + timestamp + cap len (16 byte), thiếu wire len
+    std::vector<uint8_t> truncated = epbBody(1500000, {});
+    truncated.resize(16);
+    putBlock(file, 0x00000006, truncated);
+
+    putBlock(file, 0x00000006, epbBody(2000000, std::vector<uint8_t>(14, 0xBB)));
+
+    FILE* f = fopen(QFile::encodeName(path).constData(), "wb");
+    if (!f) return false;
+    const bool ok = fwrite(file.data(), 1, file.size(), f) == file.size();
+    return fclose(f) == 0 && ok;
+}
+
+// --- Triển khai (Implementation) ---
+
+int main()
+{
+    QTemporaryDir dir;
+    CHECK(dir.isValid());
+    const QString path = QDir(dir.path()).filePath("truncated_epb.pcapng");
+    CHECK(writeCapture(path));
+
+    // 1. scan: chỉ hai EPB hợp lệ là gói
+    CaptureFileInfo info;
+    QString error;
+    CHECK(CaptureFileIndex::scan(path, info, error));
+    CHECK(info.isPcapng);
+    CHECK(info.packetCount == 2);
+    CHECK(info.firstNs == 1000000000LL);
+    CHECK(info.lastNs == 2000000000LL);
+
+    // 2. PacketIndex đọc lại đúng số gói đã đếm, gói số 2 là EPB hợp lệ thứ hai
+    PacketIndex index;
+    CHECK(index.build(path, error));
+    CHECK(index.packetCount() == 2);
+
+    std::vector<RawPacket> packets;
+    CHECK(index.readPackets(1, 10, packets, error));
+    CHECK(packets.size() == 2);
+    if (packets.size() == 2) {
+        CHECK(packets[0].data == std::vector<uint8_t>(14, 0xAA));
+        CHECK(packets[1].data == std::vector<uint8_t>(14, 0xBB));
+        CHECK(packets[1].header.ts.tv_sec == 2);
+    }
+
+    CHECK(index.readPackets(2, 1, packets, error));
+    CHECK(packets.size() == 1 && packets[0].data == std::vector<uint8_t>(14, 0xBB));
+    CHECK(!index.readPackets(3, 1, packets, error));
+
+    // 3. Tìm theo thời gian: block bị cắt (1.5 s) không có số thứ tự riêng
+    CHECK(index.findTime(1500000000LL, error) == 2);
+
+    return testResult("capture_file_index_test");
+}
@@ -0,0 +1,128 @@
+/**
+ * @brief Test model ảo của bảng gói: số dòng, tra dòng theo packet_id, định dạng khi cần,
+ * sắp xếp trên luồng nền (kết quả cũ bị bỏ) và trả về thứ tự bắt gói.
+ */
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <algorithm>
+#include <map>
+#include <thread>
+#include "PacketListModel.hpp"
+#include "TestUtil.hpp"
+
+// --- Các hàm trợ giúp nội bộ ---
+
+static PacketData makePacket(quint32 id, uint32_t length)
+{
+    PacketData packet;
+    packet.packet_id = id;
+    packet.timestamp.tv_sec = 1700000000 + id;
+    packet.cap_length = packet.wire_length = length;
+    return packet;
+}
+
+// Xử lý sự kiện (kết quả sắp xếp gửi về luồng GUI) tới khi cond đúng hoặc hết thời gian
+template <typename Cond>
+static bool waitFor(Cond cond, qint64 timeoutMs = 5000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!cond() && timer.elapsed() < timeoutMs) QCoreApplication::processEvents();
+    return cond();
+}
+
+// --- Triển khai (Implementation) ---
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // Gói 1..10 (bỏ 4, 7 như bị lọc); độ dài giảm dần theo packet_id
+    QHash<quint32, PacketData> store;
+    QList<quint32> ids;
+    for (quint32 id = 1; id <= 10; ++id) {
+        if (id == 4 || id == 7) continue;
+        store.insert(id, makePacket(id, 1000 - id * 10));
+        ids.append(id);
+    }
+    int lookups = 0;
+
+    PacketListModel model;
+    model.setPacketLookup([&](quint32 packetId, PacketData& out) {
+        ++lookups;
+        auto it = store.constFind(packetId);
+        if (it == store.constEnd()) return false;
+        out = it.value();
+        return true;
+    });
+    // Sắp theo độ dài trên luồng riêng (như AppController); luồng GUI chỉ nhận mảng packet_id
+    int sorts = 0;
+    model.setPacketSorter([&store, &sorts](std::vector<quint32> packetIds, int column, Qt::SortOrder order,
+                                           PacketListModel::SortDone done) {
+        ++sorts;
+        std::map<quint32, uint32_t> lengths;
+        for (quint32 id : packetIds) lengths[id] = store.value(id).wire_length;
+        std::thread([packetIds, lengths, column, order, done]() mutable {
+            std::sort(packetIds.begin(), packetIds.end(), [&](quint32 a, quint32 b) {
+                if (column != PacketRow::COL_LENGTH || lengths[a] == lengths[b]) return a < b;
+                return order == Qt::AscendingOrder ? lengths[a] < lengths[b] : lengths[a] > lengths[b];
+            });
+            done(packetIds);
+        }).detach();
+    });
+    model.appendPackets(ids.mid(0, 5));
+    model.appendPackets(ids.mid(5));
+    CHECK(model.rowCount() == 8);
+    CHECK(model.columnCount() == PacketRow::COL_COUNT);
+
+    // Thêm dòng không định dạng gói nào; chỉ dòng được hỏi mới tra gói
+    CHECK(lookups == 0);
+    const QModelIndex lengthCell = model.index(2, PacketRow::COL_LENGTH);
+    CHECK(model.data(lengthCell).toString() == QString::number(1000 - 3 * 10));
+    CHECK(lookups == 1);
+    model.data(lengthCell);
+    CHECK(lookups == 1);   // Lấy từ bộ đệm dòng
+
+    // Gói bị lọc: trả dòng kế tiếp; quá cuối: -1
+    CHECK(model.rowForPacket(5) == 3);
+    CHECK(model.rowForPacket(4) == 3);
+    CHECK(model.rowForPacket(11) == -1);
+    CHECK(model.packetIdAt(7) == 10);
+
+    // Sắp theo độ dài tăng dần: packet_id lớn (gói ngắn) lên đầu, khi kết quả về tới luồng GUI
+    lookups = 0;
+    model.sort(PacketRow::COL_LENGTH, Qt::AscendingOrder);
+    CHECK(sorts == 1);
+    CHECK(waitFor([&] { return model.packetIdAt(0) == 10; }));
+    CHECK(lookups == 0);                 // Không tra gói trên luồng GUI khi sắp xếp
+    CHECK(model.packetIdAt(7) == 1);
+    CHECK(model.rowForPacket(9) == 1);
+    CHECK(model.rowForPacket(7) == 2);   // Gói 7 bị lọc: gói 8 ở dòng 2
+    PacketData packet;
+    CHECK(model.packetAt(0, packet) && packet.packet_id == 10);
+
+    // Bỏ sắp xếp: về thứ tự bắt gói ngay (không qua luồng nền)
+    model.sort(-1);
+    CHECK(sorts == 1);
+    for (int row = 0; row < model.rowCount(); ++row) CHECK(model.packetIdAt(row) == ids[row]);
+
+    // Sắp lại rồi xóa bảng trước khi kết quả về: kết quả cũ bị bỏ
+    model.sort(PacketRow::COL_LENGTH, Qt::DescendingOrder);
+    model.clear();
+    model.appendPackets({1, 2, 3});
+    waitFor([] { return false; }, 300); // Chờ kết quả của job cũ về tới luồng GUI
+    CHECK(model.rowCount() == 3);
+    CHECK(model.packetIdAt(0) == 1 && model.packetIdAt(2) == 3);
+
+    // Gói không còn trong kho: dòng chỉ có số thứ tự
+    store.remove(9);
+    model.sort(-1);
+    model.clear();
+    CHECK(model.rowCount() == 0);
+    model.appendPackets({9});
+    CHECK(model.data(model.index(0, PacketRow::COL_NO)).toString() == "9");
+    CHECK(model.data(model.index(0, PacketRow::COL_LENGTH)).toString().isEmpty());
+    return testResult("packet_list_model_test");
+}